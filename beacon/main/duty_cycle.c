@@ -0,0 +1,253 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include <sys/time.h>
+#include "duty_cycle.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "swift_trace.h"
+#include "phase_profiler.h"
+
+static const char *TAG = "DUTY_CYCLE";
+
+#define DUTY_CYCLE_MAGIC 0x44435931         // "DCY1", 전원 인가 직후 RTC 메모리 쓰레기 값 구분
+
+// 듀티 사이클 상태 (Deep Sleep 동안 RTC 슬로우 메모리에 유지)
+typedef struct {
+    uint32_t magic;                         // DUTY_CYCLE_MAGIC 이면 유효
+    int64_t deadline_us;                    // 이번 깨어남의 예정 시각 (RTC 시계, 마이크로초)
+    int64_t last_report_us;                 // 마지막 전체 사이클 시각
+    uint32_t interval_sec;                  // 현재 주기
+    uint8_t stationary_cycles;              // 연속 정지 판정 횟수
+    uint8_t range_count;                    // 마지막 거리 측정 수
+    struct {
+        uint8_t anchor_mac[6];              // 앵커 MAC 주소
+        float distance;                     // 거리 (m)
+        float variance;                     // 분산 (m²)
+    } ranges[SWIFT_FRAME_MAX_MEASUREMENTS];
+    uint8_t rssi_count;                     // RSSI 기준값 수 (0 이면 다음 확인에서 새로 저장)
+    duty_rssi_sample_t rssi_ref[DUTY_RSSI_MAX_GATEWAYS];
+    bool slot_valid;                        // 게이트웨이 배정 슬롯에 데드라인을 맞췄는지
+    uint8_t slot;                           // 배정 슬롯 번호
+    uint16_t superframe_ms;                 // 슈퍼프레임 길이
+    uint32_t full_cycles;                   // 전체 사이클 누적 수
+    uint32_t rssi_cycles;                   // RSSI 확인만 하고 다시 잠든 누적 수
+} duty_cycle_state_t;
+
+RTC_DATA_ATTR static duty_cycle_state_t duty;
+
+static int64_t rtc_now_us(void) {
+    struct timeval tv_now;
+    gettimeofday(&tv_now, NULL);
+    return (int64_t)tv_now.tv_sec * 1000000 + tv_now.tv_usec;
+}
+
+// RTC 상태가 없으면 지금을 첫 데드라인으로 초기화
+static void duty_cycle_ensure_state(void) {
+    if (duty.magic == DUTY_CYCLE_MAGIC && duty.interval_sec >= DUTY_MIN_INTERVAL_SEC &&
+        duty.interval_sec <= DUTY_MAX_INTERVAL_SEC) {
+        return;
+    }
+    memset(&duty, 0, sizeof(duty));
+    duty.deadline_us = rtc_now_us();
+    duty.interval_sec = DUTY_MIN_INTERVAL_SEC;
+    duty.magic = DUTY_CYCLE_MAGIC;
+}
+
+// 정지 판정: 주기를 두 배로 (최대 DUTY_MAX_INTERVAL_SEC)
+static void duty_cycle_stretch(void) {
+    if (duty.stationary_cycles < UINT8_MAX) {
+        duty.stationary_cycles++;
+    }
+    duty.interval_sec *= 2;
+    if (duty.interval_sec > DUTY_MAX_INTERVAL_SEC) {
+        duty.interval_sec = DUTY_MAX_INTERVAL_SEC;
+    }
+}
+
+// 움직임 판정: 최소 주기로 복귀
+static void duty_cycle_tighten(void) {
+    duty.stationary_cycles = 0;
+    duty.interval_sec = DUTY_MIN_INTERVAL_SEC;
+    duty.rssi_count = 0;
+}
+
+
+// ===== 사이클 계획 =====
+
+duty_cycle_mode_t duty_cycle_plan(void) {
+    duty_cycle_ensure_state();
+
+    int64_t since_report_sec = (rtc_now_us() - duty.last_report_us) / 1000000;
+    if (duty.full_cycles == 0 || duty.stationary_cycles < DUTY_STATIONARY_CYCLES ||
+        since_report_sec < 0 || since_report_sec >= DUTY_HEARTBEAT_SEC) {
+        return DUTY_CYCLE_FULL;
+    }
+    return DUTY_CYCLE_RSSI_CHECK;
+}
+
+
+// ===== 움직임 판정 =====
+
+bool duty_cycle_rssi_stationary(const duty_rssi_sample_t *samples, int count) {
+    duty_cycle_ensure_state();
+
+    if (count == 0) {
+        ESP_LOGI(TAG, "RSSI 확인: 게이트웨이가 보이지 않음, 전체 사이클");
+        duty_cycle_tighten();
+        return false;
+    }
+
+    if (duty.rssi_count == 0) {
+        int stored = (count < DUTY_RSSI_MAX_GATEWAYS) ? count : DUTY_RSSI_MAX_GATEWAYS;
+        memcpy(duty.rssi_ref, samples, stored * sizeof(duty_rssi_sample_t));
+        duty.rssi_count = (uint8_t)stored;
+        duty.rssi_cycles++;
+        duty_cycle_stretch();
+        ESP_LOGI(TAG, "RSSI 확인: 기준값 %d개 저장", stored);
+        return true;
+    }
+
+    int matched = 0;
+    int max_delta = 0;
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < duty.rssi_count; j++) {
+            if (memcmp(samples[i].mac, duty.rssi_ref[j].mac, 6) == 0) {
+                int delta = abs((int)samples[i].rssi - (int)duty.rssi_ref[j].rssi);
+                if (delta > max_delta) {
+                    max_delta = delta;
+                }
+                matched++;
+                break;
+            }
+        }
+    }
+
+    if (matched == 0 || max_delta >= DUTY_RSSI_MOTION_DB) {
+        ESP_LOGI(TAG, "RSSI 확인: 움직임 감지 (일치 %d개, 최대 변화 %d dB), 전체 사이클", matched, max_delta);
+        duty_cycle_tighten();
+        return false;
+    }
+
+    duty.rssi_cycles++;
+    duty_cycle_stretch();
+    ESP_LOGI(TAG, "RSSI 확인: 정지 (일치 %d개, 최대 변화 %d dB)", matched, max_delta);
+    return true;
+}
+
+void duty_cycle_report_ranges(const swift_measurement_t *measurements, int count) {
+    duty_cycle_ensure_state();
+
+    // 이전 측정과 공통인 앵커의 거리 변화를 두 측정 분산으로 정규화해 비교
+    int matched = 0;
+    bool moved = false;
+    for (int i = 0; i < count && !moved; i++) {
+        for (int j = 0; j < duty.range_count; j++) {
+            if (memcmp(measurements[i].anchor_mac, duty.ranges[j].anchor_mac, 6) != 0) {
+                continue;
+            }
+            float delta = fabsf(measurements[i].distance_meters - duty.ranges[j].distance);
+            float threshold = DUTY_MOTION_GATE_SIGMA * sqrtf(measurements[i].variance + duty.ranges[j].variance);
+            if (threshold < DUTY_MOTION_MIN_DELTA_M) {
+                threshold = DUTY_MOTION_MIN_DELTA_M;
+            }
+            if (delta > threshold) {
+                ESP_LOGI(TAG, "거리 변화 "MACSTR": %.2f m (기준 %.2f m)",
+                        MAC2STR(measurements[i].anchor_mac), delta, threshold);
+                moved = true;
+            }
+            matched++;
+            break;
+        }
+    }
+
+    // 공통 앵커가 없으면 (첫 측정, 다른 구역) 움직인 것으로 봄
+    if (moved || matched == 0) {
+        duty_cycle_tighten();
+    } else {
+        duty_cycle_stretch();
+    }
+
+    int stored = (count < SWIFT_FRAME_MAX_MEASUREMENTS) ? count : SWIFT_FRAME_MAX_MEASUREMENTS;
+    for (int i = 0; i < stored; i++) {
+        memcpy(duty.ranges[i].anchor_mac, measurements[i].anchor_mac, 6);
+        duty.ranges[i].distance = measurements[i].distance_meters;
+        duty.ranges[i].variance = measurements[i].variance;
+    }
+    duty.range_count = (uint8_t)stored;
+    duty.rssi_count = 0;                    // 다음 RSSI 확인은 지금 위치 기준으로 새로 시작
+    duty.last_report_us = rtc_now_us();
+    duty.full_cycles++;
+
+    ESP_LOGI(TAG, "%s (공통 앵커 %d개), 주기 %" PRIu32 "초, 연속 정지 %d회",
+            (moved || matched == 0) ? "움직임" : "정지", matched, duty.interval_sec, duty.stationary_cycles);
+}
+
+void duty_cycle_report_failure(void) {
+    duty_cycle_ensure_state();
+    duty_cycle_tighten();
+}
+
+
+// ===== TDMA 슬롯 =====
+
+void duty_cycle_align_slot(const swift_slot_assignment_t *assignment, int64_t received_age_us) {
+    duty_cycle_ensure_state();
+
+    // 모든 주기가 슈퍼프레임의 배수여야 데드라인을 더해도 슬롯 위치가 유지됨
+    if (assignment->superframe_ms == 0 || (DUTY_MIN_INTERVAL_SEC * 1000) % assignment->superframe_ms != 0) {
+        ESP_LOGW(TAG, "슬롯 무시: 슈퍼프레임 %d ms 가 최소 주기 %d초의 약수가 아님",
+                assignment->superframe_ms, DUTY_MIN_INTERVAL_SEC);
+        return;
+    }
+
+    // 배정 슬롯 시작 시각을 이번 깨어남 이전으로 당겨 "이번 사이클의 예정 시각"으로 사용
+    int64_t now_us = rtc_now_us();
+    int64_t superframe_us = (int64_t)assignment->superframe_ms * 1000;
+    int64_t slot_start_us = now_us - received_age_us + (int64_t)assignment->offset_ms * 1000;
+    while (slot_start_us > now_us) {
+        slot_start_us -= superframe_us;
+    }
+
+    int64_t shift_ms = (slot_start_us - duty.deadline_us) % superframe_us / 1000;
+    duty.deadline_us = slot_start_us;
+    duty.slot = assignment->slot;
+    duty.superframe_ms = assignment->superframe_ms;
+    duty.slot_valid = true;
+    ESP_LOGI(TAG, "TDMA 슬롯 %d/%d 에 맞춤 (슈퍼프레임 %d ms, 위상 이동 %" PRId64 " ms)",
+            assignment->slot, assignment->slot_count, assignment->superframe_ms, shift_ms);
+}
+
+
+// ===== Deep Sleep =====
+
+void duty_cycle_sleep(void) {
+    duty_cycle_ensure_state();
+
+    // 트레이스 링은 일반 RAM 이라 Deep Sleep 에서 사라지므로 잠들기 직전에 덤프 (측정/전송이 끝난 뒤)
+    swift_trace_dump();
+
+    // 이번 깨어남의 예정 시각에서 주기만큼 더함 (처리 시간은 주기 안에 흡수)
+    // 처리가 주기를 넘겼으면 놓친 주기는 건너뛰고 다음 주기 경계로
+    int64_t now_us = rtc_now_us();
+    int64_t interval_us = (int64_t)duty.interval_sec * 1000000;
+    int64_t deadline_us = duty.deadline_us + interval_us;
+    if (duty.deadline_us > now_us + interval_us) {
+        deadline_us = now_us + interval_us;             // RTC 시계가 뒤로 간 경우
+    }
+    while (deadline_us < now_us + (int64_t)DUTY_MIN_SLEEP_MS * 1000) {
+        deadline_us += interval_us;
+    }
+    duty.deadline_us = deadline_us;
+
+    uint64_t sleep_us = (uint64_t)(deadline_us - now_us);
+    phase_profiler_finish_cycle(sleep_us);
+    ESP_LOGI(TAG, "Deep Sleep %" PRIu64 " ms (주기 %" PRIu32 "초, 슬롯 %d, 깨어 있던 시간 %" PRId64 " ms, 전체 %" PRIu32 "회 / RSSI 확인 %" PRIu32 "회)",
+            sleep_us / 1000, duty.interval_sec, duty.slot_valid ? duty.slot : -1, esp_timer_get_time() / 1000,
+            duty.full_cycles, duty.rssi_cycles);
+    esp_deep_sleep(sleep_us);
+}
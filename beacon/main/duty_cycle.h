@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "swift_frame.h"
+
+// ===== 적응형 듀티 사이클 설정 =====
+// 최근 거리/RSSI 를 RTC 메모리에 두고, 정지 상태면 주기를 늘리고 움직이면 다시 줄임
+// 깨어날 시각은 고정 주기 데드라인 기준 (사이클 처리 시간만큼 주기가 밀리지 않음)
+#define DUTY_MIN_INTERVAL_SEC 5             // 움직일 때 (그리고 처음) 주기
+#define DUTY_MAX_INTERVAL_SEC 60            // 정지 상태에서 늘어나는 최대 주기
+#define DUTY_STATIONARY_CYCLES 3            // 이 횟수만큼 연속 정지 판정이면 FTM 대신 RSSI 만 확인
+#define DUTY_HEARTBEAT_SEC 300              // 정지 상태여도 이 간격으로는 전체 측정/전송
+#define DUTY_MOTION_MIN_DELTA_M 0.5f        // 이보다 작은 거리 변화는 움직임으로 보지 않음
+#define DUTY_MOTION_GATE_SIGMA 3.0f         // 거리 변화가 두 측정 표준편차 합성의 이 배수를 넘으면 움직임
+#define DUTY_RSSI_MOTION_DB 8               // RSSI 확인에서 이 이상 변하면 움직임
+#define DUTY_RSSI_MAX_GATEWAYS 8            // RSSI 기준값으로 보관할 최대 게이트웨이 수
+#define DUTY_MIN_SLEEP_MS 100               // 데드라인이 이보다 가까우면 다음 주기로 넘김
+
+// 이번 깨어남에서 할 일
+typedef enum {
+    DUTY_CYCLE_FULL = 0,                    // 스캔/FTM/층 수신 후 전송
+    DUTY_CYCLE_RSSI_CHECK = 1,              // 한 채널 스캔으로 RSSI 만 비교 (변화 없으면 바로 다시 잠듦)
+} duty_cycle_mode_t;
+
+// RSSI 확인 관측값
+typedef struct {
+    uint8_t mac[6];                         // 게이트웨이 BSSID
+    int8_t rssi;                            // 신호 강도
+} duty_rssi_sample_t;
+
+// 이번 깨어남의 사이클 종류 결정 (RTC 상태가 없으면 전체 사이클)
+duty_cycle_mode_t duty_cycle_plan(void);
+
+// RSSI 확인 결과 반영, 정지 상태로 볼 수 있으면 true (false 면 전체 사이클로 진행)
+// 기준값이 없으면 이번 관측을 기준으로 저장하고 정지로 판정
+bool duty_cycle_rssi_stationary(const duty_rssi_sample_t *samples, int count);
+
+// 전체 사이클의 거리 측정 결과로 움직임 판정 후 주기 조정
+void duty_cycle_report_ranges(const swift_measurement_t *measurements, int count);
+
+// 측정/전송 실패 시 최소 주기로 복귀
+void duty_cycle_report_failure(void);
+
+// 게이트웨이가 배정한 TDMA 슬롯에 데드라인을 맞춤 (received_age_us = 배정 프레임 수신 후 지난 시간)
+// 이후 데드라인은 주기(슈퍼프레임의 배수)만큼씩 더하므로 슬롯 위치가 유지됨
+// RTC 저속 클럭 오차가 누적되므로 전송에 성공할 때마다 다시 맞춤
+void duty_cycle_align_slot(const swift_slot_assignment_t *assignment, int64_t received_age_us);
+
+// 트레이스를 덤프하고 깨어남 프로파일을 닫은 뒤 다음 데드라인까지 Deep Sleep (반환하지 않음)
+void duty_cycle_sleep(void);
@@ -0,0 +1,214 @@
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "ftm_reducer.h"
+#include "esp_log.h"
+
+static const char *TAG = "FTM_REDUCER";
+
+// 피코초 RTT → 보정 후 거리 (m): RTT * 광속 / 2 * 보정 계수
+#define PS_TO_METERS (299792458.0 * 1e-12 / 2.0)
+#define PS_TO_CALIBRATED_METERS (PS_TO_METERS * FTM_CALIBRATION_FACTOR)
+
+// 보정 후 거리 범위를 RTT 정수 범위로 환산 (컴파일 시 계산)
+static const uint32_t rtt_min_ps = (uint32_t)(FTM_DISTANCE_MIN_M / PS_TO_CALIBRATED_METERS) + 1;
+static const uint32_t rtt_max_ps = (uint32_t)(FTM_DISTANCE_MAX_M / PS_TO_CALIBRATED_METERS);
+
+
+// ===== 정수 축약 =====
+
+// 삽입 정렬 (샘플 수가 작고 FTM 리포트는 대부분 거의 정렬되지 않은 작은 배열)
+static void sort_u32(uint32_t *data, int count) {
+    for (int i = 1; i < count; i++) {
+        uint32_t value = data[i];
+        int j = i - 1;
+        while (j >= 0 && data[j] > value) {
+            data[j + 1] = data[j];
+            j--;
+        }
+        data[j + 1] = value;
+    }
+}
+
+// FTM 리포트 엔트리를 거리 하나로 축약
+esp_err_t ftm_reduce(const wifi_ftm_report_entry_t *entries, int count, ftm_reduce_result_t *out) {
+    uint32_t rtt[FTM_REDUCER_MAX_SAMPLES];
+    int n = 0;
+
+    if (count > FTM_REDUCER_MAX_SAMPLES) {
+        ESP_LOGW(TAG, "FTM 엔트리 %d개 중 앞 %d개만 사용", count, FTM_REDUCER_MAX_SAMPLES);
+        count = FTM_REDUCER_MAX_SAMPLES;
+    }
+
+    // 유효 범위 RTT 수집 (RTT 범위와 보정 후 거리 범위를 모두 만족)
+    for (int i = 0; i < count; i++) {
+        uint32_t value = entries[i].rtt;
+        if (value < FTM_RTT_MIN_PS || value > FTM_RTT_MAX_PS || value < rtt_min_ps || value > rtt_max_ps) {
+            continue;
+        }
+        rtt[n++] = value;
+    }
+
+    // 한 번만 정렬 (IQR, 중앙값, 분산이 공유)
+    sort_u32(rtt, n);
+
+    // IQR 이상치 제거: 정렬된 배열에서 범위 안의 샘플은 연속 구간 [lo, hi)
+    int lo = 0;
+    int hi = n;
+    if (n >= FTM_MIN_VALID_SAMPLES) {
+        int64_t q1 = rtt[n / 4];
+        int64_t q3 = rtt[(3 * n) / 4];
+        int64_t iqr = q3 - q1;
+        // 2배 스케일로 비교해 1.5 * IQR 을 정확히 계산
+        int64_t lower2 = 2 * q1 - 3 * iqr;
+        int64_t upper2 = 2 * q3 + 3 * iqr;
+        while (lo < hi && 2 * (int64_t)rtt[lo] < lower2) {
+            lo++;
+        }
+        while (hi > lo && 2 * (int64_t)rtt[hi - 1] > upper2) {
+            hi--;
+        }
+    }
+
+    int valid = hi - lo;
+    if (valid == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // 중앙값 (2배 스케일, 짝수 개면 가운데 두 값의 합)
+    const uint32_t *s = &rtt[lo];
+    uint64_t median2 = (valid % 2 == 0) ? (uint64_t)s[valid / 2 - 1] + s[valid / 2] : 2 * (uint64_t)s[valid / 2];
+
+    // 중앙값 기준 제곱합 (2배 스케일이므로 4로 나눔)
+    uint64_t sum_sq4 = 0;
+    for (int i = 0; i < valid; i++) {
+        int64_t diff2 = 2 * (int64_t)s[i] - (int64_t)median2;
+        sum_sq4 += (uint64_t)(diff2 * diff2);
+    }
+
+    // 보정 계수는 마지막에 한 번만 적용
+    out->distance = (float)(median2 * (PS_TO_CALIBRATED_METERS / 2.0));
+    out->variance = (float)((double)sum_sq4 / (4.0 * valid) * (PS_TO_CALIBRATED_METERS * PS_TO_CALIBRATED_METERS));
+    out->valid_count = valid;
+    out->rtt_ns = (uint32_t)(median2 / 2000);
+
+    ESP_LOGD(TAG, "FTM 축약: 유효 %d/%d개 (IQR 제거 %d개), 중앙값 RTT=%" PRIu32 "ps",
+            valid, count, n - valid, (uint32_t)(median2 / 2));
+    return ESP_OK;
+}
+
+
+// ===== 기준 구현 (이전 부동소수점 경로) =====
+
+static int compare_floats(const void *a, const void *b) {
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// 중앙값 계산
+static float calculate_median(float *data, int count) {
+    if (count == 0) return 0.0f;
+
+    // 복사 후 정렬
+    float *sorted = malloc(count * sizeof(float));
+    memcpy(sorted, data, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), compare_floats);
+
+    float median;
+    if (count % 2 == 0) {
+        median = (sorted[count/2 - 1] + sorted[count/2]) / 2.0f;
+    } else {
+        median = sorted[count/2];
+    }
+
+    free(sorted);
+    return median;
+}
+
+// IQR 방법으로 이상치 제거
+static void remove_outliers_iqr(float *data, int *count) {
+    if (*count < 4) return;  // IQR 계산에는 최소 4개 샘플 필요
+
+    // 정렬된 복사본 생성
+    float *sorted = malloc(*count * sizeof(float));
+    memcpy(sorted, data, *count * sizeof(float));
+    qsort(sorted, *count, sizeof(float), compare_floats);
+
+    // Q1, Q3 계산
+    int q1_idx = (*count) / 4;
+    int q3_idx = (3 * (*count)) / 4;
+    float q1 = sorted[q1_idx];
+    float q3 = sorted[q3_idx];
+    float iqr = q3 - q1;
+
+    // 범위 계산
+    float lower_bound = q1 - 1.5f * iqr;
+    float upper_bound = q3 + 1.5f * iqr;
+
+    free(sorted);
+
+    // 원본 배열에서 이상치 제거
+    int new_count = 0;
+    for (int i = 0; i < *count; i++) {
+        if (data[i] >= lower_bound && data[i] <= upper_bound) {
+            data[new_count++] = data[i];
+        }
+    }
+
+    *count = new_count;
+}
+
+// 이전 부동소수점 구현 (검증 기준)
+esp_err_t ftm_reduce_reference(const wifi_ftm_report_entry_t *entries, int count, ftm_reduce_result_t *out) {
+    float *distances = malloc(count * sizeof(float));
+    int valid_count = 0;
+    if (distances == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < count; i++) {
+        // RTT 유효성 확인 (피코초 단위: 1000-333000ps = 0.15-50m)
+        if (entries[i].rtt == 0 || entries[i].rtt == UINT32_MAX ||
+            entries[i].rtt < FTM_RTT_MIN_PS || entries[i].rtt > FTM_RTT_MAX_PS) {
+            continue;
+        }
+
+        // 거리 계산 (RTT * 광속 / 2) 후 시스템 오차 보정 계수 적용
+        float dist_raw = (entries[i].rtt * 1e-12 * 299792458.0) / 2.0;
+        float dist_calibrated = dist_raw * FTM_CALIBRATION_FACTOR;
+
+        // 보정 후 거리 범위 확인 (실내: 0.15m ~ 50m)
+        if (dist_calibrated >= 0.15 && dist_calibrated <= 50.0) {
+            distances[valid_count++] = dist_calibrated;
+        }
+    }
+
+    // IQR 이상치 제거 적용
+    if (valid_count >= FTM_MIN_VALID_SAMPLES) {
+        remove_outliers_iqr(distances, &valid_count);
+    }
+
+    esp_err_t result = ESP_ERR_NOT_FOUND;
+    if (valid_count > 0) {
+        // 중앙값 사용
+        float median = calculate_median(distances, valid_count);
+
+        // 분산 계산
+        float sum_sq = 0;
+        for (int i = 0; i < valid_count; i++) {
+            float diff = distances[i] - median;
+            sum_sq += diff * diff;
+        }
+
+        out->distance = median;
+        out->variance = sum_sq / valid_count;
+        out->valid_count = valid_count;
+        // RTT 계산 (거리에서 역산): distance = (RTT_ns * 0.299792458) / 2
+        out->rtt_ns = (uint32_t)((median / FTM_CALIBRATION_FACTOR) * 2.0 / 0.299792458);
+        result = ESP_OK;
+    }
+
+    free(distances);
+    return result;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_wifi.h"
+
+// ===== FTM 샘플 축약 설정 =====
+#define FTM_REDUCER_MAX_SAMPLES 64          // 한 세션에서 처리하는 최대 FTM 엔트리 수
+#define FTM_MIN_VALID_SAMPLES 6             // IQR 이상치 제거를 적용할 최소 유효 샘플 수
+
+// ===== FTM 보정 파라미터 =====
+// 실제 측정 결과 기반:
+// - 실제 0.5m → 측정값 ~3m (비율: 6배)
+// - 실제 1.5m → 측정값 ~6m (비율: 4배)
+// 평균 보정 계수: 0.2 (1/5)
+// 하드웨어 및 환경에 따라 조정 필요
+#define FTM_CALIBRATION_FACTOR 0.20f        // 시스템 오차 보정 스케일 계수
+
+// 유효 RTT 범위 (피코초, 1000-333000ps = 원본 0.15-50m)
+#define FTM_RTT_MIN_PS 1000
+#define FTM_RTT_MAX_PS 333000
+
+// 보정 후 유효 거리 범위 (실내: 0.15m ~ 50m)
+#define FTM_DISTANCE_MIN_M 0.15f
+#define FTM_DISTANCE_MAX_M 50.0f
+
+// 세션 결과 (보정 후 거리 단위)
+typedef struct {
+    float distance;                         // 중앙값 거리 (m)
+    float variance;                         // 중앙값 기준 분산 (m²)
+    int valid_count;                        // 이상치 제거 후 샘플 수
+    uint32_t rtt_ns;                        // 중앙값 RTT (보정 전, 나노초)
+} ftm_reduce_result_t;
+
+// FTM 리포트 엔트리를 거리 하나로 축약 (범위 검사 → IQR 이상치 제거 → 중앙값/분산)
+// 피코초 정수로 한 번만 정렬해 IQR, 중앙값, 분산이 공유하고 보정 계수는 마지막에 한 번 적용
+// 힙 할당 없음 (스택 버퍼), 유효 샘플이 없으면 ESP_ERR_NOT_FOUND
+esp_err_t ftm_reduce(const wifi_ftm_report_entry_t *entries, int count, ftm_reduce_result_t *out);
+
+// 이전 부동소수점 구현 (검증 기준, FTM_REDUCER_VERIFY 빌드와 host_test/test_ftm_reducer 에서 결과 비교용)
+esp_err_t ftm_reduce_reference(const wifi_ftm_report_entry_t *entries, int count, ftm_reduce_result_t *out);
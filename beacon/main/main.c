@@ -14,9 +14,15 @@
 #include "esp_now.h"
 #include "esp_sleep.h"
 #include "nvs_flash.h"
-#include "nvs.h"
 #include "esp_netif.h"
 #include "esp_mac.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "swift_frame.h"
+#include "ftm_reducer.h"
+#include "duty_cycle.h"
+#include "phase_profiler.h"
+#include "swift_trace.h"
 #include <inttypes.h>
 #include <math.h>
 
@@ -26,56 +32,43 @@
 #define FTM_RSSI_THRESHOLD -85              // FTM 측정을 위한 최소 신호 강도
 #define MAX_FTM_CANDIDATES 6                // FTM 측정 최대 후보 AP 개수
 #define MAX_RETRY_ATTEMPTS 3                // 데이터 전송 최대 재시도 횟수
-#define FLOOR_DISCOVERY_DURATION_MS 1000    // 층 정보 수집 시간 (ms)
-#define SLEEP_DURATION_SEC 5                // Deep Sleep 지속 시간 (초)
-
-// ===== 가상 배터리 설정 =====
-#define BATTERY_DECAY_INTERVAL_SEC 600      // 배터리 감소 간격 (10분 = 600초)
-#define BATTERY_DECAY_PERCENT 5             // 10분당 감소량 (5%)
-#define BATTERY_TOTAL_LIFETIME_SEC 12000    // 총 배터리 수명 (200분 = 12000초)
-#define NVS_NAMESPACE "battery"
-#define NVS_KEY_START_TIME "start_time"
+#define SEND_ACK_TIMEOUT_MS 50              // 전송 완료 콜백 최대 대기 (MAC 재전송 포함 보통 수 ms)
+#define SEND_BACKOFF_MIN_MS 2               // 재시도 전 최소 대기
+#define SEND_BACKOFF_JITTER_MS 8            // 재시도 대기 지터 (0 ~ 이 값 추가, 다른 비콘과 충돌 분산)
+#define SLOT_REPLY_TIMEOUT_MS 30            // 전송 성공 후 게이트웨이 슬롯 배정 대기
+#define FLOOR_DISCOVERY_DURATION_MS 1000    // 채널당 최대 층 정보 수집 시간 (ms, 채널 진입부터, FTM 과 겹침)
+#define MAX_FLOOR_REPORTS 20                // 층 정보를 보관할 최대 게이트웨이 수
+#define MAX_GATEWAYS 16                     // 한 번에 다루는 최대 게이트웨이 AP 수
+#define LEARNED_GATEWAY_QUEUE_LENGTH 32     // 이웃 리포트로 알게 된 게이트웨이 대기열 깊이
+
+// ===== 게이트웨이 토폴로지 캐시 (RTC 메모리) =====
+#define TOPOLOGY_CACHE_MAGIC 0x54504731     // "TPG1", 전원 인가 직후 RTC 메모리 쓰레기 값 구분
+#define TOPOLOGY_CACHE_MAX_AGE_SEC 300      // 이보다 오래된 캐시는 전체 스캔으로 갱신 (5분)
 
 // ===== FTM 최적화 파라미터 =====
-#define FTM_FRAME_COUNT 24                  // FTM 프레임 개수 (24프레임 = 6버스트 x 4)
+// 짧은 세션으로 시작해 신뢰구간이 목표보다 넓을 때만 세션을 추가 (샘플은 누적해서 다시 축약)
+#define FTM_SESSION_FRAMES 16               // 세션 하나의 요청 프레임 수 (ESP-IDF 허용값 16/24/32/64)
+#define FTM_MAX_FRAMES_PER_ANCHOR 64        // 앵커당 최대 요청 프레임 수 (FTM_REDUCER_MAX_SAMPLES 이하)
 #define FTM_BURST_PERIOD 2                  // 버스트 간격 (200ms)
-#define MAX_FTM_RETRY 2                     // 분산이 높을 경우 재시도 횟수
-#define MIN_VALID_SAMPLES 6                 // 필요한 최소 유효 샘플 개수
-
-// ===== FTM 보정 파라미터 =====
-// 실제 측정 결과 기반:
-// - 실제 0.5m → 측정값 ~3m (비율: 6배)
-// - 실제 1.5m → 측정값 ~6m (비율: 4배)
-// 평균 보정 계수: 0.2 (1/5)
-// 하드웨어 및 환경에 따라 조정 필요
-#define FTM_CALIBRATION_FACTOR 0.20f        // 시스템 오차 보정 스케일 계수
-
-// 보정 후 분산 임계값 조정
-// 원래 임계값: 2.0 (보정 전)
-// 보정 후 (0.2배): 분산은 계수^2 = 0.04배로 스케일링
-// 새 임계값: 2.0 * 0.04 = 0.08, 여유를 위해 0.10 사용
-#define MAX_VARIANCE_THRESHOLD 0.10f        // 보정 후 최대 허용 분산 (m²)
+#define FTM_SESSION_TIMEOUT_MS 4000         // 세션 하나의 리포트 대기 시간
+#define FTM_MAX_FAILED_SESSIONS 2           // 앵커당 이만큼 세션이 실패하면 추가 세션 중단
+
+// 샘플 축약 검증 빌드 (1 이면 이전 부동소수점 구현과 결과를 비교해 로그)
+#ifndef FTM_REDUCER_VERIFY
+#define FTM_REDUCER_VERIFY 0
+#endif
+
+// 중앙값 거리의 95% 신뢰구간 반폭 ≈ 1.96 * 1.2533 * sqrt(분산 / 샘플 수)
+// 예전 분산 임계값 0.10 m² 기준으로 16샘플은 0.19 m, 32샘플은 0.14 m
+#define FTM_TARGET_CI_M 0.15f               // 목표 신뢰구간 반폭 (m, 보정 후)
+#define FTM_MEDIAN_CI_FACTOR 2.456f         // 1.96 * 1.2533 (정규분포 중앙값의 표준오차 배수)
+
+_Static_assert(FTM_MAX_FRAMES_PER_ANCHOR <= FTM_REDUCER_MAX_SAMPLES, "누적 샘플이 축약 버퍼를 넘음");
 
 static const char *TAG = "BEACON";
 static const char* serial_number = "S-03";
 
 // ===== 데이터 구조 =====
-// 비콘 데이터 패킷 구조체 (게이트웨이와 동일해야 함)
-typedef struct {
-    char serial_number[10];                 // 비콘 시리얼 번호
-    uint8_t battery_level;                  // 배터리 잔량 (%)
-    int8_t floor;                           // 층 번호 (-99~99)
-    char timestamp[128];                    // ISO 8601 형식: "2025-10-22T21:15:30.123Z"
-    struct {
-        uint8_t anchor_mac[6];              // 앵커(게이트웨이) MAC 주소
-        float distance_meters;              // 거리 (미터)
-        float variance;                     // 측정 분산 (칼만 필터용)
-        int8_t rssi;                        // 신호 강도
-        uint8_t sample_count;               // 사용된 유효 샘플 개수
-        uint32_t rtt_nanoseconds;           // RTT (왕복 시간, 나노초)
-    } measurements[3];                      // 앵커 측정값 (1~3개, 빈 슬롯은 MAC=0)
-} beacon_data_packet_t;
-
 // AP 레코드 구조체
 typedef struct {
     uint8_t mac[6];                         // AP MAC 주소
@@ -90,138 +83,173 @@ typedef struct {
     int8_t rssi;                            // 신호 강도
 } gateway_info_t;
 
+// 게이트웨이 토폴로지 캐시 (Deep Sleep 동안 RTC 슬로우 메모리에 유지)
+typedef struct {
+    uint32_t magic;                         // TOPOLOGY_CACHE_MAGIC 이면 유효
+    int64_t updated_sec;                    // 마지막 전체 스캔 시각 (RTC 시계, 초)
+    uint8_t gateway_count;                  // 캐시된 게이트웨이 수
+    gateway_info_t gateways[MAX_GATEWAYS];  // 게이트웨이 BSSID, 채널, 마지막 RSSI
+    int8_t floor;                           // 마지막으로 계산한 층 (층 정보를 못 들었을 때 사용)
+    bool floor_valid;                       // floor 값 유효 여부
+    uint32_t wake_to_send_ms[2];            // 최근 깨어남→전송 시간 (0: 전체 스캔, 1: 캐시 사용)
+} topology_cache_t;
+
+// ESP-NOW 전송 지연 통계 (Deep Sleep 동안 유지, 전원 인가 시 0)
+typedef struct {
+    uint32_t attempts;                      // esp_now_send 호출 수
+    uint32_t acked;                         // 성공 콜백 수
+    uint32_t nacked;                        // 실패 콜백 수
+    uint32_t timeouts;                      // SEND_ACK_TIMEOUT_MS 안에 콜백이 없던 수
+    uint64_t total_latency_us;              // 콜백까지 걸린 시간 합 (성공/실패 콜백)
+    uint32_t max_latency_us;                // 최대 지연
+} send_stats_t;
+
 // 층 정보 구조체
 typedef struct {
     uint8_t gateway_mac[6];                 // 게이트웨이 MAC 주소
     int8_t floor;                           // 층 번호 (-99~99)
     int8_t rssi;                            // 신호 강도
     uint8_t channel;                        // 채널 번호 (ESP-NOW 전송용)
+    bool neighbors_learned;                 // 이웃 리포트로 게이트웨이/이웃을 학습했는지
 } floor_info_t;
 
 // ===== 전역 변수 =====
-static bool upload_successful = false;
-static floor_info_t floor_list[20];         // 발견된 게이트웨이 목록
+static EventGroupHandle_t send_event_group;
+static const int SEND_SUCCESS_BIT = BIT0;
+static const int SEND_FAILURE_BIT = BIT1;
+static const int SLOT_RECV_BIT = BIT2;
+static swift_slot_assignment_t slot_assignment;  // 게이트웨이가 보낸 이 비콘의 슬롯 배정
+static int64_t slot_received_us = 0;            // 슬롯 배정 수신 시각 (esp_timer)
+RTC_DATA_ATTR static send_stats_t send_stats;
+RTC_DATA_ATTR static uint32_t report_sequence;          // 리포트 사이클 번호 (재전송은 같은 번호)
+RTC_DATA_ATTR static bool report_sequence_valid;        // 전원 인가 후 임의 값으로 시작했는지
+static floor_info_t floor_list[MAX_FLOOR_REPORTS];   // 발견된 게이트웨이 목록
 static int floor_count = 0;
+static volatile int channel_floor_heard = 0;    // 현재 채널에서 새로 들은 게이트웨이 수
 static EventGroupHandle_t ftm_event_group;
+static EventGroupHandle_t floor_event_group;
+static const int FLOOR_RECV_BIT = BIT0;
+static QueueHandle_t learned_gateway_queue;     // 이웃 리포트로 알게 된 게이트웨이 (수신 콜백 → 채널 순회)
+RTC_DATA_ATTR static topology_cache_t topology_cache;
 static const int FTM_REPORT_BIT = BIT0;
 static const int FTM_FAILURE_BIT = BIT1;
-static uint8_t ftm_report_num_entries = 0;
-static wifi_ftm_report_entry_t *ftm_report_data = NULL;
+static uint8_t ftm_report_num_entries = 0;     // 현재 앵커에서 누적한 엔트리 수
+static wifi_ftm_report_entry_t ftm_report_data[FTM_REDUCER_MAX_SAMPLES];   // 현재 앵커의 FTM 리포트 누적본
+static uint32_t ftm_frames_requested = 0;       // 이번 깨어남에서 요청한 FTM 프레임 합계
+static uint32_t ftm_sessions = 0;               // 이번 깨어남의 FTM 세션 수
+static uint32_t ftm_anchors_measured = 0;       // 이번 깨어남에서 측정을 시도한 앵커 수
 
 // ===== 함수 선언 =====
 static void floor_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len);
 static void data_send_cb(const uint8_t *mac_addr, esp_now_send_status_t status);
+static void slot_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len);
 static int8_t calculate_floor_mode(void);
-static esp_err_t send_data_with_retry(beacon_data_packet_t *packet);
+static esp_err_t send_data_with_retry(const uint8_t *frame, size_t frame_len);
 static esp_err_t perform_ftm_measurement(uint8_t *bssid, uint8_t channel, float *distance, float *variance, int *valid_count, uint32_t *rtt_ns);
-static int compare_floats(const void *a, const void *b);
-static float calculate_median(float *data, int count);
-static void remove_outliers_iqr(float *data, int *count);
-static esp_err_t init_battery_nvs(void);
-static int64_t get_start_time_from_nvs(void);
-static uint8_t getBatteryLevel(void);
-
-
-// ===== 통계 유틸리티 함수 =====
-
-static int compare_floats(const void *a, const void *b) {
-    float fa = *(const float*)a;
-    float fb = *(const float*)b;
-    return (fa > fb) - (fa < fb);
-}
+static void wait_for_floor_reports(int expected, int64_t channel_start_us);
+static int64_t rtc_now_sec(void);
+static bool topology_cache_usable(void);
+static void topology_cache_store(const gateway_info_t *list, int count);
+static void topology_cache_invalidate(const char *reason);
+static void topology_cache_merge(const gateway_info_t *list, int count);
+static int merge_learned_gateways(gateway_info_t *list, int count, int *channels, int *channel_count);
+static int scan_gateways(gateway_info_t *list, int max, uint8_t channel);
 
-// 중앙값 계산
-static float calculate_median(float *data, int count) {
-    if (count == 0) return 0.0f;
 
-    // 복사 후 정렬
-    float *sorted = malloc(count * sizeof(float));
-    memcpy(sorted, data, count * sizeof(float));
-    qsort(sorted, count, sizeof(float), compare_floats);
+// ===== ESP-NOW 콜백 함수 =====
 
-    float median;
-    if (count % 2 == 0) {
-        median = (sorted[count/2 - 1] + sorted[count/2]) / 2.0f;
-    } else {
-        median = sorted[count/2];
+// 층/이웃 브로드캐스트 수신 콜백 (채널 순회 내내 등록, FTM 세션과 동시에 수신)
+// 처음 듣는 게이트웨이면 리포트에 담긴 게이트웨이 자신과 이웃 목록을 learned_gateway_queue 로 넘김
+static void floor_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len) {
+    static swift_neighbor_report_t report;
+    if (!swift_frame_is_neighbor_report(data, len) ||
+        swift_frame_decode_neighbor_report(data, len, &report) != ESP_OK) {
+        return;
     }
 
-    free(sorted);
-    return median;
-}
-
-// IQR 방법으로 이상치 제거
-static void remove_outliers_iqr(float *data, int *count) {
-    if (*count < 4) return;  // IQR 계산에는 최소 4개 샘플 필요
+    // 현재 WiFi 채널 가져오기
+    uint8_t primary_channel = 0;
+    wifi_second_chan_t second_channel = WIFI_SECOND_CHAN_NONE;
+    esp_wifi_get_channel(&primary_channel, &second_channel);
 
-    // 정렬된 복사본 생성
-    float *sorted = malloc(*count * sizeof(float));
-    memcpy(sorted, data, *count * sizeof(float));
-    qsort(sorted, *count, sizeof(float), compare_floats);
-
-    // Q1, Q3 계산
-    int q1_idx = (*count) / 4;
-    int q3_idx = (3 * (*count)) / 4;
-    float q1 = sorted[q1_idx];
-    float q3 = sorted[q3_idx];
-    float iqr = q3 - q1;
-
-    // 범위 계산
-    float lower_bound = q1 - 1.5f * iqr;
-    float upper_bound = q3 + 1.5f * iqr;
-
-    ESP_LOGI(TAG, "IQR 필터: Q1=%.2f, Q3=%.2f, IQR=%.2f, 범위=[%.2f, %.2f]",
-            q1, q3, iqr, lower_bound, upper_bound);
-
-    free(sorted);
-
-    // 원본 배열에서 이상치 제거
-    int new_count = 0;
-    for (int i = 0; i < *count; i++) {
-        if (data[i] >= lower_bound && data[i] <= upper_bound) {
-            data[new_count++] = data[i];
-        } else {
-            ESP_LOGW(TAG, "이상치 제거: %.2f m", data[i]);
+    // 같은 게이트웨이의 반복 브로드캐스트는 최신 값으로 갱신만 함
+    int index = 0;
+    while (index < floor_count && memcmp(floor_list[index].gateway_mac, recv_info->src_addr, 6) != 0) {
+        index++;
+    }
+    if (index == floor_count) {
+        if (floor_count >= MAX_FLOOR_REPORTS) {
+            return;
         }
+        floor_count++;
+        channel_floor_heard++;
+        floor_list[index].neighbors_learned = false;
     }
 
-    *count = new_count;
-    ESP_LOGI(TAG, "이상치 제거 후 샘플 개수: %d", new_count);
-}
-
-
-// ===== ESP-NOW 콜백 함수 =====
+    // 레거시 1바이트 층 브로드캐스트는 BSSID 가 없어 FTM 대상으로 쓸 수 없음
+    // 게이트웨이가 레거시 프레임도 함께 보내므로 레거시를 먼저 들었어도 이웃 리포트에서 한 번 학습
+    if (report.channel != 0 && !floor_list[index].neighbors_learned) {
+        floor_list[index].neighbors_learned = true;
+        gateway_info_t learned;
+        memcpy(learned.mac, report.bssid, 6);
+        learned.channel = report.channel;
+        learned.rssi = recv_info->rx_ctrl->rssi;
+        xQueueSend(learned_gateway_queue, &learned, 0);
+        for (int i = 0; i < report.neighbor_count; i++) {
+            memcpy(learned.mac, report.neighbors[i].bssid, 6);
+            learned.channel = report.neighbors[i].channel;
+            learned.rssi = report.neighbors[i].rssi;      // 송신 게이트웨이 기준 세기 (정렬용 추정치)
+            xQueueSend(learned_gateway_queue, &learned, 0);
+        }
+    }
 
-// 층 브로드캐스트 수신 콜백
-static void floor_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len) {
-    if (len == 1 && floor_count < 20) {
-        // 현재 WiFi 채널 가져오기
-        uint8_t primary_channel = 0;
-        wifi_second_chan_t second_channel = WIFI_SECOND_CHAN_NONE;
-        esp_wifi_get_channel(&primary_channel, &second_channel);
+    // 게이트웨이 MAC, 층, RSSI, 채널 저장
+    memcpy(floor_list[index].gateway_mac, recv_info->src_addr, 6);
+    floor_list[index].floor = report.floor;
+    floor_list[index].rssi = recv_info->rx_ctrl->rssi;
+    floor_list[index].channel = primary_channel;
+    xEventGroupSetBits(floor_event_group, FLOOR_RECV_BIT);
 
-        // 게이트웨이 MAC, 층, RSSI, 채널 저장
-        memcpy(floor_list[floor_count].gateway_mac, recv_info->src_addr, 6);
-        floor_list[floor_count].floor = data[0];
-        floor_list[floor_count].rssi = recv_info->rx_ctrl->rssi;
-        floor_list[floor_count].channel = primary_channel;
-        floor_count++;
+    ESP_LOGI(TAG, "층 정보 수신: %d층 from "MACSTR" (채널 %d, RSSI: %d, 이웃 %d개)",
+            report.floor, MAC2STR(recv_info->src_addr), primary_channel, recv_info->rx_ctrl->rssi,
+            report.neighbor_count);
+}
 
-        ESP_LOGI(TAG, "층 정보 수신: %d층 from "MACSTR" (채널 %d, RSSI: %d)",
-                data[0], MAC2STR(recv_info->src_addr), primary_channel, recv_info->rx_ctrl->rssi);
+// 슬롯 배정 수신 콜백 (전송 단계에서만 등록, 다른 비콘의 배정은 무시)
+static void slot_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len) {
+    swift_slot_assignment_t assignment;
+    if (!swift_frame_is_slot_assignment(data, len) ||
+        swift_frame_decode_slot_assignment(data, len, &assignment) != ESP_OK ||
+        strcmp(assignment.serial_number, serial_number) != 0) {
+        return;
     }
+    slot_assignment = assignment;
+    slot_received_us = esp_timer_get_time();
+    xEventGroupSetBits(send_event_group, SLOT_RECV_BIT);
 }
 
-// 데이터 전송 콜백
+// 데이터 전송 콜백 (Wi-Fi 태스크에서 호출, 결과만 알리고 로그는 전송 함수에서)
 static void data_send_cb(const uint8_t *mac_addr, esp_now_send_status_t status) {
-    upload_successful = (status == ESP_NOW_SEND_SUCCESS);
-    ESP_LOGI(TAG, "전송 상태 to "MACSTR": %s",
-            MAC2STR(mac_addr), upload_successful ? "성공" : "실패");
+    xEventGroupSetBits(send_event_group,
+                       (status == ESP_NOW_SEND_SUCCESS) ? SEND_SUCCESS_BIT : SEND_FAILURE_BIT);
 }
 
 
 // ===== 층 계산 함수 =====
 
+// 현재 채널 게이트웨이들의 층 브로드캐스트를 모두 듣거나 채널 진입 후 FLOOR_DISCOVERY_DURATION_MS 가 지날 때까지 대기
+static void wait_for_floor_reports(int expected, int64_t channel_start_us) {
+    while (channel_floor_heard < expected) {
+        int64_t elapsed_ms = (esp_timer_get_time() - channel_start_us) / 1000;
+        if (elapsed_ms >= FLOOR_DISCOVERY_DURATION_MS) {
+            ESP_LOGW(TAG, "층 수신 대기 시간 초과 (%d/%d개 게이트웨이)", channel_floor_heard, expected);
+            return;
+        }
+        xEventGroupWaitBits(floor_event_group, FLOOR_RECV_BIT, pdTRUE, pdFALSE,
+                            pdMS_TO_TICKS(FLOOR_DISCOVERY_DURATION_MS - elapsed_ms) + 1);
+    }
+}
+
 // 층 최빈값 계산
 static int8_t calculate_floor_mode(void) {
     if (floor_count == 0) return 0;
@@ -251,131 +279,149 @@ static int8_t calculate_floor_mode(void) {
 }
 
 
-// ===== 가상 배터리 함수 =====
+// ===== 게이트웨이 토폴로지 캐시 =====
 
-/**
- * @brief NVS 초기화 (배터리 네임스페이스)
- *
- * @return esp_err_t ESP_OK on success
- */
-static esp_err_t init_battery_nvs(void) {
-    nvs_handle_t nvs_handle;
-    esp_err_t err;
+// RTC 시계 기준 현재 시각 (초, Deep Sleep 중에도 계속 흐름)
+static int64_t rtc_now_sec(void) {
+    struct timeval tv_now;
+    gettimeofday(&tv_now, NULL);
+    return (int64_t)tv_now.tv_sec;
+}
 
-    // NVS 오픈
-    err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "NVS 오픈 실패: %s", esp_err_to_name(err));
-        return err;
+// 캐시로 스캔을 생략할 수 있는지 (유효, 비어 있지 않음, 오래되지 않음)
+static bool topology_cache_usable(void) {
+    if (topology_cache.magic != TOPOLOGY_CACHE_MAGIC || topology_cache.gateway_count == 0 ||
+        topology_cache.gateway_count > MAX_GATEWAYS) {
+        ESP_LOGI(TAG, "토폴로지 캐시 없음, 전체 스캔");
+        return false;
     }
+    int64_t age_sec = rtc_now_sec() - topology_cache.updated_sec;
+    if (age_sec < 0 || age_sec > TOPOLOGY_CACHE_MAX_AGE_SEC) {
+        ESP_LOGI(TAG, "토폴로지 캐시 만료 (%" PRId64 "초 경과), 전체 스캔", age_sec);
+        return false;
+    }
+    return true;
+}
 
-    // 시작 시간이 존재하는지 확인
-    int64_t start_time = 0;
-    err = nvs_get_i64(nvs_handle, NVS_KEY_START_TIME, &start_time);
+// 전체 스캔 결과를 캐시에 저장
+static void topology_cache_store(const gateway_info_t *list, int count) {
+    if (topology_cache.magic != TOPOLOGY_CACHE_MAGIC) {
+        memset(&topology_cache, 0, sizeof(topology_cache));
+    }
+    topology_cache.gateway_count = (uint8_t)count;
+    memcpy(topology_cache.gateways, list, count * sizeof(gateway_info_t));
+    topology_cache.updated_sec = rtc_now_sec();
+    topology_cache.magic = TOPOLOGY_CACHE_MAGIC;
+}
 
-    if (err == ESP_ERR_NVS_NOT_FOUND) {
-        // 시작 시간이 없으면 현재 시간을 시작 시간으로 저장
-        struct timeval tv_now;
-        gettimeofday(&tv_now, NULL);
-        int64_t now_us = (int64_t)tv_now.tv_sec * 1000000L + (int64_t)tv_now.tv_usec;
+// 측정/전송 실패 시 다음 깨어남에서 전체 스캔하도록 게이트웨이 목록 무효화
+static void topology_cache_invalidate(const char *reason) {
+    if (topology_cache.magic == TOPOLOGY_CACHE_MAGIC && topology_cache.gateway_count > 0) {
+        ESP_LOGW(TAG, "토폴로지 캐시 무효화: %s", reason);
+        topology_cache.gateway_count = 0;
+    }
+}
 
-        err = nvs_set_i64(nvs_handle, NVS_KEY_START_TIME, now_us);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "시작 시간 저장 실패: %s", esp_err_to_name(err));
-            nvs_close(nvs_handle);
-            return err;
-        }
+// 이웃 리포트로 알게 된 게이트웨이를 캐시에 반영 (전체 스캔 시각은 유지해 주기적 재스캔은 그대로)
+static void topology_cache_merge(const gateway_info_t *list, int count) {
+    if (topology_cache.magic != TOPOLOGY_CACHE_MAGIC) {
+        topology_cache_store(list, count);
+        return;
+    }
+    topology_cache.gateway_count = (uint8_t)count;
+    memcpy(topology_cache.gateways, list, count * sizeof(gateway_info_t));
+}
 
-        err = nvs_commit(nvs_handle);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "NVS 커밋 실패: %s", esp_err_to_name(err));
-            nvs_close(nvs_handle);
-            return err;
+// 수신 콜백이 넘긴 게이트웨이 중 목록에 없는 것을 추가하고 새 채널을 방문 목록에 붙임, 새 게이트웨이 수 반환
+static int merge_learned_gateways(gateway_info_t *list, int count, int *channels, int *channel_count) {
+    gateway_info_t learned;
+    int added = 0;
+
+    while (xQueueReceive(learned_gateway_queue, &learned, 0) == pdTRUE) {
+        if (count + added >= MAX_GATEWAYS || learned.channel == 0) {
+            continue;
+        }
+        bool known = false;
+        for (int i = 0; i < count + added; i++) {
+            if (memcmp(list[i].mac, learned.mac, 6) == 0) {
+                known = true;
+                break;
+            }
+        }
+        if (known) {
+            continue;
         }
 
-        ESP_LOGI(TAG, "새 시작 시간 저장: %lld us", now_us);
-    } else if (err == ESP_OK) {
-        ESP_LOGI(TAG, "기존 시작 시간 로드: %lld us", start_time);
-    } else {
-        ESP_LOGE(TAG, "시작 시간 읽기 실패: %s", esp_err_to_name(err));
-        nvs_close(nvs_handle);
-        return err;
-    }
+        list[count + added] = learned;
+        added++;
 
-    nvs_close(nvs_handle);
-    return ESP_OK;
+        bool channel_exists = false;
+        for (int j = 0; j < *channel_count; j++) {
+            if (channels[j] == learned.channel) {
+                channel_exists = true;
+                break;
+            }
+        }
+        if (!channel_exists) {
+            channels[(*channel_count)++] = learned.channel;
+        }
+        ESP_LOGI(TAG, "이웃 리포트로 게이트웨이 추가: "MACSTR" (채널 %d%s)",
+                MAC2STR(learned.mac), learned.channel, channel_exists ? "" : ", 새 채널");
+    }
+    return added;
 }
 
-/**
- * @brief NVS에서 시작 시간 가져오기
- *
- * @return int64_t 시작 시간 (마이크로초), 실패 시 0
- */
-static int64_t get_start_time_from_nvs(void) {
-    nvs_handle_t nvs_handle;
-    esp_err_t err;
-    int64_t start_time = 0;
-
-    err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "NVS 오픈 실패: %s", esp_err_to_name(err));
+// 액티브 스캔으로 게이트웨이 AP 수집, 찾은 수 반환 (RSSI 내림차순으로 최대 max 개)
+// channel 이 0 이면 전체 채널, 아니면 해당 채널만 짧게 (RSSI 확인용)
+static int scan_gateways(gateway_info_t *list, int max, uint8_t channel) {
+    wifi_scan_config_t scan_config = {
+        .ssid = NULL,  // 모든 SSID 스캔하여 게이트웨이 찾기
+        .bssid = NULL,
+        .channel = channel,
+        .show_hidden = false,
+        .scan_type = WIFI_SCAN_TYPE_ACTIVE,
+        .scan_time = {
+            .active = {
+                .min = (channel == 0) ? 100 : 30,
+                .max = (channel == 0) ? 300 : 60,
+            },
+        },
+    };
+
+    ESP_ERROR_CHECK(esp_wifi_scan_start(&scan_config, true));
+
+    uint16_t ap_count = 0;
+    ESP_ERROR_CHECK(esp_wifi_scan_get_ap_num(&ap_count));
+    if (ap_count == 0) {
         return 0;
     }
 
-    err = nvs_get_i64(nvs_handle, NVS_KEY_START_TIME, &start_time);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "시작 시간 읽기 실패: %s", esp_err_to_name(err));
-        nvs_close(nvs_handle);
+    wifi_ap_record_t *ap_records = malloc(ap_count * sizeof(wifi_ap_record_t));
+    if (ap_records == NULL) {
+        ESP_LOGE(TAG, "메모리 할당 실패");
+        esp_wifi_clear_ap_list();
         return 0;
     }
+    ESP_ERROR_CHECK(esp_wifi_scan_get_ap_records(&ap_count, ap_records));
 
-    nvs_close(nvs_handle);
-    return start_time;
-}
-
-/**
- * @brief 가상 배터리 레벨 계산
- *
- * 10분(600초)마다 5%씩 감소
- * 총 배터리 수명: 200분 (12000초)
- * Deep Sleep에서 깨어나도 NVS에 저장된 시작 시간을 기준으로 계산
- *
- * @return uint8_t 배터리 레벨 (0-100%)
- */
-static uint8_t getBatteryLevel(void) {
-    // 시작 시간 가져오기
-    int64_t start_time_us = get_start_time_from_nvs();
-    if (start_time_us == 0) {
-        ESP_LOGW(TAG, "시작 시간을 가져올 수 없음, 100%% 반환");
-        return 100;
-    }
-
-    // 현재 시간 가져오기
-    struct timeval tv_now;
-    gettimeofday(&tv_now, NULL);
-    int64_t now_us = (int64_t)tv_now.tv_sec * 1000000L + (int64_t)tv_now.tv_usec;
-
-    // 누적 작동 시간 계산 (초 단위)
-    int64_t elapsed_us = now_us - start_time_us;
-    int64_t elapsed_sec = elapsed_us / 1000000L;
-
-    // 배터리 감소 계산
-    // 10분(600초)마다 5% 감소
-    int64_t decay_cycles = elapsed_sec / BATTERY_DECAY_INTERVAL_SEC;
-    int battery_decrease = (int)(decay_cycles * BATTERY_DECAY_PERCENT);
+    // 모든 게이트웨이 AP 수집 (스캔 결과는 RSSI 내림차순)
+    int count = 0;
+    for (int i = 0; i < ap_count && count < max; i++) {
+        if (strcmp((char*)ap_records[i].ssid, WIFI_SSID) != 0) {
+            continue;
+        }
 
-    // 배터리 레벨 계산 (100%에서 시작)
-    int battery_level = 100 - battery_decrease;
+        memcpy(list[count].mac, ap_records[i].bssid, 6);
+        list[count].channel = ap_records[i].primary;
+        list[count].rssi = ap_records[i].rssi;
+        count++;
 
-    // 0% 미만으로 떨어지지 않도록 보정
-    if (battery_level < 0) {
-        battery_level = 0;
+        ESP_LOGI(TAG, "게이트웨이 %d: "MACSTR" (채널 %d, RSSI: %d)",
+                count, MAC2STR(ap_records[i].bssid), ap_records[i].primary, ap_records[i].rssi);
     }
 
-    ESP_LOGI(TAG, "배터리 계산: 경과시간=%lld초 (%.1f분), 감소사이클=%lld, 배터리=%d%%",
-             elapsed_sec, elapsed_sec / 60.0, decay_cycles, battery_level);
-
-    return (uint8_t)battery_level;
+    free(ap_records);
+    return count;
 }
 
 
@@ -386,33 +432,28 @@ static void ftm_event_handler(void *arg, esp_event_base_t event_base,
                              int32_t event_id, void *event_data) {
     if (event_id == WIFI_EVENT_FTM_REPORT) {
         wifi_event_ftm_report_t *event = (wifi_event_ftm_report_t *)event_data;
-        ESP_LOGI(TAG, "FTM 리포트 수신");
-
-        // 엔트리 개수 저장
-        ftm_report_num_entries = event->ftm_report_num_entries;
-        ESP_LOGI(TAG, "FTM 상태: %d, 엔트리 개수: %d", event->status, ftm_report_num_entries);
-
-        // 이전 리포트 메모리 해제
-        if (ftm_report_data != NULL) {
-            free(ftm_report_data);
-            ftm_report_data = NULL;
+        SWIFT_TRACE_LOGI(TAG, "FTM 상태: %d, 엔트리 개수: %d", event->status, event->ftm_report_num_entries);
+
+        // 리포트 엔트리를 누적 버퍼 뒤에 즉시 복사 (유효한 동안, 고정 버퍼)
+        int entries = event->ftm_report_num_entries;
+        int space = FTM_REDUCER_MAX_SAMPLES - ftm_report_num_entries;
+        if (entries > space) {
+            ESP_LOGW(TAG, "FTM 엔트리 %d개 중 앞 %d개만 사용", entries, space);
+            entries = space;
         }
-
-        // 리포트 엔트리를 즉시 복사 (유효한 동안)
-        if (ftm_report_num_entries > 0 && event->ftm_report_data != NULL) {
-            ftm_report_data = malloc(sizeof(wifi_ftm_report_entry_t) * ftm_report_num_entries);
-            if (ftm_report_data != NULL) {
-                memcpy(ftm_report_data, event->ftm_report_data,
-                       sizeof(wifi_ftm_report_entry_t) * ftm_report_num_entries);
-                ESP_LOGI(TAG, "%d개 FTM 엔트리 복사 완료", ftm_report_num_entries);
-            } else {
-                ESP_LOGE(TAG, "FTM 리포트 메모리 할당 실패");
-                ftm_report_num_entries = 0;
-            }
+        if (entries > 0 && event->ftm_report_data != NULL) {
+            memcpy(&ftm_report_data[ftm_report_num_entries], event->ftm_report_data,
+                   sizeof(wifi_ftm_report_entry_t) * entries);
+            ftm_report_num_entries += entries;
+        } else {
+            entries = 0;
         }
 
+        swift_trace(SWIFT_TRACE_BC_FTM_REPORT, (uint8_t)event->status, (uint16_t)event->ftm_report_num_entries,
+                    ftm_report_num_entries, 0);
+
         // 이벤트 비트 설정
-        if (event->status == FTM_STATUS_SUCCESS && ftm_report_num_entries > 0) {
+        if (event->status == FTM_STATUS_SUCCESS && entries > 0) {
             xEventGroupSetBits(ftm_event_group, FTM_REPORT_BIT);
         } else {
             ESP_LOGW(TAG, "FTM 실패: 상태=%d 또는 엔트리 없음", event->status);
@@ -425,53 +466,48 @@ static void ftm_event_handler(void *arg, esp_event_base_t event_base,
 // ===== FTM 측정 함수 =====
 
 // 특정 AP와 FTM 거리 측정 수행
+// FTM_SESSION_FRAMES 세션으로 시작해 누적 샘플의 신뢰구간이 FTM_TARGET_CI_M 이하가 되거나
+// 요청 프레임이 FTM_MAX_FRAMES_PER_ANCHOR 에 닿을 때까지 세션을 추가
+// (이벤트 핸들러는 app_main 에서 깨어날 때 한 번 등록)
 static esp_err_t perform_ftm_measurement(uint8_t *bssid, uint8_t channel,
                                         float *distance, float *variance, int *valid_count, uint32_t *rtt_ns) {
-    ESP_LOGI(TAG, "FTM 측정 시작: "MACSTR" (채널 %d)", MAC2STR(bssid), channel);
+    SWIFT_TRACE_LOGI(TAG, "FTM 측정 시작: "MACSTR" (채널 %d)", MAC2STR(bssid), channel);
 
     esp_err_t final_result = ESP_FAIL;
-    float best_distance = 0;
-    float best_variance = 999999.0f;
-    int best_valid_count = 0;
-    uint32_t best_rtt_ns = 0;
+    ftm_reduce_result_t reduced = {0};
+    int frames_requested = 0;
+    int session = 0;
+    int failed_sessions = 0;
 
-    // 좋은 측정값을 얻기 위해 최대 MAX_FTM_RETRY번 시도
-    for (int attempt = 0; attempt < MAX_FTM_RETRY; attempt++) {
-        ESP_LOGI(TAG, "FTM 시도 %d/%d", attempt + 1, MAX_FTM_RETRY);
+    ftm_report_num_entries = 0;
+    ftm_anchors_measured++;
 
-        // FTM 이벤트 핸들러 등록
-        ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT,
-                                                  WIFI_EVENT_FTM_REPORT,
-                                                  &ftm_event_handler,
-                                                  NULL));
+    while (frames_requested < FTM_MAX_FRAMES_PER_ANCHOR) {
+        session++;
 
         // FTM 파라미터 설정 (실내 측위 최적화)
         wifi_ftm_initiator_cfg_t ftm_cfg = {
             .resp_mac = {0},
             .channel = channel,
-            .frm_count = FTM_FRAME_COUNT,
+            .frm_count = FTM_SESSION_FRAMES,
             .burst_period = FTM_BURST_PERIOD,
         };
         memcpy(ftm_cfg.resp_mac, bssid, 6);
 
-        ESP_LOGI(TAG, "FTM 설정: 프레임=%d, 버스트주기=%d, 채널=%d",
-                 ftm_cfg.frm_count, ftm_cfg.burst_period, ftm_cfg.channel);
+        swift_trace(SWIFT_TRACE_BC_FTM_SESSION, (uint8_t)session, ftm_cfg.frm_count, channel, frames_requested);
+        SWIFT_TRACE_LOGI(TAG, "FTM 세션 %d: 프레임=%d (누적 요청 %d), 버스트주기=%d, 채널=%d",
+                 session, ftm_cfg.frm_count, frames_requested, ftm_cfg.burst_period, ftm_cfg.channel);
 
-        // 이벤트 비트 및 리포트 개수 초기화
+        // 이벤트 비트 초기화 (누적 엔트리는 유지)
         xEventGroupClearBits(ftm_event_group, FTM_REPORT_BIT | FTM_FAILURE_BIT);
-        ftm_report_num_entries = 0;
-
-        // 이전 리포트 데이터 해제
-        if (ftm_report_data != NULL) {
-            free(ftm_report_data);
-            ftm_report_data = NULL;
-        }
 
         // FTM 세션 시작
         esp_err_t err = esp_wifi_ftm_initiate_session(&ftm_cfg);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "FTM 세션 시작 실패: %s", esp_err_to_name(err));
-            esp_event_handler_unregister(WIFI_EVENT, WIFI_EVENT_FTM_REPORT, &ftm_event_handler);
+            if (final_result == ESP_OK) {
+                break;
+            }
 
             // RSSI 기반 추정값으로 폴백
             ESP_LOGW(TAG, "FTM 미지원, RSSI 추정값 사용");
@@ -482,6 +518,9 @@ static esp_err_t perform_ftm_measurement(uint8_t *bssid, uint8_t channel,
             *variance = 10.0;  // RSSI 기반 추정은 분산이 높음
             return ESP_OK;
         }
+        frames_requested += FTM_SESSION_FRAMES;
+        ftm_frames_requested += FTM_SESSION_FRAMES;
+        ftm_sessions++;
 
         // FTM 리포트 대기
         EventBits_t bits = xEventGroupWaitBits(
@@ -489,126 +528,64 @@ static esp_err_t perform_ftm_measurement(uint8_t *bssid, uint8_t channel,
             FTM_REPORT_BIT | FTM_FAILURE_BIT,
             pdTRUE,
             pdFALSE,
-            pdMS_TO_TICKS(6000)  // 타임아웃: 6초
+            pdMS_TO_TICKS(FTM_SESSION_TIMEOUT_MS)
         );
 
-        esp_err_t result = ESP_FAIL;
-        float attempt_distance = 0;
-        float attempt_variance = 999999.0f;
-        int attempt_valid_count = 0;
-
-        if (bits & FTM_REPORT_BIT) {
-            // 엔트리 및 데이터 확인
-            if (ftm_report_num_entries == 0 || ftm_report_data == NULL) {
-                ESP_LOGW(TAG, "FTM 리포트 엔트리 또는 데이터 없음");
-                result = ESP_FAIL;
-            } else {
-                // 유효한 거리 측정값 수집
-                float *distances = malloc(ftm_report_num_entries * sizeof(float));
-                int valid_count = 0;
-
-                for (int i = 0; i < ftm_report_num_entries; i++) {
-                    // RTT 유효성 확인 (피코초 단위: 1000-333000ps = 0.15-50m)
-                    if (ftm_report_data[i].rtt == 0 || ftm_report_data[i].rtt == UINT32_MAX ||
-                        ftm_report_data[i].rtt < 1000 || ftm_report_data[i].rtt > 333000) {
-                        ESP_LOGW(TAG, "FTM 엔트리 %d: 유효하지 않은 RTT %" PRIu32 "ps (범위: 1000-333000ps = 0.15-50m)",
-                                i, ftm_report_data[i].rtt);
-                        continue;
-                    }
-
-                    // 거리 계산 (RTT * 광속 / 2)
-                    float dist_raw = (ftm_report_data[i].rtt * 1e-12 * 299792458.0) / 2.0;
-
-                    // 시스템 오차 보정 계수 적용
-                    float dist_calibrated = dist_raw * FTM_CALIBRATION_FACTOR;
-
-                    // 보정 후 거리 범위 확인 (실내: 0.15m ~ 50m)
-                    if (dist_calibrated >= 0.15 && dist_calibrated <= 50.0) {
-                        distances[valid_count++] = dist_calibrated;
-                        ESP_LOGI(TAG, "FTM 샘플 %d: RTT=%" PRIu32 "ps (%.2fns), 원본=%.2f m, 보정=%.2f m - 유효",
-                                i, ftm_report_data[i].rtt, ftm_report_data[i].rtt / 1000.0, dist_raw, dist_calibrated);
-                    } else {
-                        ESP_LOGW(TAG, "FTM 엔트리 %d: 거리 %.2f m (원본: %.2f m) 범위 밖 (0.15-50m)", i, dist_calibrated, dist_raw);
-                    }
-                }
-
-                ESP_LOGI(TAG, "이상치 제거 전 유효 샘플: %d개", valid_count);
-
-                // IQR 이상치 제거 적용
-                if (valid_count >= MIN_VALID_SAMPLES) {
-                    remove_outliers_iqr(distances, &valid_count);
-                }
-
-                attempt_valid_count = valid_count;
-                if (valid_count > 0) {
-                    // 중앙값 사용
-                    attempt_distance = calculate_median(distances, valid_count);
-
-                    // 분산 계산
-                    float sum_sq = 0;
-                    for (int i = 0; i < valid_count; i++) {
-                        float diff = distances[i] - attempt_distance;
-                        sum_sq += diff * diff;
-                    }
-                    attempt_variance = sum_sq / valid_count;
-
-                    ESP_LOGI(TAG, "FTM 시도 결과: 거리=%.2f m (중앙값), 분산=%.4f (%d개 샘플)",
-                            attempt_distance, attempt_variance, valid_count);
-                    result = ESP_OK;
-                } else {
-                    ESP_LOGW(TAG, "필터링 후 유효한 FTM 측정값 없음");
-                }
-
-                free(distances);
-            }
-        } else {
-            ESP_LOGW(TAG, "FTM 타임아웃 (시도 %d)", attempt + 1);
-        }
-
         // FTM 세션 종료
         esp_wifi_ftm_end_session();
 
-        // 이벤트 핸들러 등록 해제
-        esp_event_handler_unregister(WIFI_EVENT, WIFI_EVENT_FTM_REPORT, &ftm_event_handler);
-
-        // 가장 좋은 결과인지 확인
-        if (result == ESP_OK && attempt_variance < best_variance) {
-            best_distance = attempt_distance;
-            best_variance = attempt_variance;
-            best_valid_count = attempt_valid_count;
-            // RTT 계산 (거리에서 역산): distance = (RTT_ns * 0.299792458) / 2
-            best_rtt_ns = (uint32_t)((best_distance / FTM_CALIBRATION_FACTOR) * 2.0 / 0.299792458);
-            final_result = ESP_OK;
-
-            ESP_LOGI(TAG, "최선의 결과 갱신: 거리=%.2f m, RTT=%"PRIu32" ns, 분산=%.4f, 샘플=%d개",
-                    best_distance, best_rtt_ns, best_variance, best_valid_count);
-
-            // 분산이 충분히 낮으면 재시도 중단
-            if (best_variance < MAX_VARIANCE_THRESHOLD) {
-                ESP_LOGI(TAG, "분산 허용 범위 (%.4f < %.4f), 재시도 중단",
-                        best_variance, MAX_VARIANCE_THRESHOLD);
+        if (!(bits & FTM_REPORT_BIT)) {
+            ESP_LOGW(TAG, "FTM 세션 %d %s", session, (bits & FTM_FAILURE_BIT) ? "실패" : "타임아웃");
+            if (++failed_sessions >= FTM_MAX_FAILED_SESSIONS) {
                 break;
             }
+            continue;
         }
 
-        // 재시도 전 짧은 대기
-        if (attempt < MAX_FTM_RETRY - 1) {
-            vTaskDelay(pdMS_TO_TICKS(200));
+        // 누적 엔트리 전체를 다시 축약 (범위 검사 → IQR 이상치 제거 → 중앙값/분산, 정수 연산)
+        if (ftm_reduce(ftm_report_data, ftm_report_num_entries, &reduced) != ESP_OK) {
+            ESP_LOGW(TAG, "필터링 후 유효한 FTM 측정값 없음 (누적 엔트리 %d개)", ftm_report_num_entries);
+            final_result = ESP_FAIL;
+            continue;
+        }
+        final_result = ESP_OK;
+
+#if FTM_REDUCER_VERIFY
+        // 이전 부동소수점 구현과 비교
+        ftm_reduce_result_t reference;
+        esp_err_t reference_result = ftm_reduce_reference(ftm_report_data, ftm_report_num_entries, &reference);
+        if (reference_result != ESP_OK || reference.valid_count != reduced.valid_count ||
+            fabsf(reference.distance - reduced.distance) > 0.001f) {
+            ESP_LOGW(TAG, "FTM 축약 불일치: 정수=%.4f m (%d개), 기준=%.4f m (%d개)",
+                    reduced.distance, reduced.valid_count, reference.distance, reference.valid_count);
+        }
+#endif
+
+        // 중앙값의 95% 신뢰구간 반폭이 목표 이하면 추가 세션 없이 종료
+        float ci_m = FTM_MEDIAN_CI_FACTOR * sqrtf(reduced.variance / reduced.valid_count);
+        swift_trace(SWIFT_TRACE_BC_FTM_RESULT, (uint8_t)reduced.valid_count, (uint16_t)ftm_report_num_entries,
+                    swift_trace_milli(reduced.distance), swift_trace_milli(ci_m));
+        SWIFT_TRACE_LOGI(TAG, "누적 결과: 거리=%.2f m (중앙값), 분산=%.4f, 신뢰구간 ±%.3f m (%d/%d개 샘플)",
+                reduced.distance, reduced.variance, ci_m, reduced.valid_count, ftm_report_num_entries);
+        if (ci_m <= FTM_TARGET_CI_M) {
+            break;
         }
     }
 
-    // 최선의 결과 반환
+    // 결과 반환
     if (final_result == ESP_OK) {
-        *distance = best_distance;
-        *variance = best_variance;
-        *valid_count = best_valid_count;
+        *distance = reduced.distance;
+        *variance = reduced.variance;
+        *valid_count = reduced.valid_count;
         if (rtt_ns != NULL) {
-            *rtt_ns = best_rtt_ns;
+            *rtt_ns = reduced.rtt_ns;
         }
-        ESP_LOGI(TAG, "최종 FTM 결과: 거리=%.2f m, RTT=%"PRIu32" ns, 분산=%.4f, 샘플=%d개",
-                *distance, best_rtt_ns, *variance, *valid_count);
+        swift_trace(SWIFT_TRACE_BC_FTM_FINAL, (uint8_t)session, (uint16_t)*valid_count,
+                    swift_trace_milli(*distance), (int32_t)reduced.rtt_ns);
+        SWIFT_TRACE_LOGI(TAG, "최종 FTM 결과: 거리=%.2f m, RTT=%"PRIu32" ns, 분산=%.4f, 샘플=%d개 (세션 %d회, 프레임 %d개)",
+                *distance, reduced.rtt_ns, *variance, *valid_count, session, frames_requested);
     } else {
-        ESP_LOGE(TAG, "모든 FTM 시도 실패");
+        ESP_LOGE(TAG, "모든 FTM 세션 실패 (세션 %d회)", session);
     }
 
     return final_result;
@@ -620,7 +597,7 @@ static esp_err_t perform_ftm_measurement(uint8_t *bssid, uint8_t channel,
 // ===== 데이터 전송 함수 =====
 
 // 재시도 로직을 포함한 데이터 전송 (RSSI 순)
-static esp_err_t send_data_with_retry(beacon_data_packet_t *packet) {
+static esp_err_t send_data_with_retry(const uint8_t *frame, size_t frame_len) {
     // RSSI로 게이트웨이 정렬 (재시도 순서)
     for (int i = 0; i < floor_count - 1; i++) {
         for (int j = i + 1; j < floor_count; j++) {
@@ -639,10 +616,14 @@ static esp_err_t send_data_with_retry(beacon_data_packet_t *packet) {
         ESP_LOGI(TAG, "게이트웨이 %d에 전송 시도: "MACSTR" (채널 %d, RSSI: %d)",
                 gw+1, MAC2STR(floor_list[gw].gateway_mac), floor_list[gw].channel, floor_list[gw].rssi);
 
-        // 게이트웨이 채널로 변경
-        ESP_LOGI(TAG, "채널 %d로 변경", floor_list[gw].channel);
-        esp_wifi_set_channel(floor_list[gw].channel, WIFI_SECOND_CHAN_NONE);
-        vTaskDelay(pdMS_TO_TICKS(100));  // 채널 변경 안정화 대기
+        // 게이트웨이 채널로 변경 (동기 호출이라 안정화 대기 없음)
+        uint8_t current_channel = 0;
+        wifi_second_chan_t second_channel = WIFI_SECOND_CHAN_NONE;
+        esp_wifi_get_channel(&current_channel, &second_channel);
+        if (current_channel != floor_list[gw].channel) {
+            ESP_LOGI(TAG, "채널 %d로 변경", floor_list[gw].channel);
+            esp_wifi_set_channel(floor_list[gw].channel, WIFI_SECOND_CHAN_NONE);
+        }
 
         // 피어가 추가되지 않았으면 추가
         esp_now_peer_info_t peer_info = {0};
@@ -659,28 +640,52 @@ static esp_err_t send_data_with_retry(beacon_data_packet_t *packet) {
             ESP_LOGI(TAG, "피어 추가 성공");
         }
 
-        // 재시도하며 전송
+        // 재시도하며 전송 (전송 콜백이 오는 즉시 다음 단계로)
         for (int retry = 0; retry < MAX_RETRY_ATTEMPTS; retry++) {
-            upload_successful = false;
+            xEventGroupClearBits(send_event_group, SEND_SUCCESS_BIT | SEND_FAILURE_BIT);
+            int64_t send_start_us = esp_timer_get_time();
 
             esp_err_t result = esp_now_send(
                 floor_list[gw].gateway_mac,
-                (uint8_t*)packet,
-                sizeof(beacon_data_packet_t)
+                frame,
+                frame_len
             );
 
             if (result == ESP_OK) {
-                // 전송 콜백 대기
-                vTaskDelay(pdMS_TO_TICKS(100));
+                send_stats.attempts++;
+                EventBits_t bits = xEventGroupWaitBits(send_event_group,
+                                                       SEND_SUCCESS_BIT | SEND_FAILURE_BIT,
+                                                       pdTRUE, pdFALSE,
+                                                       pdMS_TO_TICKS(SEND_ACK_TIMEOUT_MS));
+                uint32_t latency_us = (uint32_t)(esp_timer_get_time() - send_start_us);
+
+                if (bits & (SEND_SUCCESS_BIT | SEND_FAILURE_BIT)) {
+                    send_stats.total_latency_us += latency_us;
+                    if (latency_us > send_stats.max_latency_us) {
+                        send_stats.max_latency_us = latency_us;
+                    }
+                }
 
-                if (upload_successful) {
-                    ESP_LOGI(TAG, "게이트웨이 %d에 데이터 전송 성공", gw+1);
+                if (bits & SEND_SUCCESS_BIT) {
+                    send_stats.acked++;
+                    swift_trace(SWIFT_TRACE_BC_SEND, (uint8_t)(gw + 1), (uint16_t)(retry + 1), (int32_t)latency_us, 0);
+                    SWIFT_TRACE_LOGI(TAG, "게이트웨이 %d에 데이터 전송 성공 (%" PRIu32 " us, 시도 %d)", gw+1, latency_us, retry+1);
                     return ESP_OK;
+                } else if (bits & SEND_FAILURE_BIT) {
+                    send_stats.nacked++;
+                    ESP_LOGW(TAG, "전송 시도 %d/%d 실패: ACK 없음 (%" PRIu32 " us)", retry+1, MAX_RETRY_ATTEMPTS, latency_us);
+                } else {
+                    send_stats.timeouts++;
+                    ESP_LOGW(TAG, "전송 시도 %d/%d 실패: 콜백 타임아웃 (%d ms)", retry+1, MAX_RETRY_ATTEMPTS, SEND_ACK_TIMEOUT_MS);
                 }
+            } else {
+                ESP_LOGW(TAG, "전송 시도 %d/%d 실패: %s", retry+1, MAX_RETRY_ATTEMPTS, esp_err_to_name(result));
             }
 
-            ESP_LOGW(TAG, "전송 시도 %d/%d 실패", retry+1, MAX_RETRY_ATTEMPTS);
-            vTaskDelay(pdMS_TO_TICKS(50));
+            // 짧은 지터 백오프 (같은 채널의 다른 비콘과 재충돌 방지)
+            if (retry < MAX_RETRY_ATTEMPTS - 1) {
+                vTaskDelay(pdMS_TO_TICKS(SEND_BACKOFF_MIN_MS + esp_random() % (SEND_BACKOFF_JITTER_MS + 1)));
+            }
         }
     }
 
@@ -692,9 +697,11 @@ static esp_err_t send_data_with_retry(beacon_data_packet_t *packet) {
 // ===== 메인 애플리케이션 =====
 
 void app_main(void) {
+    phase_profiler_start();
     ESP_LOGI(TAG, "비콘 디바이스 시작 (v11 - 칼만 필터 지원)");
 
     // NVS 초기화
+    phase_profiler_enter(SWIFT_PHASE_NVS);
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
         ESP_ERROR_CHECK(nvs_flash_erase());
@@ -702,14 +709,11 @@ void app_main(void) {
     }
     ESP_ERROR_CHECK(ret);
 
-    // 배터리 NVS 초기화 (시작 시간 저장/로드)
-    ESP_LOGI(TAG, "가상 배터리 NVS 초기화");
-    ret = init_battery_nvs();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "배터리 NVS 초기화 실패, 계속 진행");
-    }
+    // 배터리 누적 소모 전하 로드 (실패해도 계속 진행)
+    phase_profiler_init_battery();
 
     // Wi-Fi 초기화 (스캔/FTM 전용 STA 모드)
+    phase_profiler_enter(SWIFT_PHASE_WIFI_INIT);
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
     esp_netif_create_default_wifi_sta();
@@ -718,6 +722,7 @@ void app_main(void) {
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_start());
+    phase_profiler_radio_on();
 
     // 대역폭을 20MHz (HT20)로 설정 (최적의 FTM 정확도)
     esp_err_t bw_err = esp_wifi_set_bandwidth(WIFI_IF_STA, WIFI_BW_HT20);
@@ -735,110 +740,87 @@ void app_main(void) {
         ESP_LOGW(TAG, "STA 프로토콜 설정 실패: %s", esp_err_to_name(proto_err));
     }
 
-    // FTM 이벤트 그룹 생성
+    phase_profiler_enter(SWIFT_PHASE_OTHER);
+
+    // FTM / 층 수신 이벤트 그룹 생성
     ftm_event_group = xEventGroupCreate();
+    ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_FTM_REPORT, &ftm_event_handler, NULL));
+    floor_event_group = xEventGroupCreate();
+    learned_gateway_queue = xQueueCreate(LEARNED_GATEWAY_QUEUE_LENGTH, sizeof(gateway_info_t));
+
+    // 0단계: 오래 정지해 있었으면 가장 센 게이트웨이 채널의 RSSI 만 확인하고 변화가 없으면 다시 잠듦
+    if (duty_cycle_plan() == DUTY_CYCLE_RSSI_CHECK && topology_cache_usable()) {
+        gateway_info_t seen[MAX_GATEWAYS];
+        duty_rssi_sample_t samples[MAX_GATEWAYS];
+        phase_profiler_enter(SWIFT_PHASE_SCAN);
+        int seen_count = scan_gateways(seen, MAX_GATEWAYS, topology_cache.gateways[0].channel);
+        phase_profiler_enter(SWIFT_PHASE_OTHER);
+        for (int i = 0; i < seen_count; i++) {
+            memcpy(samples[i].mac, seen[i].mac, 6);
+            samples[i].rssi = seen[i].rssi;
+        }
+        ESP_LOGI(TAG, "0단계: 채널 %d RSSI 확인 (%d개 게이트웨이)", topology_cache.gateways[0].channel, seen_count);
+        if (duty_cycle_rssi_stationary(samples, seen_count)) {
+            duty_cycle_sleep();
+            return;
+        }
+    }
 
     // 메인 작업 (Deep Sleep 전 1회 실행)
     ESP_LOGI(TAG, "=== 메인 측정 사이클 시작 ===");
 
-    // 1단계: 모든 게이트웨이 AP 스캔 및 정보 수집
-    ESP_LOGI(TAG, "1단계: 게이트웨이 AP 스캔하여 모든 채널 정보 수집");
-
-    wifi_scan_config_t scan_config = {
-        .ssid = NULL,  // 모든 SSID 스캔하여 게이트웨이 찾기
-        .bssid = NULL,
-        .channel = 0,
-        .show_hidden = false,
-        .scan_type = WIFI_SCAN_TYPE_ACTIVE,
-        .scan_time = {
-            .active = {
-                .min = 100,
-                .max = 300,
-            },
-        },
-    };
-
-    ESP_ERROR_CHECK(esp_wifi_scan_start(&scan_config, true));
-
-    uint16_t ap_count = 0;
-    ESP_ERROR_CHECK(esp_wifi_scan_get_ap_num(&ap_count));
-
-    // 게이트웨이 리스트 동적 할당
-    gateway_info_t *gateway_list = NULL;
+    // 1단계: 게이트웨이 목록 확보 (RTC 캐시가 유효하면 스캔 생략)
+    gateway_info_t gateway_list[MAX_GATEWAYS];
     int gateway_count = 0;
-    int *unique_channel_list = NULL;
+    int unique_channel_list[MAX_GATEWAYS];
     int unique_channel_count = 0;
+    bool used_topology_cache = topology_cache_usable();
 
-    if (ap_count > 0) {
-        wifi_ap_record_t *ap_records = malloc(ap_count * sizeof(wifi_ap_record_t));
-        ESP_ERROR_CHECK(esp_wifi_scan_get_ap_records(&ap_count, ap_records));
-
-        // 최대 게이트웨이 개수만큼 메모리 할당
-        gateway_list = malloc(ap_count * sizeof(gateway_info_t));
-        unique_channel_list = malloc(ap_count * sizeof(int));
-
-        if (gateway_list == NULL || unique_channel_list == NULL) {
-            ESP_LOGE(TAG, "메모리 할당 실패");
-            free(ap_records);
-            if (gateway_list) free(gateway_list);
-            if (unique_channel_list) free(unique_channel_list);
-            esp_deep_sleep(SLEEP_DURATION_SEC * 1000000);
-            return;
+    if (used_topology_cache) {
+        gateway_count = topology_cache.gateway_count;
+        memcpy(gateway_list, topology_cache.gateways, gateway_count * sizeof(gateway_info_t));
+        ESP_LOGI(TAG, "1단계: 토폴로지 캐시 사용 (%d개 게이트웨이, %" PRId64 "초 전 스캔), 스캔 생략",
+                gateway_count, rtc_now_sec() - topology_cache.updated_sec);
+    } else {
+        ESP_LOGI(TAG, "1단계: 게이트웨이 AP 스캔하여 모든 채널 정보 수집");
+        phase_profiler_enter(SWIFT_PHASE_SCAN);
+        gateway_count = scan_gateways(gateway_list, MAX_GATEWAYS, 0);
+        phase_profiler_enter(SWIFT_PHASE_OTHER);
+        if (gateway_count > 0) {
+            topology_cache_store(gateway_list, gateway_count);
         }
+    }
 
-        // 모든 게이트웨이 AP 수집 (break 제거)
-        for (int i = 0; i < ap_count; i++) {
-            // 게이트웨이 AP 확인
-            if (strcmp((char*)ap_records[i].ssid, "Gateway_Network") == 0 ||
-                strcmp((char*)ap_records[i].ssid, WIFI_SSID) == 0) {
-
-                // 게이트웨이 정보 저장
-                memcpy(gateway_list[gateway_count].mac, ap_records[i].bssid, 6);
-                gateway_list[gateway_count].channel = ap_records[i].primary;
-                gateway_list[gateway_count].rssi = ap_records[i].rssi;
-
-                ESP_LOGI(TAG, "게이트웨이 %d: "MACSTR" (채널 %d, RSSI: %d)",
-                        gateway_count + 1, MAC2STR(ap_records[i].bssid),
-                        ap_records[i].primary, ap_records[i].rssi);
-
-                // unique_channel_list에 채널 추가 (중복 제거)
-                bool channel_exists = false;
-                for (int j = 0; j < unique_channel_count; j++) {
-                    if (unique_channel_list[j] == ap_records[i].primary) {
-                        channel_exists = true;
-                        break;
-                    }
-                }
-                if (!channel_exists) {
-                    unique_channel_list[unique_channel_count] = ap_records[i].primary;
-                    unique_channel_count++;
-                    ESP_LOGI(TAG, "새 채널 추가: %d (총 %d개 채널)",
-                            ap_records[i].primary, unique_channel_count);
-                }
-
-                gateway_count++;
+    // 채널 목록 (중복 제거)
+    for (int i = 0; i < gateway_count; i++) {
+        bool channel_exists = false;
+        for (int j = 0; j < unique_channel_count; j++) {
+            if (unique_channel_list[j] == gateway_list[i].channel) {
+                channel_exists = true;
+                break;
             }
         }
-
-        free(ap_records);
+        if (!channel_exists) {
+            unique_channel_list[unique_channel_count++] = gateway_list[i].channel;
+        }
     }
 
     if (gateway_count == 0) {
         ESP_LOGW(TAG, "게이트웨이를 찾을 수 없음, Deep Sleep 진입");
-        if (gateway_list) free(gateway_list);
-        if (unique_channel_list) free(unique_channel_list);
-        esp_deep_sleep(SLEEP_DURATION_SEC * 1000000);
+        duty_cycle_report_failure();
+        duty_cycle_sleep();
         return;
     }
 
-    ESP_LOGI(TAG, "스캔 완료: %d개 게이트웨이, %d개 채널 발견",
+    ESP_LOGI(TAG, "%s: %d개 게이트웨이, %d개 채널",
+            used_topology_cache ? "캐시 로드 완료" : "스캔 완료",
             gateway_count, unique_channel_count);
 
     // ESP-NOW 초기화 (채널 순회 전 1회)
     ESP_LOGI(TAG, "ESP-NOW 초기화");
     ESP_ERROR_CHECK(esp_now_init());
+    send_event_group = xEventGroupCreate();
     ESP_ERROR_CHECK(esp_now_register_send_cb(data_send_cb));
-    vTaskDelay(pdMS_TO_TICKS(100));
 
     // FTM 결과를 저장할 구조체
     typedef struct {
@@ -850,43 +832,53 @@ void app_main(void) {
         uint32_t rtt_nanoseconds;
     } ftm_result_t;
 
-    // 최종 FTM 결과 리스트 동적 할당
-    ftm_result_t *final_ftm_results = malloc(gateway_count * sizeof(ftm_result_t));
+    // 최종 FTM 결과 리스트 동적 할당 (채널 순회 중 이웃 리포트로 게이트웨이가 늘 수 있음)
+    ftm_result_t *final_ftm_results = malloc(MAX_GATEWAYS * sizeof(ftm_result_t));
     int final_ftm_count = 0;
 
     if (final_ftm_results == NULL) {
         ESP_LOGE(TAG, "FTM 결과 메모리 할당 실패");
-        free(gateway_list);
-        free(unique_channel_list);
-        esp_deep_sleep(SLEEP_DURATION_SEC * 1000000);
+        duty_cycle_report_failure();
+        duty_cycle_sleep();
         return;
     }
 
     // 2~5단계: 채널 순회 메인 루프
+    // 채널마다 층 수신 (ESP-NOW) 과 FTM 측정을 겹쳐서 수행하고, 고정 대기 대신 이벤트 완료로 진행
     ESP_LOGI(TAG, "=== 채널 순회 시작 (%d개 채널) ===", unique_channel_count);
     floor_count = 0;  // 전역 floor_count 초기화
+    ESP_ERROR_CHECK(esp_now_register_recv_cb(floor_recv_cb));
+
+    int64_t visit_start_us = esp_timer_get_time();
+    int64_t total_ftm_us = 0;
+    int64_t total_floor_wait_us = 0;
+    int initial_gateway_count = gateway_count;    // 스캔/캐시로 확보한 게이트웨이 수 (이후는 이웃 리포트로 추가)
+    int initial_failures = 0;
+    bool gateway_measured[MAX_GATEWAYS] = {false};
 
     for (int ch_idx = 0; ch_idx < unique_channel_count; ch_idx++) {
         int current_channel = unique_channel_list[ch_idx];
         ESP_LOGI(TAG, "\n--- 채널 %d 처리 중 (%d/%d) ---",
                 current_channel, ch_idx + 1, unique_channel_count);
 
-        // 채널 고정
+        // 채널 고정 후 바로 층 수신 시작 (안정화 대기 없음)
         ESP_LOGI(TAG, "채널 %d로 변경", current_channel);
+        int64_t channel_start_us = esp_timer_get_time();
+        channel_floor_heard = 0;
+        xEventGroupClearBits(floor_event_group, FLOOR_RECV_BIT);
         ESP_ERROR_CHECK(esp_wifi_set_channel(current_channel, WIFI_SECOND_CHAN_NONE));
 
-        // 안정화 대기
-        vTaskDelay(pdMS_TO_TICKS(200));
-
-        // 층 발견 (ESP-NOW) - 모든 채널에서 누적
-        ESP_LOGI(TAG, "채널 %d에서 층 발견 시작", current_channel);
-        ESP_ERROR_CHECK(esp_now_register_recv_cb(floor_recv_cb));
-        vTaskDelay(pdMS_TO_TICKS(FLOOR_DISCOVERY_DURATION_MS));
-        ESP_ERROR_CHECK(esp_now_unregister_recv_cb());
-        ESP_LOGI(TAG, "층 발견 완료: 현재까지 총 %d개 게이트웨이", floor_count);
+        // 이 채널에서 기다릴 층 브로드캐스트 수 (스캔에서 찾은 게이트웨이 수)
+        int channel_gateways = 0;
+        for (int gw_idx = 0; gw_idx < gateway_count; gw_idx++) {
+            if (gateway_list[gw_idx].channel == current_channel) {
+                channel_gateways++;
+            }
+        }
 
-        // 현재 채널의 게이트웨이에 대해 FTM 측정
+        // 현재 채널의 게이트웨이에 대해 FTM 측정 (층 수신은 백그라운드로 계속)
         ESP_LOGI(TAG, "채널 %d의 게이트웨이 FTM 측정 시작", current_channel);
+        phase_profiler_enter(SWIFT_PHASE_FTM);
 
         for (int gw_idx = 0; gw_idx < gateway_count; gw_idx++) {
             // 현재 채널에 속한 게이트웨이만 측정
@@ -901,10 +893,6 @@ void app_main(void) {
 
             float distance, variance;
             int valid_samples = 0;
-
-            // 안정화를 위한 짧은 대기
-            vTaskDelay(pdMS_TO_TICKS(50));
-
             uint32_t rtt_ns = 0;
             if (perform_ftm_measurement(gateway_list[gw_idx].mac,
                                        gateway_list[gw_idx].channel,
@@ -917,33 +905,74 @@ void app_main(void) {
                 final_ftm_results[final_ftm_count].sample_count = valid_samples;
                 final_ftm_results[final_ftm_count].rtt_nanoseconds = rtt_ns;
                 final_ftm_count++;
+                gateway_measured[gw_idx] = true;
 
                 ESP_LOGI(TAG, "FTM 성공 [%d]: 거리=%.2f m, 분산=%.4f, 샘플=%d개",
                         final_ftm_count, distance, variance, valid_samples);
             } else {
                 ESP_LOGW(TAG, "FTM 실패: "MACSTR, MAC2STR(gateway_list[gw_idx].mac));
+                if (gw_idx < initial_gateway_count) {
+                    initial_failures++;
+                }
             }
         }
 
-        ESP_LOGI(TAG, "채널 %d 처리 완료 (현재까지 FTM 성공: %d개)",
-                current_channel, final_ftm_count);
+        // FTM 이 끝난 뒤에도 이 채널 게이트웨이의 층 정보를 다 못 들었으면 남은 시간만큼 대기
+        int64_t ftm_done_us = esp_timer_get_time();
+        phase_profiler_enter(SWIFT_PHASE_FLOOR_WAIT);
+        wait_for_floor_reports(channel_gateways, channel_start_us);
+        phase_profiler_enter(SWIFT_PHASE_OTHER);
+        int64_t channel_end_us = esp_timer_get_time();
+
+        // 이 채널에서 들은 이웃 리포트로 새 게이트웨이/채널 반영 (새 채널은 이번 깨어남에 바로 방문)
+        gateway_count += merge_learned_gateways(gateway_list, gateway_count,
+                                                unique_channel_list, &unique_channel_count);
+
+        total_ftm_us += ftm_done_us - channel_start_us;
+        total_floor_wait_us += channel_end_us - ftm_done_us;
+        ESP_LOGI(TAG, "채널 %d 처리 완료 (현재까지 FTM 성공: %d개, 층 정보: %d개) - FTM %" PRId64 " ms, 층 대기 %" PRId64 " ms, 합계 %" PRId64 " ms",
+                current_channel, final_ftm_count, floor_count,
+                (ftm_done_us - channel_start_us) / 1000, (channel_end_us - ftm_done_us) / 1000,
+                (channel_end_us - channel_start_us) / 1000);
     }
 
-    ESP_LOGI(TAG, "=== 채널 순회 완료 ===");
+    ESP_ERROR_CHECK(esp_now_unregister_recv_cb());
+
+    // 캐시된 게이트웨이 중 측정 실패가 있으면 (이동/전원 꺼짐 등) 다음 깨어남에서 다시 스캔
+    if (used_topology_cache && initial_failures > 0) {
+        topology_cache_invalidate("캐시된 게이트웨이 FTM 실패");
+    } else if (gateway_count > initial_gateway_count) {
+        // 이웃 리포트로 알게 된 게이트웨이 중 측정에 성공한 것만 캐시에 추가 (다음 깨어남은 스캔 없이 방문)
+        int cache_count = initial_gateway_count;
+        for (int i = initial_gateway_count; i < gateway_count; i++) {
+            if (gateway_measured[i]) {
+                gateway_list[cache_count++] = gateway_list[i];
+            }
+        }
+        if (cache_count > initial_gateway_count) {
+            topology_cache_merge(gateway_list, cache_count);
+            ESP_LOGI(TAG, "토폴로지 캐시에 이웃 게이트웨이 %d개 추가", cache_count - initial_gateway_count);
+        }
+    }
+    ESP_LOGI(TAG, "=== 채널 순회 완료: %" PRId64 " ms (FTM %" PRId64 " ms, 층 대기 %" PRId64 " ms) ===",
+            (esp_timer_get_time() - visit_start_us) / 1000, total_ftm_us / 1000, total_floor_wait_us / 1000);
     ESP_LOGI(TAG, "총 FTM 성공: %d개, 층 정보: %d개", final_ftm_count, floor_count);
-
-    // 메모리 해제
-    free(gateway_list);
-    free(unique_channel_list);
+    if (ftm_anchors_measured > 0) {
+        ESP_LOGI(TAG, "FTM 앵커당 평균 프레임 %.1f개 (세션 %.1f회, 최대 %d개)",
+                (float)ftm_frames_requested / ftm_anchors_measured,
+                (float)ftm_sessions / ftm_anchors_measured, FTM_MAX_FRAMES_PER_ANCHOR);
+    }
 
     // 데이터 취합 및 필터링
-    beacon_data_packet_t packet = {0};
+    swift_beacon_report_t report = {0};
 
     // 최소 1개 이상의 FTM 측정값이 있어야 전송
     if (final_ftm_count < 1) {
         ESP_LOGW(TAG, "FTM 측정값 없음 (%d < 1), Deep Sleep 진입", final_ftm_count);
+        topology_cache_invalidate("FTM 측정 실패");
         free(final_ftm_results);
-        esp_deep_sleep(SLEEP_DURATION_SEC * 1000000);
+        duty_cycle_report_failure();
+        duty_cycle_sleep();
         return;
     }
 
@@ -961,15 +990,16 @@ void app_main(void) {
         }
     }
 
-    // 측정 결과를 패킷에 저장 (최대 3개, 최소 1개)
-    int result_count = (final_ftm_count < 3) ? final_ftm_count : 3;
+    // 측정 결과를 리포트에 저장 (분산이 작은 순으로 최대 SWIFT_FRAME_MAX_MEASUREMENTS개)
+    int result_count = (final_ftm_count < SWIFT_FRAME_MAX_MEASUREMENTS) ? final_ftm_count : SWIFT_FRAME_MAX_MEASUREMENTS;
     for (int i = 0; i < result_count; i++) {
-        memcpy(packet.measurements[i].anchor_mac, final_ftm_results[i].mac, 6);
-        packet.measurements[i].distance_meters = final_ftm_results[i].distance;
-        packet.measurements[i].variance = final_ftm_results[i].variance;
-        packet.measurements[i].rssi = final_ftm_results[i].rssi;
-        packet.measurements[i].sample_count = (uint8_t)final_ftm_results[i].sample_count;
-        packet.measurements[i].rtt_nanoseconds = final_ftm_results[i].rtt_nanoseconds;
+        swift_measurement_t *m = &report.measurements[i];
+        memcpy(m->anchor_mac, final_ftm_results[i].mac, 6);
+        m->distance_meters = final_ftm_results[i].distance;
+        m->variance = final_ftm_results[i].variance;
+        m->rssi = final_ftm_results[i].rssi;
+        m->sample_count = (uint8_t)final_ftm_results[i].sample_count;
+        m->rtt_nanoseconds = final_ftm_results[i].rtt_nanoseconds;
 
         ESP_LOGI(TAG, "최종 측정 %d: "MACSTR" 거리=%.2f m, 분산=%.4f, RTT=%"PRIu32" ns, rssi=%d, 샘플=%d개",
                 i+1, MAC2STR(final_ftm_results[i].mac),
@@ -978,38 +1008,100 @@ void app_main(void) {
                 final_ftm_results[i].rssi, final_ftm_results[i].sample_count);
     }
 
+    report.measurement_count = (uint8_t)result_count;
+
     // FTM 결과 메모리 해제
     free(final_ftm_results);
 
     // 6단계: 층 계산
     ESP_LOGI(TAG, "6단계: %d개 게이트웨이 리포트에서 층 계산", floor_count);
-    int8_t my_floor = calculate_floor_mode();
+    int8_t my_floor;
+    if (floor_count > 0) {
+        my_floor = calculate_floor_mode();
+        topology_cache.floor = my_floor;
+        topology_cache.floor_valid = true;
+    } else if (topology_cache.floor_valid) {
+        my_floor = topology_cache.floor;
+        ESP_LOGW(TAG, "층 정보 없음, 캐시된 층 사용: %d층", my_floor);
+    } else {
+        my_floor = calculate_floor_mode();
+    }
 
-    // 7단계: 패킷 생성
-    ESP_LOGI(TAG, "7단계: 데이터 패킷 생성");
-    strncpy(packet.serial_number, serial_number, sizeof(packet.serial_number) - 1);
+    // 7단계: 프레임 생성
+    ESP_LOGI(TAG, "7단계: 데이터 프레임 생성");
+    strncpy(report.serial_number, serial_number, SWIFT_SERIAL_MAX_LEN);
 
-    // 가상 배터리 레벨 계산
-    packet.battery_level = getBatteryLevel();
+    // 배터리 잔량 (추정 소모 전하 기준)과 지난 전송 이후 깨어남 전력 프로파일
+    report.battery_level = phase_profiler_battery_level();
+    report.has_profile = phase_profiler_summary(&report.profile);
 
-    packet.floor = my_floor;
+    report.floor = my_floor;
     // 타임스탬프는 게이트웨이 수신 시 채워짐
-    strcpy(packet.timestamp, "");
 
-    ESP_LOGI(TAG, "패킷 준비 완료: SN=%s, 배터리=%d%%, 층=%d",
-            packet.serial_number, packet.battery_level, packet.floor);
+    // 사이클 번호: 전원 인가 시 임의 값에서 시작해 게이트웨이가 재시작을 중복으로 오인하지 않게 함
+    if (!report_sequence_valid) {
+        report_sequence = esp_random();
+        report_sequence_valid = true;
+    }
+    report.has_sequence = true;
+    report.sequence = report_sequence++;
+
+    uint8_t frame[SWIFT_FRAME_MAX_SIZE];
+    size_t frame_len = 0;
+    esp_err_t encode_result = swift_frame_encode_report(&report, frame, sizeof(frame), &frame_len);
+    if (encode_result != ESP_OK) {
+        ESP_LOGE(TAG, "프레임 인코딩 실패: %s", esp_err_to_name(encode_result));
+        duty_cycle_report_failure();
+        duty_cycle_sleep();
+        return;
+    }
+
+    ESP_LOGI(TAG, "프레임 준비 완료: SN=%s #%" PRIu32 ", 배터리=%d%%, 층=%d, 측정=%d개, %d바이트",
+            report.serial_number, report.sequence, report.battery_level, report.floor,
+            report.measurement_count, (int)frame_len);
 
     // 8단계: 데이터 전송
     ESP_LOGI(TAG, "8단계: 게이트웨이로 데이터 전송");
-    esp_err_t send_result = send_data_with_retry(&packet);
+    phase_profiler_enter(SWIFT_PHASE_SEND);
+    xEventGroupClearBits(send_event_group, SLOT_RECV_BIT);
+    ESP_ERROR_CHECK(esp_now_register_recv_cb(slot_recv_cb));
+    esp_err_t send_result = send_data_with_retry(frame, frame_len);
+
+    // 게이트웨이가 리포트를 받자마자 보내는 TDMA 슬롯 배정을 잠깐 기다려 다음 깨어남 시각을 맞춤
+    if (send_result == ESP_OK &&
+        (xEventGroupWaitBits(send_event_group, SLOT_RECV_BIT, pdTRUE, pdFALSE,
+                             pdMS_TO_TICKS(SLOT_REPLY_TIMEOUT_MS)) & SLOT_RECV_BIT)) {
+        duty_cycle_align_slot(&slot_assignment, esp_timer_get_time() - slot_received_us);
+    }
+    esp_now_unregister_recv_cb();
+    phase_profiler_enter(SWIFT_PHASE_OTHER);
 
     if (send_result == ESP_OK) {
-        ESP_LOGI(TAG, "✓ 데이터 전송 성공");
+        phase_profiler_report_sent();
+
+        // 깨어남 → 전송 완료 시간 (esp_timer 는 깨어날 때마다 0 부터 시작)
+        uint32_t wake_to_send_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        topology_cache.wake_to_send_ms[used_topology_cache ? 1 : 0] = wake_to_send_ms;
+        ESP_LOGI(TAG, "✓ 데이터 전송 성공 (깨어남→전송 %" PRIu32 " ms, %s / 최근 전체 스캔 %" PRIu32 " ms, 캐시 %" PRIu32 " ms)",
+                wake_to_send_ms, used_topology_cache ? "캐시" : "전체 스캔",
+                topology_cache.wake_to_send_ms[0], topology_cache.wake_to_send_ms[1]);
     } else {
         ESP_LOGE(TAG, "✗ 데이터 전송 실패");
+        topology_cache_invalidate("데이터 전송 실패");
     }
 
-    // 9단계: Deep Sleep 진입
-    ESP_LOGI(TAG, "9단계: %d초 동안 Deep Sleep 진입", SLEEP_DURATION_SEC);
-    esp_deep_sleep(SLEEP_DURATION_SEC * 1000000);
+    // 전송 완료 콜백까지의 지연 (깨어남 간 누적)
+    uint32_t callbacks = send_stats.acked + send_stats.nacked;
+    ESP_LOGI(TAG, "전송 지연 누적: 시도 %" PRIu32 "회, ACK %" PRIu32 " / NACK %" PRIu32 " / 타임아웃 %" PRIu32 ", 평균 %" PRIu32 " us, 최대 %" PRIu32 " us",
+            send_stats.attempts, send_stats.acked, send_stats.nacked, send_stats.timeouts,
+            callbacks ? (uint32_t)(send_stats.total_latency_us / callbacks) : 0, send_stats.max_latency_us);
+
+    // 9단계: 움직임에 따라 주기 조정 후 Deep Sleep 진입 (전송 실패면 최소 주기로 재시도)
+    ESP_LOGI(TAG, "9단계: Deep Sleep 진입");
+    if (send_result == ESP_OK) {
+        duty_cycle_report_ranges(report.measurements, report.measurement_count);
+    } else {
+        duty_cycle_report_failure();
+    }
+    duty_cycle_sleep();
 }
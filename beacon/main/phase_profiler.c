@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/time.h>
+#include "phase_profiler.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "nvs.h"
+
+static const char *TAG = "PHASE_PROFILER";
+
+#define PROFILER_MAGIC 0x50524631           // "PRF1", 전원 인가 직후 RTC 메모리 쓰레기 값 구분
+#define PROFILER_NVS_NAMESPACE "battery"
+#define PROFILER_NVS_KEY_CONSUMED "consumed_uas"
+#define BATTERY_CAPACITY_UAS ((uint64_t)BATTERY_CAPACITY_MAH * 3600 * 1000)   // mAh → µA·s
+
+// 라디오가 켜진 동안 단계별 송신 비율 추정 (나머지는 수신 대기)
+// 스캔은 채널당 프로브 요청, FTM 은 요청/ACK 만 보내고 측정 프레임은 응답기가 보냄, 전송은 재시도와 ACK 대기가 대부분
+static const float phase_tx_duty[SWIFT_PHASE_COUNT] = {
+    [SWIFT_PHASE_SCAN] = 0.02f,
+    [SWIFT_PHASE_FTM] = 0.05f,
+    [SWIFT_PHASE_SEND] = 0.10f,
+};
+
+// 프로파일 누적 상태 (Deep Sleep 동안 RTC 슬로우 메모리에 유지)
+typedef struct {
+    uint32_t magic;                         // PROFILER_MAGIC 이면 유효
+    int64_t wake_rtc_us;                    // 다음 깨어남 예정 시각 (RTC 시계, 0 이면 모름)
+    uint32_t cycles;                        // 지난 전송 이후 완료된 깨어남 수
+    uint32_t phase_ms[SWIFT_PHASE_COUNT];   // 단계별 시간 합
+    uint32_t radio_on_ms;                   // 라디오 켜짐 시간 합
+    uint64_t charge_uas;                    // 소모 전하 합 (µA·s, 수면 포함)
+    uint64_t consumed_uas;                  // 배터리 장착 후 누적 소모 전하 (µA·s)
+    bool battery_loaded;                    // consumed_uas 가 NVS 또는 새 배터리로 초기화됐는지
+    uint8_t saved_level;                    // NVS 에 마지막으로 저장한 시점의 배터리 잔량
+} profiler_state_t;
+
+RTC_DATA_ATTR static profiler_state_t profile;
+
+// 이번 깨어남 계측 (일반 RAM)
+static struct {
+    bool started;
+    swift_phase_t phase;                    // 진행 중인 단계
+    int64_t since_us;                       // 진행 중인 구간 시작 (esp_timer)
+    bool radio_on;                          // Wi-Fi 라디오 켜짐
+    uint32_t phase_us[SWIFT_PHASE_COUNT];   // 단계별 시간
+    float phase_uas[SWIFT_PHASE_COUNT];     // 단계별 소모 전하 (µA·s)
+    uint32_t radio_on_us;                   // 라디오 켜짐 시간
+} cycle;
+
+static int64_t rtc_now_us(void) {
+    struct timeval tv_now;
+    gettimeofday(&tv_now, NULL);
+    return (int64_t)tv_now.tv_sec * 1000000 + tv_now.tv_usec;
+}
+
+// u16 포화
+static uint16_t saturate_u16(uint64_t value) {
+    return value > UINT16_MAX ? UINT16_MAX : (uint16_t)value;
+}
+
+// 단계와 라디오 상태로 본 평균 전류 (mA)
+static float phase_current_ma(swift_phase_t phase, bool radio_on) {
+    if (!radio_on) {
+        return PROFILER_CPU_MA;
+    }
+    return PROFILER_RX_MA + phase_tx_duty[phase] * (PROFILER_TX_MA - PROFILER_RX_MA);
+}
+
+// 진행 중인 구간을 현재 단계에 반영하고 새 구간 시작
+static void profiler_account(int64_t now_us) {
+    uint32_t elapsed_us = (uint32_t)(now_us - cycle.since_us);
+    cycle.phase_us[cycle.phase] += elapsed_us;
+    cycle.phase_uas[cycle.phase] += phase_current_ma(cycle.phase, cycle.radio_on) * elapsed_us / 1000.0f;
+    if (cycle.radio_on) {
+        cycle.radio_on_us += elapsed_us;
+    }
+    cycle.since_us = now_us;
+}
+
+// 누적 소모 전하로 본 잔량
+static uint8_t battery_level_of(uint64_t consumed_uas) {
+    if (consumed_uas >= BATTERY_CAPACITY_UAS) {
+        return 0;
+    }
+    return (uint8_t)(100 - consumed_uas * 100 / BATTERY_CAPACITY_UAS);
+}
+
+// 누적 소모 전하 NVS 저장 (잔량이 1% 떨어질 때마다, 배터리 수명 동안 100회 이하)
+static esp_err_t save_consumed(void) {
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(PROFILER_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_u64(nvs_handle, PROFILER_NVS_KEY_CONSUMED, profile.consumed_uas);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+    if (err == ESP_OK) {
+        profile.saved_level = battery_level_of(profile.consumed_uas);
+    }
+    return err;
+}
+
+
+// ===== 깨어남 계측 =====
+
+void phase_profiler_start(void) {
+    int64_t timer_us = esp_timer_get_time();
+    if (profile.magic != PROFILER_MAGIC) {
+        memset(&profile, 0, sizeof(profile));
+        profile.magic = PROFILER_MAGIC;
+    }
+
+    // 부팅 단계: 예정 깨어남 시각부터 지금까지 (ROM/부트로더 포함), 모르면 esp_timer 시작부터
+    int64_t boot_us = timer_us;
+    if (profile.wake_rtc_us != 0) {
+        int64_t since_wake_us = rtc_now_us() - profile.wake_rtc_us;
+        if (since_wake_us > 0 && since_wake_us < (int64_t)PROFILER_BOOT_MAX_MS * 1000) {
+            boot_us = since_wake_us;
+        }
+    }
+    profile.wake_rtc_us = 0;
+
+    memset(&cycle, 0, sizeof(cycle));
+    cycle.started = true;
+    cycle.phase = SWIFT_PHASE_BOOT;
+    cycle.since_us = timer_us - boot_us;
+    profiler_account(timer_us);
+    cycle.phase = SWIFT_PHASE_OTHER;
+}
+
+void phase_profiler_enter(swift_phase_t phase) {
+    if (!cycle.started || (unsigned)phase >= SWIFT_PHASE_COUNT) {
+        return;
+    }
+    profiler_account(esp_timer_get_time());
+    cycle.phase = phase;
+}
+
+void phase_profiler_radio_on(void) {
+    if (!cycle.started) {
+        return;
+    }
+    profiler_account(esp_timer_get_time());
+    cycle.radio_on = true;
+}
+
+void phase_profiler_finish_cycle(uint64_t sleep_us) {
+    if (!cycle.started) {
+        return;
+    }
+    profiler_account(esp_timer_get_time());
+    cycle.started = false;
+
+    float awake_uas = 0.0f;
+    for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+        awake_uas += cycle.phase_uas[i];
+    }
+    float sleep_uas = PROFILER_SLEEP_UA * (sleep_us / 1000000.0f);
+    uint64_t cycle_uas = (uint64_t)(awake_uas + sleep_uas + 0.5f);
+
+    profile.cycles++;
+    for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+        profile.phase_ms[i] += (cycle.phase_us[i] + 500) / 1000;
+    }
+    profile.radio_on_ms += (cycle.radio_on_us + 500) / 1000;
+    profile.charge_uas += cycle_uas;
+    profile.consumed_uas += cycle_uas;
+    profile.wake_rtc_us = rtc_now_us() + (int64_t)sleep_us;
+
+    char line[256];
+    int len = 0;
+    for (int i = 0; i < SWIFT_PHASE_COUNT && len < (int)sizeof(line); i++) {
+        if (cycle.phase_us[i] == 0) {
+            continue;
+        }
+        len += snprintf(&line[len], sizeof(line) - len, " %s %" PRIu32 "ms/%.1fmAs",
+                        swift_phase_name((swift_phase_t)i), cycle.phase_us[i] / 1000, cycle.phase_uas[i] / 1000.0f);
+    }
+    uint8_t level = battery_level_of(profile.consumed_uas);
+    ESP_LOGI(TAG, "깨어남 프로파일:%s, 라디오 %" PRIu32 " ms, 전하 %.1f mAs (수면 %.2f mAs), 배터리 %d%%",
+            line, cycle.radio_on_us / 1000, (awake_uas + sleep_uas) / 1000.0f, sleep_uas / 1000.0f, level);
+
+    if (profile.battery_loaded && level < profile.saved_level) {
+        esp_err_t err = save_consumed();
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "누적 소모 전하 저장 실패: %s", esp_err_to_name(err));
+        }
+    }
+}
+
+
+// ===== 리포트 =====
+
+bool phase_profiler_summary(swift_profile_t *out) {
+    if (profile.cycles == 0) {
+        return false;
+    }
+    out->cycles = profile.cycles > UINT8_MAX ? UINT8_MAX : (uint8_t)profile.cycles;
+    out->charge_dmas = saturate_u16(profile.charge_uas / profile.cycles / 100);
+    out->radio_on_ms = saturate_u16(profile.radio_on_ms / profile.cycles);
+    for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+        out->phase_ms[i] = saturate_u16(profile.phase_ms[i] / profile.cycles);
+    }
+    return true;
+}
+
+void phase_profiler_report_sent(void) {
+    profile.cycles = 0;
+    memset(profile.phase_ms, 0, sizeof(profile.phase_ms));
+    profile.radio_on_ms = 0;
+    profile.charge_uas = 0;
+}
+
+
+// ===== 배터리 =====
+
+esp_err_t phase_profiler_init_battery(void) {
+    if (profile.battery_loaded) {
+        return ESP_OK;
+    }
+
+    // 전원 인가 리셋은 배터리 교체로 보고 0 부터, 그 밖의 리셋 (패닉/브라운아웃/워치독) 은 NVS 값에서 이어감
+    esp_err_t err = ESP_OK;
+    if (esp_reset_reason() == ESP_RST_POWERON) {
+        profile.consumed_uas = 0;
+        err = save_consumed();
+        ESP_LOGI(TAG, "전원 인가: 새 배터리로 간주 (%d mAh)", BATTERY_CAPACITY_MAH);
+    } else {
+        nvs_handle_t nvs_handle;
+        uint64_t consumed_uas = 0;
+        err = nvs_open(PROFILER_NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+        if (err == ESP_OK) {
+            err = nvs_get_u64(nvs_handle, PROFILER_NVS_KEY_CONSUMED, &consumed_uas);
+            nvs_close(nvs_handle);
+        }
+        if (err == ESP_ERR_NVS_NOT_FOUND) {
+            err = ESP_OK;
+        }
+        profile.consumed_uas = consumed_uas;
+        profile.saved_level = battery_level_of(consumed_uas);
+        ESP_LOGI(TAG, "누적 소모 전하 로드: %.1f mAh (배터리 %d%%)",
+                consumed_uas / 3600000.0f, profile.saved_level);
+    }
+
+    // 로드에 실패해도 이번 깨어남부터 누적은 계속 (저장은 다음 1% 경계에서 다시 시도)
+    profile.battery_loaded = true;
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "누적 소모 전하 초기화 실패: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+uint8_t phase_profiler_battery_level(void) {
+    return battery_level_of(profile.consumed_uas);
+}
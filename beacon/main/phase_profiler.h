@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "swift_frame.h"
+
+// ===== 깨어남 단계 프로파일러 =====
+// 깨어남을 swift_phase_t 단계로 나눠 esp_timer 로 시간을 재고, 라디오 상태와 단계별 전류 모델로 소모 전하를 추정
+// 합계는 RTC 메모리에 누적해 다음 리포트에 SWIFT_EXT_PROFILE 로 싣고, 누적 소모 전하로 배터리 잔량을 계산
+// 전류 값은 ESP32-C6 데이터시트 기준 추정치 (실측 보드에 맞게 조정)
+#define PROFILER_CPU_MA 25.0f               // CPU 160MHz, 라디오 꺼짐
+#define PROFILER_RX_MA 78.0f                // Wi-Fi 켜짐 (수신 대기, 802.11n HT20)
+#define PROFILER_TX_MA 290.0f               // Wi-Fi 송신 (최대 출력 부근)
+#define PROFILER_SLEEP_UA 20.0f             // Deep Sleep 보드 전체 (칩 약 7µA + 레귤레이터/누설)
+#define PROFILER_BOOT_MAX_MS 5000           // 예정 시각과 이보다 크게 어긋나면 부팅 시간을 esp_timer 로 대체
+#define BATTERY_CAPACITY_MAH 2000           // 배터리 용량 (AA 2개 기준)
+
+// 이번 깨어남 계측 시작 (app_main 첫 줄, 이전 Deep Sleep 예정 시각과의 차이를 부팅 단계로 기록)
+void phase_profiler_start(void);
+
+// 현재 단계를 닫고 다음 단계 시작 (단계 밖의 처리는 SWIFT_PHASE_OTHER)
+void phase_profiler_enter(swift_phase_t phase);
+
+// Wi-Fi 라디오가 켜진 시점 표시 (esp_wifi_start 직후, 이후 Deep Sleep 까지 켜진 것으로 봄)
+void phase_profiler_radio_on(void);
+
+// 누적 소모 전하 준비 (NVS 초기화 직후, 전원 인가 리셋이면 새 배터리로 보고 0 부터)
+esp_err_t phase_profiler_init_battery(void);
+
+// 누적 소모 전하로 계산한 배터리 잔량 (0-100%)
+uint8_t phase_profiler_battery_level(void);
+
+// 지난 전송 이후 완료된 깨어남의 평균 프로파일 (집계한 깨어남이 없으면 false)
+bool phase_profiler_summary(swift_profile_t *out);
+
+// 리포트 전송 성공: 프로파일 집계를 비움
+void phase_profiler_report_sent(void);
+
+// 이번 깨어남을 닫고 뒤따를 수면 전하까지 누적 (Deep Sleep 직전)
+void phase_profiler_finish_cycle(uint64_t sleep_us);
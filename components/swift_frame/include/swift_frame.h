@@ -0,0 +1,198 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// ===== 비콘 → 게이트웨이 ESP-NOW 프레임 형식 =====
+//
+// 헤더 바이트: 상위 4비트 = 프레임 종류, 하위 4비트 = 형식 버전
+// 모든 다중 바이트 값은 리틀 엔디언이며 패딩 없이 연속 배치됨
+//
+// 비콘 리포트 v1:
+//   u8  header                 (SWIFT_FRAME_BEACON_REPORT_V1)
+//   u8  serial_len             (1 ~ SWIFT_SERIAL_MAX_LEN)
+//   u8  serial[serial_len]
+//   u8  battery_level          (%)
+//   i8  floor
+//   u8  measurement_count      (0 ~ SWIFT_FRAME_MAX_MEASUREMENTS)
+//   measurement_count x {
+//       u8  anchor_mac[6]
+//       u16 distance_mm        (0 ~ 65.535 m)
+//       u16 variance_cm2       (1e-4 m² 단위, 6.5535 m² 에서 포화)
+//       i8  rssi
+//       u8  sample_count
+//       u16 rtt_ns
+//   }
+//   이후 남은 바이트는 확장 필드 {u8 type, u8 len, u8 data[len]} 의 나열
+//   (디코더는 모르는 type 을 건너뜀)
+//
+// 비콘 리포트 확장 필드:
+//   SWIFT_EXT_SEQUENCE (len 4): u32 사이클 번호 (비콘 RTC 메모리, 측정 사이클마다 1 증가,
+//                               재전송/다른 게이트웨이로의 재시도는 같은 번호, 전원 인가 시 임의 값부터)
+//   SWIFT_EXT_PROFILE (len 5 + 2n): 지난 전송 이후 완료된 깨어남의 평균 전력 프로파일
+//       u8  cycles             집계한 깨어남 수 (RSSI 확인만 하고 잠든 깨어남 포함, 255 에서 포화)
+//       u16 charge_dmas        깨어남 한 번의 평균 소모 전하 (0.1 mAs 단위, 뒤따르는 수면 포함)
+//       u16 radio_on_ms        깨어남 한 번의 평균 라디오 켜짐 시간
+//       u16 phase_ms[n]        단계별 평균 시간 (swift_phase_t 순서, 디코더는 모르는 뒤쪽 단계를 무시)
+//
+// ===== 게이트웨이 → 브로드캐스트 이웃 리포트 =====
+//
+// 층 브로드캐스트를 대체 (이전 형식은 층 번호 i8 1바이트)
+//
+// 이웃 리포트 v1:
+//   u8  header                 (SWIFT_FRAME_NEIGHBOR_REPORT_V1)
+//   u8  bssid[6]               송신 게이트웨이 AP BSSID (FTM 응답 MAC)
+//   u8  channel
+//   i8  floor
+//   u8  neighbor_count         (0 ~ SWIFT_NEIGHBOR_MAX)
+//   neighbor_count x {
+//       u8  bssid[6]           주변에서 들린 다른 게이트웨이 AP BSSID
+//       u8  channel
+//       i8  floor
+//       i8  rssi               송신 게이트웨이에서 들린 세기
+//   }
+//   이후 확장 필드는 비콘 리포트와 동일
+//
+// ===== 게이트웨이 → 브로드캐스트 TDMA 슬롯 배정 =====
+//
+// 비콘 리포트를 받은 게이트웨이가 바로 브로드캐스트 (피어 등록 없이, 비콘은 시리얼로 자기 것만 받음)
+//
+// 슬롯 배정 v1:
+//   u8  header                 (SWIFT_FRAME_SLOT_ASSIGN_V1)
+//   u8  serial_len             (1 ~ SWIFT_SERIAL_MAX_LEN)
+//   u8  serial[serial_len]     대상 비콘 시리얼
+//   u8  slot                   배정 슬롯 번호 (0 ~ slot_count-1)
+//   u8  slot_count             슈퍼프레임당 슬롯 수
+//   u16 superframe_ms          슈퍼프레임 길이
+//   u16 offset_ms              송신 시점부터 배정 슬롯 시작까지 (0 ~ superframe_ms-1)
+//   이후 확장 필드는 비콘 리포트와 동일
+
+#define SWIFT_FRAME_TYPE_BEACON_REPORT 0x1
+#define SWIFT_FRAME_TYPE_NEIGHBOR_REPORT 0x2
+#define SWIFT_FRAME_TYPE_SLOT_ASSIGN 0x3
+#define SWIFT_FRAME_VERSION_1 0x1
+#define SWIFT_FRAME_HEADER(type, version) ((uint8_t)(((type) << 4) | ((version) & 0x0F)))
+#define SWIFT_FRAME_TYPE(header) ((uint8_t)((header) >> 4))
+#define SWIFT_FRAME_VERSION(header) ((uint8_t)((header) & 0x0F))
+#define SWIFT_FRAME_BEACON_REPORT_V1 SWIFT_FRAME_HEADER(SWIFT_FRAME_TYPE_BEACON_REPORT, SWIFT_FRAME_VERSION_1)
+#define SWIFT_FRAME_NEIGHBOR_REPORT_V1 SWIFT_FRAME_HEADER(SWIFT_FRAME_TYPE_NEIGHBOR_REPORT, SWIFT_FRAME_VERSION_1)
+#define SWIFT_FRAME_SLOT_ASSIGN_V1 SWIFT_FRAME_HEADER(SWIFT_FRAME_TYPE_SLOT_ASSIGN, SWIFT_FRAME_VERSION_1)
+
+#define SWIFT_EXT_SEQUENCE 0x01           // 비콘 리포트 확장 필드: 사이클 번호
+#define SWIFT_EXT_PROFILE 0x02            // 비콘 리포트 확장 필드: 깨어남 단계별 전력 프로파일
+
+#define SWIFT_SERIAL_MAX_LEN 9              // 시리얼 번호 최대 길이 (NUL 제외)
+#define SWIFT_FRAME_MAX_MEASUREMENTS 6      // 프레임당 최대 앵커 측정값 수
+#define SWIFT_FRAME_MEASUREMENT_SIZE 14     // 측정값 하나의 인코딩 크기
+#define SWIFT_FRAME_MAX_SIZE 250            // ESP-NOW 최대 페이로드
+#define SWIFT_NEIGHBOR_MAX 16               // 이웃 리포트당 최대 이웃 게이트웨이 수
+#define SWIFT_NEIGHBOR_ENTRY_SIZE 9         // 이웃 하나의 인코딩 크기
+#define SWIFT_NEIGHBOR_HEADER_SIZE 10       // 이웃 목록 앞부분 크기
+
+// 레거시 고정 구조체 (beacon_data_packet_t, 3개 측정값 + 128바이트 타임스탬프) 크기
+#define SWIFT_LEGACY_FRAME_SIZE 212
+
+// 앵커 측정값
+typedef struct {
+    uint8_t anchor_mac[6];                  // 앵커(게이트웨이) MAC 주소
+    float distance_meters;                  // 거리 (미터)
+    float variance;                         // 측정 분산 (m²)
+    int8_t rssi;                            // 신호 강도
+    uint8_t sample_count;                   // 사용된 유효 샘플 개수
+    uint32_t rtt_nanoseconds;               // RTT (왕복 시간, 나노초)
+} swift_measurement_t;
+
+// 비콘 깨어남 단계 (SWIFT_EXT_PROFILE 의 phase_ms 순서, 뒤에만 추가할 것)
+typedef enum {
+    SWIFT_PHASE_BOOT = 0,                   // 깨어남 → app_main (ROM, 부트로더, 앱 로딩)
+    SWIFT_PHASE_NVS,                        // NVS 초기화
+    SWIFT_PHASE_WIFI_INIT,                  // Wi-Fi 드라이버 초기화와 시작
+    SWIFT_PHASE_SCAN,                       // AP 스캔 (0단계 RSSI 확인 포함)
+    SWIFT_PHASE_FTM,                        // 채널별 FTM 측정
+    SWIFT_PHASE_FLOOR_WAIT,                 // 채널별 층/이웃 브로드캐스트 대기
+    SWIFT_PHASE_SEND,                       // ESP-NOW 전송과 슬롯 배정 대기
+    SWIFT_PHASE_OTHER,                      // 그 밖의 처리 (ESP-NOW 초기화, 층 계산, 인코딩, 로그 등)
+    SWIFT_PHASE_COUNT
+} swift_phase_t;
+
+// 깨어남 전력 프로파일 (SWIFT_EXT_PROFILE)
+typedef struct {
+    uint8_t cycles;                         // 집계한 깨어남 수
+    uint16_t charge_dmas;                   // 깨어남당 평균 소모 전하 (0.1 mAs)
+    uint16_t radio_on_ms;                   // 깨어남당 평균 라디오 켜짐 시간
+    uint16_t phase_ms[SWIFT_PHASE_COUNT];   // 단계별 평균 시간
+} swift_profile_t;
+
+// 디코딩된 비콘 리포트
+typedef struct {
+    char serial_number[SWIFT_SERIAL_MAX_LEN + 1];   // 비콘 시리얼 번호
+    uint8_t battery_level;                  // 배터리 잔량 (%)
+    int8_t floor;                           // 층 번호 (-99~99)
+    uint8_t measurement_count;              // 유효 측정값 수
+    swift_measurement_t measurements[SWIFT_FRAME_MAX_MEASUREMENTS];
+    bool has_sequence;                      // 사이클 번호 포함 여부 (레거시/이전 펌웨어는 false)
+    uint32_t sequence;                      // 사이클 번호 (SWIFT_EXT_SEQUENCE)
+    bool has_profile;                       // 전력 프로파일 포함 여부
+    swift_profile_t profile;                // 전력 프로파일 (SWIFT_EXT_PROFILE)
+} swift_beacon_report_t;
+
+// 이웃 게이트웨이
+typedef struct {
+    uint8_t bssid[6];                       // AP BSSID (FTM 응답 MAC)
+    uint8_t channel;                        // 채널 번호
+    int8_t floor;                           // 층 번호
+    int8_t rssi;                            // 송신 게이트웨이에서 들린 세기
+} swift_neighbor_t;
+
+// 디코딩된 이웃 리포트 (레거시 1바이트 층 브로드캐스트는 bssid 0, channel 0, 이웃 0개)
+typedef struct {
+    uint8_t bssid[6];                       // 송신 게이트웨이 AP BSSID
+    uint8_t channel;                        // 송신 게이트웨이 채널
+    int8_t floor;                           // 송신 게이트웨이 층 번호
+    uint8_t neighbor_count;                 // 이웃 수
+    swift_neighbor_t neighbors[SWIFT_NEIGHBOR_MAX];
+} swift_neighbor_report_t;
+
+// 디코딩된 슬롯 배정
+typedef struct {
+    char serial_number[SWIFT_SERIAL_MAX_LEN + 1];   // 대상 비콘 시리얼 (NUL 종료)
+    uint8_t slot;                           // 배정 슬롯 번호
+    uint8_t slot_count;                     // 슈퍼프레임당 슬롯 수
+    uint16_t superframe_ms;                 // 슈퍼프레임 길이
+    uint16_t offset_ms;                     // 송신 시점부터 배정 슬롯 시작까지
+} swift_slot_assignment_t;
+
+// 비콘 리포트를 v1 프레임으로 인코딩
+esp_err_t swift_frame_encode_report(const swift_beacon_report_t *report,
+                                    uint8_t *buf, size_t buf_size, size_t *out_len);
+
+// 수신 프레임 디코딩 (v1 프레임과 레거시 고정 구조체 모두 허용)
+esp_err_t swift_frame_decode_report(const uint8_t *data, size_t len, swift_beacon_report_t *out);
+
+// 비콘 리포트 프레임처럼 보이는지 (v1 헤더 또는 레거시 크기)
+bool swift_frame_is_beacon_report(const uint8_t *data, size_t len);
+
+// 깨어남 단계 이름 ("boot", "nvs", ... 범위 밖은 "unknown")
+const char *swift_phase_name(swift_phase_t phase);
+
+// 이웃 리포트를 v1 프레임으로 인코딩
+esp_err_t swift_frame_encode_neighbor_report(const swift_neighbor_report_t *report,
+                                             uint8_t *buf, size_t buf_size, size_t *out_len);
+
+// 이웃 리포트 디코딩 (v1 프레임과 레거시 1바이트 층 브로드캐스트 모두 허용)
+esp_err_t swift_frame_decode_neighbor_report(const uint8_t *data, size_t len, swift_neighbor_report_t *out);
+
+// 층/이웃 브로드캐스트처럼 보이는지 (v1 헤더 또는 레거시 1바이트)
+bool swift_frame_is_neighbor_report(const uint8_t *data, size_t len);
+
+// 슬롯 배정을 v1 프레임으로 인코딩
+esp_err_t swift_frame_encode_slot_assignment(const swift_slot_assignment_t *assignment,
+                                             uint8_t *buf, size_t buf_size, size_t *out_len);
+
+// 슬롯 배정 디코딩
+esp_err_t swift_frame_decode_slot_assignment(const uint8_t *data, size_t len, swift_slot_assignment_t *out);
+
+// 슬롯 배정 프레임처럼 보이는지
+bool swift_frame_is_slot_assignment(const uint8_t *data, size_t len);
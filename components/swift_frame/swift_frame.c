@@ -0,0 +1,419 @@
+#include <string.h>
+#include "swift_frame.h"
+
+// ===== 레거시 형식 =====
+
+// 이전 펌웨어가 전송하던 고정 구조체 (디코딩 전용)
+typedef struct {
+    char serial_number[10];
+    uint8_t battery_level;
+    int8_t floor;
+    char timestamp[128];                    // 항상 빈 문자열로 전송됨
+    struct {
+        uint8_t anchor_mac[6];
+        float distance_meters;
+        float variance;
+        int8_t rssi;
+        uint8_t sample_count;
+        uint32_t rtt_nanoseconds;
+    } measurements[3];                      // 빈 슬롯은 MAC=0
+} swift_legacy_packet_t;
+
+_Static_assert(sizeof(swift_legacy_packet_t) == SWIFT_LEGACY_FRAME_SIZE, "레거시 구조체 크기 불일치");
+
+// SWIFT_EXT_PROFILE 인코딩 길이
+#define SWIFT_PROFILE_EXT_LEN (5 + 2 * SWIFT_PHASE_COUNT)
+
+// 깨어남 단계 이름 (swift_phase_t 순서)
+static const char *const phase_names[SWIFT_PHASE_COUNT] = {
+    "boot", "nvs", "wifi_init", "scan", "ftm", "floor_wait", "send", "other",
+};
+
+
+// ===== 바이트 인코딩 유틸리티 =====
+
+// u16 리틀 엔디언 쓰기
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+// u16 리틀 엔디언 읽기
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// 0 이상 실수를 고정 소수점 u16 으로 변환 (범위 밖은 포화)
+static uint16_t to_fixed_u16(float value, float scale) {
+    float scaled = value * scale + 0.5f;
+    if (!(scaled > 0.0f)) {
+        return 0;
+    }
+    if (scaled >= 65535.0f) {
+        return 0xFFFF;
+    }
+    return (uint16_t)scaled;
+}
+
+// 맥 주소가 모두 0인지 확인 (레거시 빈 슬롯)
+static bool mac_is_zero(const uint8_t *mac) {
+    for (int i = 0; i < 6; i++) {
+        if (mac[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// ===== 디코더 =====
+
+// 레거시 고정 구조체 디코딩
+static esp_err_t decode_legacy(const uint8_t *data, swift_beacon_report_t *out) {
+    swift_legacy_packet_t legacy;
+    memcpy(&legacy, data, sizeof(legacy));
+
+    memset(out, 0, sizeof(*out));
+    memcpy(out->serial_number, legacy.serial_number, SWIFT_SERIAL_MAX_LEN);
+    out->serial_number[SWIFT_SERIAL_MAX_LEN] = '\0';
+    out->battery_level = legacy.battery_level;
+    out->floor = legacy.floor;
+
+    for (int i = 0; i < 3; i++) {
+        if (mac_is_zero(legacy.measurements[i].anchor_mac)) {
+            continue;
+        }
+        swift_measurement_t *m = &out->measurements[out->measurement_count++];
+        memcpy(m->anchor_mac, legacy.measurements[i].anchor_mac, 6);
+        m->distance_meters = legacy.measurements[i].distance_meters;
+        m->variance = legacy.measurements[i].variance;
+        m->rssi = legacy.measurements[i].rssi;
+        m->sample_count = legacy.measurements[i].sample_count;
+        m->rtt_nanoseconds = legacy.measurements[i].rtt_nanoseconds;
+    }
+    return ESP_OK;
+}
+
+// v1 프레임 디코딩
+static esp_err_t decode_v1(const uint8_t *data, size_t len, swift_beacon_report_t *out) {
+    size_t pos = 1;
+
+    memset(out, 0, sizeof(*out));
+    if (pos + 1 > len) return ESP_ERR_INVALID_SIZE;
+    uint8_t serial_len = data[pos++];
+    if (serial_len == 0 || serial_len > SWIFT_SERIAL_MAX_LEN || pos + serial_len + 3 > len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(out->serial_number, &data[pos], serial_len);
+    out->serial_number[serial_len] = '\0';
+    pos += serial_len;
+
+    out->battery_level = data[pos++];
+    out->floor = (int8_t)data[pos++];
+    uint8_t count = data[pos++];
+    if (count > SWIFT_FRAME_MAX_MEASUREMENTS || pos + (size_t)count * SWIFT_FRAME_MEASUREMENT_SIZE > len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const uint8_t *p = &data[pos];
+        swift_measurement_t *m = &out->measurements[i];
+        memcpy(m->anchor_mac, p, 6);
+        m->distance_meters = get_u16(p + 6) / 1000.0f;
+        m->variance = get_u16(p + 8) / 10000.0f;
+        m->rssi = (int8_t)p[10];
+        m->sample_count = p[11];
+        m->rtt_nanoseconds = get_u16(p + 12);
+        pos += SWIFT_FRAME_MEASUREMENT_SIZE;
+    }
+    out->measurement_count = count;
+
+    // 확장 필드: 아는 type 만 해석하고 모르는 type 은 건너뜀
+    while (pos < len) {
+        if (pos + 2 > len || pos + 2 + data[pos + 1] > len) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        uint8_t type = data[pos];
+        uint8_t field_len = data[pos + 1];
+        const uint8_t *value = &data[pos + 2];
+        if (type == SWIFT_EXT_SEQUENCE && field_len == 4) {
+            out->sequence = (uint32_t)get_u16(value) | ((uint32_t)get_u16(value + 2) << 16);
+            out->has_sequence = true;
+        } else if (type == SWIFT_EXT_PROFILE && field_len >= 5 && (field_len - 5) % 2 == 0) {
+            swift_profile_t *profile = &out->profile;
+            profile->cycles = value[0];
+            profile->charge_dmas = get_u16(value + 1);
+            profile->radio_on_ms = get_u16(value + 3);
+            int phases = (field_len - 5) / 2;
+            for (int i = 0; i < phases && i < SWIFT_PHASE_COUNT; i++) {
+                profile->phase_ms[i] = get_u16(value + 5 + 2 * i);
+            }
+            out->has_profile = true;
+        }
+        pos += 2 + field_len;
+    }
+    return ESP_OK;
+}
+
+
+// ===== 공개 함수 =====
+
+// 비콘 리포트를 v1 프레임으로 인코딩
+esp_err_t swift_frame_encode_report(const swift_beacon_report_t *report,
+                                    uint8_t *buf, size_t buf_size, size_t *out_len) {
+    size_t serial_len = strnlen(report->serial_number, SWIFT_SERIAL_MAX_LEN);
+    if (serial_len == 0 || report->measurement_count > SWIFT_FRAME_MAX_MEASUREMENTS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t needed = 1 + 1 + serial_len + 3 + (size_t)report->measurement_count * SWIFT_FRAME_MEASUREMENT_SIZE +
+                    (report->has_sequence ? 2 + 4 : 0) +
+                    (report->has_profile ? 2 + SWIFT_PROFILE_EXT_LEN : 0);
+    if (needed > buf_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t pos = 0;
+    buf[pos++] = SWIFT_FRAME_BEACON_REPORT_V1;
+    buf[pos++] = (uint8_t)serial_len;
+    memcpy(&buf[pos], report->serial_number, serial_len);
+    pos += serial_len;
+    buf[pos++] = report->battery_level;
+    buf[pos++] = (uint8_t)report->floor;
+    buf[pos++] = report->measurement_count;
+
+    for (int i = 0; i < report->measurement_count; i++) {
+        const swift_measurement_t *m = &report->measurements[i];
+        uint8_t *p = &buf[pos];
+        memcpy(p, m->anchor_mac, 6);
+        put_u16(p + 6, to_fixed_u16(m->distance_meters, 1000.0f));
+        put_u16(p + 8, to_fixed_u16(m->variance, 10000.0f));
+        p[10] = (uint8_t)m->rssi;
+        p[11] = m->sample_count;
+        put_u16(p + 12, m->rtt_nanoseconds > 0xFFFF ? 0xFFFF : (uint16_t)m->rtt_nanoseconds);
+        pos += SWIFT_FRAME_MEASUREMENT_SIZE;
+    }
+
+    // 확장 필드
+    if (report->has_sequence) {
+        buf[pos++] = SWIFT_EXT_SEQUENCE;
+        buf[pos++] = 4;
+        put_u16(&buf[pos], (uint16_t)(report->sequence & 0xFFFF));
+        put_u16(&buf[pos + 2], (uint16_t)(report->sequence >> 16));
+        pos += 4;
+    }
+    if (report->has_profile) {
+        const swift_profile_t *profile = &report->profile;
+        buf[pos++] = SWIFT_EXT_PROFILE;
+        buf[pos++] = SWIFT_PROFILE_EXT_LEN;
+        buf[pos++] = profile->cycles;
+        put_u16(&buf[pos], profile->charge_dmas);
+        put_u16(&buf[pos + 2], profile->radio_on_ms);
+        pos += 4;
+        for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+            put_u16(&buf[pos], profile->phase_ms[i]);
+            pos += 2;
+        }
+    }
+
+    *out_len = pos;
+    return ESP_OK;
+}
+
+// 수신 프레임 디코딩
+esp_err_t swift_frame_decode_report(const uint8_t *data, size_t len, swift_beacon_report_t *out) {
+    if (len == SWIFT_LEGACY_FRAME_SIZE) {
+        return decode_legacy(data, out);
+    }
+    if (len < 1 || SWIFT_FRAME_TYPE(data[0]) != SWIFT_FRAME_TYPE_BEACON_REPORT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (SWIFT_FRAME_VERSION(data[0]) != SWIFT_FRAME_VERSION_1) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    return decode_v1(data, len, out);
+}
+
+// 이웃 리포트 v1 프레임으로 인코딩
+esp_err_t swift_frame_encode_neighbor_report(const swift_neighbor_report_t *report,
+                                             uint8_t *buf, size_t buf_size, size_t *out_len) {
+    if (report->neighbor_count > SWIFT_NEIGHBOR_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t needed = SWIFT_NEIGHBOR_HEADER_SIZE + (size_t)report->neighbor_count * SWIFT_NEIGHBOR_ENTRY_SIZE;
+    if (needed > buf_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t pos = 0;
+    buf[pos++] = SWIFT_FRAME_NEIGHBOR_REPORT_V1;
+    memcpy(&buf[pos], report->bssid, 6);
+    pos += 6;
+    buf[pos++] = report->channel;
+    buf[pos++] = (uint8_t)report->floor;
+    buf[pos++] = report->neighbor_count;
+
+    for (int i = 0; i < report->neighbor_count; i++) {
+        const swift_neighbor_t *n = &report->neighbors[i];
+        memcpy(&buf[pos], n->bssid, 6);
+        buf[pos + 6] = n->channel;
+        buf[pos + 7] = (uint8_t)n->floor;
+        buf[pos + 8] = (uint8_t)n->rssi;
+        pos += SWIFT_NEIGHBOR_ENTRY_SIZE;
+    }
+
+    *out_len = pos;
+    return ESP_OK;
+}
+
+// 이웃 리포트 디코딩
+esp_err_t swift_frame_decode_neighbor_report(const uint8_t *data, size_t len, swift_neighbor_report_t *out) {
+    memset(out, 0, sizeof(*out));
+
+    // 레거시: 층 번호 1바이트
+    if (len == 1) {
+        out->floor = (int8_t)data[0];
+        return ESP_OK;
+    }
+    if (len < 1 || SWIFT_FRAME_TYPE(data[0]) != SWIFT_FRAME_TYPE_NEIGHBOR_REPORT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (SWIFT_FRAME_VERSION(data[0]) != SWIFT_FRAME_VERSION_1) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (len < SWIFT_NEIGHBOR_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t pos = 1;
+    memcpy(out->bssid, &data[pos], 6);
+    pos += 6;
+    out->channel = data[pos++];
+    out->floor = (int8_t)data[pos++];
+    uint8_t count = data[pos++];
+    if (count > SWIFT_NEIGHBOR_MAX || pos + (size_t)count * SWIFT_NEIGHBOR_ENTRY_SIZE > len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const uint8_t *p = &data[pos];
+        swift_neighbor_t *n = &out->neighbors[i];
+        memcpy(n->bssid, p, 6);
+        n->channel = p[6];
+        n->floor = (int8_t)p[7];
+        n->rssi = (int8_t)p[8];
+        pos += SWIFT_NEIGHBOR_ENTRY_SIZE;
+    }
+    out->neighbor_count = count;
+
+    // 확장 필드: 구조만 검증
+    while (pos < len) {
+        if (pos + 2 > len || pos + 2 + data[pos + 1] > len) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        pos += 2 + data[pos + 1];
+    }
+    return ESP_OK;
+}
+
+// 슬롯 배정 인코딩
+esp_err_t swift_frame_encode_slot_assignment(const swift_slot_assignment_t *assignment,
+                                             uint8_t *buf, size_t buf_size, size_t *out_len) {
+    size_t serial_len = strnlen(assignment->serial_number, SWIFT_SERIAL_MAX_LEN);
+    if (serial_len == 0 || assignment->slot_count == 0 || assignment->slot >= assignment->slot_count ||
+        assignment->offset_ms >= assignment->superframe_ms) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t needed = 1 + 1 + serial_len + 6;
+    if (needed > buf_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t pos = 0;
+    buf[pos++] = SWIFT_FRAME_SLOT_ASSIGN_V1;
+    buf[pos++] = (uint8_t)serial_len;
+    memcpy(&buf[pos], assignment->serial_number, serial_len);
+    pos += serial_len;
+    buf[pos++] = assignment->slot;
+    buf[pos++] = assignment->slot_count;
+    put_u16(&buf[pos], assignment->superframe_ms);
+    pos += 2;
+    put_u16(&buf[pos], assignment->offset_ms);
+    pos += 2;
+
+    *out_len = pos;
+    return ESP_OK;
+}
+
+// 슬롯 배정 디코딩
+esp_err_t swift_frame_decode_slot_assignment(const uint8_t *data, size_t len, swift_slot_assignment_t *out) {
+    memset(out, 0, sizeof(*out));
+
+    if (len < 1 || SWIFT_FRAME_TYPE(data[0]) != SWIFT_FRAME_TYPE_SLOT_ASSIGN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (SWIFT_FRAME_VERSION(data[0]) != SWIFT_FRAME_VERSION_1) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (len < 2) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t pos = 1;
+    uint8_t serial_len = data[pos++];
+    if (serial_len == 0 || serial_len > SWIFT_SERIAL_MAX_LEN || pos + serial_len + 6 > len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(out->serial_number, &data[pos], serial_len);
+    out->serial_number[serial_len] = '\0';
+    pos += serial_len;
+    out->slot = data[pos++];
+    out->slot_count = data[pos++];
+    out->superframe_ms = get_u16(&data[pos]);
+    pos += 2;
+    out->offset_ms = get_u16(&data[pos]);
+    pos += 2;
+    if (out->slot_count == 0 || out->slot >= out->slot_count || out->offset_ms >= out->superframe_ms) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 확장 필드: 구조만 검증
+    while (pos < len) {
+        if (pos + 2 > len || pos + 2 + data[pos + 1] > len) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        pos += 2 + data[pos + 1];
+    }
+    return ESP_OK;
+}
+
+// 비콘 리포트 프레임처럼 보이는지
+bool swift_frame_is_beacon_report(const uint8_t *data, size_t len) {
+    if (len == SWIFT_LEGACY_FRAME_SIZE) {
+        return true;
+    }
+    return len > 1 && SWIFT_FRAME_TYPE(data[0]) == SWIFT_FRAME_TYPE_BEACON_REPORT;
+}
+
+// 깨어남 단계 이름
+const char *swift_phase_name(swift_phase_t phase) {
+    if ((unsigned)phase >= SWIFT_PHASE_COUNT) {
+        return "unknown";
+    }
+    return phase_names[phase];
+}
+
+// 층/이웃 브로드캐스트처럼 보이는지
+bool swift_frame_is_neighbor_report(const uint8_t *data, size_t len) {
+    if (len == 1) {
+        return true;
+    }
+    return len > 1 && SWIFT_FRAME_TYPE(data[0]) == SWIFT_FRAME_TYPE_NEIGHBOR_REPORT;
+}
+
+// 슬롯 배정 프레임처럼 보이는지
+bool swift_frame_is_slot_assignment(const uint8_t *data, size_t len) {
+    return len > 1 && SWIFT_FRAME_TYPE(data[0]) == SWIFT_FRAME_TYPE_SLOT_ASSIGN;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_log.h"
+
+// ===== 바이너리 트레이스 =====
+//
+// 핫 패스(패킷마다, FTM 세션마다)의 텍스트 로그 대신 16바이트 고정 레코드를 RAM 링에 기록
+// 부동소수점 포맷팅과 UART 대기가 없고, 덤프할 때만 16진수 줄로 내보냄
+// 덤프 줄은 호스트에서 tools/swift_trace_decode.py 로 읽을 수 있는 텍스트로 변환
+//
+// 덤프 줄 형식: "@SWT <첫 레코드 번호 hex8> <레코드 hex32>..."
+//   레코드 번호는 부팅 후 기록 순번 (번호가 건너뛰면 덤프 전에 덮어써져 잃은 레코드)
+//
+// 레코드 (리틀 엔디언, 16바이트):
+//   u32 time_us                (esp_timer 하위 32비트)
+//   u8  event                  (swift_trace_event_t)
+//   u8  u8
+//   u16 u16
+//   i32 a
+//   i32 b
+//
+// 이벤트별 인자 의미는 아래 표의 설명 문자열 (디코더가 이 헤더를 읽어 그대로 포맷에 사용)
+//   {u8} {s8} {u16}: 원래 값 (s8 은 u8 을 부호 있는 값으로)
+//   {a} {b}: 원래 값, {am} {bm}: 1/1000 배 (mm → m), {bu}: 1/1000000 배
+//   {k16}: u16 / 1000, {cm16}: u16 / 100, {mac}: u16 을 MAC 뒤 2바이트로, {serial}: b 를 시리얼 끝 4글자로
+
+#define SWIFT_TRACE_EVENTS(X) \
+    X(GW_REPORT,        0x01, "report {serial} seq={a} measurements={u8}") \
+    X(GW_DUPLICATE,     0x02, "duplicate {serial} seq={a}") \
+    X(GW_KALMAN_INIT,   0x03, "kalman init ..:{mac} distance={am:.3f}m variance={bu:.4f}") \
+    X(GW_KALMAN_UPDATE, 0x04, "kalman update measurement={am:.3f}m estimate={bm:.3f}m gain={k16:.3f} flags={u8}") \
+    X(GW_MEASUREMENT,   0x05, "measurement ..:{mac} filtered={am:.3f}m raw={bm:.3f}m rssi={s8}") \
+    X(GW_POSITION,      0x06, "position x={am:.3f} y={bm:.3f} accuracy={cm16:.2f}m anchors={u8}") \
+    X(BC_FTM_REPORT,    0x10, "ftm report status={u8} entries={u16} accumulated={a}") \
+    X(BC_FTM_SESSION,   0x11, "ftm session #{u8} frames={u16} channel={a} requested={b}") \
+    X(BC_FTM_RESULT,    0x12, "ftm cumulative distance={am:.3f}m ci={bm:.3f}m valid={u8}/{u16}") \
+    X(BC_FTM_FINAL,     0x13, "ftm final distance={am:.3f}m rtt={b}ns valid={u16} sessions={u8}") \
+    X(BC_SEND,          0x14, "send gateway={u8} attempt={u16} latency={a}us")
+
+// 이벤트 번호
+typedef enum {
+#define SWIFT_TRACE_ENUM(name, id, description) SWIFT_TRACE_##name = id,
+    SWIFT_TRACE_EVENTS(SWIFT_TRACE_ENUM)
+#undef SWIFT_TRACE_ENUM
+} swift_trace_event_t;
+
+// 링 크기 (레코드 수, 2의 거듭제곱, 기본 4KB)
+#ifndef SWIFT_TRACE_RING_RECORDS
+#define SWIFT_TRACE_RING_RECORDS 256
+#endif
+
+_Static_assert((SWIFT_TRACE_RING_RECORDS & (SWIFT_TRACE_RING_RECORDS - 1)) == 0,
+               "SWIFT_TRACE_RING_RECORDS 는 2의 거듭제곱이어야 함");
+
+// 디버그 프로파일 (1 이면 핫 패스 텍스트 로그도 출력, idf.py -DSWIFT_TRACE_TEXT_LOG=1 build)
+#ifndef SWIFT_TRACE_TEXT_LOG
+#define SWIFT_TRACE_TEXT_LOG 0
+#endif
+
+// 핫 패스 텍스트 로그: 디버그 프로파일이 아니면 코드가 생성되지 않음 (인자는 타입 검사만)
+#if SWIFT_TRACE_TEXT_LOG
+#define SWIFT_TRACE_LOGI(tag, format, ...) ESP_LOGI(tag, format, ##__VA_ARGS__)
+#else
+#define SWIFT_TRACE_LOGI(tag, format, ...) do { if (0) { ESP_LOGI(tag, format, ##__VA_ARGS__); } } while (0)
+#endif
+
+// 레코드 하나 기록 (어느 태스크에서든 호출 가능, 링이 가득 차면 가장 오래된 레코드를 덮어씀)
+void swift_trace(swift_trace_event_t event, uint8_t u8, uint16_t u16, int32_t a, int32_t b);
+
+// 마지막 덤프 이후 쌓인 레코드 수 (덮어써진 것 포함)
+uint32_t swift_trace_pending(void);
+
+// 마지막 덤프 이후 레코드를 16진수 줄로 로그 출력 (핫 패스 밖에서 호출)
+void swift_trace_dump(void);
+
+// 미터 → 밀리미터 정수 (int32 범위에서 포화)
+int32_t swift_trace_milli(float value);
+
+// 값 → 1e-6 단위 정수 (int32 범위에서 포화)
+int32_t swift_trace_micro(float value);
+
+// MAC 뒤 2바이트 ({mac})
+static inline uint16_t swift_trace_mac_tail(const uint8_t *mac) {
+    return (uint16_t)((mac[4] << 8) | mac[5]);
+}
+
+// 시리얼 끝 4글자를 리틀 엔디언 정수로 ({serial})
+int32_t swift_trace_serial_tail(const char *serial_number);
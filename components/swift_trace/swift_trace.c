@@ -0,0 +1,128 @@
+#include <inttypes.h>
+#include <string.h>
+#include "swift_trace.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+static const char *TAG = "SWIFT_TRACE";
+
+#define TRACE_MASK (SWIFT_TRACE_RING_RECORDS - 1)
+#define TRACE_RECORDS_PER_LINE 4            // 덤프 줄 하나에 담는 레코드 수
+
+// 레코드 (덤프 시 메모리 그대로 16진수로 출력, 리틀 엔디언 대상)
+typedef struct __attribute__((packed)) {
+    uint32_t time_us;                       // esp_timer 하위 32비트
+    uint8_t event;                          // swift_trace_event_t
+    uint8_t u8;
+    uint16_t u16;
+    int32_t a;
+    int32_t b;
+} trace_record_t;
+
+_Static_assert(sizeof(trace_record_t) == 16, "트레이스 레코드는 16바이트");
+
+// written 은 부팅 후 기록 순번, dumped 는 다음 덤프 시작 순번 (둘 다 자유 증가 카운터)
+static trace_record_t ring[SWIFT_TRACE_RING_RECORDS];
+static uint32_t written = 0;
+static uint32_t dumped = 0;
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;  // 기록 태스크들 ↔ 덤프
+
+
+// ===== 기록 =====
+
+// 레코드 하나 기록
+void swift_trace(swift_trace_event_t event, uint8_t u8, uint16_t u16, int32_t a, int32_t b) {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+
+    portENTER_CRITICAL(&trace_lock);
+    trace_record_t *record = &ring[written & TRACE_MASK];
+    record->time_us = now;
+    record->event = (uint8_t)event;
+    record->u8 = u8;
+    record->u16 = u16;
+    record->a = a;
+    record->b = b;
+    written++;
+    portEXIT_CRITICAL(&trace_lock);
+}
+
+// 마지막 덤프 이후 쌓인 레코드 수
+uint32_t swift_trace_pending(void) {
+    portENTER_CRITICAL(&trace_lock);
+    uint32_t pending = written - dumped;
+    portEXIT_CRITICAL(&trace_lock);
+    return pending;
+}
+
+
+// ===== 덤프 =====
+
+// 마지막 덤프 이후 레코드를 줄 단위로 출력 (락은 레코드 복사 동안만 잡음)
+void swift_trace_dump(void) {
+    trace_record_t batch[TRACE_RECORDS_PER_LINE];
+    char line[TRACE_RECORDS_PER_LINE * sizeof(trace_record_t) * 2 + 1];
+    static const char hex[] = "0123456789abcdef";
+
+    while (1) {
+        portENTER_CRITICAL(&trace_lock);
+        // 덮어써진 레코드는 건너뜀 (디코더가 순번 차이로 손실을 표시)
+        if (written - dumped > SWIFT_TRACE_RING_RECORDS) {
+            dumped = written - SWIFT_TRACE_RING_RECORDS;
+        }
+        uint32_t first = dumped;
+        int count = 0;
+        while (count < TRACE_RECORDS_PER_LINE && dumped != written) {
+            batch[count++] = ring[dumped & TRACE_MASK];
+            dumped++;
+        }
+        portEXIT_CRITICAL(&trace_lock);
+
+        if (count == 0) {
+            break;
+        }
+
+        const uint8_t *bytes = (const uint8_t *)batch;
+        size_t len = count * sizeof(trace_record_t);
+        for (size_t i = 0; i < len; i++) {
+            line[2 * i] = hex[bytes[i] >> 4];
+            line[2 * i + 1] = hex[bytes[i] & 0x0F];
+        }
+        line[2 * len] = '\0';
+        ESP_LOGI(TAG, "@SWT %08" PRIx32 " %s", first, line);
+    }
+}
+
+
+// ===== 인자 변환 =====
+
+// 실수 → 정수 (포화, 범위 밖 float → int 변환은 정의되지 않은 동작이므로 먼저 자름)
+static int32_t saturate(float scaled) {
+    if (scaled >= 2147483647.0f) {
+        return INT32_MAX;
+    }
+    if (scaled <= -2147483648.0f) {
+        return INT32_MIN;
+    }
+    return (int32_t)scaled;
+}
+
+// 미터 → 밀리미터 정수
+int32_t swift_trace_milli(float value) {
+    return saturate(value * 1000.0f);
+}
+
+// 값 → 1e-6 단위 정수
+int32_t swift_trace_micro(float value) {
+    return saturate(value * 1000000.0f);
+}
+
+// 시리얼 끝 4글자 (짧으면 앞에서부터, 남는 바이트는 0)
+int32_t swift_trace_serial_tail(const char *serial_number) {
+    size_t len = strlen(serial_number);
+    const char *tail = len > 4 ? serial_number + len - 4 : serial_number;
+    uint32_t packed = 0;
+    for (int i = 0; i < 4 && tail[i] != '\0'; i++) {
+        packed |= (uint32_t)(uint8_t)tail[i] << (8 * i);
+    }
+    return (int32_t)packed;
+}
@@ -0,0 +1,211 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "nvs.h"
+#include "anchor_registry.h"
+
+static const char *TAG = "ANCHOR_REG";
+
+// 등록된 앵커 (RAM 사본, 조회는 여기서만 수행)
+typedef struct {
+    uint8_t mac[6];
+    anchor_position_t position;
+} anchor_entry_t;
+
+static anchor_entry_t anchors[ANCHOR_REGISTRY_MAX];
+static int anchor_count = 0;
+static portMUX_TYPE anchor_lock = portMUX_INITIALIZER_UNLOCKED;     // 콘솔 태스크 ↔ 데이터 중계 태스크
+
+
+// ===== 내부 함수 =====
+
+// MAC → NVS 키 ("aabbccddeeff")
+static void mac_to_key(const uint8_t *mac, char *key) {
+    snprintf(key, 13, "%02x%02x%02x%02x%02x%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+// NVS 키 → MAC
+static bool key_to_mac(const char *key, uint8_t *mac) {
+    unsigned int b[6];
+    if (strlen(key) != 12 ||
+        sscanf(key, "%2x%2x%2x%2x%2x%2x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) != 6) {
+        return false;
+    }
+    for (int i = 0; i < 6; i++) {
+        mac[i] = (uint8_t)b[i];
+    }
+    return true;
+}
+
+// RAM 테이블에서 앵커 위치 찾기 (anchor_lock 보유 상태에서 호출)
+static int find_index(const uint8_t *mac) {
+    for (int i = 0; i < anchor_count; i++) {
+        if (memcmp(anchors[i].mac, mac, 6) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+// ===== 공개 함수 =====
+
+// NVS 에서 등록된 앵커 좌표 전체 로드
+esp_err_t anchor_registry_load(void) {
+    nvs_handle_t nvs_handle;
+    portENTER_CRITICAL(&anchor_lock);
+    anchor_count = 0;
+    portEXIT_CRITICAL(&anchor_lock);
+
+    esp_err_t err = nvs_open(ANCHOR_REGISTRY_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "등록된 앵커 없음 (게이트웨이 위치 계산 비활성)");
+        return err;
+    }
+
+    nvs_iterator_t it = NULL;
+    err = nvs_entry_find(NVS_DEFAULT_PART_NAME, ANCHOR_REGISTRY_NAMESPACE, NVS_TYPE_BLOB, &it);
+    int loaded = 0;
+    while (err == ESP_OK && loaded < ANCHOR_REGISTRY_MAX) {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+
+        // NVS 는 잠금 밖에서 읽고, 다 채운 항목만 테이블에 추가
+        anchor_entry_t entry;
+        size_t len = sizeof(entry.position);
+        if (key_to_mac(info.key, entry.mac) &&
+            nvs_get_blob(nvs_handle, info.key, &entry.position, &len) == ESP_OK &&
+            len == sizeof(entry.position)) {
+            portENTER_CRITICAL(&anchor_lock);
+            anchors[anchor_count++] = entry;
+            portEXIT_CRITICAL(&anchor_lock);
+            loaded++;
+        } else {
+            ESP_LOGW(TAG, "잘못된 앵커 항목 무시: %s", info.key);
+        }
+        err = nvs_entry_next(&it);
+    }
+    nvs_release_iterator(it);
+    nvs_close(nvs_handle);
+
+    ESP_LOGI(TAG, "앵커 좌표 %d개 로드", loaded);
+    return ESP_OK;
+}
+
+// 앵커 좌표 등록/갱신 후 NVS 에 저장
+esp_err_t anchor_registry_set(const uint8_t *mac, const anchor_position_t *position) {
+    portENTER_CRITICAL(&anchor_lock);
+    bool full = find_index(mac) < 0 && anchor_count >= ANCHOR_REGISTRY_MAX;
+    portEXIT_CRITICAL(&anchor_lock);
+    if (full) {
+        ESP_LOGE(TAG, "앵커 레지스트리 가득 참 (%d개)", ANCHOR_REGISTRY_MAX);
+        return ESP_ERR_NO_MEM;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(ANCHOR_REGISTRY_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS 열기 실패");
+        return err;
+    }
+
+    char key[13];
+    mac_to_key(mac, key);
+    err = nvs_set_blob(nvs_handle, key, position, sizeof(*position));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "앵커 좌표 저장 실패: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    // 새 항목은 MAC 과 좌표를 다 쓴 뒤에 개수를 늘려 조회에 보이게 함 (쓰기는 콘솔 태스크 하나뿐)
+    portENTER_CRITICAL(&anchor_lock);
+    int index = find_index(mac);
+    if (index >= 0) {
+        anchors[index].position = *position;
+    } else if (anchor_count < ANCHOR_REGISTRY_MAX) {
+        memcpy(anchors[anchor_count].mac, mac, 6);
+        anchors[anchor_count].position = *position;
+        anchor_count++;
+    }
+    portEXIT_CRITICAL(&anchor_lock);
+    ESP_LOGI(TAG, "앵커 등록: "MACSTR" (%.2f, %.2f, %.2f)",
+            MAC2STR(mac), position->x, position->y, position->z);
+    return ESP_OK;
+}
+
+// 앵커 등록 해제
+esp_err_t anchor_registry_remove(const uint8_t *mac) {
+    portENTER_CRITICAL(&anchor_lock);
+    bool found = find_index(mac) >= 0;
+    portEXIT_CRITICAL(&anchor_lock);
+    if (!found) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(ANCHOR_REGISTRY_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS 열기 실패");
+        return err;
+    }
+
+    char key[13];
+    mac_to_key(mac, key);
+    err = nvs_erase_key(nvs_handle, key);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "앵커 삭제 실패: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    // 마지막 항목으로 빈자리 채움
+    portENTER_CRITICAL(&anchor_lock);
+    int index = find_index(mac);
+    if (index >= 0) {
+        anchors[index] = anchors[--anchor_count];
+    }
+    portEXIT_CRITICAL(&anchor_lock);
+    ESP_LOGI(TAG, "앵커 삭제: "MACSTR, MAC2STR(mac));
+    return ESP_OK;
+}
+
+// 앵커 좌표 조회 (잠금 안에서 복사)
+bool anchor_registry_lookup(const uint8_t *mac, anchor_position_t *out) {
+    portENTER_CRITICAL(&anchor_lock);
+    int index = find_index(mac);
+    if (index >= 0) {
+        *out = anchors[index].position;
+    }
+    portEXIT_CRITICAL(&anchor_lock);
+    return index >= 0;
+}
+
+// 등록된 앵커 수
+int anchor_registry_count(void) {
+    portENTER_CRITICAL(&anchor_lock);
+    int count = anchor_count;
+    portEXIT_CRITICAL(&anchor_lock);
+    return count;
+}
+
+// index 번째 등록 앵커 (잠금 안에서 복사)
+bool anchor_registry_get(int index, uint8_t *mac_out, anchor_position_t *out) {
+    portENTER_CRITICAL(&anchor_lock);
+    bool found = index >= 0 && index < anchor_count;
+    if (found) {
+        memcpy(mac_out, anchors[index].mac, 6);
+        *out = anchors[index].position;
+    }
+    portEXIT_CRITICAL(&anchor_lock);
+    return found;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// ===== 앵커 좌표 레지스트리 =====
+// 앵커(게이트웨이) MAC 별 설치 좌표를 NVS 네임스페이스 ANCHOR_REGISTRY_NAMESPACE 에 저장
+// (키 = MAC 16진수 12자, 값 = anchor_position_t blob)
+// 등록/삭제는 콘솔 태스크, 조회는 데이터 중계 태스크에서 하므로 RAM 테이블은 잠금 안에서만 읽고 씀
+// (조회 결과는 포인터가 아니라 복사본으로 돌려줌)
+#define ANCHOR_REGISTRY_NAMESPACE "anchor_reg"
+#define ANCHOR_REGISTRY_MAX 32              // 등록 가능한 최대 앵커 수
+
+// 앵커 설치 좌표 (건물 기준 좌표계, 미터)
+typedef struct {
+    float x;
+    float y;
+    float z;                                // 설치 높이
+} anchor_position_t;
+
+// NVS 에서 등록된 앵커 좌표 전체 로드 (부팅 시 1회)
+esp_err_t anchor_registry_load(void);
+
+// 앵커 좌표 등록/갱신 후 NVS 에 저장
+esp_err_t anchor_registry_set(const uint8_t *mac, const anchor_position_t *position);
+
+// 앵커 등록 해제 (NVS 에서도 삭제), 없으면 ESP_ERR_NOT_FOUND
+esp_err_t anchor_registry_remove(const uint8_t *mac);
+
+// 앵커 좌표를 out 에 복사, 등록되지 않았으면 false
+bool anchor_registry_lookup(const uint8_t *mac, anchor_position_t *out);
+
+// 등록된 앵커 수
+int anchor_registry_count(void);
+
+// index 번째 등록 앵커의 MAC 과 좌표 복사 (목록 출력용), 범위를 벗어나면 false
+bool anchor_registry_get(int index, uint8_t *mac_out, anchor_position_t *out);
@@ -0,0 +1,207 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include "beacon_table.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+
+static const char *TAG = "BEACON_TABLE";
+
+// 해시 인덱스 크기 (부하율 0.5 이하 유지)
+#define BEACON_INDEX_SIZE (BEACON_TABLE_CAPACITY * 2)
+#define SLOT_EMPTY (-1)
+
+// ===== 테이블 상태 =====
+// 엔트리는 고정 위치 배열에 두고, 개방 주소법(선형 탐사) 인덱스는 엔트리 번호만 가짐
+// → 제거 시 인덱스만 당겨 채우므로 엔트리 포인터가 움직이지 않음
+static beacon_anchor_entry_t entries[BEACON_TABLE_CAPACITY];
+static int16_t slot_index[BEACON_INDEX_SIZE];
+static int16_t free_head;                   // 빈 엔트리 목록 (lru_next 로 연결)
+static int16_t lru_head;                    // 가장 최근 수신 엔트리
+static int16_t lru_tail;                    // 가장 오래 수신 없는 엔트리
+static beacon_table_stats_t stats;
+
+
+// ===== 내부 함수 =====
+
+// (시리얼, 앵커 MAC) 해시 (FNV-1a)
+static uint32_t key_hash(const char *serial_number, const uint8_t *anchor_mac) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < (int)sizeof(entries[0].serial_number) && serial_number[i] != '\0'; i++) {
+        h = (h ^ (uint8_t)serial_number[i]) * 16777619u;
+    }
+    for (int i = 0; i < 6; i++) {
+        h = (h ^ anchor_mac[i]) * 16777619u;
+    }
+    return h;
+}
+
+// 키의 기본 인덱스 위치
+static uint32_t home_slot(const char *serial_number, const uint8_t *anchor_mac) {
+    return key_hash(serial_number, anchor_mac) % BEACON_INDEX_SIZE;
+}
+
+// 엔트리 키 비교
+static bool key_equals(const beacon_anchor_entry_t *e, const char *serial_number, const uint8_t *anchor_mac) {
+    return memcmp(e->anchor_mac, anchor_mac, 6) == 0 &&
+           strncmp(e->serial_number, serial_number, sizeof(e->serial_number)) == 0;
+}
+
+// LRU 목록에서 떼어내기
+static void lru_unlink(int16_t idx) {
+    beacon_anchor_entry_t *e = &entries[idx];
+    if (e->lru_prev != SLOT_EMPTY) {
+        entries[e->lru_prev].lru_next = e->lru_next;
+    } else {
+        lru_head = e->lru_next;
+    }
+    if (e->lru_next != SLOT_EMPTY) {
+        entries[e->lru_next].lru_prev = e->lru_prev;
+    } else {
+        lru_tail = e->lru_prev;
+    }
+}
+
+// LRU 목록 맨 앞 (가장 최근) 에 붙이기
+static void lru_push_front(int16_t idx) {
+    beacon_anchor_entry_t *e = &entries[idx];
+    e->lru_prev = SLOT_EMPTY;
+    e->lru_next = lru_head;
+    if (lru_head != SLOT_EMPTY) {
+        entries[lru_head].lru_prev = idx;
+    }
+    lru_head = idx;
+    if (lru_tail == SLOT_EMPTY) {
+        lru_tail = idx;
+    }
+}
+
+// 엔트리 제거: 인덱스에서 지우고 뒤따르는 탐사 체인을 당겨 채움 (툼스톤 없음)
+static void remove_entry(int16_t idx) {
+    beacon_anchor_entry_t *e = &entries[idx];
+    uint32_t pos = home_slot(e->serial_number, e->anchor_mac);
+    while (slot_index[pos] != idx) {
+        pos = (pos + 1) % BEACON_INDEX_SIZE;
+    }
+
+    uint32_t hole = pos;
+    uint32_t next = pos;
+    while (true) {
+        next = (next + 1) % BEACON_INDEX_SIZE;
+        int16_t moved = slot_index[next];
+        if (moved == SLOT_EMPTY) {
+            break;
+        }
+        // 기본 위치가 (hole, next] 구간에 있으면 그대로 두어야 탐사가 끊기지 않음
+        uint32_t home = home_slot(entries[moved].serial_number, entries[moved].anchor_mac);
+        bool stays = (hole <= next) ? (hole < home && home <= next)
+                                    : (hole < home || home <= next);
+        if (!stays) {
+            slot_index[hole] = moved;
+            hole = next;
+        }
+    }
+    slot_index[hole] = SLOT_EMPTY;
+
+    lru_unlink(idx);
+    e->lru_next = free_head;
+    free_head = idx;
+    stats.count--;
+}
+
+// 타임아웃된 엔트리 정리 (LRU 끝에서부터, 만료된 만큼만 확인)
+static void expire_old_entries(uint32_t now_ms) {
+    while (lru_tail != SLOT_EMPTY && now_ms - entries[lru_tail].last_seen >= BEACON_TIMEOUT_MS) {
+        ESP_LOGD(TAG, "오래된 엔트리 제거: %s - "MACSTR,
+                entries[lru_tail].serial_number, MAC2STR(entries[lru_tail].anchor_mac));
+        remove_entry(lru_tail);
+        stats.expired++;
+    }
+}
+
+
+// ===== 공개 함수 =====
+
+// 테이블 비우기
+void beacon_table_init(void) {
+    for (int i = 0; i < BEACON_INDEX_SIZE; i++) {
+        slot_index[i] = SLOT_EMPTY;
+    }
+    for (int i = 0; i < BEACON_TABLE_CAPACITY; i++) {
+        entries[i].lru_next = (i + 1 < BEACON_TABLE_CAPACITY) ? (int16_t)(i + 1) : SLOT_EMPTY;
+    }
+    free_head = 0;
+    lru_head = SLOT_EMPTY;
+    lru_tail = SLOT_EMPTY;
+    memset(&stats, 0, sizeof(stats));
+}
+
+// 기존 엔트리 찾기 또는 새로 생성
+beacon_anchor_entry_t *beacon_table_find_or_create(const char *serial_number, const uint8_t *anchor_mac,
+                                                   uint32_t now_ms) {
+    expire_old_entries(now_ms);
+
+    // 인덱스 탐사
+    uint32_t pos = home_slot(serial_number, anchor_mac);
+    uint32_t probe = 1;
+    while (slot_index[pos] != SLOT_EMPTY) {
+        int16_t idx = slot_index[pos];
+        if (key_equals(&entries[idx], serial_number, anchor_mac)) {
+            if (probe > stats.max_probe) {
+                stats.max_probe = probe;
+            }
+            entries[idx].last_seen = now_ms;
+            if (lru_head != idx) {
+                lru_unlink(idx);
+                lru_push_front(idx);
+            }
+            return &entries[idx];
+        }
+        pos = (pos + 1) % BEACON_INDEX_SIZE;
+        probe++;
+    }
+
+    // 가득 찼으면 가장 오래 수신 없는 엔트리를 밀어냄 (횟수는 통계로 보고)
+    if (free_head == SLOT_EMPTY) {
+        ESP_LOGD(TAG, "테이블 가득 참 (%d개), 가장 오래된 엔트리 밀어냄: %s - "MACSTR,
+                BEACON_TABLE_CAPACITY, entries[lru_tail].serial_number,
+                MAC2STR(entries[lru_tail].anchor_mac));
+        remove_entry(lru_tail);
+        stats.evicted++;
+
+        // 제거로 탐사 체인이 당겨졌을 수 있으므로 빈 자리 다시 찾기
+        pos = home_slot(serial_number, anchor_mac);
+        while (slot_index[pos] != SLOT_EMPTY) {
+            pos = (pos + 1) % BEACON_INDEX_SIZE;
+        }
+    }
+
+    int16_t idx = free_head;
+    beacon_anchor_entry_t *entry = &entries[idx];
+    free_head = entry->lru_next;
+
+    memset(entry, 0, sizeof(*entry));
+    strncpy(entry->serial_number, serial_number, sizeof(entry->serial_number) - 1);
+    memcpy(entry->anchor_mac, anchor_mac, 6);
+    entry->last_seen = now_ms;
+    entry->kf_state.initialized = false;
+    slot_index[pos] = idx;
+    lru_push_front(idx);
+
+    stats.count++;
+    stats.inserted++;
+    ESP_LOGD(TAG, "새 엔트리 생성: %s - "MACSTR" (총 %" PRIu32 "개)",
+            serial_number, MAC2STR(anchor_mac), stats.count);
+    return entry;
+}
+
+// 비콘 위치 추적 엔트리 찾기 또는 새로 생성
+beacon_anchor_entry_t *beacon_table_find_or_create_position(const char *serial_number, uint32_t now_ms) {
+    static const uint8_t position_key[6] = {0};
+    return beacon_table_find_or_create(serial_number, position_key, now_ms);
+}
+
+// 테이블 통계 복사
+void beacon_table_get_stats(beacon_table_stats_t *out) {
+    *out = stats;
+}
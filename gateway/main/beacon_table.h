@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include "kalman_filter.h"
+#include "position_tracker.h"
+
+// ===== 비콘-앵커 상태 테이블 설정 =====
+// 용량은 빌드 시 결정 (main/CMakeLists.txt 에서 target_compile_definitions 로 변경 가능)
+// 엔트리 하나당 약 60바이트 + 해시 인덱스 4바이트
+#ifndef BEACON_TABLE_CAPACITY
+#define BEACON_TABLE_CAPACITY 1024          // 최대 (비콘, 앵커) 엔트리 수
+#endif
+#define BEACON_TIMEOUT_MS 60000             // 이 시간 동안 수신 없는 엔트리는 만료 (1분)
+
+_Static_assert(BEACON_TABLE_CAPACITY > 0 && BEACON_TABLE_CAPACITY < 0x8000,
+               "BEACON_TABLE_CAPACITY 는 1 ~ 32767 사이여야 함");
+
+// 비콘-앵커 추적 엔트리
+// anchor_mac 이 모두 0 인 엔트리는 앵커가 아닌 비콘 자체의 위치 추적 상태를 가짐
+typedef struct {
+    char serial_number[10];                 // 비콘 시리얼 번호
+    uint8_t anchor_mac[6];                  // 앵커 MAC 주소
+    union {
+        kalman_filter_state_t kf_state;     // 앵커 거리 칼만 필터 상태
+        position_track_t position;          // 비콘 위치 추적 상태 (위치 엔트리)
+    };
+    uint32_t last_seen;                     // 마지막 수신 시간
+    int16_t lru_prev;                       // LRU 목록 이전 엔트리 (더 최근)
+    int16_t lru_next;                       // LRU 목록 다음 엔트리 (더 오래됨)
+} beacon_anchor_entry_t;
+
+// 테이블 통계
+typedef struct {
+    uint32_t count;                         // 현재 엔트리 수
+    uint32_t inserted;                      // 새로 만든 엔트리 수
+    uint32_t expired;                       // 타임아웃으로 제거된 엔트리 수
+    uint32_t evicted;                       // 테이블이 가득 차 밀려난 (가장 오래된) 엔트리 수
+    uint32_t max_probe;                     // 조회 시 최장 탐사 길이
+} beacon_table_stats_t;
+
+// 테이블 비우기
+void beacon_table_init(void);
+
+// (시리얼, 앵커 MAC) 엔트리 찾기, 없으면 새로 생성 (kf_state.initialized = false)
+// 타임아웃된 엔트리를 먼저 정리하고, 그래도 가득 차 있으면 가장 오래 수신 없는 엔트리를 밀어냄
+// 반환된 포인터는 해당 엔트리가 제거되기 전까지 유효
+beacon_anchor_entry_t *beacon_table_find_or_create(const char *serial_number, const uint8_t *anchor_mac,
+                                                   uint32_t now_ms);
+
+// 비콘 위치 추적 엔트리 찾기 또는 새로 생성 (position.initialized = false)
+beacon_anchor_entry_t *beacon_table_find_or_create_position(const char *serial_number, uint32_t now_ms);
+
+// 테이블 통계 복사
+void beacon_table_get_stats(beacon_table_stats_t *out);
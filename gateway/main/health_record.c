@@ -0,0 +1,103 @@
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "health_record.h"
+
+// ===== 쓰기 버퍼 =====
+// 넘치면 overflow 만 표시하고 이후 쓰기는 무시 (마지막에 한 번만 검사)
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    bool overflow;
+} health_out_t;
+
+// printf 형식으로 이어 쓰기
+static void put_format(health_out_t *out, const char *format, ...) {
+    if (out->overflow) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(&out->buf[out->len], out->size - out->len, format, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= out->size - out->len) {
+        out->overflow = true;
+        return;
+    }
+    out->len += (size_t)n;
+}
+
+// 게이트웨이 이름 (콘솔 입력이므로 JSON 문자열을 깨는 문자는 '_' 로 바꿈)
+static void put_name(health_out_t *out, const char *name) {
+    put_format(out, "\"");
+    for (const char *p = name; *p != '\0' && !out->overflow; p++) {
+        char c = (*p == '"' || *p == '\\' || (unsigned char)*p < 0x20) ? '_' : *p;
+        put_format(out, "%c", c);
+    }
+    put_format(out, "\"");
+}
+
+// 단계 히스토그램 하나
+static void put_histogram(health_out_t *out, const pipeline_histogram_t *hist) {
+    put_format(out, "{\"count\":%" PRIu32 ",\"avg\":%" PRIu32 ",\"p50\":%" PRIu32 ",\"p99\":%" PRIu32
+               ",\"max\":%" PRIu32 ",\"buckets\":[",
+               hist->count, hist->count ? (uint32_t)(hist->sum_us / hist->count) : 0,
+               pipeline_histogram_percentile(hist, 50), pipeline_histogram_percentile(hist, 99), hist->max_us);
+    for (int i = 0; i < PIPELINE_HIST_BUCKETS; i++) {
+        put_format(out, i ? ",%" PRIu32 : "%" PRIu32, hist->buckets[i]);
+    }
+    put_format(out, "]}");
+}
+
+
+// ===== 직렬화 =====
+
+// 상태 레코드를 JSON 객체로 직렬화
+esp_err_t health_record_encode_json(const health_record_t *record, char *buf, size_t buf_size, size_t *out_len) {
+    health_out_t out = { .buf = buf, .size = buf_size, .len = 0, .overflow = buf_size == 0 };
+
+    put_format(&out, "{\"gateway\":");
+    put_name(&out, record->gateway);
+    put_format(&out, ",\"timestamp\":%" PRId64 ",\"uptime_sec\":%" PRIu32
+               ",\"free_heap\":%" PRIu32 ",\"min_free_heap\":%" PRIu32,
+               record->timestamp_ms, record->uptime_sec, record->free_heap, record->min_free_heap);
+
+    put_format(&out, ",\"ingest\":{\"received\":%" PRIu32 ",\"ring_dropped\":%" PRIu32
+               ",\"decode_errors\":%" PRIu32 ",\"unknown_frames\":%" PRIu32
+               ",\"duplicates\":%" PRIu32 ",\"lost\":%" PRIu32 "}",
+               record->received, record->ring_dropped, record->decode_errors, record->unknown_frames,
+               record->duplicates, record->lost);
+
+    put_format(&out, ",\"uplink\":{\"records_sent\":%" PRIu32 ",\"records_dropped\":%" PRIu32
+               ",\"records_failed\":%" PRIu32 ",\"records_spooled\":%" PRIu32 ",\"spool_pending\":%" PRIu32
+               ",\"http\":{\"retries\":%" PRIu32 ",\"2xx\":%" PRIu32 ",\"4xx\":%" PRIu32 ",\"5xx\":%" PRIu32
+               ",\"other\":%" PRIu32 ",\"transport_errors\":%" PRIu32 ",\"last_status\":%d}}",
+               record->records_sent, record->records_dropped, record->records_failed, record->records_spooled,
+               record->spool_pending, record->http.retries, record->http.status_2xx, record->http.status_4xx,
+               record->http.status_5xx, record->http.status_other, record->http.transport_errors,
+               record->http.last_status);
+
+    put_format(&out, ",\"evictions\":{\"beacon_table\":%" PRIu32 ",\"beacon_table_expired\":%" PRIu32
+               ",\"seq_tracker\":%" PRIu32 ",\"slot_reclaimed\":%" PRIu32 ",\"slot_shared\":%" PRIu32 "}",
+               record->beacon_table_evicted, record->beacon_table_expired, record->seq_evicted,
+               record->slot_reclaimed, record->slot_shared);
+
+    put_format(&out, ",\"latency_us\":{");
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        put_format(&out, stage ? ",\"%s\":" : "\"%s\":", pipeline_stage_name((pipeline_stage_t)stage));
+        put_histogram(&out, &record->latency[stage]);
+    }
+    put_format(&out, "},\"bucket_upper_us\":[");
+    for (int i = 0; i < PIPELINE_HIST_BUCKETS - 1; i++) {
+        put_format(&out, i ? ",%" PRIu32 : "%" PRIu32, pipeline_bucket_upper_us(i));
+    }
+    put_format(&out, "]}");
+
+    if (out.overflow) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    *out_len = out.len;
+    return ESP_OK;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "pipeline_metrics.h"
+
+// ===== 게이트웨이 상태 레코드 =====
+// 수신/업로드 카운터와 단계별 지연 히스토그램을 주기적으로 서버에 올려 시리얼 모니터 없이 정체 구간을 찾음
+#define HEALTH_RECORD_MAX_LEN 2048          // 상태 레코드 JSON 최대 길이 (히스토그램 5개 포함 약 1.3KB)
+
+// 상태 레코드 (모든 카운터는 부팅 후 누적)
+typedef struct {
+    const char *gateway;                    // 게이트웨이 이름
+    int64_t timestamp_ms;                   // 수집 시각 (UTC epoch 밀리초)
+    uint32_t uptime_sec;                    // 부팅 후 경과 시간
+    uint32_t free_heap;                     // 현재 / 최소 여유 힙 (바이트)
+    uint32_t min_free_heap;
+
+    // 수신 단계
+    uint32_t received;                      // 수신 링에 넣은 프레임 수
+    uint32_t ring_dropped;                  // 수신 링이 가득 차 버린 프레임 수
+    uint32_t decode_errors;                 // 디코딩 실패
+    uint32_t unknown_frames;                // 종류를 알 수 없는 프레임
+    uint32_t duplicates;                    // 버린 중복 리포트
+    uint32_t lost;                          // 사이클 번호로 본 손실
+
+    // 업로드 단계
+    uint32_t records_sent;                  // 전송 성공 레코드
+    uint32_t records_dropped;               // 레코드 버퍼가 가득 차 버린 레코드
+    uint32_t records_failed;                // 전송도 스풀 보관도 못 한 레코드
+    uint32_t records_spooled;               // 스풀에 보관한 레코드
+    uint32_t spool_pending;                 // 스풀에 남은 레코드
+    pipeline_http_stats_t http;             // HTTP 재시도 / 상태 코드
+
+    // 테이블 밀려남
+    uint32_t beacon_table_evicted;          // 비콘 상태 테이블 (가득 차 밀려남 / 만료)
+    uint32_t beacon_table_expired;
+    uint32_t seq_evicted;                   // 사이클 번호 추적기
+    uint32_t slot_reclaimed;                // TDMA 슬롯 (만료 회수 / 공유)
+    uint32_t slot_shared;
+
+    pipeline_histogram_t latency[PIPELINE_STAGE_COUNT];     // 단계별 지연
+} health_record_t;
+
+// 상태 레코드를 JSON 객체로 직렬화 (NUL 종료, 버퍼가 부족하면 ESP_ERR_INVALID_SIZE)
+// {"gateway", "timestamp", "uptime_sec", "free_heap", "min_free_heap",
+//  "ingest": {...}, "uplink": {..., "http": {...}}, "evictions": {...},
+//  "latency_us": {"ring": {"count", "avg", "p50", "p99", "max", "buckets": [...]}, ...},
+//  "bucket_upper_us": [...]}
+esp_err_t health_record_encode_json(const health_record_t *record, char *buf, size_t buf_size, size_t *out_len);
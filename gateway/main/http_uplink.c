@@ -0,0 +1,153 @@
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_http_client.h"
+#include "http_uplink.h"
+
+// ===== 설정 상수 =====
+#define HTTP_UPLINK_TIMEOUT_MS 5000         // 요청 타임아웃
+#define HTTP_UPLINK_BUFFER_SIZE 2048        // 수신 버퍼 크기
+#define HTTP_UPLINK_KEEPALIVE_IDLE_SEC 5    // TCP keep-alive 유휴 시간
+#define HTTP_UPLINK_KEEPALIVE_INTERVAL_SEC 5
+#define HTTP_UPLINK_KEEPALIVE_COUNT 3
+
+static const char *TAG = "HTTP_UPLINK";
+
+// ===== 전역 변수 =====
+static esp_http_client_handle_t s_client = NULL;   // 프로그램 수명 동안 유지되는 클라이언트
+static const char *s_url = NULL;
+static bool s_new_connection = false;              // 이번 요청에서 새 TCP 연결이 맺어졌는지
+static http_uplink_stats_t s_stats = {0};
+
+
+// ===== 내부 함수 =====
+
+// HTTP 클라이언트 이벤트 핸들러 (연결 수립/해제 추적)
+static esp_err_t http_uplink_event_handler(esp_http_client_event_t *evt) {
+    switch (evt->event_id) {
+        case HTTP_EVENT_ON_CONNECTED:
+            s_new_connection = true;
+            break;
+
+        case HTTP_EVENT_DISCONNECTED:
+            ESP_LOGD(TAG, "연결 종료 (연결당 요청 %" PRIu32 "개 처리)", s_stats.current_conn_requests);
+            break;
+
+        default:
+            break;
+    }
+    return ESP_OK;
+}
+
+// 클라이언트 생성
+static esp_err_t http_uplink_create_client(void) {
+    esp_http_client_config_t config = {
+        .url = s_url,
+        .method = HTTP_METHOD_POST,
+        .timeout_ms = HTTP_UPLINK_TIMEOUT_MS,
+        .buffer_size = HTTP_UPLINK_BUFFER_SIZE,
+        .keep_alive_enable = true,
+        .keep_alive_idle = HTTP_UPLINK_KEEPALIVE_IDLE_SEC,
+        .keep_alive_interval = HTTP_UPLINK_KEEPALIVE_INTERVAL_SEC,
+        .keep_alive_count = HTTP_UPLINK_KEEPALIVE_COUNT,
+        .event_handler = http_uplink_event_handler,
+    };
+
+    s_client = esp_http_client_init(&config);
+    if (s_client == NULL) {
+        ESP_LOGE(TAG, "HTTP 클라이언트 초기화 실패");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// 한 번의 POST 수행
+static esp_err_t http_uplink_perform(const char *content_type, const char *body, size_t len) {
+    esp_http_client_set_header(s_client, "Content-Type", content_type);
+    esp_http_client_set_post_field(s_client, body, (int)len);
+    return esp_http_client_perform(s_client);
+}
+
+
+// ===== 공개 함수 =====
+
+// 영구 HTTP 클라이언트 생성
+esp_err_t http_uplink_init(const char *url) {
+    s_url = url;
+    if (s_client != NULL) {
+        return ESP_OK;
+    }
+    esp_err_t err = http_uplink_create_client();
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Keep-Alive HTTP 업링크 준비 완료: %s", url);
+    }
+    return err;
+}
+
+// 영구 연결로 POST 전송
+esp_err_t http_uplink_post(const char *content_type, const char *body, size_t len, int *status_code) {
+    if (s_client == NULL && http_uplink_create_client() != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    s_new_connection = false;
+    esp_err_t err = http_uplink_perform(content_type, body, len);
+
+    // 서버나 링크가 유휴 연결을 끊은 경우: 소켓을 닫고 즉시 1회 재연결
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "기존 연결로 전송 실패 (%s), 재연결 시도", esp_err_to_name(err));
+        esp_http_client_close(s_client);
+        s_stats.reconnects++;
+        s_new_connection = false;
+        err = http_uplink_perform(content_type, body, len);
+    }
+
+    s_stats.requests++;
+    if (err != ESP_OK) {
+        s_stats.failures++;
+        esp_http_client_close(s_client);
+        return err;
+    }
+
+    if (s_new_connection) {
+        s_stats.connects++;
+        s_stats.current_conn_requests = 1;
+    } else {
+        s_stats.reused++;
+        s_stats.current_conn_requests++;
+    }
+    if (s_stats.current_conn_requests > s_stats.max_conn_requests) {
+        s_stats.max_conn_requests = s_stats.current_conn_requests;
+    }
+
+    if (status_code != NULL) {
+        *status_code = esp_http_client_get_status_code(s_client);
+    }
+    return ESP_OK;
+}
+
+// 다른 경로로 POST (호스트가 같으면 esp_http_client 가 연결을 유지)
+esp_err_t http_uplink_post_to(const char *url, const char *content_type, const char *body, size_t len, int *status_code) {
+    if (s_client == NULL && http_uplink_create_client() != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    esp_err_t err = esp_http_client_set_url(s_client, url);
+    if (err == ESP_OK) {
+        err = http_uplink_post(content_type, body, len, status_code);
+    }
+    esp_http_client_set_url(s_client, s_url);
+    return err;
+}
+
+// 현재 연결 강제 종료
+void http_uplink_reset(void) {
+    if (s_client != NULL) {
+        esp_http_client_close(s_client);
+    }
+}
+
+// 연결 재사용 통계 복사
+void http_uplink_get_stats(http_uplink_stats_t *out) {
+    *out = s_stats;
+}
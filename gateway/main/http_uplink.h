@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// ===== HTTP 업링크 (Keep-Alive 영구 연결) =====
+
+// 연결 재사용 통계
+typedef struct {
+    uint32_t requests;                      // 전체 POST 요청 수
+    uint32_t connects;                      // 새로 맺은 TCP 연결 수
+    uint32_t reused;                        // 기존 연결을 재사용한 요청 수
+    uint32_t reconnects;                    // 끊긴 연결 감지 후 재연결 시도 수
+    uint32_t failures;                      // 재연결 후에도 실패한 요청 수
+    uint32_t current_conn_requests;         // 현재 연결에서 처리한 요청 수
+    uint32_t max_conn_requests;             // 단일 연결에서 처리한 최대 요청 수
+} http_uplink_stats_t;
+
+// 영구 HTTP 클라이언트 생성 (url은 프로그램 수명 동안 유효해야 함)
+esp_err_t http_uplink_init(const char *url);
+
+// 영구 연결로 POST 전송, 연결이 끊겼으면 1회 투명하게 재연결
+// 전송 성공 시 ESP_OK 와 함께 status_code 반환 (상태 코드 판단은 호출자 몫)
+esp_err_t http_uplink_post(const char *content_type, const char *body, size_t len, int *status_code);
+
+// 다른 경로로 POST (같은 서버면 영구 연결 재사용, 끝나면 기본 URL 로 되돌림, url 은 프로그램 수명 동안 유효)
+esp_err_t http_uplink_post_to(const char *url, const char *content_type, const char *body, size_t len, int *status_code);
+
+// 현재 연결 강제 종료 (다음 요청에서 재연결)
+void http_uplink_reset(void);
+
+// 연결 재사용 통계 복사
+void http_uplink_get_stats(http_uplink_stats_t *out);
@@ -0,0 +1,70 @@
+#include <string.h>
+#include <stdatomic.h>
+#include "ingest_ring.h"
+#include "pipeline_metrics.h"
+#include "freertos/task.h"
+
+#define RING_MASK (INGEST_RING_SLOTS - 1)
+
+// head 는 생산자만, tail 은 소비자만 씀 (둘 다 자유 증가 카운터, 차이가 채워진 슬롯 수)
+static ingest_frame_t slots[INGEST_RING_SLOTS];
+static atomic_uint_fast32_t head;
+static atomic_uint_fast32_t tail;
+static TaskHandle_t _Atomic consumer_task;      // 첫 peek 에서 등록, 게시할 때 깨움
+static ingest_ring_stats_t stats;
+
+bool ingest_ring_push(const uint8_t *data, size_t len) {
+    if (len > SWIFT_FRAME_MAX_SIZE) {
+        return false;
+    }
+
+    uint32_t h = (uint32_t)atomic_load_explicit(&head, memory_order_relaxed);
+    uint32_t t = (uint32_t)atomic_load_explicit(&tail, memory_order_acquire);
+    uint32_t used = h - t;
+    if (used >= INGEST_RING_SLOTS) {
+        stats.dropped++;
+        return false;
+    }
+
+    // 슬롯 확보 → 복사 → 게시 (release 로 슬롯 내용이 인덱스보다 먼저 보이게 함)
+    ingest_frame_t *slot = &slots[h & RING_MASK];
+    slot->rx_us = pipeline_now_us();
+    slot->len = (uint8_t)len;
+    memcpy(slot->data, data, len);
+    atomic_store_explicit(&head, h + 1, memory_order_release);
+
+    stats.received++;
+    if (used + 1 > stats.high_water) {
+        stats.high_water = used + 1;
+    }
+
+    TaskHandle_t consumer = atomic_load_explicit(&consumer_task, memory_order_acquire);
+    if (consumer != NULL) {
+        xTaskNotifyGive(consumer);
+    }
+    return true;
+}
+
+const ingest_frame_t *ingest_ring_peek(TickType_t timeout) {
+    if (atomic_load_explicit(&consumer_task, memory_order_relaxed) == NULL) {
+        atomic_store_explicit(&consumer_task, xTaskGetCurrentTaskHandle(), memory_order_release);
+    }
+
+    uint32_t t = (uint32_t)atomic_load_explicit(&tail, memory_order_relaxed);
+    // 게시 후 알림이 비어 있는지 확인과 대기 사이에 와도 알림 카운트가 남아 있어 놓치지 않음
+    while ((uint32_t)atomic_load_explicit(&head, memory_order_acquire) == t) {
+        if (ulTaskNotifyTake(pdTRUE, timeout) == 0) {
+            return NULL;
+        }
+    }
+    return &slots[t & RING_MASK];
+}
+
+void ingest_ring_release(void) {
+    uint32_t t = (uint32_t)atomic_load_explicit(&tail, memory_order_relaxed);
+    atomic_store_explicit(&tail, t + 1, memory_order_release);
+}
+
+void ingest_ring_get_stats(ingest_ring_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "swift_frame.h"
+
+// ===== ESP-NOW 수신 링 =====
+// 수신 콜백(Wi-Fi 태스크, 생산자 1개) → 데이터 중계 태스크(소비자 1개) 단방향 링
+// 슬롯은 미리 할당된 고정 배열이고 인덱스만 원자적으로 전진 (락 없음, 프레임 복사는 콜백에서 한 번)
+#define INGEST_RING_SLOTS 16                // 슬롯 수 (2의 거듭제곱)
+
+_Static_assert((INGEST_RING_SLOTS & (INGEST_RING_SLOTS - 1)) == 0, "INGEST_RING_SLOTS 는 2의 거듭제곱이어야 함");
+
+// 수신 프레임 슬롯 (디코딩은 중계 태스크가 슬롯에서 바로 수행)
+typedef struct {
+    uint32_t rx_us;                         // 수신 시각 (pipeline_now_us, 단계별 지연 계측용)
+    uint8_t len;                            // 프레임 길이
+    uint8_t data[SWIFT_FRAME_MAX_SIZE];     // 프레임 원본 (swift_frame 형식 또는 레거시 구조체)
+} ingest_frame_t;
+
+// 링 통계 (생산자만 갱신)
+typedef struct {
+    uint32_t received;                      // 링에 넣은 프레임 수
+    uint32_t dropped;                       // 링이 가득 차 버린 프레임 수
+    uint32_t high_water;                    // 최고 수위 (슬롯)
+} ingest_ring_stats_t;
+
+// 생산자: 빈 슬롯에 프레임과 수신 시각을 복사하고 게시, 가득 차 있으면 false (절대 블록하지 않음, 로그 없음)
+bool ingest_ring_push(const uint8_t *data, size_t len);
+
+// 소비자: 가장 오래된 프레임을 기다려 반환 (timeout 동안 없으면 NULL)
+// 반환된 슬롯은 ingest_ring_release 전까지 생산자가 덮어쓰지 않음
+const ingest_frame_t *ingest_ring_peek(TickType_t timeout);
+
+// 소비자: ingest_ring_peek 로 받은 슬롯 반납
+void ingest_ring_release(void);
+
+// 통계 복사
+void ingest_ring_get_stats(ingest_ring_stats_t *out);
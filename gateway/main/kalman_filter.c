@@ -0,0 +1,158 @@
+#include <math.h>
+#include "kalman_filter.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "swift_trace.h"
+
+static const char *TAG = "KALMAN";
+
+static kalman_filter_stats_t stats;
+
+// 칼만 필터 초기화
+void kalman_filter_init(kalman_filter_state_t *kf, float initial_value, float initial_variance) {
+    if (initial_variance < KALMAN_MIN_MEASUREMENT_VARIANCE) {
+        initial_variance = KALMAN_MIN_MEASUREMENT_VARIANCE;
+    }
+    kf->x = initial_value;
+    kf->v = 0.0f;
+    kf->P00 = initial_variance;
+    kf->P01 = 0.0f;
+    kf->P11 = KALMAN_INITIAL_VELOCITY_VARIANCE;
+    kf->q = KALMAN_PROCESS_NOISE_DEFAULT;
+    kf->nis_avg = 1.0f;
+    kf->last_update_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    kf->gated_measurement = 0.0f;
+    kf->gated_streak = 0;
+    kf->initialized = true;
+}
+
+// 최근 NIS 평균으로 프로세스 노이즈 조정
+// 혁신이 예상보다 크면 (이동 중) q 를 키우고, 작으면 (정지) 줄여서 더 강하게 평활
+static void adapt_process_noise(kalman_filter_state_t *kf, float nis) {
+    kf->nis_avg += KALMAN_NIS_SMOOTHING * (nis - kf->nis_avg);
+    if (kf->nis_avg > 1.5f) {
+        kf->q *= 2.0f;
+    } else if (kf->nis_avg < 0.5f) {
+        kf->q *= 0.5f;
+    }
+    if (kf->q < KALMAN_PROCESS_NOISE_MIN) {
+        kf->q = KALMAN_PROCESS_NOISE_MIN;
+    } else if (kf->q > KALMAN_PROCESS_NOISE_MAX) {
+        kf->q = KALMAN_PROCESS_NOISE_MAX;
+    }
+}
+
+// 칼만 필터 업데이트
+float kalman_filter_update(kalman_filter_state_t *kf, float measurement, float measurement_variance, float dt) {
+    if (!kf->initialized) {
+        ESP_LOGE(TAG, "칼만 필터가 초기화되지 않음");
+        return measurement;
+    }
+    if (dt < 0.0f) {
+        dt = 0.0f;
+    } else if (dt > KALMAN_MAX_DT) {
+        dt = KALMAN_MAX_DT;
+    }
+
+    // 예측 단계 (변화율은 KALMAN_VELOCITY_TAU 로 감쇠, 가속도 백색 잡음)
+    float a = expf(-dt / KALMAN_VELOCITY_TAU);
+    float dt2 = dt * dt;
+    float x_pred = kf->x + kf->v * dt;
+    float v_pred = kf->v * a;
+    float P00 = kf->P00 + 2.0f * dt * kf->P01 + dt2 * kf->P11 + kf->q * dt2 * dt / 3.0f;
+    float P01 = a * (kf->P01 + dt * kf->P11) + kf->q * dt2 / 2.0f;
+    float P11 = a * a * kf->P11 + kf->q * dt;
+
+    // 혁신과 마할라노비스 거리
+    float R = measurement_variance;
+    if (R < KALMAN_MIN_MEASUREMENT_VARIANCE) {
+        R = KALMAN_MIN_MEASUREMENT_VARIANCE;
+    }
+    float innovation = measurement - x_pred;
+    float S = P00 + R;
+    float nis = innovation * innovation / S;
+
+    kf->last_update_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+
+    bool gated = nis > KALMAN_GATE_THRESHOLD;
+    bool maneuver = false;
+    if (gated && kf->gated_streak > 0) {
+        // 직전 측정값과 같은 쪽으로 게이트를 벗어났고, 두 측정값이 보행 속도(+ 측정 잡음 3 시그마)로 이어지는지
+        float prev_side = kf->gated_measurement - x_pred;
+        float step = fabsf(measurement - kf->gated_measurement);
+        maneuver = prev_side * innovation > 0.0f &&
+                   step <= KALMAN_MAX_SPEED * dt + sqrtf(KALMAN_GATE_THRESHOLD * R);
+    }
+    if (maneuver) {
+        // 한 번 튄 값(다중경로 등)이 아니라 이어지는 이동: 정지 후 이동 시작 등 기동으로 보고
+        // 예측 불확실성을 혁신 크기로 키워 측정값을 따라가게 하고, 변화율은 두 측정값 차이로 다시 잡음
+        // (리포트 주기가 길면 몇 주기씩 뒤처지는 것 방지)
+        if (dt > 0.0f) {
+            v_pred = (measurement - kf->gated_measurement) / dt;
+            if (v_pred > KALMAN_MAX_SPEED) {
+                v_pred = KALMAN_MAX_SPEED;
+            } else if (v_pred < -KALMAN_MAX_SPEED) {
+                v_pred = -KALMAN_MAX_SPEED;
+            }
+        }
+        P00 = innovation * innovation;
+        P01 = 0.0f;
+        P11 = KALMAN_INITIAL_VELOCITY_VARIANCE;
+        S = P00 + R;
+        nis = 1.0f;
+        kf->q = KALMAN_PROCESS_NOISE_MAX;
+        kf->nis_avg = 1.0f;
+        gated = false;
+        stats.maneuvers++;
+    }
+    if (gated) {
+        stats.gated++;
+        kf->gated_measurement = measurement;
+        if (++kf->gated_streak >= KALMAN_MAX_CONSECUTIVE_GATED) {
+            // 계속 게이트 밖: 필터가 실제 거리를 놓친 것으로 보고 재시작
+            stats.reinitialized++;
+            ESP_LOGW(TAG, "칼만 재초기화: 측정=%.2f, 예측=%.2f (연속 %d회 게이트 밖)",
+                    measurement, x_pred, kf->gated_streak);
+            kalman_filter_init(kf, measurement, measurement_variance);
+            return kf->x;
+        }
+
+        // 측정 분산을 키워 NIS 가 게이트 경계가 되도록 함 (이상치는 약하게, 실제 이동은 점진적으로 반영)
+        // 이동일 수도 있으므로 프로세스 노이즈도 키움
+        R = innovation * innovation / KALMAN_GATE_THRESHOLD - P00;
+        S = P00 + R;
+        kf->q *= 4.0f;
+        if (kf->q > KALMAN_PROCESS_NOISE_MAX) {
+            kf->q = KALMAN_PROCESS_NOISE_MAX;
+        }
+    } else {
+        kf->gated_streak = 0;
+    }
+
+    // 업데이트 단계
+    float K0 = P00 / S;
+    float K1 = P01 / S;
+    kf->x = x_pred + K0 * innovation;
+    kf->v = v_pred + K1 * innovation;
+    kf->P00 = (1.0f - K0) * P00;
+    kf->P01 = (1.0f - K0) * P01;
+    kf->P11 = P11 - K1 * P01;
+    stats.updates++;
+
+    if (!gated) {
+        adapt_process_noise(kf, nis);
+    }
+
+    swift_trace(SWIFT_TRACE_GW_KALMAN_UPDATE, gated ? 1 : 0, (uint16_t)(K0 * 1000.0f),
+                swift_trace_milli(measurement), swift_trace_milli(kf->x));
+    SWIFT_TRACE_LOGI(TAG, "칼만 업데이트: 측정=%.2f, 분산=%.4f, 예측=%.2f, 이득=%.3f, 추정=%.2f, 변화율=%.2f, P=%.4f, q=%.5f%s",
+            measurement, R, x_pred, K0, kf->x, kf->v, kf->P00, kf->q, gated ? " (게이트 밖)" : "");
+
+    return kf->x;
+}
+
+// 칼만 필터 통계 복사
+void kalman_filter_get_stats(kalman_filter_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ===== 칼만 필터 설정 =====
+#define KALMAN_PROCESS_NOISE_DEFAULT 0.01f      // 가속도 프로세스 노이즈 초기값 (m²/s³)
+#define KALMAN_PROCESS_NOISE_MIN 0.00001f       // 적응 프로세스 노이즈 하한 (정지 비콘)
+#define KALMAN_PROCESS_NOISE_MAX 1.0f           // 적응 프로세스 노이즈 상한 (뛰는 속도 수준)
+#define KALMAN_VELOCITY_TAU 2.0f                // 거리 변화율 감쇠 시간 상수 (초, 보행자는 수 초 안에 방향을 바꿈)
+#define KALMAN_INITIAL_VELOCITY_VARIANCE 1.0f   // 초기 거리 변화율 분산 ((m/s)²)
+#define KALMAN_MIN_MEASUREMENT_VARIANCE 0.0025f // 측정 분산 하한 (m², 이득 폭주 방지)
+#define KALMAN_GATE_THRESHOLD 9.0f              // 혁신 게이트 (마할라노비스 거리², 3 시그마)
+#define KALMAN_MAX_CONSECUTIVE_GATED 3          // 연속으로 게이트를 벗어나면 측정값으로 재초기화
+#define KALMAN_NIS_SMOOTHING 0.2f               // 정규화 혁신 제곱(NIS) 지수 평균 계수
+#define KALMAN_MAX_DT 10.0f                     // 예측에 쓰는 최대 경과 시간 (초)
+#define KALMAN_MAX_SPEED 1.5f                   // 연속 게이트 밖 측정값을 기동으로 볼 최대 거리 변화율 (m/s, 빠른 보행)
+
+// 칼만 필터 상태 구조체 (앵커까지의 거리 + 거리 변화율, 감쇠 등속 모델)
+typedef struct {
+    float x;                                // 추정 거리 (m)
+    float v;                                // 추정 거리 변화율 (m/s)
+    float P00;                              // 거리 추정 분산 (m²)
+    float P01;                              // 거리-변화율 공분산
+    float P11;                              // 변화율 추정 분산 ((m/s)²)
+    float q;                                // 적응 프로세스 노이즈 (m²/s³)
+    float nis_avg;                          // 정규화 혁신 제곱 지수 평균 (1 근처가 정상)
+    uint32_t last_update_time;              // 마지막 업데이트 타임스탬프 (밀리초)
+    float gated_measurement;                // 직전에 게이트를 벗어난 측정값 (gated_streak > 0 일 때만 유효)
+    uint8_t gated_streak;                   // 연속으로 게이트를 벗어난 횟수
+    bool initialized;                       // 초기화 플래그
+} kalman_filter_state_t;
+
+// 칼만 필터 통계 (전체 엔트리 누적)
+typedef struct {
+    uint32_t updates;                       // 업데이트 수
+    uint32_t gated;                         // 게이트를 벗어나 가중치를 낮춘 측정값 수
+    uint32_t reinitialized;                 // 연속으로 게이트를 벗어나 재초기화한 횟수
+    uint32_t maneuvers;                     // 연속으로 게이트 밖이고 서로 일치해 기동으로 본 측정값 수
+} kalman_filter_stats_t;
+
+// 칼만 필터 초기화
+void kalman_filter_init(kalman_filter_state_t *kf, float initial_value, float initial_variance);
+
+// 측정값으로 칼만 필터 업데이트, 필터링된 거리 반환 (dt: 이전 업데이트 이후 경과 초)
+// 혁신이 게이트를 벗어나면 (다중경로 등) 게이트 경계만큼만 반영
+// 직전 측정값도 같은 쪽으로 게이트를 벗어났고 두 측정값이 보행 속도로 이어지면 기동으로 보고 따라감
+float kalman_filter_update(kalman_filter_state_t *kf, float measurement, float measurement_variance, float dt);
+
+// 칼만 필터 통계 복사
+void kalman_filter_get_stats(kalman_filter_stats_t *out);
@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "load_generator.h"
+#include "ingest_ring.h"
+#include "pipeline_metrics.h"
+#include "uploader.h"
+#include "swift_frame.h"
+
+static const char *TAG = "LOADGEN";
+
+#define LOADGEN_TASK_STACK 4096
+#define LOADGEN_TASK_PRIORITY 2             // 결과 집계만 하므로 낮게 (생성은 esp_timer 태스크)
+
+// 결과 비교용 카운터 묶음 (시작/종료 시점)
+typedef struct {
+    uploader_stats_t uploader;
+    pipeline_histogram_t latency[PIPELINE_STAGE_COUNT];
+} loadgen_snapshot_t;
+
+// 실행 상태 (생성 카운터는 esp_timer 태스크만 갱신)
+static struct {
+    loadgen_config_t config;
+    uint32_t sequence_base;                 // 실행마다 임의 값 (이전 실행과 사이클 번호가 겹쳐 중복으로 버려지지 않게)
+    int64_t start_us;                       // 생성 시작 (esp_timer)
+    uint64_t offered;                       // 지금까지 차례가 된 프레임 수 (건너뛴 것 포함)
+    uint32_t pushed;                        // 수신 링에 넣은 프레임 수
+    uint32_t ring_full;                     // 수신 링이 가득 차 버린 프레임 수
+    uint32_t skipped;                       // 생성 타이머가 밀려 건너뛴 프레임 수
+    esp_timer_handle_t timer;
+    TaskHandle_t task;
+} run;
+
+static atomic_bool active;
+static loadgen_result_t result;             // 마지막 실행 결과 (result_ready 가 켜진 뒤에만 읽음)
+static atomic_bool result_ready;
+
+
+// ===== 합성 리포트 =====
+
+// index 번째 프레임의 리포트 (비콘은 순서대로 돌아가며 보내고, 한 바퀴마다 사이클 번호 1 증가)
+static void loadgen_build_report(uint64_t index, swift_beacon_report_t *report) {
+    uint32_t beacon = (uint32_t)(index % run.config.beacons);
+    uint32_t round = (uint32_t)(index / run.config.beacons);
+
+    memset(report, 0, sizeof(*report));
+    snprintf(report->serial_number, sizeof(report->serial_number), LOADGEN_SERIAL_PREFIX "%04" PRIu32, beacon);
+    report->battery_level = 100;
+    report->floor = 1;
+    report->has_sequence = true;
+    report->sequence = run.sequence_base + round;
+    report->measurement_count = LOADGEN_ANCHORS;
+
+    for (int a = 0; a < LOADGEN_ANCHORS; a++) {
+        swift_measurement_t *m = &report->measurements[a];
+        const uint8_t anchor_mac[6] = {0x02, 'L', 'G', 0x00, 0x00, (uint8_t)a};   // 로컬 관리 주소
+        memcpy(m->anchor_mac, anchor_mac, 6);
+
+        // 비콘·앵커마다 1~21 m 고정 거리 + ±5 cm 잡음 (칼만 필터가 초기화 뒤 갱신 경로를 타도록)
+        float base = 1.0f + (float)((beacon * 7 + (uint32_t)a * 13) % 200) / 10.0f;
+        m->distance_meters = base + ((int)(esp_random() % 101) - 50) / 1000.0f;
+        m->variance = 0.01f;
+        m->rssi = (int8_t)(-50 - 5 * a);
+        m->sample_count = 16;
+        m->rtt_nanoseconds = (uint32_t)(m->distance_meters * 6.671f);   // 왕복 거리 / 광속 (ns)
+    }
+}
+
+// 생성 타이머 (esp_timer 태스크): 시작부터의 경과 시간만큼 밀린 프레임을 링에 넣음
+static void loadgen_tick(void *arg) {
+    static swift_beacon_report_t report;
+    static uint8_t frame[SWIFT_FRAME_MAX_SIZE];
+
+    uint64_t due = (uint64_t)(esp_timer_get_time() - run.start_us) * run.config.rate / 1000000;
+    if (due - run.offered > LOADGEN_MAX_BURST) {
+        run.skipped += (uint32_t)(due - run.offered - LOADGEN_MAX_BURST);
+        run.offered = due - LOADGEN_MAX_BURST;
+    }
+
+    while (run.offered < due) {
+        size_t frame_len = 0;
+        loadgen_build_report(run.offered++, &report);
+        if (swift_frame_encode_report(&report, frame, sizeof(frame), &frame_len) != ESP_OK) {
+            continue;
+        }
+        if (ingest_ring_push(frame, frame_len)) {
+            run.pushed++;
+        } else {
+            run.ring_full++;
+        }
+    }
+}
+
+
+// ===== 결과 집계 =====
+
+static void loadgen_snapshot(loadgen_snapshot_t *out) {
+    uploader_get_stats(&out->uploader);
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        pipeline_metrics_get_histogram((pipeline_stage_t)stage, &out->latency[stage]);
+    }
+}
+
+// 두 시점 사이의 히스토그램 (최대값은 누적값만 있으므로 종료 시점 값)
+static void histogram_delta(const pipeline_histogram_t *before, const pipeline_histogram_t *after,
+                            pipeline_histogram_t *out) {
+    out->count = after->count - before->count;
+    out->sum_us = after->sum_us - before->sum_us;
+    out->max_us = after->max_us;
+    for (int i = 0; i < PIPELINE_HIST_BUCKETS; i++) {
+        out->buckets[i] = after->buckets[i] - before->buckets[i];
+    }
+}
+
+// 시작/종료 스냅숏 차이로 실행 결과 작성
+static void loadgen_fill_result(const loadgen_snapshot_t *before, const loadgen_snapshot_t *after, int64_t elapsed_us) {
+    const uploader_stats_t *b = &before->uploader;
+    const uploader_stats_t *a = &after->uploader;
+
+    result.config = run.config;
+    result.elapsed_us = elapsed_us;
+    result.pushed = run.pushed;
+    result.ring_full = run.ring_full;
+    result.skipped = run.skipped;
+    result.uploader = (uploader_stats_t) {
+        .records_enqueued = a->records_enqueued - b->records_enqueued,
+        .records_dropped = a->records_dropped - b->records_dropped,
+        .queue_high_water = a->queue_high_water,
+        .records_sent = a->records_sent - b->records_sent,
+        .records_failed = a->records_failed - b->records_failed,
+        .records_spooled = a->records_spooled - b->records_spooled,
+        .records_replayed = a->records_replayed - b->records_replayed,
+        .batches_sent = a->batches_sent - b->batches_sent,
+        .batches_failed = a->batches_failed - b->batches_failed,
+        .bytes_sent = a->bytes_sent - b->bytes_sent,
+    };
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        histogram_delta(&before->latency[stage], &after->latency[stage], &result.latency[stage]);
+    }
+}
+
+static void loadgen_report(const loadgen_result_t *r) {
+    float elapsed_sec = r->elapsed_us / 1000000.0f;
+    const uploader_stats_t *up = &r->uploader;
+
+    ESP_LOGI(TAG, "=== 부하 결과: 비콘 %" PRIu32 "개, 목표 %" PRIu32 " fps, %.1f초 ===",
+            r->config.beacons, r->config.rate, elapsed_sec);
+    ESP_LOGI(TAG, "생성: 링 투입 %" PRIu32 " (%.0f fps), 링 가득 참 %" PRIu32 ", 타이머 지연으로 건너뜀 %" PRIu32,
+            r->pushed, r->pushed / elapsed_sec, r->ring_full, r->skipped);
+    ESP_LOGI(TAG, "업로드: 전송 %" PRIu32 " (%.0f 레코드/s), 버퍼 폐기 %" PRIu32 ", 스풀 보관 %" PRIu32
+            ", 유실 %" PRIu32 ", 배치 %" PRIu32 " (실패 %" PRIu32 "), %" PRIu32 " 바이트",
+            up->records_sent, up->records_sent / elapsed_sec, up->records_dropped, up->records_spooled,
+            up->records_failed, up->batches_sent, up->batches_failed, up->bytes_sent);
+
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        const pipeline_histogram_t *hist = &r->latency[stage];
+        ESP_LOGI(TAG, "지연 %-6s 건수 %" PRIu32 ", 평균 %" PRIu32 " us, p50 %" PRIu32 " us, p99 %" PRIu32 " us",
+                pipeline_stage_name((pipeline_stage_t)stage), hist->count,
+                hist->count ? (uint32_t)(hist->sum_us / hist->count) : 0,
+                pipeline_histogram_percentile(hist, 50), pipeline_histogram_percentile(hist, 99));
+    }
+}
+
+// 실행 태스크: 생성 타이머를 돌리고 끝나면 결과 출력
+static void loadgen_task(void *arg) {
+    static loadgen_snapshot_t before;
+    static loadgen_snapshot_t after;
+
+    // 수신 콜백이 진행 중인 push 를 마칠 시간 (링 생산자는 하나만)
+    vTaskDelay(1);
+    loadgen_snapshot(&before);
+
+    run.start_us = esp_timer_get_time();
+    esp_timer_start_periodic(run.timer, LOADGEN_TICK_US);
+    ESP_LOGI(TAG, "부하 생성 시작: 비콘 %" PRIu32 "개, %" PRIu32 " fps, %" PRIu32 "초",
+            run.config.beacons, run.config.rate, run.config.duration_sec);
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(run.config.duration_sec * 1000));
+    esp_timer_stop(run.timer);
+    int64_t elapsed_us = esp_timer_get_time() - run.start_us;
+    vTaskDelay(1);                          // 실행 중이던 타이머 콜백이 끝난 뒤 수신 콜백에 링을 돌려줌
+    atomic_store(&active, false);
+
+    // 배치 대기와 업로드가 끝날 때까지 기다린 뒤 집계
+    vTaskDelay(pdMS_TO_TICKS(LOADGEN_DRAIN_MS));
+    loadgen_snapshot(&after);
+    loadgen_fill_result(&before, &after, elapsed_us);
+    atomic_store(&result_ready, true);
+    loadgen_report(&result);
+
+    esp_timer_delete(run.timer);
+    run.timer = NULL;
+    run.task = NULL;
+    vTaskDelete(NULL);
+}
+
+
+// ===== 공개 함수 =====
+
+esp_err_t load_generator_start(const loadgen_config_t *config) {
+    if (config->beacons == 0 || config->beacons > LOADGEN_MAX_BEACONS ||
+        config->rate == 0 || config->rate > LOADGEN_MAX_RATE ||
+        config->duration_sec == 0 || config->duration_sec > LOADGEN_MAX_DURATION_SEC) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (run.task != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    atomic_store(&result_ready, false);
+    memset(&run, 0, sizeof(run));
+    run.config = *config;
+    run.sequence_base = esp_random();
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = loadgen_tick,
+        .name = "loadgen",
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &run.timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    atomic_store(&active, true);
+    if (xTaskCreate(loadgen_task, "loadgen", LOADGEN_TASK_STACK, NULL, LOADGEN_TASK_PRIORITY, &run.task) != pdPASS) {
+        atomic_store(&active, false);
+        esp_timer_delete(run.timer);
+        run.timer = NULL;
+        run.task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void load_generator_stop(void) {
+    TaskHandle_t task = run.task;
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+}
+
+esp_err_t load_generator_get_result(loadgen_result_t *out) {
+    if (!atomic_load(&result_ready)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *out = result;
+    return ESP_OK;
+}
+
+bool load_generator_active(void) {
+    return atomic_load(&active);
+}
+
+bool load_generator_is_synthetic(const char *serial_number) {
+    return strncmp(serial_number, LOADGEN_SERIAL_PREFIX, sizeof(LOADGEN_SERIAL_PREFIX) - 1) == 0;
+}
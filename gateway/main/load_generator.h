@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "uploader.h"
+#include "pipeline_metrics.h"
+
+// ===== 합성 비콘 부하 생성기 =====
+// ESP-NOW 수신 콜백과 같은 입구(ingest_ring_push)에 합성 비콘 리포트를 넣어 수신 → 필터 → 직렬화 → 업로드 경로를 측정
+// esp_timer 태스크(수신 콜백처럼 중계 태스크보다 우선순위가 높음)에서 1ms 마다 밀린 만큼 생성
+// 수신 링은 생산자가 하나여야 하므로 생성 중에는 수신 콜백이 실제 비콘 리포트를 버림
+// 업로드 대상은 tools/stub_upload_server.py (idf.py -DGATEWAY_SERVER_BASE_URL=http://<PC>:8080 build)
+// loadgen 콘솔 명령은 그 빌드에서만 등록됨 (합성 비콘이 비콘 테이블/사이클 번호 추적의 실제 비콘 상태를 밀어내므로)
+// 같은 소스가 host_test/bench_pipeline 에서 호스트 하네스의 부하 생성기로도 쓰임
+#define LOADGEN_MAX_BEACONS 10000           // 합성 비콘 수 상한 (시리얼 "LG-0000" ~ "LG-9999")
+#define LOADGEN_MAX_RATE 10000              // 초당 프레임 상한
+#define LOADGEN_MAX_DURATION_SEC 3600       // 실행 시간 상한
+#define LOADGEN_TICK_US 1000                // 생성 주기
+#define LOADGEN_MAX_BURST 32                // 주기당 최대 생성 수 (밀린 나머지는 건너뛰고 집계)
+#define LOADGEN_ANCHORS 3                   // 리포트당 합성 앵커 측정값 수
+#define LOADGEN_DRAIN_MS 3000               // 생성 종료 후 결과 집계 전 대기 (배치/업로드 마무리)
+#define LOADGEN_SERIAL_PREFIX "LG-"         // 합성 비콘 시리얼 접두사
+
+// 부하 설정
+typedef struct {
+    uint32_t beacons;                       // 합성 비콘 수 (순서대로 돌아가며 전송)
+    uint32_t rate;                          // 초당 프레임 수
+    uint32_t duration_sec;                  // 실행 시간
+} loadgen_config_t;
+
+// 실행 결과 (업로더 통계와 히스토그램은 시작~집계 시점 차이, 최대 지연만 누적값)
+typedef struct {
+    loadgen_config_t config;
+    int64_t elapsed_us;                     // 실제 생성 시간
+    uint32_t pushed;                        // 수신 링에 넣은 프레임 수
+    uint32_t ring_full;                     // 수신 링이 가득 차 버린 프레임 수
+    uint32_t skipped;                       // 생성 타이머가 밀려 건너뛴 프레임 수
+    uploader_stats_t uploader;
+    pipeline_histogram_t latency[PIPELINE_STAGE_COUNT];
+} loadgen_result_t;
+
+// 부하 생성 시작 (이미 실행 중이면 ESP_ERR_INVALID_STATE, 범위 밖 설정은 ESP_ERR_INVALID_ARG)
+// 끝나면 처리량과 수신 → 업로드 지연 p50/p99 를 로그로 출력
+esp_err_t load_generator_start(const loadgen_config_t *config);
+
+// 실행 중인 부하 생성을 일찍 끝냄 (결과는 그대로 출력)
+void load_generator_stop(void);
+
+// 마지막으로 끝난 실행의 결과 (실행 중이거나 끝난 실행이 없으면 ESP_ERR_INVALID_STATE)
+esp_err_t load_generator_get_result(loadgen_result_t *out);
+
+// 생성 중인지 (수신 콜백이 실제 비콘 리포트를 링에 넣지 않아야 하는 동안 true)
+bool load_generator_active(void);
+
+// 합성 비콘 시리얼인지 (슬롯 배정 같은 무선 응답을 보내지 않음)
+bool load_generator_is_synthetic(const char *serial_number);
@@ -1,3 +1,4 @@
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,8 +25,22 @@
 #include "nvs.h"
 #include "esp_netif.h"
 #include "esp_mac.h"
+#include "esp_timer.h"
 #include "esp_sntp.h"
-#include "cJSON.h"
+#include "beacon_table.h"
+#include "anchor_registry.h"
+#include "neighbor_table.h"
+#include "slot_scheduler.h"
+#include "ingest_ring.h"
+#include "seq_tracker.h"
+#include "pipeline_metrics.h"
+#include "health_record.h"
+#include "spool.h"
+#include "uploader.h"
+#include "relay_pipeline.h"
+#include "load_generator.h"
+#include "swift_frame.h"
+#include "swift_trace.h"
 
 // ===== 설정 상수 =====
 #define AP_SSID "Gateway_Network"
@@ -34,9 +49,26 @@
 #define STA_WIFI_SSID "S-Guest"
 #define STA_WIFI_PASSWORD ""
 #define NVS_NAMESPACE "gateway_cfg"
-#define SERVER_URL "http://52.78.98.182:8080/api/locations/calculate"
+#define NVS_KEY_UPLOAD_FORMAT "upload_fmt"  // 업로드 형식 (0 = JSON, 1 = CBOR, 없으면 JSON)
+#define NVS_KEY_UPLINK "uplink"             // 업링크 전송 방식 (0 = HTTP, 1 = MQTT, 없으면 HTTP)
+#ifndef SERVER_BASE_URL
+#define SERVER_BASE_URL "http://52.78.98.182:8080"  // 부하 측정 때는 idf.py -DGATEWAY_SERVER_BASE_URL=... 로 대체
+#endif
+#ifndef GATEWAY_LOAD_TEST
+#define GATEWAY_LOAD_TEST 0                 // loadgen 명령 등록 (업로드 주소를 GATEWAY_SERVER_BASE_URL 로 바꾼 빌드에서만 1)
+#endif
+#define SERVER_URL SERVER_BASE_URL "/api/locations/calculate"
+#define SERVER_BATCH_URL SERVER_URL "/batch"   // 레코드 배열(JSON array) 업로드 엔드포인트
+#define SERVER_HEALTH_URL SERVER_BASE_URL "/api/gateways/health"   // 게이트웨이 상태 레코드 엔드포인트
+#define MQTT_BROKER_URI "mqtt://52.78.98.182:1883"  // MQTT 업링크 브로커
 #define FLOOR_BROADCAST_INTERVAL_MS 1000    // 층 브로드캐스트 간격 (1초)
-#define MAX_HTTP_RETRY_COUNT 3              // HTTP 전송 최대 재시도 횟수
+#ifndef FLOOR_LEGACY_BROADCAST
+#define FLOOR_LEGACY_BROADCAST 1            // 이웃 리포트와 함께 레거시 1바이트 층 프레임도 전송 (이웃 리포트 이전 비콘용)
+#endif
+#define INGEST_STATS_LOG_INTERVAL 100       // 수신 통계 로깅 주기 (패킷 수)
+#define TRACE_DUMP_THRESHOLD (SWIFT_TRACE_RING_RECORDS / 2)    // 디버그 프로파일에서 이만큼 쌓이면 트레이스 덤프
+#define TRACE_DUMP_POLL_MS 1000             // 디버그 프로파일에서 쌓인 레코드 수 확인 주기
+#define SEQ_LOG_WORST_BEACONS 5             // 수신 통계에 손실/중복률을 보여줄 비콘 수
 #define SNTP_SERVER "pool.ntp.org"
 #define TIMEZONE "KST-9"                    // 한국 표준시 (UTC+9)
 
@@ -48,73 +80,41 @@ static uint8_t broadcast_mac[ESP_NOW_ETH_ALEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
 // ===== 전역 변수 =====
 static char my_device_name[32] = {0};       // 게이트웨이 장치 이름
 static int32_t my_floor_number = 0;         // 게이트웨이 층 번호
-static QueueHandle_t data_recv_queue;       // 비콘 데이터 수신 큐
 static EventGroupHandle_t wifi_event_group;
+static TaskHandle_t trace_dump_task_handle = NULL;  // 트레이스 덤프 태스크 (경고/오류 로그, trace_dump 명령이 깨움)
+static vprintf_like_t default_log_vprintf = NULL;   // 트레이스 훅 이전의 로그 출력 함수
 static const int STA_CONNECTED_BIT = BIT0;
 static const int AP_STARTED_BIT = BIT1;
 static bool config_loaded = false;
 
 // ===== 데이터 구조 =====
 
-// 비콘 데이터 패킷 구조체 (비콘과 동일해야 함)
-typedef struct {
-    char serial_number[10];                 // 비콘 시리얼 번호
-    uint8_t battery_level;                  // 배터리 잔량 (%)
-    int8_t floor;                           // 층 번호 (-99~99)
-    char timestamp[128];                    // ISO 8601 형식: "2025-10-22T21:15:30.123Z"
-    struct {
-        uint8_t anchor_mac[6];              // 앵커(게이트웨이) MAC 주소
-        float distance_meters;              // 거리 (미터)
-        float variance;                     // 측정 분산 (칼만 필터용)
-        int8_t rssi;                        // 신호 강도
-        uint8_t sample_count;               // 사용된 유효 샘플 개수
-        uint32_t rtt_nanoseconds;           // RTT (왕복 시간, 나노초)
-    } measurements[3];                      // 앵커 측정값 (1~3개, 빈 슬롯은 MAC=0)
-} beacon_data_packet_t;
-
-// 칼만 필터 상태 구조체
-typedef struct {
-    float x;                                // 추정 거리 (상태)
-    float P;                                // 추정 오차 공분산
-    float Q;                                // 프로세스 노이즈 공분산
-    float R;                                // 측정 노이즈 공분산
-    uint32_t last_update_time;              // 마지막 업데이트 타임스탬프 (밀리초)
-    bool initialized;                       // 초기화 플래그
-} kalman_filter_state_t;
-
-// 비콘-앵커 추적 엔트리
-#define MAX_BEACONS 10
-#define MAX_ANCHORS_PER_BEACON 6
-#define BEACON_TIMEOUT_MS 60000             // 비콘 타임아웃 (1분)
-
-typedef struct {
-    char serial_number[10];                 // 비콘 시리얼 번호
-    uint8_t anchor_mac[6];                  // 앵커 MAC 주소
-    kalman_filter_state_t kf_state;         // 칼만 필터 상태
-    uint32_t last_seen;                     // 마지막 수신 시간
-} beacon_anchor_entry_t;
-
-// 전역 상태 추적
-static beacon_anchor_entry_t beacon_anchor_states[MAX_BEACONS * MAX_ANCHORS_PER_BEACON];
-static int beacon_anchor_count = 0;
+// 수신 단계 통계 (링 통계는 ingest_ring, 디코딩/위치 계산은 relay_pipeline, 여기는 ESP-NOW 콜백만 갱신)
+static struct {
+    uint32_t unknown_frames;                // 종류를 알 수 없는 ESP-NOW 프레임 수
+} ingest_stats;
 
 // ===== 함수 선언 =====
 static esp_err_t load_config_from_nvs(void);
 static esp_err_t save_config_to_nvs(const char *name, int32_t floor);
+static esp_err_t save_uplink_setting_to_nvs(const char *key, uint8_t value);
+static bool parse_mac(const char *str, uint8_t *mac);
 static void register_console_commands(void);
+static void register_runtime_console_commands(void);
+static void console_start(void);
+static void console_loop(const char *prompt, const bool *stop);
 static void run_provisioning_console(void);
+static void runtime_console_task(void *pvParameters);
 static void wifi_init_apsta(void);
 static void initialize_sntp(void);
 static void floor_broadcast_task(void *pvParameters);
 static void data_relay_task(void *pvParameters);
+static void trace_dump_task(void *pvParameters);
+static int trace_log_vprintf(const char *format, va_list args);
 static void beacon_data_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len);
-static esp_err_t send_json_to_server(const char *json_data);
-
-// 칼만 필터 함수
-static void kalman_filter_init(kalman_filter_state_t *kf, float initial_value, float initial_variance);
-static float kalman_filter_update(kalman_filter_state_t *kf, float measurement, float measurement_variance, float dt);
-static beacon_anchor_entry_t* find_or_create_entry(const char *serial_number, const uint8_t *anchor_mac);
-static void cleanup_old_entries(void);
+static void send_slot_assignment(const swift_beacon_report_t *report, bool duplicate);
+static void log_ingest_stats(void);
+static void collect_health_record(health_record_t *out);
 
 
 // ===== 콘솔 명령 핸들러 =====
@@ -129,6 +129,39 @@ static struct {
     struct arg_end *end;
 } set_floor_args;
 
+static struct {
+    struct arg_str *format;
+    struct arg_end *end;
+} set_upload_format_args;
+
+static struct {
+    struct arg_str *transport;
+    struct arg_end *end;
+} set_uplink_args;
+
+static struct {
+    struct arg_str *mac;
+    struct arg_dbl *x;
+    struct arg_dbl *y;
+    struct arg_dbl *z;
+    struct arg_end *end;
+} set_anchor_args;
+
+static struct {
+    struct arg_str *mac;
+    struct arg_end *end;
+} del_anchor_args;
+
+#if GATEWAY_LOAD_TEST
+static struct {
+    struct arg_int *beacons;
+    struct arg_int *rate;
+    struct arg_int *seconds;
+    struct arg_lit *stop;
+    struct arg_end *end;
+} loadgen_args;
+#endif
+
 // 장치 이름 설정 명령 핸들러
 static int set_name_handler(int argc, char **argv) {
     int nerrors = arg_parse(argc, argv, (void **)&set_name_args);
@@ -187,6 +220,220 @@ static int set_floor_handler(int argc, char **argv) {
     return 0;
 }
 
+// 업로드 형식 설정 명령 핸들러 (저장 후 다음 배치부터 바로 적용)
+static int set_upload_format_handler(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void **)&set_upload_format_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, set_upload_format_args.end, argv[0]);
+        return 1;
+    }
+
+    const char *name = set_upload_format_args.format->sval[0];
+    upload_format_t format;
+    if (strcmp(name, "json") == 0) {
+        format = UPLOAD_FORMAT_JSON;
+    } else if (strcmp(name, "cbor") == 0) {
+        format = UPLOAD_FORMAT_CBOR;
+    } else {
+        printf("오류: 업로드 형식은 json 또는 cbor 입니다\n");
+        return 1;
+    }
+
+    if (save_uplink_setting_to_nvs(NVS_KEY_UPLOAD_FORMAT, (uint8_t)format) != ESP_OK) {
+        printf("오류: 업로드 형식 저장 실패\n");
+        return 1;
+    }
+    uploader_set_format(format);
+    printf("업로드 형식 설정: %s\n", upload_format_name(format));
+    return 0;
+}
+
+// 업링크 전송 방식 설정 명령 핸들러 (저장 후 다음 배치부터 바로 적용)
+static int set_uplink_handler(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void **)&set_uplink_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, set_uplink_args.end, argv[0]);
+        return 1;
+    }
+
+    const char *name = set_uplink_args.transport->sval[0];
+    uplink_transport_t transport;
+    if (strcmp(name, "http") == 0) {
+        transport = UPLINK_TRANSPORT_HTTP;
+    } else if (strcmp(name, "mqtt") == 0) {
+        transport = UPLINK_TRANSPORT_MQTT;
+    } else {
+        printf("오류: 업링크 전송 방식은 http 또는 mqtt 입니다\n");
+        return 1;
+    }
+
+    if (save_uplink_setting_to_nvs(NVS_KEY_UPLINK, (uint8_t)transport) != ESP_OK) {
+        printf("오류: 업링크 전송 방식 저장 실패\n");
+        return 1;
+    }
+    uploader_set_transport(transport);
+    printf("업링크 전송 방식 설정: %s\n", uplink_transport_name(transport));
+    return 0;
+}
+
+// 앵커 좌표 등록 명령 핸들러 (저장 후 바로 위치 계산에 사용)
+static int set_anchor_handler(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void **)&set_anchor_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, set_anchor_args.end, argv[0]);
+        return 1;
+    }
+
+    uint8_t mac[6];
+    if (!parse_mac(set_anchor_args.mac->sval[0], mac)) {
+        printf("오류: MAC 주소 형식은 aa:bb:cc:dd:ee:ff 입니다\n");
+        return 1;
+    }
+
+    anchor_position_t position = {
+        .x = (float)set_anchor_args.x->dval[0],
+        .y = (float)set_anchor_args.y->dval[0],
+        .z = (float)set_anchor_args.z->dval[0],
+    };
+    esp_err_t err = anchor_registry_set(mac, &position);
+    if (err != ESP_OK) {
+        printf("오류: 앵커 등록 실패 (%s)\n", esp_err_to_name(err));
+        return 1;
+    }
+    printf("앵커 등록: "MACSTR" (%.2f, %.2f, %.2f)\n", MAC2STR(mac), position.x, position.y, position.z);
+    return 0;
+}
+
+// 앵커 등록 해제 명령 핸들러
+static int del_anchor_handler(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void **)&del_anchor_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, del_anchor_args.end, argv[0]);
+        return 1;
+    }
+
+    uint8_t mac[6];
+    if (!parse_mac(del_anchor_args.mac->sval[0], mac)) {
+        printf("오류: MAC 주소 형식은 aa:bb:cc:dd:ee:ff 입니다\n");
+        return 1;
+    }
+
+    esp_err_t err = anchor_registry_remove(mac);
+    if (err != ESP_OK) {
+        printf("오류: 앵커 등록 해제 실패 (%s)\n", esp_err_to_name(err));
+        return 1;
+    }
+    printf("앵커 등록 해제: "MACSTR"\n", MAC2STR(mac));
+    return 0;
+}
+
+// 등록된 앵커 목록 출력 명령 핸들러
+static int list_anchors_handler(int argc, char **argv) {
+    int count = anchor_registry_count();
+    printf("등록된 앵커: %d개\n", count);
+    for (int i = 0; i < count; i++) {
+        uint8_t mac[6];
+        anchor_position_t position;
+        if (anchor_registry_get(i, mac, &position)) {
+            printf("  "MACSTR"  (%.2f, %.2f, %.2f)\n", MAC2STR(mac), position.x, position.y, position.z);
+        }
+    }
+    return 0;
+}
+
+// 트레이스 덤프 명령 핸들러 (운영 중 콘솔, 출력은 덤프 태스크가 함)
+static int trace_dump_handler(int argc, char **argv) {
+    printf("트레이스 덤프: 레코드 %" PRIu32 "개 (링 %d개, 넘친 만큼은 덮어써짐)\n",
+           swift_trace_pending(), SWIFT_TRACE_RING_RECORDS);
+    xTaskNotifyGive(trace_dump_task_handle);
+    return 0;
+}
+
+// 처리 단계 지연 히스토그램과 카운터 출력 명령 핸들러 (운영 중 콘솔)
+static int stats_handler(int argc, char **argv) {
+    static health_record_t health;
+    memset(&health, 0, sizeof(health));
+    collect_health_record(&health);
+
+    printf("가동 %" PRIu32 "초, 여유 힙 %" PRIu32 " (최소 %" PRIu32 ") 바이트\n",
+           health.uptime_sec, health.free_heap, health.min_free_heap);
+    printf("단계 지연 (us)   건수      평균      p50       p99       최대\n");
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        const pipeline_histogram_t *hist = &health.latency[stage];
+        printf("  %-8s %9" PRIu32 " %9" PRIu32 " %9" PRIu32 " %9" PRIu32 " %9" PRIu32 "\n",
+               pipeline_stage_name((pipeline_stage_t)stage), hist->count,
+               hist->count ? (uint32_t)(hist->sum_us / hist->count) : 0,
+               pipeline_histogram_percentile(hist, 50), pipeline_histogram_percentile(hist, 99), hist->max_us);
+    }
+    printf("수신: %" PRIu32 ", 링 폐기 %" PRIu32 ", 디코딩 실패 %" PRIu32 ", 알 수 없는 프레임 %" PRIu32
+           ", 중복 %" PRIu32 ", 손실 %" PRIu32 "\n",
+           health.received, health.ring_dropped, health.decode_errors, health.unknown_frames,
+           health.duplicates, health.lost);
+    printf("업로드: 전송 %" PRIu32 ", 버퍼 폐기 %" PRIu32 ", 유실 %" PRIu32 ", 스풀 보관 %" PRIu32 " (남음 %" PRIu32 ")\n",
+           health.records_sent, health.records_dropped, health.records_failed, health.records_spooled,
+           health.spool_pending);
+    printf("HTTP: 재시도 %" PRIu32 ", 2xx %" PRIu32 ", 4xx %" PRIu32 ", 5xx %" PRIu32 ", 기타 %" PRIu32
+           ", 전송 오류 %" PRIu32 ", 마지막 상태 %d\n",
+           health.http.retries, health.http.status_2xx, health.http.status_4xx, health.http.status_5xx,
+           health.http.status_other, health.http.transport_errors, health.http.last_status);
+    printf("밀려남: 비콘 테이블 %" PRIu32 " (만료 %" PRIu32 "), 사이클 번호 %" PRIu32 ", TDMA 회수 %" PRIu32
+           " (공유 %" PRIu32 ")\n",
+           health.beacon_table_evicted, health.beacon_table_expired, health.seq_evicted,
+           health.slot_reclaimed, health.slot_shared);
+    return 0;
+}
+
+#if GATEWAY_LOAD_TEST
+// 합성 비콘 부하 생성 명령 핸들러 (운영 중 콘솔, 결과는 끝난 뒤 로그로 출력)
+// 합성 레코드가 운영 서버로 올라가거나 실제 비콘의 칼만/사이클 번호 상태를 밀어내지 않도록 부하 측정 빌드에만 있음
+static int loadgen_handler(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void **)&loadgen_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, loadgen_args.end, argv[0]);
+        return 1;
+    }
+
+    if (loadgen_args.stop->count > 0) {
+        load_generator_stop();
+        printf("부하 생성 중지 요청\n");
+        return 0;
+    }
+
+    const loadgen_config_t config = {
+        .beacons = (uint32_t)(loadgen_args.beacons->count ? loadgen_args.beacons->ival[0] : 100),
+        .rate = (uint32_t)(loadgen_args.rate->count ? loadgen_args.rate->ival[0] : 500),
+        .duration_sec = (uint32_t)(loadgen_args.seconds->count ? loadgen_args.seconds->ival[0] : 30),
+    };
+    esp_err_t err = load_generator_start(&config);
+    if (err == ESP_ERR_INVALID_ARG) {
+        printf("오류: 비콘 1~%d개, 1~%d fps, 1~%d초 범위로 지정하세요\n",
+               LOADGEN_MAX_BEACONS, LOADGEN_MAX_RATE, LOADGEN_MAX_DURATION_SEC);
+        return 1;
+    }
+    if (err != ESP_OK) {
+        printf("오류: 부하 생성 시작 실패 (%s)\n", esp_err_to_name(err));
+        return 1;
+    }
+    printf("부하 생성: 비콘 %" PRIu32 "개, %" PRIu32 " fps, %" PRIu32 "초 (실행 중 실제 비콘 리포트는 버려짐)\n",
+           config.beacons, config.rate, config.duration_sec);
+    return 0;
+}
+#endif
+
+// "aa:bb:cc:dd:ee:ff" 형식 MAC 주소 파싱
+static bool parse_mac(const char *str, uint8_t *mac) {
+    unsigned int bytes[6];
+    char extra;
+    if (sscanf(str, "%2x:%2x:%2x:%2x:%2x:%2x%c",
+               &bytes[0], &bytes[1], &bytes[2], &bytes[3], &bytes[4], &bytes[5], &extra) != 6) {
+        return false;
+    }
+    for (int i = 0; i < 6; i++) {
+        mac[i] = (uint8_t)bytes[i];
+    }
+    return true;
+}
+
 
 // ===== NVS 설정 관리 =====
 
@@ -216,9 +463,25 @@ static esp_err_t load_config_from_nvs(void) {
         return err;
     }
 
+    // 업로드 형식 (선택 항목, 없으면 JSON)
+    uint8_t upload_format = UPLOAD_FORMAT_JSON;
+    if (nvs_get_u8(nvs_handle, NVS_KEY_UPLOAD_FORMAT, &upload_format) == ESP_OK &&
+        upload_format == UPLOAD_FORMAT_CBOR) {
+        uploader_set_format(UPLOAD_FORMAT_CBOR);
+    }
+
+    // 업링크 전송 방식 (선택 항목, 없으면 HTTP)
+    uint8_t uplink = UPLINK_TRANSPORT_HTTP;
+    if (nvs_get_u8(nvs_handle, NVS_KEY_UPLINK, &uplink) == ESP_OK &&
+        uplink == UPLINK_TRANSPORT_MQTT) {
+        uploader_set_transport(UPLINK_TRANSPORT_MQTT);
+    }
+
     nvs_close(nvs_handle);
 
-    ESP_LOGI(TAG, "설정 로드 완료: 이름=%s, 층=%" PRId32, my_device_name, my_floor_number);
+    ESP_LOGI(TAG, "설정 로드 완료: 이름=%s, 층=%" PRId32 ", 업로드 형식=%s, 업링크=%s",
+            my_device_name, my_floor_number, upload_format_name(uploader_get_format()),
+            uplink_transport_name(uploader_get_transport()));
     config_loaded = true;
     return ESP_OK;
 }
@@ -257,6 +520,29 @@ static esp_err_t save_config_to_nvs(const char *name, int32_t floor) {
     return err;
 }
 
+// NVS에 업링크 설정값 (업로드 형식 / 전송 방식) 저장
+static esp_err_t save_uplink_setting_to_nvs(const char *key, uint8_t value) {
+    nvs_handle_t nvs_handle;
+    esp_err_t err;
+
+    err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS 열기 실패");
+        return err;
+    }
+
+    err = nvs_set_u8(nvs_handle, key, value);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "업링크 설정 저장 실패: %s", key);
+    }
+
+    nvs_close(nvs_handle);
+    return err;
+}
+
 
 // ===== 콘솔 프로비저닝 =====
 
@@ -287,19 +573,114 @@ static void register_console_commands(void) {
         .argtable = &set_floor_args
     };
     ESP_ERROR_CHECK(esp_console_cmd_register(&set_floor_cmd));
+
+    // 업로드 형식 설정 명령
+    set_upload_format_args.format = arg_str1(NULL, NULL, "<json|cbor>", "업로드 형식");
+    set_upload_format_args.end = arg_end(2);
+
+    const esp_console_cmd_t set_upload_format_cmd = {
+        .command = "set_upload_format",
+        .help = "서버 업로드 형식 설정 (json / cbor)",
+        .hint = NULL,
+        .func = &set_upload_format_handler,
+        .argtable = &set_upload_format_args
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&set_upload_format_cmd));
+
+    // 업링크 전송 방식 설정 명령
+    set_uplink_args.transport = arg_str1(NULL, NULL, "<http|mqtt>", "업링크 전송 방식");
+    set_uplink_args.end = arg_end(2);
+
+    const esp_console_cmd_t set_uplink_cmd = {
+        .command = "set_uplink",
+        .help = "서버 업링크 전송 방식 설정 (http / mqtt)",
+        .hint = NULL,
+        .func = &set_uplink_handler,
+        .argtable = &set_uplink_args
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&set_uplink_cmd));
+
+    // 앵커 좌표 등록 명령
+    set_anchor_args.mac = arg_str1(NULL, NULL, "<mac>", "앵커 MAC 주소 (aa:bb:cc:dd:ee:ff)");
+    set_anchor_args.x = arg_dbl1(NULL, NULL, "<x>", "X 좌표 (m)");
+    set_anchor_args.y = arg_dbl1(NULL, NULL, "<y>", "Y 좌표 (m)");
+    set_anchor_args.z = arg_dbl1(NULL, NULL, "<z>", "설치 높이 (m)");
+    set_anchor_args.end = arg_end(5);
+
+    const esp_console_cmd_t set_anchor_cmd = {
+        .command = "set_anchor",
+        .help = "앵커 설치 좌표 등록 (게이트웨이 위치 계산용)",
+        .hint = NULL,
+        .func = &set_anchor_handler,
+        .argtable = &set_anchor_args
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&set_anchor_cmd));
+
+    // 앵커 등록 해제 명령
+    del_anchor_args.mac = arg_str1(NULL, NULL, "<mac>", "앵커 MAC 주소 (aa:bb:cc:dd:ee:ff)");
+    del_anchor_args.end = arg_end(2);
+
+    const esp_console_cmd_t del_anchor_cmd = {
+        .command = "del_anchor",
+        .help = "앵커 좌표 등록 해제",
+        .hint = NULL,
+        .func = &del_anchor_handler,
+        .argtable = &del_anchor_args
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&del_anchor_cmd));
+
+    // 앵커 목록 명령
+    const esp_console_cmd_t list_anchors_cmd = {
+        .command = "list_anchors",
+        .help = "등록된 앵커 좌표 목록 출력",
+        .hint = NULL,
+        .func = &list_anchors_handler,
+        .argtable = NULL
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&list_anchors_cmd));
 }
 
-// 프로비저닝 콘솔 실행
-static void run_provisioning_console(void) {
-    ESP_LOGI(TAG, "프로비저닝 콘솔 시작");
-    printf("\n===========================================\n");
-    printf("게이트웨이 설정이 필요합니다\n");
-    printf("===========================================\n");
-    printf("게이트웨이를 설정하세요:\n");
-    printf("1. set_name <장치이름>  (예: set_name GW_01)\n");
-    printf("2. set_floor <층번호>   (예: set_floor 3)\n");
-    printf("===========================================\n\n");
+// 운영 중 콘솔 명령 등록 (설정 변경 없이 조회와 부하 측정만)
+static void register_runtime_console_commands(void) {
+    const esp_console_cmd_t stats_cmd = {
+        .command = "stats",
+        .help = "처리 단계 지연 히스토그램과 수신/업로드 카운터 출력",
+        .hint = NULL,
+        .func = &stats_handler,
+        .argtable = NULL
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&stats_cmd));
+
+    const esp_console_cmd_t trace_dump_cmd = {
+        .command = "trace_dump",
+        .help = "바이너리 트레이스 링을 @SWT 16진수 줄로 출력 (tools/swift_trace_decode.py 로 변환)",
+        .hint = NULL,
+        .func = &trace_dump_handler,
+        .argtable = NULL
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&trace_dump_cmd));
+
+#if GATEWAY_LOAD_TEST
+    // 합성 비콘 부하 생성 명령
+    loadgen_args.beacons = arg_int0(NULL, NULL, "<beacons>", "합성 비콘 수 (기본 100)");
+    loadgen_args.rate = arg_int0(NULL, NULL, "<fps>", "초당 프레임 수 (기본 500)");
+    loadgen_args.seconds = arg_int0(NULL, NULL, "<seconds>", "실행 시간 (기본 30)");
+    loadgen_args.stop = arg_lit0(NULL, "stop", "실행 중인 부하 생성 중지");
+    loadgen_args.end = arg_end(5);
+
+    const esp_console_cmd_t loadgen_cmd = {
+        .command = "loadgen",
+        .help = "합성 비콘 리포트로 수신 → 업로드 경로 부하 측정 (처리량, 단계별 지연 p50/p99)",
+        .hint = NULL,
+        .func = &loadgen_handler,
+        .argtable = &loadgen_args
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&loadgen_cmd));
+#endif
+}
 
+// 콘솔 UART 설정 및 esp_console 초기화
+static void console_start(void) {
     // 라인 엔딩 설정
     uart_vfs_dev_port_set_rx_line_endings(CONFIG_ESP_CONSOLE_UART_NUM, ESP_LINE_ENDINGS_CRLF);
     uart_vfs_dev_port_set_tx_line_endings(CONFIG_ESP_CONSOLE_UART_NUM, ESP_LINE_ENDINGS_CRLF);
@@ -310,11 +691,8 @@ static void run_provisioning_console(void) {
         ESP_LOGW(TAG, "UART flush 실패 (무시): %s", esp_err_to_name(uart_err));
     }
 
-    // 버퍼링 비활성화
+    // 입력 버퍼링 비활성화
     setvbuf(stdin, NULL, _IONBF, 0);
-    setvbuf(stdout, NULL, _IONBF, 0);
-
-    vTaskDelay(pdMS_TO_TICKS(200));
 
     // 콘솔 초기화
     esp_console_config_t console_config = {
@@ -322,17 +700,16 @@ static void run_provisioning_console(void) {
         .max_cmdline_args = 8,
     };
     ESP_ERROR_CHECK(esp_console_init(&console_config));
+}
 
-    // 명령 등록
-    register_console_commands();
-
+// 콘솔 입력 루프 (한 줄씩 읽어 등록된 명령 실행, stop 이 NULL 이 아니면 *stop 이 참이 될 때까지)
+static void console_loop(const char *prompt, const bool *stop) {
     // 입력 버퍼
     char line[256];
     int pos = 0;
-    const char *prompt = "gateway> ";
     bool prompt_shown = false;
 
-    while (!config_loaded) {
+    while (stop == NULL || !*stop) {
         // 프롬프트 출력 (라인 시작 시에만)
         if (!prompt_shown) {
             printf("%s", prompt);
@@ -396,10 +773,43 @@ static void run_provisioning_console(void) {
             fflush(stdout);
         }
     }
+}
+
+// 프로비저닝 콘솔 실행
+static void run_provisioning_console(void) {
+    ESP_LOGI(TAG, "프로비저닝 콘솔 시작");
+    printf("\n===========================================\n");
+    printf("게이트웨이 설정이 필요합니다\n");
+    printf("===========================================\n");
+    printf("게이트웨이를 설정하세요:\n");
+    printf("1. set_name <장치이름>  (예: set_name GW_01)\n");
+    printf("2. set_floor <층번호>   (예: set_floor 3)\n");
+    printf("(선택) set_upload_format <json|cbor>  (기본값 json)\n");
+    printf("(선택) set_uplink <http|mqtt>         (기본값 http)\n");
+    printf("(선택) set_anchor <mac> <x> <y> <z>   (앵커 좌표, 3개 이상 등록 시 게이트웨이에서 위치 계산)\n");
+    printf("(선택) del_anchor <mac> / list_anchors\n");
+    printf("===========================================\n\n");
+
+    // 출력 버퍼링 비활성화 (프롬프트 에코)
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    vTaskDelay(pdMS_TO_TICKS(200));
+
+    console_start();
+    register_console_commands();
+    console_loop("gateway> ", &config_loaded);
 
     esp_console_deinit();
 }
 
+// 운영 중 콘솔 태스크 (stats 조회용, 낮은 우선순위로 입력만 폴링)
+static void runtime_console_task(void *pvParameters) {
+    console_start();
+    register_runtime_console_commands();
+    console_loop("gateway> ", NULL);
+    vTaskDelete(NULL);
+}
+
 
 // ===== WiFi 이벤트 핸들러 =====
 
@@ -642,22 +1052,58 @@ static void initialize_sntp(void) {
 
 // ===== 층 브로드캐스트 태스크 =====
 
-// 층 브로드캐스트 태스크 (1초마다 ESP-NOW로 전송)
+// 층 브로드캐스트 태스크 (1초마다 ESP-NOW로 이웃 리포트 전송)
+// 층 번호와 함께 자신의 AP BSSID/채널, 주변에서 들린 게이트웨이 목록을 알려
+// 비콘이 스캔 없이 FTM 대상 게이트웨이를 찾을 수 있게 함
+// 이웃 리포트 이전 비콘은 1바이트 층 프레임만 받으므로 같은 주기에 레거시 프레임도 보냄
+// (모든 비콘이 이웃 리포트 펌웨어로 바뀐 뒤 idf.py -DGATEWAY_FLOOR_LEGACY_BROADCAST=0 build 로 끔)
 static void floor_broadcast_task(void *pvParameters) {
     ESP_LOGI(TAG, "층 브로드캐스트 태스크 시작");
 
-    int8_t floor_data = (int8_t)my_floor_number;
+    static swift_neighbor_report_t report;
+    static swift_neighbor_t new_neighbors[SWIFT_NEIGHBOR_MAX];
+    uint8_t frame[SWIFT_FRAME_MAX_SIZE];
     TickType_t last_wake_time = xTaskGetTickCount();
 
+    esp_wifi_get_mac(WIFI_IF_AP, report.bssid);
+    report.floor = (int8_t)my_floor_number;
+
     while (1) {
         // 충돌 방지 지터
         int jitter = esp_random() % 200 - 100;
 
-        // ESP-NOW 브로드캐스트로 층 번호 전송
-        esp_err_t result = esp_now_send(broadcast_mac, (const uint8_t*)&floor_data, sizeof(floor_data));
+        // STA 재연결로 채널이 바뀔 수 있으므로 매번 확인
+        wifi_second_chan_t second;
+        esp_wifi_get_channel(&report.channel, &second);
+
+        uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        report.neighbor_count = (uint8_t)neighbor_table_snapshot(report.neighbors, SWIFT_NEIGHBOR_MAX, now_ms);
+
+        // 수신 콜백은 로그를 남기지 않으므로 새 이웃은 여기서 기록
+        int new_count = neighbor_table_take_new(new_neighbors, SWIFT_NEIGHBOR_MAX);
+        for (int i = 0; i < new_count; i++) {
+            ESP_LOGI(TAG, "새 이웃 게이트웨이: "MACSTR" (채널 %d, %d층, RSSI %d)",
+                    MAC2STR(new_neighbors[i].bssid), new_neighbors[i].channel,
+                    new_neighbors[i].floor, new_neighbors[i].rssi);
+        }
+
+        // ESP-NOW 브로드캐스트로 이웃 리포트 전송
+        size_t frame_len = 0;
+        esp_err_t result = swift_frame_encode_neighbor_report(&report, frame, sizeof(frame), &frame_len);
+        if (result == ESP_OK) {
+            result = esp_now_send(broadcast_mac, frame, frame_len);
+        }
+
+#if FLOOR_LEGACY_BROADCAST
+        // 레거시 층 프레임 (층 번호 1바이트)
+        if (result == ESP_OK) {
+            result = esp_now_send(broadcast_mac, (const uint8_t *)&report.floor, sizeof(report.floor));
+        }
+#endif
 
         if (result == ESP_OK) {
-            ESP_LOGD(TAG, "층 브로드캐스트 전송: %d", floor_data);
+            ESP_LOGD(TAG, "층 브로드캐스트 전송: %d층, 채널 %d, 이웃 %d개",
+                    report.floor, report.channel, report.neighbor_count);
         } else {
             ESP_LOGW(TAG, "층 브로드캐스트 실패: %s", esp_err_to_name(result));
         }
@@ -667,179 +1113,141 @@ static void floor_broadcast_task(void *pvParameters) {
 }
 
 
-// ===== 칼만 필터 함수 =====
-
-// 칼만 필터 초기화
-static void kalman_filter_init(kalman_filter_state_t *kf, float initial_value, float initial_variance) {
-    kf->x = initial_value;
-    kf->P = initial_variance;
-    kf->Q = 0.05;  // 프로세스 노이즈
-    kf->R = 0.0;   // 측정 분산
-    kf->last_update_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-    kf->initialized = true;
-}
-
-// 칼만 필터 업데이트
-static float kalman_filter_update(kalman_filter_state_t *kf, float measurement, float measurement_variance, float dt) {
-    if (!kf->initialized) {
-        ESP_LOGE(TAG, "칼만 필터가 초기화되지 않음");
-        return measurement;
+// ===== 데이터 중계 태스크 (수신/필터 단계) =====
+
+// 수신 단계 통계 로깅
+static void log_ingest_stats(void) {
+    ingest_ring_stats_t ring;
+    uploader_stats_t up;
+    beacon_table_stats_t table;
+    kalman_filter_stats_t kf;
+    relay_pipeline_stats_t relay;
+    ingest_ring_get_stats(&ring);
+    uploader_get_stats(&up);
+    beacon_table_get_stats(&table);
+    kalman_filter_get_stats(&kf);
+    relay_pipeline_get_stats(&relay);
+    ESP_LOGI(TAG, "수신 통계: 수신=%" PRIu32 ", 링 폐기=%" PRIu32 ", 링 최고 수위=%" PRIu32 "/%d, "
+            "알 수 없는 프레임=%" PRIu32 ", 디코딩 실패=%" PRIu32 ", "
+            "레코드 버퍼 폐기=%" PRIu32 ", 레코드 버퍼 최고 수위=%" PRIu32 "/%d",
+            ring.received, ring.dropped, ring.high_water, INGEST_RING_SLOTS,
+            ingest_stats.unknown_frames, relay.decode_errors,
+            up.records_dropped, up.queue_high_water, RECORD_QUEUE_LENGTH);
+    ESP_LOGI(TAG, "위치 계산: 성공=%" PRIu32 ", 실패=%" PRIu32 ", 등록 앵커=%d",
+            relay.positions_solved, relay.position_failures, anchor_registry_count());
+    ESP_LOGI(TAG, "칼만 필터: 업데이트=%" PRIu32 ", 게이트 밖=%" PRIu32 ", 기동=%" PRIu32 ", 재초기화=%" PRIu32,
+            kf.updates, kf.gated, kf.maneuvers, kf.reinitialized);
+    ESP_LOGI(TAG, "상태 테이블: 엔트리=%" PRIu32 "/%d, 만료=%" PRIu32 ", 밀려남=%" PRIu32 ", 최장 탐사=%" PRIu32,
+            table.count, BEACON_TABLE_CAPACITY, table.expired, table.evicted, table.max_probe);
+    seq_tracker_stats_t seq;
+    seq_beacon_stats_t worst[SEQ_LOG_WORST_BEACONS];
+    seq_tracker_get_stats(&seq);
+    ESP_LOGI(TAG, "사이클 번호: 추적=%" PRIu32 "/%d, 수신=%" PRIu32 ", 중복=%" PRIu32 ", 손실=%" PRIu32
+            ", 번호 없음=%" PRIu32 ", 밀려남=%" PRIu32,
+            seq.tracked, SEQ_TRACKER_CAPACITY, seq.accepted, seq.duplicates, seq.lost, seq.unsequenced, seq.evicted);
+    int worst_count = seq_tracker_worst(worst, SEQ_LOG_WORST_BEACONS);
+    for (int i = 0; i < worst_count; i++) {
+        uint32_t expected = worst[i].received + worst[i].lost;
+        ESP_LOGI(TAG, "  %s: 손실률 %.1f%%, 중복률 %.1f%% (수신 %" PRIu32 ", 손실 %" PRIu32 ", 중복 %" PRIu32 ", 재시작 %" PRIu32 ")",
+                worst[i].serial_number,
+                expected ? 100.0 * worst[i].lost / expected : 0.0,
+                worst[i].received ? 100.0 * worst[i].duplicates / worst[i].received : 0.0,
+                worst[i].received, worst[i].lost, worst[i].duplicates, worst[i].restarts);
     }
-
-    // 예측 단계
-    float x_pred = kf->x;
-    float P_pred = kf->P + kf->Q * dt;
-
-    // 업데이트 단계
-    kf->R = measurement_variance;
-
-    // 칼만 이득
-    float K = P_pred / (P_pred + kf->R);
-
-    // 추정값 업데이트
-    kf->x = x_pred + K * (measurement - x_pred);
-    kf->P = (1.0f - K) * P_pred;
-
-    // 타임스탬프 업데이트
-    kf->last_update_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-
-    ESP_LOGI(TAG, "칼만 업데이트: 측정=%.2f, 분산=%.4f, 예측=%.2f, 이득=%.3f, 추정=%.2f, P=%.4f",
-            measurement, measurement_variance, x_pred, K, kf->x, kf->P);
-
-    return kf->x;
+    slot_scheduler_stats_t slot;
+    slot_scheduler_get_stats(&slot);
+    ESP_LOGI(TAG, "TDMA 슬롯: 사용=%" PRIu32 "/%d, 슬롯=%d ms (깨어남 p%d %d ms), 배정=%" PRIu32 ", 회수=%" PRIu32
+            ", 공유=%" PRIu32 ", 재배치=%" PRIu32,
+            slot.active, slot.slot_count, slot.slot_ms, TDMA_WAKE_PERCENTILE, slot.wake_ms,
+            slot.assigned, slot.reclaimed, slot.shared, slot.relayouts);
 }
 
-// 기존 엔트리 찾기 또는 새로 생성
-static beacon_anchor_entry_t* find_or_create_entry(const char *serial_number, const uint8_t *anchor_mac) {
-    uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-
-    // 먼저 기존 엔트리 찾기
-    for (int i = 0; i < beacon_anchor_count; i++) {
-        if (strcmp(beacon_anchor_states[i].serial_number, serial_number) == 0 &&
-            memcmp(beacon_anchor_states[i].anchor_mac, anchor_mac, 6) == 0) {
-            beacon_anchor_states[i].last_seen = current_time;
-            return &beacon_anchor_states[i];
-        }
-    }
-
-    // 없으면 공간이 있을 때 새 엔트리 생성
-    if (beacon_anchor_count < MAX_BEACONS * MAX_ANCHORS_PER_BEACON) {
-        beacon_anchor_entry_t *entry = &beacon_anchor_states[beacon_anchor_count];
-        strncpy(entry->serial_number, serial_number, sizeof(entry->serial_number) - 1);
-        memcpy(entry->anchor_mac, anchor_mac, 6);
-        entry->last_seen = current_time;
-        entry->kf_state.initialized = false;
-        beacon_anchor_count++;
-
-        ESP_LOGI(TAG, "새 엔트리 생성: %s - "MACSTR" (총 %d개)",
-                serial_number, MAC2STR(anchor_mac), beacon_anchor_count);
-        return entry;
+// 상태 레코드 수집 (업로더 태스크 / 콘솔 태스크에서 호출, 다른 태스크의 카운터는 복사 시점 값)
+static void collect_health_record(health_record_t *out) {
+    ingest_ring_stats_t ring;
+    uploader_stats_t up;
+    beacon_table_stats_t table;
+    seq_tracker_stats_t seq;
+    slot_scheduler_stats_t slot;
+    relay_pipeline_stats_t relay;
+    ingest_ring_get_stats(&ring);
+    uploader_get_stats(&up);
+    beacon_table_get_stats(&table);
+    seq_tracker_get_stats(&seq);
+    slot_scheduler_get_stats(&slot);
+    relay_pipeline_get_stats(&relay);
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    out->gateway = my_device_name;
+    out->timestamp_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    out->uptime_sec = (uint32_t)(esp_timer_get_time() / 1000000);
+    out->free_heap = esp_get_free_heap_size();
+    out->min_free_heap = esp_get_minimum_free_heap_size();
+
+    out->received = ring.received;
+    out->ring_dropped = ring.dropped;
+    out->decode_errors = relay.decode_errors;
+    out->unknown_frames = ingest_stats.unknown_frames;
+    out->duplicates = seq.duplicates;
+    out->lost = seq.lost;
+
+    out->records_sent = up.records_sent;
+    out->records_dropped = up.records_dropped;
+    out->records_failed = up.records_failed;
+    out->records_spooled = up.records_spooled;
+    out->spool_pending = spool_pending();
+    pipeline_metrics_get_http_stats(&out->http);
+
+    out->beacon_table_evicted = table.evicted;
+    out->beacon_table_expired = table.expired;
+    out->seq_evicted = seq.evicted;
+    out->slot_reclaimed = slot.reclaimed;
+    out->slot_shared = slot.shared;
+
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        pipeline_metrics_get_histogram((pipeline_stage_t)stage, &out->latency[stage]);
     }
-
-    // 공간이 없으면 오래된 엔트리 정리 후 재시도
-    ESP_LOGW(TAG, "새 엔트리 공간 없음, 오래된 엔트리 정리 중");
-    cleanup_old_entries();
-
-    // 정리 후 재시도
-    if (beacon_anchor_count < MAX_BEACONS * MAX_ANCHORS_PER_BEACON) {
-        beacon_anchor_entry_t *entry = &beacon_anchor_states[beacon_anchor_count];
-        strncpy(entry->serial_number, serial_number, sizeof(entry->serial_number) - 1);
-        memcpy(entry->anchor_mac, anchor_mac, 6);
-        entry->last_seen = current_time;
-        entry->kf_state.initialized = false;
-        beacon_anchor_count++;
-        return entry;
-    }
-
-    ESP_LOGE(TAG, "엔트리 생성 실패, 배열 가득 참");
-    return NULL;
 }
 
-// 오래된 엔트리 정리 (BEACON_TIMEOUT_MS 이상)
-static void cleanup_old_entries(void) {
-    uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-    int write_idx = 0;
-    int removed = 0;
-
-    for (int read_idx = 0; read_idx < beacon_anchor_count; read_idx++) {
-        if (current_time - beacon_anchor_states[read_idx].last_seen < BEACON_TIMEOUT_MS) {
-            if (write_idx != read_idx) {
-                beacon_anchor_states[write_idx] = beacon_anchor_states[read_idx];
-            }
-            write_idx++;
-        } else {
-            removed++;
-            ESP_LOGI(TAG, "오래된 엔트리 제거: %s - "MACSTR,
-                    beacon_anchor_states[read_idx].serial_number,
-                    MAC2STR(beacon_anchor_states[read_idx].anchor_mac));
+// 비콘에 TDMA 슬롯 배정을 브로드캐스트 (비콘은 전송 직후 잠깐 수신 대기, 시리얼로 자기 것만 받음)
+// 중계 파이프라인의 리포트 훅: 재전송된 중복에도 응답, 합성 비콘은 무선으로 보내지 않음
+// 중복이 아닌 리포트만 리포트 수와 깨어남 프로파일(있으면)을 슬롯 길이 추정에 반영
+static void send_slot_assignment(const swift_beacon_report_t *report, bool duplicate) {
+    const char *serial_number = report->serial_number;
+    if (load_generator_is_synthetic(serial_number)) {
+        return;
+    }
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t now_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+
+    if (!duplicate) {
+        slot_scheduler_note_report(now_ms);
+        if (report->has_profile) {
+            slot_scheduler_note_wake(&report->profile, now_ms);
         }
     }
 
-    beacon_anchor_count = write_idx;
-    if (removed > 0) {
-        ESP_LOGI(TAG, "정리 완료: %d개 제거, %d개 남음", removed, beacon_anchor_count);
+    swift_slot_assignment_t assignment;
+    uint8_t frame[SWIFT_FRAME_MAX_SIZE];
+    size_t frame_len = 0;
+    esp_err_t err = slot_scheduler_assign(serial_number, now_ms, &assignment);
+    if (err == ESP_OK) {
+        err = swift_frame_encode_slot_assignment(&assignment, frame, sizeof(frame), &frame_len);
     }
-}
-
-
-// ===== HTTP 서버 전송 =====
-
-// JSON 데이터를 서버로 전송
-static esp_err_t send_json_to_server(const char *json_data) {
-    esp_http_client_config_t config = {
-        .url = SERVER_URL,
-        .method = HTTP_METHOD_POST,
-        .timeout_ms = 5000,
-        .buffer_size = 2048,
-    };
-
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    if (client == NULL) {
-        ESP_LOGE(TAG, "HTTP 클라이언트 초기화 실패");
-        return ESP_FAIL;
+    if (err == ESP_OK) {
+        err = esp_now_send(broadcast_mac, frame, frame_len);
     }
-
-    // 헤더 설정
-    esp_http_client_set_header(client, "Content-Type", "application/json");
-
-    // POST 데이터 설정
-    esp_http_client_set_post_field(client, json_data, strlen(json_data));
-
-    // HTTP 요청 수행 (재시도 포함)
-    esp_err_t err = ESP_FAIL;
-    for (int retry = 0; retry < MAX_HTTP_RETRY_COUNT; retry++) {
-        err = esp_http_client_perform(client);
-
-        if (err == ESP_OK) {
-            int status_code = esp_http_client_get_status_code(client);
-            if (status_code == 200 || status_code == 201) {
-                ESP_LOGI(TAG, "HTTP POST 성공, 상태: %d", status_code);
-                break;
-            } else {
-                ESP_LOGW(TAG, "HTTP POST 상태 코드 반환: %d", status_code);
-                err = ESP_FAIL;
-            }
-        } else {
-            ESP_LOGW(TAG, "HTTP POST 실패 (시도 %d/%d): %s",
-                    retry + 1, MAX_HTTP_RETRY_COUNT, esp_err_to_name(err));
-        }
-
-        if (retry < MAX_HTTP_RETRY_COUNT - 1) {
-            vTaskDelay(pdMS_TO_TICKS(1000));
-        }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "슬롯 배정 전송 실패 (%s): %s", serial_number, esp_err_to_name(err));
     }
-
-    esp_http_client_cleanup(client);
-    return err;
 }
 
-
-// ===== 데이터 중계 태스크 =====
-
-// 데이터 중계 태스크
+// 데이터 중계 태스크: 수신 링 → 칼만 필터 → 업로더 레코드 버퍼 (업로드로 블록되지 않음, 처리는 relay_pipeline)
 static void data_relay_task(void *pvParameters) {
     ESP_LOGI(TAG, "데이터 중계 태스크 시작");
-    beacon_data_packet_t packet;
+    uint32_t processed = 0;
 
     // STA 연결 대기
     xEventGroupWaitBits(wifi_event_group, STA_CONNECTED_BIT, false, true, portMAX_DELAY);
@@ -848,169 +1256,94 @@ static void data_relay_task(void *pvParameters) {
     // SNTP 초기화
     initialize_sntp();
 
+    // 업로더 태스크 시작 (HTTP / MQTT 전송은 별도 태스크에서 수행)
+    const uploader_config_t uploader_config = {
+        .http_url = SERVER_BATCH_URL,
+        .mqtt_uri = MQTT_BROKER_URI,
+        .device_name = my_device_name,
+        .health_url = SERVER_HEALTH_URL,
+        .collect_health = collect_health_record,
+    };
+    if (uploader_start(&uploader_config, wifi_event_group, STA_CONNECTED_BIT) != ESP_OK) {
+        ESP_LOGE(TAG, "업로더 시작 실패");
+        vTaskDelete(NULL);
+        return;
+    }
+
     ESP_LOGI(TAG, "데이터 중계 준비 완료");
 
     while (1) {
-        // 큐에서 비콘 데이터 대기
-        if (xQueueReceive(data_recv_queue, &packet, portMAX_DELAY) == pdTRUE) {
-            ESP_LOGI(TAG, "비콘 데이터 처리 중: %s", packet.serial_number);
-
-            // 타임스탬프 업데이트 (ISO 8601 UTC with milliseconds)
-            struct timeval tv;
-            gettimeofday(&tv, NULL);
-            struct tm timeinfo;
-            gmtime_r(&tv.tv_sec, &timeinfo);
-
-            // 밀리초 계산
-            int milliseconds = tv.tv_usec / 1000;
-
-            // 포맷: YYYY-MM-DDTHH:MM:SS.sssZ
-            snprintf(packet.timestamp, sizeof(packet.timestamp),
-                    "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
-                    timeinfo.tm_year + 1900,
-                    timeinfo.tm_mon + 1,
-                    timeinfo.tm_mday,
-                    timeinfo.tm_hour,
-                    timeinfo.tm_min,
-                    timeinfo.tm_sec,
-                    milliseconds);
-            ESP_LOGI(TAG, "타임스탬프 업데이트: %s (UTC)", packet.timestamp);
-
-            // JSON 객체 생성
-            cJSON *root = cJSON_CreateObject();
-            if (root == NULL) {
-                ESP_LOGE(TAG, "JSON 객체 생성 실패");
-                continue;
+        // 수신 링 → 디코딩 → 중복 제거 → 칼만/위치 계산 → 업로더 (relay_pipeline)
+        if (relay_pipeline_step(portMAX_DELAY)) {
+            if (++processed % INGEST_STATS_LOG_INTERVAL == 0) {
+                log_ingest_stats();
             }
+        }
+    }
+}
 
-            // 비콘 데이터 추가 (순서: battery_level, floor, measurements, serial_number, timestamp)
-            cJSON_AddNumberToObject(root, "battery_level", packet.battery_level);
-            cJSON_AddNumberToObject(root, "floor", packet.floor);
-
-            // 측정값 배열 추가 (칼만 필터링)
-            cJSON *measurements = cJSON_CreateArray();
-            for (int i = 0; i < 3; i++) {
-                // 측정값이 유효한지 확인 (0이 아닌 MAC)
-                bool valid = false;
-                for (int j = 0; j < 6; j++) {
-                    if (packet.measurements[i].anchor_mac[j] != 0) {
-                        valid = true;
-                        break;
-                    }
-                }
 
-                if (valid) {
-                    cJSON *measurement = cJSON_CreateObject();
-
-                    // MAC 주소 포맷
-                    char mac_str[18];
-                    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-                            packet.measurements[i].anchor_mac[0],
-                            packet.measurements[i].anchor_mac[1],
-                            packet.measurements[i].anchor_mac[2],
-                            packet.measurements[i].anchor_mac[3],
-                            packet.measurements[i].anchor_mac[4],
-                            packet.measurements[i].anchor_mac[5]);
-
-                    // 칼만 필터 적용
-                    beacon_anchor_entry_t *entry = find_or_create_entry(
-                        packet.serial_number,
-                        packet.measurements[i].anchor_mac
-                    );
-
-                    float filtered_distance = packet.measurements[i].distance_meters;
-
-                    if (entry != NULL) {
-                        // 칼만 필터 초기화
-                        if (!entry->kf_state.initialized) {
-                            kalman_filter_init(&entry->kf_state,
-                                             packet.measurements[i].distance_meters,
-                                             packet.measurements[i].variance);
-                            filtered_distance = entry->kf_state.x;
-                            ESP_LOGI(TAG, "%s - "MACSTR" 칼만 필터 초기화: 거리=%.2f, 분산=%.4f",
-                                    packet.serial_number, MAC2STR(packet.measurements[i].anchor_mac),
-                                    packet.measurements[i].distance_meters,
-                                    packet.measurements[i].variance);
-                        } else {
-                            // 시간 간격 계산
-                            uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-                            float dt = (current_time - entry->kf_state.last_update_time) / 1000.0f;  // 초 단위
-
-                            // 칼만 필터 업데이트
-                            filtered_distance = kalman_filter_update(
-                                &entry->kf_state,
-                                packet.measurements[i].distance_meters,
-                                packet.measurements[i].variance,
-                                dt
-                            );
-
-                            ESP_LOGI(TAG, "%s - "MACSTR" 칼만 필터 업데이트: 원본=%.2f -> 필터=%.2f (dt=%.2fs)",
-                                    packet.serial_number, MAC2STR(packet.measurements[i].anchor_mac),
-                                    packet.measurements[i].distance_meters, filtered_distance, dt);
-                        }
-                    } else {
-                        ESP_LOGW(TAG, "칼만 필터 엔트리 획득 실패, 원본 거리 사용");
-                    }
-
-                    // 칼만 필터링된 거리 사용
-                    cJSON_AddStringToObject(measurement, "anchor_mac", mac_str);
-                    cJSON_AddNumberToObject(measurement, "distance_meters", filtered_distance);
-                    cJSON_AddNumberToObject(measurement, "rssi", packet.measurements[i].rssi);
-                    cJSON_AddNumberToObject(measurement, "rtt_nanoseconds", packet.measurements[i].rtt_nanoseconds);
-
-                    ESP_LOGI(TAG, "측정값 추가: %s 거리=%.2f (원본=%.2f) rssi=%d RTT=%"PRIu32" ns",
-                            mac_str, filtered_distance, packet.measurements[i].distance_meters,
-                            packet.measurements[i].rssi, packet.measurements[i].rtt_nanoseconds);
-
-                    cJSON_AddItemToArray(measurements, measurement);
-                }
-            }
-            cJSON_AddItemToObject(root, "measurements", measurements);
-
-            // serial_number와 timestamp 추가 (순서 유지)
-            cJSON_AddStringToObject(root, "serial_number", packet.serial_number);
-            cJSON_AddStringToObject(root, "timestamp", packet.timestamp);
-
-            // 문자열로 변환
-            char *json_string = cJSON_PrintUnformatted(root);
-            if (json_string) {
-                ESP_LOGI(TAG, "JSON 데이터: %s", json_string);
-
-                // 서버로 전송
-                if (send_json_to_server(json_string) == ESP_OK) {
-                    ESP_LOGI(TAG, "데이터 서버 전송 성공");
-                } else {
-                    ESP_LOGE(TAG, "데이터 서버 전송 실패");
-                }
+// ===== 트레이스 덤프 태스크 =====
 
-                free(json_string);
-            }
+// 로그 출력 훅: 경고/오류 줄이면 덤프 태스크를 깨우고 출력은 원래 함수로 넘김
+// 어느 태스크에서든 호출되므로 알림만 보내고 여기서 덤프하지 않음
+static int trace_log_vprintf(const char *format, va_list args) {
+    const char *level = format;
+    if (level[0] == '\033') {
+        // CONFIG_LOG_COLORS: 색 코드 ("\033[0;33m") 뒤가 레벨 글자
+        const char *color_end = strchr(level, 'm');
+        level = color_end != NULL ? color_end + 1 : level;
+    }
+    if ((level[0] == 'W' || level[0] == 'E') && level[1] == ' ') {
+        xTaskNotifyGive(trace_dump_task_handle);
+    }
+    return default_log_vprintf(format, args);
+}
 
-            cJSON_Delete(root);
+// 트레이스 덤프 태스크 (중계 태스크보다 낮은 우선순위, UART 출력이 수신 경로를 막지 않음)
+// 평소에는 링을 RAM 에 두고 덮어쓰다가 경고/오류 로그나 trace_dump 명령이 오면 직전 레코드를 출력
+// 디버그 프로파일에서는 링이 반쯤 찰 때마다 계속 덤프
+static void trace_dump_task(void *pvParameters) {
+    while (1) {
+#if SWIFT_TRACE_TEXT_LOG
+        bool requested = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TRACE_DUMP_POLL_MS)) > 0;
+        if (requested || swift_trace_pending() >= TRACE_DUMP_THRESHOLD) {
+            swift_trace_dump();
         }
+#else
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        swift_trace_dump();
+#endif
     }
 }
 
 
 // ===== ESP-NOW 수신 콜백 =====
 
-// 비콘 데이터 수신 콜백
+// 비콘 데이터 수신 콜백 (Wi-Fi 태스크, 로그 없이 링 슬롯에 한 번 복사하고 바로 반환)
 static void beacon_data_recv_cb(const esp_now_recv_info_t *recv_info, const uint8_t *data, int len) {
-    if (len == sizeof(beacon_data_packet_t)) {
-        ESP_LOGI(TAG, "비콘 데이터 수신: "MACSTR, MAC2STR(recv_info->src_addr));
-
-        // 큐에 전송
-        beacon_data_packet_t packet;
-        memcpy(&packet, data, sizeof(beacon_data_packet_t));
-
-        if (xQueueSend(data_recv_queue, &packet, 0) != pdTRUE) {
-            ESP_LOGW(TAG, "비콘 데이터 큐 전송 실패");
+    if (swift_frame_is_beacon_report(data, len)) {
+        // 가득 차면 폐기 (통계는 ingest_ring 이 집계, 중계 태스크가 주기적으로 로그)
+        // 부하 생성 중에는 생성기가 링의 유일한 생산자이므로 버림
+        if (!load_generator_active()) {
+            ingest_ring_push(data, (size_t)len);
         }
-    } else if (len == 1) {
-        // 다른 게이트웨이의 층 브로드캐스트
-        ESP_LOGD(TAG, "다른 게이트웨이로부터 층 브로드캐스트 수신");
+    } else if (swift_frame_is_neighbor_report(data, len)) {
+        // 다른 게이트웨이의 층/이웃 브로드캐스트 (이웃 목록은 다시 퍼뜨리지 않고 송신자만 기록)
+        static swift_neighbor_report_t neighbor_report;
+        if (swift_frame_decode_neighbor_report(data, len, &neighbor_report) == ESP_OK &&
+            neighbor_report.channel != 0) {
+            neighbor_table_update(neighbor_report.bssid, neighbor_report.channel, neighbor_report.floor,
+                                  (int8_t)recv_info->rx_ctrl->rssi,
+                                  xTaskGetTickCount() * portTICK_PERIOD_MS);
+        } else {
+            ESP_LOGD(TAG, "다른 게이트웨이로부터 레거시 층 브로드캐스트 수신");
+        }
+    } else if (swift_frame_is_slot_assignment(data, len)) {
+        // 다른 게이트웨이가 비콘에 보낸 슬롯 배정
+        ESP_LOGD(TAG, "다른 게이트웨이의 슬롯 배정 수신");
     } else {
-        ESP_LOGW(TAG, "알 수 없는 ESP-NOW 데이터 수신 (길이 %d)", len);
+        ingest_stats.unknown_frames++;
     }
 }
 
@@ -1028,6 +1361,11 @@ void app_main(void) {
     }
     ESP_ERROR_CHECK(ret);
 
+    // 앵커 좌표 레지스트리 로드 (없으면 위치 계산 없이 거리만 업로드)
+    if (anchor_registry_load() != ESP_OK) {
+        ESP_LOGW(TAG, "앵커 좌표 레지스트리 로드 실패, 거리만 업로드");
+    }
+
     // NVS에서 설정 로드
     if (load_config_from_nvs() != ESP_OK) {
         // 설정을 찾을 수 없으면 프로비저닝 콘솔 실행
@@ -1056,12 +1394,9 @@ void app_main(void) {
     };
     ESP_ERROR_CHECK(esp_now_add_peer(&broadcast_peer));
 
-    // 비콘 데이터용 큐 생성
-    data_recv_queue = xQueueCreate(10, sizeof(beacon_data_packet_t));
-    if (data_recv_queue == NULL) {
-        ESP_LOGE(TAG, "데이터 수신 큐 생성 실패");
-        return;
-    }
+    // 중계 파이프라인 (비콘-앵커 상태 테이블, 사이클 번호 추적), TDMA 슬롯 배정 초기화
+    relay_pipeline_init(send_slot_assignment);
+    slot_scheduler_init();
 
     // 층 브로드캐스트 태스크 생성
     xTaskCreate(floor_broadcast_task, "floor_broadcast", 4096, NULL, 5, NULL);
@@ -1069,6 +1404,13 @@ void app_main(void) {
     // 데이터 중계 태스크 생성
     xTaskCreate(data_relay_task, "data_relay", 8192, NULL, 10, NULL);
 
+    // 트레이스 덤프 태스크 생성 후 경고/오류 로그 훅 등록
+    xTaskCreate(trace_dump_task, "trace_dump", 3072, NULL, 2, &trace_dump_task_handle);
+    default_log_vprintf = esp_log_set_vprintf(trace_log_vprintf);
+
+    // 운영 중 콘솔 태스크 생성 (stats, trace_dump 명령)
+    xTaskCreate(runtime_console_task, "console", 4096, NULL, 1, NULL);
+
     ESP_LOGI(TAG, "게이트웨이 운영 중 - AP: %s, 층: %" PRId32, AP_SSID, my_floor_number);
     ESP_LOGI(TAG, "비콘 데이터 대기 중...");
 }
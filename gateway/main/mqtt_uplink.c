@@ -0,0 +1,157 @@
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "mqtt_client.h"
+#include "mqtt_uplink.h"
+
+// ===== 설정 상수 =====
+#define MQTT_UPLINK_KEEPALIVE_SEC 30        // MQTT keep-alive 간격
+#define MQTT_UPLINK_RECONNECT_MS 2000       // 연결 끊김 후 재연결 대기
+
+static const char *TAG = "MQTT_UPLINK";
+
+// ===== 전역 변수 =====
+static esp_mqtt_client_handle_t s_client = NULL;   // 프로그램 수명 동안 유지되는 클라이언트
+static SemaphoreHandle_t s_window = NULL;          // 남은 발행 윈도우 (PUBACK 마다 반환)
+static volatile bool s_connected = false;
+static mqtt_uplink_stats_t s_stats = {0};
+
+
+// ===== 내부 함수 =====
+
+// 윈도우 한 칸 반환
+static void mqtt_uplink_release_slot(void) {
+    xSemaphoreGive(s_window);
+}
+
+// MQTT 이벤트 핸들러 (연결 상태 및 PUBACK 추적)
+static void mqtt_uplink_event_handler(void *handler_args, esp_event_base_t base,
+                                      int32_t event_id, void *event_data) {
+    esp_mqtt_event_handle_t event = event_data;
+
+    switch ((esp_mqtt_event_id_t)event_id) {
+        case MQTT_EVENT_CONNECTED:
+            s_connected = true;
+            s_stats.connects++;
+            ESP_LOGI(TAG, "브로커 연결됨 (세션 유지=%d, 미확인 %" PRIu32 "개)",
+                    event->session_present, mqtt_uplink_in_flight());
+            break;
+
+        case MQTT_EVENT_DISCONNECTED:
+            s_connected = false;
+            ESP_LOGW(TAG, "브로커 연결 끊김, 미확인 메시지는 재연결 후 재전송");
+            break;
+
+        case MQTT_EVENT_PUBLISHED:
+            // QoS1 PUBACK 수신
+            s_stats.acked++;
+            mqtt_uplink_release_slot();
+            break;
+
+        case MQTT_EVENT_DELETED:
+            // 아웃박스 만료로 PUBACK 없이 삭제됨
+            s_stats.expired++;
+            ESP_LOGW(TAG, "PUBACK 없이 만료된 메시지: msg_id=%d", event->msg_id);
+            mqtt_uplink_release_slot();
+            break;
+
+        case MQTT_EVENT_ERROR:
+            ESP_LOGW(TAG, "MQTT 오류 이벤트");
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+// ===== 공개 함수 =====
+
+// 영구 세션 MQTT 클라이언트 생성 및 연결 시작
+esp_err_t mqtt_uplink_init(const char *broker_uri, const char *client_id) {
+    if (s_client != NULL) {
+        return ESP_OK;
+    }
+
+    s_window = xSemaphoreCreateCounting(MQTT_UPLINK_WINDOW, MQTT_UPLINK_WINDOW);
+    if (s_window == NULL) {
+        ESP_LOGE(TAG, "발행 윈도우 생성 실패");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 세션을 유지해 재연결 시에도 미확인 QoS1 메시지를 이어서 전송
+    esp_mqtt_client_config_t config = {
+        .broker.address.uri = broker_uri,
+        .credentials.client_id = client_id,
+        .session.disable_clean_session = true,
+        .session.keepalive = MQTT_UPLINK_KEEPALIVE_SEC,
+        .network.reconnect_timeout_ms = MQTT_UPLINK_RECONNECT_MS,
+    };
+
+    s_client = esp_mqtt_client_init(&config);
+    if (s_client == NULL) {
+        ESP_LOGE(TAG, "MQTT 클라이언트 초기화 실패");
+        return ESP_FAIL;
+    }
+
+    esp_mqtt_client_register_event(s_client, ESP_EVENT_ANY_ID, mqtt_uplink_event_handler, NULL);
+    esp_err_t err = esp_mqtt_client_start(s_client);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "MQTT 클라이언트 시작 실패: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    ESP_LOGI(TAG, "MQTT 업링크 시작: %s (client_id=%s, 윈도우 %d)",
+            broker_uri, client_id, MQTT_UPLINK_WINDOW);
+    return ESP_OK;
+}
+
+// 브로커 연결 여부
+bool mqtt_uplink_is_connected(void) {
+    return s_client != NULL && s_connected;
+}
+
+// QoS1 발행
+esp_err_t mqtt_uplink_publish(const char *topic, const void *data, size_t len, uint32_t timeout_ms) {
+    if (s_client == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 윈도우가 가득 차면 PUBACK 으로 자리가 날 때까지 대기
+    if (xSemaphoreTake(s_window, 0) != pdTRUE) {
+        s_stats.window_stalls++;
+        if (xSemaphoreTake(s_window, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+            ESP_LOGW(TAG, "발행 윈도우 대기 시간 초과 (미확인 %d개)", MQTT_UPLINK_WINDOW);
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+
+    int msg_id = esp_mqtt_client_publish(s_client, topic, data, (int)len, 1, 0);
+    if (msg_id < 0) {
+        mqtt_uplink_release_slot();
+        s_stats.failures++;
+        return ESP_FAIL;
+    }
+
+    s_stats.published++;
+    uint32_t in_flight = mqtt_uplink_in_flight();
+    if (in_flight > s_stats.max_in_flight) {
+        s_stats.max_in_flight = in_flight;
+    }
+    return ESP_OK;
+}
+
+// 현재 미확인 메시지 수
+uint32_t mqtt_uplink_in_flight(void) {
+    if (s_window == NULL) {
+        return 0;
+    }
+    return MQTT_UPLINK_WINDOW - (uint32_t)uxSemaphoreGetCount(s_window);
+}
+
+// MQTT 업링크 통계 복사
+void mqtt_uplink_get_stats(mqtt_uplink_stats_t *out) {
+    *out = s_stats;
+}
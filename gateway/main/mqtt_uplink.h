@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// ===== MQTT 업링크 (영구 세션, QoS1 파이프라이닝) =====
+#define MQTT_UPLINK_WINDOW 8                // PUBACK 을 기다리지 않고 동시에 보낼 수 있는 최대 QoS1 메시지 수
+
+// MQTT 업링크 통계
+typedef struct {
+    uint32_t published;                     // 브로커로 보낸 QoS1 메시지 수
+    uint32_t acked;                         // PUBACK 을 받은 메시지 수
+    uint32_t expired;                       // PUBACK 없이 아웃박스에서 만료된 메시지 수
+    uint32_t failures;                      // 전송 큐에 넣지 못한 메시지 수
+    uint32_t window_stalls;                 // 윈도우가 가득 차 대기한 횟수
+    uint32_t max_in_flight;                 // 최대 동시 미확인 메시지 수
+    uint32_t connects;                      // 브로커 연결 수립 횟수
+} mqtt_uplink_stats_t;
+
+// 영구 세션 MQTT 클라이언트 생성 및 연결 시작
+// broker_uri / client_id 는 프로그램 수명 동안 유효해야 함
+esp_err_t mqtt_uplink_init(const char *broker_uri, const char *client_id);
+
+// 브로커 연결 여부
+bool mqtt_uplink_is_connected(void);
+
+// QoS1 발행 (PUBACK 을 기다리지 않음)
+// 미확인 메시지가 MQTT_UPLINK_WINDOW 개면 자리가 날 때까지 최대 timeout_ms 대기
+esp_err_t mqtt_uplink_publish(const char *topic, const void *data, size_t len, uint32_t timeout_ms);
+
+// 현재 미확인 (PUBACK 대기 중) 메시지 수
+uint32_t mqtt_uplink_in_flight(void);
+
+// MQTT 업링크 통계 복사
+void mqtt_uplink_get_stats(mqtt_uplink_stats_t *out);
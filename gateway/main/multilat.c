@@ -0,0 +1,169 @@
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#include "multilat.h"
+
+#define MULTILAT_MIN_DET 1e-6f              // 정규방정식 행렬식 하한 (앵커 기하 퇴화 판정)
+#define MULTILAT_MAX_STEP_HALVINGS 8        // 비용이 줄지 않을 때 가우스-뉴턴 스텝을 반으로 줄이는 최대 횟수
+
+// 2x2 대칭 행렬 [a b; b c] 로 연립방정식 풀기 (행렬식이 너무 작으면 false)
+static bool solve_2x2(float a, float b, float c, float r0, float r1, float *x0, float *x1) {
+    float det = a * c - b * b;
+    if (!(fabsf(det) > MULTILAT_MIN_DET * (a * c + 1e-12f))) {
+        return false;
+    }
+    *x0 = (c * r0 - b * r1) / det;
+    *x1 = (a * r1 - b * r0) / det;
+    return true;
+}
+
+// 가중 잔차제곱합
+static float weighted_cost(const multilat_range_t *ranges, const float *horizontal, const float *weight,
+                           int count, float x, float y) {
+    float cost = 0;
+    for (int i = 0; i < count; i++) {
+        float dx = x - ranges[i].anchor.x;
+        float dy = y - ranges[i].anchor.y;
+        float e = horizontal[i] - sqrtf(dx * dx + dy * dy);
+        cost += weight[i] * e * e;
+    }
+    return cost;
+}
+
+// 선형화 초기값: 마지막 앵커 식을 빼서 만든 선형 방정식의 가중 최소제곱 해
+// 실패하면 가중 무게중심 사용
+static void initial_guess(const multilat_range_t *ranges, const float *horizontal, const float *weight,
+                          int count, float *x, float *y) {
+    const multilat_range_t *ref = &ranges[count - 1];
+    float a = 0, b = 0, c = 0, r0 = 0, r1 = 0;
+    for (int i = 0; i < count - 1; i++) {
+        float ax = 2.0f * (ranges[i].anchor.x - ref->anchor.x);
+        float ay = 2.0f * (ranges[i].anchor.y - ref->anchor.y);
+        float rhs = horizontal[count - 1] * horizontal[count - 1] - horizontal[i] * horizontal[i]
+                  + ranges[i].anchor.x * ranges[i].anchor.x - ref->anchor.x * ref->anchor.x
+                  + ranges[i].anchor.y * ranges[i].anchor.y - ref->anchor.y * ref->anchor.y;
+        float w = weight[i];
+        a += w * ax * ax;
+        b += w * ax * ay;
+        c += w * ay * ay;
+        r0 += w * ax * rhs;
+        r1 += w * ay * rhs;
+    }
+    if (solve_2x2(a, b, c, r0, r1, x, y)) {
+        return;
+    }
+
+    float sum_w = 0;
+    *x = 0;
+    *y = 0;
+    for (int i = 0; i < count; i++) {
+        *x += weight[i] * ranges[i].anchor.x;
+        *y += weight[i] * ranges[i].anchor.y;
+        sum_w += weight[i];
+    }
+    *x /= sum_w;
+    *y /= sum_w;
+}
+
+// 거리 측정들로 수평 위치 계산
+esp_err_t multilat_solve(const multilat_range_t *ranges, int count, multilat_fix_t *out) {
+    if (count < MULTILAT_MIN_ANCHORS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (count > MULTILAT_MAX_ANCHORS) {
+        count = MULTILAT_MAX_ANCHORS;
+    }
+
+    // 높이 차를 빼서 수평 거리로 환산, 분산 역수를 가중치로 사용
+    float horizontal[MULTILAT_MAX_ANCHORS];
+    float weight[MULTILAT_MAX_ANCHORS];
+    for (int i = 0; i < count; i++) {
+        if (!isfinite(ranges[i].distance)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        float dz = ranges[i].anchor.z - MULTILAT_BEACON_HEIGHT_M;
+        float h2 = ranges[i].distance * ranges[i].distance - dz * dz;
+        horizontal[i] = (h2 > 0.0f) ? sqrtf(h2) : 0.0f;
+        float variance = ranges[i].variance > MULTILAT_MIN_VARIANCE ? ranges[i].variance : MULTILAT_MIN_VARIANCE;
+        weight[i] = 1.0f / variance;
+    }
+
+    float x, y;
+    initial_guess(ranges, horizontal, weight, count, &x, &y);
+
+    // 가우스-뉴턴: (J^T W J) dp = J^T W e
+    float a = 0, b = 0, c = 0;
+    int iter = 0;
+    bool solved = false;
+    while (iter < MULTILAT_MAX_ITERATIONS) {
+        float r0 = 0, r1 = 0;
+        a = b = c = 0;
+        for (int i = 0; i < count; i++) {
+            float dx = x - ranges[i].anchor.x;
+            float dy = y - ranges[i].anchor.y;
+            float dist = sqrtf(dx * dx + dy * dy);
+            if (dist < 1e-3f) {
+                dist = 1e-3f;    // 앵커 바로 위: 방향 미정, 미소 거리로 대체
+            }
+            float jx = dx / dist;
+            float jy = dy / dist;
+            float e = horizontal[i] - dist;
+            a += weight[i] * jx * jx;
+            b += weight[i] * jx * jy;
+            c += weight[i] * jy * jy;
+            r0 += weight[i] * jx * e;
+            r1 += weight[i] * jy * e;
+        }
+
+        float step_x, step_y;
+        if (!solve_2x2(a, b, c, r0, r1, &step_x, &step_y)) {
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        // 거리들이 서로 맞지 않으면 (다중경로 등) 전체 스텝이 비용을 키우며 발산할 수 있으므로
+        // 비용이 줄어들 때까지 스텝을 반으로 줄임. 끝까지 줄지 않으면 이미 최솟값 근처
+        float cost = weighted_cost(ranges, horizontal, weight, count, x, y);
+        int halvings = 0;
+        while (!(weighted_cost(ranges, horizontal, weight, count, x + step_x, y + step_y) <= cost) &&
+               halvings < MULTILAT_MAX_STEP_HALVINGS) {
+            step_x *= 0.5f;
+            step_y *= 0.5f;
+            halvings++;
+        }
+        iter++;
+        if (halvings == MULTILAT_MAX_STEP_HALVINGS) {
+            solved = true;
+            break;
+        }
+        x += step_x;
+        y += step_y;
+        if (sqrtf(step_x * step_x + step_y * step_y) < MULTILAT_CONVERGENCE_M) {
+            solved = true;
+            break;
+        }
+    }
+    if (!solved) {
+        // 한도에서 멈춘 해는 최솟값에서 수 m 떨어져 있을 수 있으므로 내보내지 않음
+        return ESP_ERR_TIMEOUT;
+    }
+
+    // 위치 공분산 (J^T W J)^-1 대각합, 가중 잔차 RMS
+    float det = a * c - b * b;
+    float sum_w = 0, sum_we2 = 0;
+    for (int i = 0; i < count; i++) {
+        float dx = x - ranges[i].anchor.x;
+        float dy = y - ranges[i].anchor.y;
+        float e = horizontal[i] - sqrtf(dx * dx + dy * dy);
+        sum_w += weight[i];
+        sum_we2 += weight[i] * e * e;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->x = x;
+    out->y = y;
+    out->variance = (a + c) / det;
+    out->residual_rms = sqrtf(sum_we2 / sum_w);
+    out->anchors_used = (uint8_t)count;
+    out->iterations = (uint8_t)iter;
+    return ESP_OK;
+}
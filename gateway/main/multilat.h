@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "anchor_registry.h"
+
+// ===== 가중 최소제곱 다변측량 =====
+#define MULTILAT_MIN_ANCHORS 3              // 위치 계산에 필요한 최소 앵커 수
+#define MULTILAT_MAX_ANCHORS 6              // 한 번에 사용하는 최대 앵커 수
+#define MULTILAT_BEACON_HEIGHT_M 1.0f       // 비콘 높이 가정 (수평 거리 환산용)
+#define MULTILAT_MIN_VARIANCE 0.0025f       // 분산 하한 (m², 가중치 폭주 방지)
+#define MULTILAT_MAX_ITERATIONS 20          // 가우스-뉴턴 최대 반복 수 (넘으면 수렴 실패)
+#define MULTILAT_CONVERGENCE_M 0.001f       // 수렴 판정 이동량 (m)
+
+// 거리 측정 하나 (앵커 좌표 + 거리 + 분산)
+typedef struct {
+    anchor_position_t anchor;               // 앵커 좌표
+    float distance;                         // 앵커까지 거리 (m)
+    float variance;                         // 거리 분산 (m²), 가중치 = 1 / 분산
+} multilat_range_t;
+
+// 위치 해
+typedef struct {
+    float x;
+    float y;
+    float variance;                         // 위치 공분산 대각합 (m², 정확도 = sqrt)
+    float residual_rms;                     // 가중 잔차 RMS (m)
+    uint8_t anchors_used;                   // 사용한 앵커 수
+    uint8_t iterations;                     // 가우스-뉴턴 반복 수
+} multilat_fix_t;
+
+// 거리 측정들로 수평 위치 (x, y) 계산
+// 선형화 최소제곱으로 초기값을 잡고 가우스-뉴턴으로 가중 잔차제곱합 최소화
+// 앵커가 부족하거나 거리가 유한하지 않으면 ESP_ERR_INVALID_ARG, 앵커 배치가 일직선 등으로 풀 수 없으면 ESP_ERR_INVALID_STATE,
+// 거리들이 서로 크게 어긋나 반복 한도 안에 수렴하지 않으면 ESP_ERR_TIMEOUT
+esp_err_t multilat_solve(const multilat_range_t *ranges, int count, multilat_fix_t *out);
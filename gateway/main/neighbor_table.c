@@ -0,0 +1,97 @@
+#include <string.h>
+#include "neighbor_table.h"
+#include "freertos/FreeRTOS.h"
+
+// 이웃 엔트리
+typedef struct {
+    swift_neighbor_t info;                  // BSSID, 채널, 층, RSSI
+    uint32_t last_seen;                     // 마지막 수신 시간 (밀리초)
+    bool announced;                         // neighbor_table_take_new 로 넘겼는지
+} neighbor_entry_t;
+
+static neighbor_entry_t neighbors[SWIFT_NEIGHBOR_MAX];
+static int neighbor_count = 0;
+static portMUX_TYPE neighbor_lock = portMUX_INITIALIZER_UNLOCKED;   // 수신 콜백 ↔ 브로드캐스트 태스크
+
+// 이웃 게이트웨이 갱신 (수신 콜백이므로 로그 없이 테이블만 고침, 새 이웃은 take_new 로 알림)
+void neighbor_table_update(const uint8_t *bssid, uint8_t channel, int8_t floor, int8_t rssi, uint32_t now_ms) {
+    portENTER_CRITICAL(&neighbor_lock);
+    int index = 0;
+    while (index < neighbor_count && memcmp(neighbors[index].info.bssid, bssid, 6) != 0) {
+        index++;
+    }
+    bool is_new = (index == neighbor_count);
+    if (is_new) {
+        if (neighbor_count < SWIFT_NEIGHBOR_MAX) {
+            neighbor_count++;
+        } else {
+            // 가득 차면 가장 약한 이웃보다 셀 때만 교체
+            int weakest = 0;
+            for (int i = 1; i < neighbor_count; i++) {
+                if (neighbors[i].info.rssi < neighbors[weakest].info.rssi) {
+                    weakest = i;
+                }
+            }
+            index = (rssi > neighbors[weakest].info.rssi) ? weakest : -1;
+        }
+    }
+    if (index >= 0) {
+        if (is_new) {
+            memcpy(neighbors[index].info.bssid, bssid, 6);
+            neighbors[index].announced = false;
+        }
+        neighbors[index].info.channel = channel;
+        neighbors[index].info.floor = floor;
+        neighbors[index].info.rssi = rssi;
+        neighbors[index].last_seen = now_ms;
+    }
+    portEXIT_CRITICAL(&neighbor_lock);
+}
+
+// 만료 정리 후 신호가 센 순서로 복사
+int neighbor_table_snapshot(swift_neighbor_t *out, int max, uint32_t now_ms) {
+    int count = 0;
+
+    portENTER_CRITICAL(&neighbor_lock);
+    for (int i = 0; i < neighbor_count; ) {
+        if (now_ms - neighbors[i].last_seen > NEIGHBOR_TIMEOUT_MS) {
+            neighbors[i] = neighbors[--neighbor_count];
+            continue;
+        }
+        i++;
+    }
+
+    // 삽입 정렬로 RSSI 내림차순 복사 (최대 SWIFT_NEIGHBOR_MAX 개)
+    for (int i = 0; i < neighbor_count; i++) {
+        const swift_neighbor_t *n = &neighbors[i].info;
+        int pos = (count < max) ? count++ : max;
+        while (pos > 0 && out[pos - 1].rssi < n->rssi) {
+            if (pos < max) {
+                out[pos] = out[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < max) {
+            out[pos] = *n;
+        }
+    }
+    portEXIT_CRITICAL(&neighbor_lock);
+
+    return count;
+}
+
+// 아직 알리지 않은 새 이웃을 최대 max 개 복사하고 알린 것으로 표시, 복사한 수 반환
+int neighbor_table_take_new(swift_neighbor_t *out, int max) {
+    int count = 0;
+
+    portENTER_CRITICAL(&neighbor_lock);
+    for (int i = 0; i < neighbor_count && count < max; i++) {
+        if (!neighbors[i].announced) {
+            neighbors[i].announced = true;
+            out[count++] = neighbors[i].info;
+        }
+    }
+    portEXIT_CRITICAL(&neighbor_lock);
+
+    return count;
+}
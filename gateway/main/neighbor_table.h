@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include "swift_frame.h"
+
+// ===== 이웃 게이트웨이 테이블 =====
+// 다른 게이트웨이의 이웃 리포트 브로드캐스트로 학습 (같은 채널에서 들리는 게이트웨이만)
+#define NEIGHBOR_TIMEOUT_MS 30000           // 이 시간 동안 들리지 않은 이웃은 제거
+
+// 이웃 게이트웨이 갱신 (ESP-NOW 수신 콜백에서 호출, 로그를 남기지 않음)
+void neighbor_table_update(const uint8_t *bssid, uint8_t channel, int8_t floor, int8_t rssi, uint32_t now_ms);
+
+// 만료된 이웃을 정리하고 신호가 센 순서로 최대 max 개 복사, 복사한 수 반환
+int neighbor_table_snapshot(swift_neighbor_t *out, int max, uint32_t now_ms);
+
+// 수신 콜백이 새로 추가한 이웃 중 아직 넘기지 않은 것을 최대 max 개 복사, 복사한 수 반환
+// (로그는 브로드캐스트 태스크가 이 결과로 남김)
+int neighbor_table_take_new(swift_neighbor_t *out, int max);
@@ -0,0 +1,105 @@
+#include "pipeline_metrics.h"
+#include "esp_timer.h"
+
+// 버킷 상한 (마이크로초, 마지막 버킷은 그 이상 전부)
+static const uint32_t bucket_upper_us[PIPELINE_HIST_BUCKETS - 1] = {
+    100, 250, 500,
+    1000, 2500, 5000,
+    10000, 25000, 50000,
+    100000, 250000, 500000,
+    1000000, 2500000, 5000000,
+};
+
+static const char *const stage_names[PIPELINE_STAGE_COUNT] = {
+    "ring", "filter", "queue", "upload", "total",
+};
+
+static pipeline_histogram_t histograms[PIPELINE_STAGE_COUNT];
+static pipeline_http_stats_t http_stats;
+
+
+// ===== 기록 =====
+
+// 현재 시각 (esp_timer 하위 32비트)
+uint32_t pipeline_now_us(void) {
+    return (uint32_t)esp_timer_get_time();
+}
+
+// 단계 지연 기록
+void pipeline_metrics_record(pipeline_stage_t stage, uint32_t from_us, uint32_t to_us) {
+    uint32_t elapsed = to_us - from_us;
+    pipeline_histogram_t *hist = &histograms[stage];
+
+    int bucket = 0;
+    while (bucket < PIPELINE_HIST_BUCKETS - 1 && elapsed > bucket_upper_us[bucket]) {
+        bucket++;
+    }
+    hist->buckets[bucket]++;
+    hist->count++;
+    hist->sum_us += elapsed;
+    if (elapsed > hist->max_us) {
+        hist->max_us = elapsed;
+    }
+}
+
+// HTTP 배치 요청 결과 기록
+void pipeline_metrics_note_http(int status_code, bool retry) {
+    if (retry) {
+        http_stats.retries++;
+    }
+    http_stats.last_status = status_code;
+    if (status_code == 0) {
+        http_stats.transport_errors++;
+    } else if (status_code >= 200 && status_code < 300) {
+        http_stats.status_2xx++;
+    } else if (status_code >= 400 && status_code < 500) {
+        http_stats.status_4xx++;
+    } else if (status_code >= 500 && status_code < 600) {
+        http_stats.status_5xx++;
+    } else {
+        http_stats.status_other++;
+    }
+}
+
+
+// ===== 조회 =====
+
+// 단계 히스토그램 복사
+void pipeline_metrics_get_histogram(pipeline_stage_t stage, pipeline_histogram_t *out) {
+    *out = histograms[stage];
+}
+
+// HTTP 카운터 복사
+void pipeline_metrics_get_http_stats(pipeline_http_stats_t *out) {
+    *out = http_stats;
+}
+
+// 버킷 상한
+uint32_t pipeline_bucket_upper_us(int bucket) {
+    return bucket < PIPELINE_HIST_BUCKETS - 1 ? bucket_upper_us[bucket] : UINT32_MAX;
+}
+
+// 백분위 추정 (버킷 상한, 최대값보다 크게 보고하지 않음)
+uint32_t pipeline_histogram_percentile(const pipeline_histogram_t *hist, int percent) {
+    if (hist->count == 0) {
+        return 0;
+    }
+    uint64_t rank = ((uint64_t)hist->count * percent + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < PIPELINE_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = pipeline_bucket_upper_us(i);
+            return upper < hist->max_us ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+// 단계 이름
+const char *pipeline_stage_name(pipeline_stage_t stage) {
+    return stage < PIPELINE_STAGE_COUNT ? stage_names[stage] : "?";
+}
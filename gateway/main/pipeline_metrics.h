@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ===== 처리 단계별 지연 계측 =====
+// 레코드마다 수신 → 꺼냄 → 필터 → 직렬화 → 업로드 시각을 찍고 단계 간 지연을 고정 버킷 히스토그램에 누적
+// 시각은 esp_timer 하위 32비트 (마이크로초, 약 71분마다 돌아가지만 차이는 부호 없는 뺄셈으로 계산)
+// 히스토그램마다 기록하는 태스크는 하나 (수신 링/필터 = 중계 태스크, 나머지 = 업로더 태스크)
+
+#define PIPELINE_HIST_BUCKETS 16            // 히스토그램 버킷 수 (100us ~ 5s, 1-2.5-5 간격 + 초과)
+
+// 지연 단계
+typedef enum {
+    PIPELINE_STAGE_RING = 0,                // 수신 콜백 → 중계 태스크가 꺼냄 (수신 링 대기)
+    PIPELINE_STAGE_FILTER,                  // 꺼냄 → 필터 완료 (디코딩, 중복 확인, 칼만, 위치 계산)
+    PIPELINE_STAGE_QUEUE,                   // 필터 완료 → 직렬화 (업로더 레코드 버퍼 대기)
+    PIPELINE_STAGE_UPLOAD,                  // 직렬화 → 업로드 성공 (배치 대기 + 전송)
+    PIPELINE_STAGE_TOTAL,                   // 수신 → 업로드 성공
+    PIPELINE_STAGE_COUNT
+} pipeline_stage_t;
+
+// 레코드별 단계 시각 (업로더 레코드 버퍼까지 레코드와 함께 전달, 스풀에는 저장하지 않음)
+typedef struct {
+    uint32_t rx_us;                         // ESP-NOW 수신 콜백
+    uint32_t dequeue_us;                    // 중계 태스크가 수신 링에서 꺼냄
+    uint32_t filter_us;                     // 필터 완료 (업로더로 넘김)
+    uint32_t serialize_us;                  // 업로더가 배치에 직렬화
+} pipeline_stamps_t;
+
+// 지연 히스토그램
+typedef struct {
+    uint32_t count;                         // 기록 수
+    uint32_t max_us;                        // 최대 지연
+    uint64_t sum_us;                        // 지연 합 (평균 계산용)
+    uint32_t buckets[PIPELINE_HIST_BUCKETS];    // 버킷별 기록 수 (상한은 pipeline_bucket_upper_us)
+} pipeline_histogram_t;
+
+// HTTP 배치 업로드 결과 카운터
+typedef struct {
+    uint32_t retries;                       // 같은 배치를 다시 보낸 횟수
+    uint32_t status_2xx;                    // 상태 코드별 응답 수
+    uint32_t status_4xx;
+    uint32_t status_5xx;
+    uint32_t status_other;                  // 1xx / 3xx / 알 수 없는 코드
+    uint32_t transport_errors;              // 응답 없이 실패한 요청 수 (연결/타임아웃)
+    int last_status;                        // 마지막 상태 코드 (0 = 전송 오류)
+} pipeline_http_stats_t;
+
+// 현재 시각 (esp_timer 하위 32비트, 마이크로초)
+uint32_t pipeline_now_us(void);
+
+// from_us → to_us 지연을 단계 히스토그램에 기록
+void pipeline_metrics_record(pipeline_stage_t stage, uint32_t from_us, uint32_t to_us);
+
+// HTTP 배치 요청 결과 기록 (status_code 0 = 응답 없음, retry = 같은 배치의 재시도)
+void pipeline_metrics_note_http(int status_code, bool retry);
+
+// 단계 히스토그램 복사
+void pipeline_metrics_get_histogram(pipeline_stage_t stage, pipeline_histogram_t *out);
+
+// HTTP 카운터 복사
+void pipeline_metrics_get_http_stats(pipeline_http_stats_t *out);
+
+// 버킷 상한 (마이크로초, 마지막 버킷은 UINT32_MAX)
+uint32_t pipeline_bucket_upper_us(int bucket);
+
+// 백분위 추정 (해당 기록이 들어 있는 버킷의 상한, 마지막 버킷이면 max_us, 기록이 없으면 0)
+uint32_t pipeline_histogram_percentile(const pipeline_histogram_t *hist, int percent);
+
+// 단계 이름 ("ring", "filter", "queue", "upload", "total")
+const char *pipeline_stage_name(pipeline_stage_t stage);
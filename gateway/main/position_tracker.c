@@ -0,0 +1,34 @@
+#include <math.h>
+#include "position_tracker.h"
+
+// 새 측위 결과로 추적 상태 갱신
+void position_tracker_update(position_track_t *track, const multilat_fix_t *fix, uint32_t now_ms,
+                             float *x, float *y, float *accuracy) {
+    // 측위 공분산 대각합을 축당 분산으로 환산
+    float R = fix->variance * 0.5f;
+    if (!(R > POSITION_MIN_VARIANCE)) {
+        R = POSITION_MIN_VARIANCE;
+    }
+
+    if (!track->initialized) {
+        track->x = fix->x;
+        track->y = fix->y;
+        track->P = R;
+        track->initialized = true;
+    } else {
+        // 예측 단계 (랜덤 워크)
+        float dt = (now_ms - track->last_update_time) / 1000.0f;
+        float P_pred = track->P + POSITION_PROCESS_NOISE * dt;
+
+        // 업데이트 단계
+        float K = P_pred / (P_pred + R);
+        track->x += K * (fix->x - track->x);
+        track->y += K * (fix->y - track->y);
+        track->P = (1.0f - K) * P_pred;
+    }
+    track->last_update_time = now_ms;
+
+    *x = track->x;
+    *y = track->y;
+    *accuracy = sqrtf(2.0f * track->P);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "multilat.h"
+
+// ===== 비콘 위치 추적 =====
+#define POSITION_PROCESS_NOISE 0.5f         // 위치 프로세스 노이즈 (m²/s, 보행 속도 수준)
+#define POSITION_MIN_VARIANCE 0.01f         // 측위 분산 하한 (축당 m²)
+
+// 비콘별 위치 추적 상태 (x, y 축 공통 분산의 랜덤 워크 칼만 필터)
+typedef struct {
+    float x;                                // 추정 위치 (m)
+    float y;
+    float P;                                // 축당 추정 분산 (m²)
+    uint32_t last_update_time;              // 마지막 업데이트 타임스탬프 (밀리초)
+    bool initialized;                       // 초기화 플래그
+} position_track_t;
+
+// 새 측위 결과로 추적 상태 갱신, 필터링된 위치와 정확도(m) 반환
+void position_tracker_update(position_track_t *track, const multilat_fix_t *fix, uint32_t now_ms,
+                             float *x, float *y, float *accuracy);
@@ -0,0 +1,151 @@
+#include <stdbool.h>
+#include <string.h>
+#include "record_cbor.h"
+
+// ===== CBOR 주 타입 (RFC 8949) =====
+#define CBOR_UINT 0
+#define CBOR_NEGINT 1
+#define CBOR_BYTES 2
+#define CBOR_TEXT 3
+#define CBOR_ARRAY 4
+#define CBOR_MAP 5
+#define CBOR_FLOAT32 0xFA
+
+// ===== 스트리밍 쓰기 버퍼 =====
+// 넘치면 overflow 만 표시하고 이후 쓰기는 무시 (마지막에 한 번만 검사)
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+    bool overflow;
+} cbor_out_t;
+
+// 바이트 열 쓰기
+static void put_bytes(cbor_out_t *out, const void *src, size_t n) {
+    if (out->overflow || out->len + n > out->size) {
+        out->overflow = true;
+        return;
+    }
+    memcpy(&out->buf[out->len], src, n);
+    out->len += n;
+}
+
+// 주 타입 + 값 (가장 짧은 인코딩)
+static void put_head(cbor_out_t *out, uint8_t major, uint64_t value) {
+    uint8_t head[9];
+    size_t n;
+    if (value < 24) {
+        head[0] = (uint8_t)((major << 5) | value);
+        n = 1;
+    } else if (value <= 0xFF) {
+        head[0] = (uint8_t)((major << 5) | 24);
+        head[1] = (uint8_t)value;
+        n = 2;
+    } else if (value <= 0xFFFF) {
+        head[0] = (uint8_t)((major << 5) | 25);
+        head[1] = (uint8_t)(value >> 8);
+        head[2] = (uint8_t)value;
+        n = 3;
+    } else if (value <= 0xFFFFFFFFu) {
+        head[0] = (uint8_t)((major << 5) | 26);
+        for (int i = 0; i < 4; i++) {
+            head[1 + i] = (uint8_t)(value >> (24 - 8 * i));
+        }
+        n = 5;
+    } else {
+        head[0] = (uint8_t)((major << 5) | 27);
+        for (int i = 0; i < 8; i++) {
+            head[1 + i] = (uint8_t)(value >> (56 - 8 * i));
+        }
+        n = 9;
+    }
+    put_bytes(out, head, n);
+}
+
+// 부호 있는 정수
+static void put_int(cbor_out_t *out, int64_t value) {
+    if (value < 0) {
+        put_head(out, CBOR_NEGINT, (uint64_t)(-1 - value));
+    } else {
+        put_head(out, CBOR_UINT, (uint64_t)value);
+    }
+}
+
+// 단정밀도 실수 (비트 그대로 빅 엔디언)
+static void put_float32(cbor_out_t *out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint8_t data[5] = {CBOR_FLOAT32, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16),
+                       (uint8_t)(bits >> 8), (uint8_t)bits};
+    put_bytes(out, data, sizeof(data));
+}
+
+
+// ===== 공개 함수 =====
+
+// 레코드를 CBOR 맵으로 직렬화
+esp_err_t record_cbor_encode(const relay_record_t *record, uint8_t *buf, size_t buf_size, size_t *out_len) {
+    cbor_out_t out = {.buf = buf, .size = buf_size, .len = 0, .overflow = false};
+    int count = record->measurement_count < RELAY_MAX_MEASUREMENTS ? record->measurement_count
+                                                                   : RELAY_MAX_MEASUREMENTS;
+
+    put_head(&out, CBOR_MAP, 5 + (record->position_anchors > 0 ? 1 : 0) + (record->has_sequence ? 1 : 0) +
+                             (record->has_profile ? 1 : 0));
+
+    size_t serial_len = strnlen(record->serial_number, sizeof(record->serial_number));
+    put_head(&out, CBOR_UINT, RECORD_CBOR_KEY_SERIAL);
+    put_head(&out, CBOR_TEXT, serial_len);
+    put_bytes(&out, record->serial_number, serial_len);
+
+    put_head(&out, CBOR_UINT, RECORD_CBOR_KEY_BATTERY);
+    put_head(&out, CBOR_UINT, record->battery_level);
+
+    put_head(&out, CBOR_UINT, RECORD_CBOR_KEY_FLOOR);
+    put_int(&out, record->floor);
+
+    put_head(&out, CBOR_UINT, RECORD_CBOR_KEY_TIMESTAMP);
+    put_int(&out, record->timestamp_ms);
+
+    put_head(&out, CBOR_UINT, RECORD_CBOR_KEY_MEASUREMENTS);
+    put_head(&out, CBOR_ARRAY, (uint64_t)count);
+    for (int i = 0; i < count; i++) {
+        put_head(&out, CBOR_ARRAY, 4);
+        put_head(&out, CBOR_BYTES, 6);
+        put_bytes(&out, record->measurements[i].anchor_mac, 6);
+        put_float32(&out, record->measurements[i].distance_meters);
+        put_int(&out, record->measurements[i].rssi);
+        put_head(&out, CBOR_UINT, record->measurements[i].rtt_nanoseconds);
+    }
+
+    if (record->position_anchors > 0) {
+        put_head(&out, CBOR_UINT, RECORD_CBOR_KEY_POSITION);
+        put_head(&out, CBOR_ARRAY, 4);
+        put_float32(&out, record->position_x);
+        put_float32(&out, record->position_y);
+        put_float32(&out, record->position_accuracy);
+        put_head(&out, CBOR_UINT, record->position_anchors);
+    }
+
+    if (record->has_sequence) {
+        put_head(&out, CBOR_UINT, RECORD_CBOR_KEY_SEQUENCE);
+        put_head(&out, CBOR_UINT, record->sequence);
+    }
+
+    if (record->has_profile) {
+        put_head(&out, CBOR_UINT, RECORD_CBOR_KEY_POWER_PROFILE);
+        put_head(&out, CBOR_ARRAY, 4);
+        put_head(&out, CBOR_UINT, record->profile.cycles);
+        put_head(&out, CBOR_UINT, record->profile.charge_dmas);
+        put_head(&out, CBOR_UINT, record->profile.radio_on_ms);
+        put_head(&out, CBOR_ARRAY, SWIFT_PHASE_COUNT);
+        for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+            put_head(&out, CBOR_UINT, record->profile.phase_ms[i]);
+        }
+    }
+
+    if (out.overflow) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    *out_len = out.len;
+    return ESP_OK;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "uploader.h"
+
+#define RECORD_CBOR_MAX_LEN 256             // 레코드 CBOR 최대 길이 (측정값 6개일 때 약 140바이트, 위치 포함 시 +18, 사이클 번호 +6, 전력 프로파일 +35)
+
+// 레코드 CBOR 맵 키 (README 의 CBOR 스키마와 동일해야 함)
+#define RECORD_CBOR_KEY_SERIAL 0            // text: 시리얼 번호
+#define RECORD_CBOR_KEY_BATTERY 1           // uint: 배터리 잔량 (%)
+#define RECORD_CBOR_KEY_FLOOR 2             // int: 층 번호
+#define RECORD_CBOR_KEY_TIMESTAMP 3         // uint: 게이트웨이 처리 시각 (UTC epoch 밀리초)
+#define RECORD_CBOR_KEY_MEASUREMENTS 4      // array of [bytes(6) mac, float32 distance_m, int rssi, uint rtt_ns]
+#define RECORD_CBOR_KEY_POSITION 5          // [float32 x, float32 y, float32 accuracy_m, uint anchors] (위치를 계산한 레코드만)
+#define RECORD_CBOR_KEY_SEQUENCE 6          // uint: 비콘 사이클 번호 (비콘이 보낸 경우만)
+#define RECORD_CBOR_KEY_POWER_PROFILE 7     // [uint cycles, uint charge_dmas, uint radio_on_ms, [uint phase_ms...]] (비콘이 보낸 경우만)
+
+// 레코드를 CBOR 맵으로 직렬화 (힙 할당 없이 buf 에 직접 기록)
+// 버퍼가 부족하면 ESP_ERR_INVALID_SIZE
+esp_err_t record_cbor_encode(const relay_record_t *record, uint8_t *buf, size_t buf_size, size_t *out_len);
@@ -0,0 +1,241 @@
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "record_json.h"
+
+// ===== 스트리밍 쓰기 버퍼 =====
+// 넘치면 overflow 만 표시하고 이후 쓰기는 무시 (마지막에 한 번만 검사)
+typedef struct {
+    char *buf;
+    size_t size;                            // NUL 자리를 뺀 사용 가능 크기
+    size_t len;
+    bool overflow;
+} json_out_t;
+
+static const char hex_upper[] = "0123456789ABCDEF";
+static const char hex_lower[] = "0123456789abcdef";
+
+// 바이트 열 쓰기
+static void put_bytes(json_out_t *out, const char *src, size_t n) {
+    if (out->overflow || out->len + n > out->size) {
+        out->overflow = true;
+        return;
+    }
+    memcpy(&out->buf[out->len], src, n);
+    out->len += n;
+}
+
+// 문자 하나 쓰기
+static void put_char(json_out_t *out, char c) {
+    if (out->overflow || out->len + 1 > out->size) {
+        out->overflow = true;
+        return;
+    }
+    out->buf[out->len++] = c;
+}
+
+// 리터럴 문자열 쓰기 (키 등 컴파일 시 길이가 정해진 문자열)
+#define PUT_LITERAL(out, s) put_bytes((out), (s), sizeof(s) - 1)
+
+// 부호 없는 정수를 최소 width 자리로 0 채워 쓰기
+static void put_uint(json_out_t *out, uint32_t value, int width) {
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (n < width) {
+        digits[n++] = '0';
+    }
+    while (n > 0) {
+        put_char(out, digits[--n]);
+    }
+}
+
+// 부호 있는 정수 쓰기
+static void put_int(json_out_t *out, int32_t value) {
+    if (value < 0) {
+        put_char(out, '-');
+        put_uint(out, (uint32_t)0 - (uint32_t)value, 1);
+    } else {
+        put_uint(out, (uint32_t)value, 1);
+    }
+}
+
+// 실수 쓰기 (cJSON print_number 와 같은 규칙)
+// 정수로 표현되는 값은 "%d", 그 외에는 "%1.15g" 로 쓰고 되읽은 값이 다르면 "%1.17g"
+static void put_double(json_out_t *out, double d) {
+    if (isnan(d) || isinf(d)) {
+        PUT_LITERAL(out, "null");
+        return;
+    }
+    if (d >= INT_MIN && d <= INT_MAX && d == (double)(int)d) {
+        put_int(out, (int)d);
+        return;
+    }
+
+    char number[26];
+    int n = snprintf(number, sizeof(number), "%1.15g", d);
+    double test = strtod(number, NULL);
+    double max_val = fabs(test) > fabs(d) ? fabs(test) : fabs(d);
+    if (!(fabs(test - d) <= max_val * DBL_EPSILON)) {
+        n = snprintf(number, sizeof(number), "%1.17g", d);
+    }
+    put_bytes(out, number, (size_t)n);
+}
+
+// 문자열 쓰기 (cJSON 과 같은 이스케이프 규칙, 제어 문자는 \u00xx)
+static void put_string(json_out_t *out, const char *s, size_t max_len) {
+    put_char(out, '"');
+    for (size_t i = 0; i < max_len && s[i] != '\0'; i++) {
+        unsigned char c = (unsigned char)s[i];
+        switch (c) {
+            case '"':  PUT_LITERAL(out, "\\\""); break;
+            case '\\': PUT_LITERAL(out, "\\\\"); break;
+            case '\b': PUT_LITERAL(out, "\\b"); break;
+            case '\f': PUT_LITERAL(out, "\\f"); break;
+            case '\n': PUT_LITERAL(out, "\\n"); break;
+            case '\r': PUT_LITERAL(out, "\\r"); break;
+            case '\t': PUT_LITERAL(out, "\\t"); break;
+            default:
+                if (c < 32) {
+                    char esc[6] = {'\\', 'u', '0', '0', hex_lower[c >> 4], hex_lower[c & 0x0F]};
+                    put_bytes(out, esc, sizeof(esc));
+                } else {
+                    put_char(out, (char)c);
+                }
+                break;
+        }
+    }
+    put_char(out, '"');
+}
+
+// MAC 주소 쓰기 ("AA:BB:CC:DD:EE:FF")
+static void put_mac(json_out_t *out, const uint8_t *mac) {
+    char text[19];
+    int n = 0;
+    text[n++] = '"';
+    for (int i = 0; i < 6; i++) {
+        if (i > 0) {
+            text[n++] = ':';
+        }
+        text[n++] = hex_upper[mac[i] >> 4];
+        text[n++] = hex_upper[mac[i] & 0x0F];
+    }
+    text[n++] = '"';
+    put_bytes(out, text, (size_t)n);
+}
+
+// 타임스탬프 쓰기: YYYY-MM-DDTHH:MM:SS.sssZ (UTC)
+static void put_timestamp(json_out_t *out, int64_t timestamp_ms) {
+    time_t seconds = (time_t)(timestamp_ms / 1000);
+    int milliseconds = (int)(timestamp_ms % 1000);
+    struct tm timeinfo;
+    gmtime_r(&seconds, &timeinfo);
+
+    put_char(out, '"');
+    put_uint(out, (uint32_t)(timeinfo.tm_year + 1900), 4);
+    put_char(out, '-');
+    put_uint(out, (uint32_t)(timeinfo.tm_mon + 1), 2);
+    put_char(out, '-');
+    put_uint(out, (uint32_t)timeinfo.tm_mday, 2);
+    put_char(out, 'T');
+    put_uint(out, (uint32_t)timeinfo.tm_hour, 2);
+    put_char(out, ':');
+    put_uint(out, (uint32_t)timeinfo.tm_min, 2);
+    put_char(out, ':');
+    put_uint(out, (uint32_t)timeinfo.tm_sec, 2);
+    put_char(out, '.');
+    put_uint(out, (uint32_t)milliseconds, 3);
+    PUT_LITERAL(out, "Z\"");
+}
+
+
+// ===== 공개 함수 =====
+
+// 레코드를 서버 JSON 객체로 직렬화
+esp_err_t record_json_encode(const relay_record_t *record, char *buf, size_t buf_size, size_t *out_len) {
+    if (buf_size == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    json_out_t out = {.buf = buf, .size = buf_size - 1, .len = 0, .overflow = false};
+
+    PUT_LITERAL(&out, "{\"battery_level\":");
+    put_uint(&out, record->battery_level, 1);
+    PUT_LITERAL(&out, ",\"floor\":");
+    put_int(&out, record->floor);
+
+    PUT_LITERAL(&out, ",\"measurements\":[");
+    for (int i = 0; i < record->measurement_count && i < RELAY_MAX_MEASUREMENTS; i++) {
+        if (i > 0) {
+            put_char(&out, ',');
+        }
+        PUT_LITERAL(&out, "{\"anchor_mac\":");
+        put_mac(&out, record->measurements[i].anchor_mac);
+        PUT_LITERAL(&out, ",\"distance_meters\":");
+        put_double(&out, record->measurements[i].distance_meters);
+        PUT_LITERAL(&out, ",\"rssi\":");
+        put_int(&out, record->measurements[i].rssi);
+        PUT_LITERAL(&out, ",\"rtt_nanoseconds\":");
+        put_uint(&out, record->measurements[i].rtt_nanoseconds, 1);
+        put_char(&out, '}');
+    }
+
+    put_char(&out, ']');
+
+    if (record->position_anchors > 0) {
+        PUT_LITERAL(&out, ",\"position\":{\"x\":");
+        put_double(&out, record->position_x);
+        PUT_LITERAL(&out, ",\"y\":");
+        put_double(&out, record->position_y);
+        PUT_LITERAL(&out, ",\"accuracy_meters\":");
+        put_double(&out, record->position_accuracy);
+        PUT_LITERAL(&out, ",\"anchors\":");
+        put_uint(&out, record->position_anchors, 1);
+        put_char(&out, '}');
+    }
+
+    if (record->has_profile) {
+        PUT_LITERAL(&out, ",\"power_profile\":{\"cycles\":");
+        put_uint(&out, record->profile.cycles, 1);
+        PUT_LITERAL(&out, ",\"charge_mas\":");
+        put_double(&out, record->profile.charge_dmas / 10.0);
+        PUT_LITERAL(&out, ",\"radio_on_ms\":");
+        put_uint(&out, record->profile.radio_on_ms, 1);
+        PUT_LITERAL(&out, ",\"phases_ms\":{");
+        for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+            if (i > 0) {
+                put_char(&out, ',');
+            }
+            const char *name = swift_phase_name((swift_phase_t)i);
+            put_string(&out, name, strlen(name));
+            put_char(&out, ':');
+            put_uint(&out, record->profile.phase_ms[i], 1);
+        }
+        PUT_LITERAL(&out, "}}");
+    }
+
+    if (record->has_sequence) {
+        PUT_LITERAL(&out, ",\"sequence\":");
+        put_uint(&out, record->sequence, 1);
+    }
+
+    PUT_LITERAL(&out, ",\"serial_number\":");
+    put_string(&out, record->serial_number, sizeof(record->serial_number));
+    PUT_LITERAL(&out, ",\"timestamp\":");
+    put_timestamp(&out, record->timestamp_ms);
+    put_char(&out, '}');
+
+    if (out.overflow) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    buf[out.len] = '\0';
+    *out_len = out.len;
+    return ESP_OK;
+}
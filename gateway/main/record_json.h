@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "uploader.h"
+
+#define RECORD_JSON_MAX_LEN 1280            // 레코드 JSON 객체 최대 길이 (측정값 6개와 전력 프로파일일 때 최대 약 1.1KB)
+
+// 레코드를 서버 JSON 객체로 직렬화 (힙 할당 없이 buf 에 직접 기록, NUL 종료)
+// 출력은 기존 cJSON_PrintUnformatted 결과와 바이트 단위로 동일 (host_test/test_record_json 에서 비교)
+// 키 순서: battery_level, floor, measurements[{anchor_mac, distance_meters, rssi, rtt_nanoseconds}],
+//          position{x, y, accuracy_meters, anchors} (위치를 계산한 레코드만),
+//          power_profile{cycles, charge_mas, radio_on_ms, phases_ms{boot, ...}} (비콘이 보낸 경우만),
+//          sequence (비콘이 보낸 경우만), serial_number, timestamp
+// 버퍼가 부족하면 ESP_ERR_INVALID_SIZE
+esp_err_t record_json_encode(const relay_record_t *record, char *buf, size_t buf_size, size_t *out_len);
@@ -0,0 +1,218 @@
+#include <string.h>
+#include <sys/time.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "beacon_table.h"
+#include "anchor_registry.h"
+#include "multilat.h"
+#include "position_tracker.h"
+#include "ingest_ring.h"
+#include "seq_tracker.h"
+#include "pipeline_metrics.h"
+#include "uploader.h"
+#include "relay_pipeline.h"
+#include "swift_frame.h"
+#include "swift_trace.h"
+
+static const char *TAG = "RELAY";
+
+// ===== 전역 변수 (데이터 중계 태스크 전용) =====
+static relay_report_hook_t report_hook = NULL;
+static relay_pipeline_stats_t stats;
+static swift_beacon_report_t step_report;   // 디코딩한 리포트 (태스크 스택 대신 정적 버퍼)
+static relay_record_t step_record;          // 업로더로 넘길 레코드
+
+static void solve_beacon_position(const char *serial_number, const multilat_range_t *ranges, int count,
+                                  relay_record_t *record);
+
+
+// ===== 필터 단계 =====
+
+// 비콘 리포트에 타임스탬프와 칼만 필터를 적용해 업로드 레코드 생성
+// 좌표가 등록된 앵커가 MULTILAT_MIN_ANCHORS 개 이상이면 거리 대신 위치를 계산해 담음
+static void filter_beacon_report(const swift_beacon_report_t *report, relay_record_t *record) {
+    multilat_range_t ranges[MULTILAT_MAX_ANCHORS];
+    int range_count = 0;
+
+    SWIFT_TRACE_LOGI(TAG, "비콘 데이터 처리 중: %s", report->serial_number);
+
+    memset(record, 0, sizeof(*record));
+    strncpy(record->serial_number, report->serial_number, sizeof(record->serial_number) - 1);
+    record->battery_level = report->battery_level;
+    record->floor = report->floor;
+    record->has_sequence = report->has_sequence;
+    record->sequence = report->sequence;
+    record->has_profile = report->has_profile;
+    record->profile = report->profile;
+
+    // 타임스탬프 기록 (UTC epoch 밀리초, 직렬화 시 ISO 8601로 변환)
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    record->timestamp_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+
+    // 측정값 칼만 필터링
+    for (int i = 0; i < report->measurement_count && i < RELAY_MAX_MEASUREMENTS; i++) {
+        // 칼만 필터 적용
+        beacon_anchor_entry_t *entry = beacon_table_find_or_create(
+            report->serial_number,
+            report->measurements[i].anchor_mac,
+            xTaskGetTickCount() * portTICK_PERIOD_MS
+        );
+
+        float filtered_distance = report->measurements[i].distance_meters;
+
+        // 칼만 필터 초기화
+        if (!entry->kf_state.initialized) {
+            kalman_filter_init(&entry->kf_state,
+                             report->measurements[i].distance_meters,
+                             report->measurements[i].variance);
+            filtered_distance = entry->kf_state.x;
+            swift_trace(SWIFT_TRACE_GW_KALMAN_INIT, 0, swift_trace_mac_tail(report->measurements[i].anchor_mac),
+                        swift_trace_milli(report->measurements[i].distance_meters),
+                        swift_trace_micro(report->measurements[i].variance));
+            SWIFT_TRACE_LOGI(TAG, "%s - "MACSTR" 칼만 필터 초기화: 거리=%.2f, 분산=%.4f",
+                    report->serial_number, MAC2STR(report->measurements[i].anchor_mac),
+                    report->measurements[i].distance_meters,
+                    report->measurements[i].variance);
+        } else {
+            // 시간 간격 계산
+            uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+            float dt = (current_time - entry->kf_state.last_update_time) / 1000.0f;  // 초 단위
+
+            // 칼만 필터 업데이트
+            filtered_distance = kalman_filter_update(
+                &entry->kf_state,
+                report->measurements[i].distance_meters,
+                report->measurements[i].variance,
+                dt
+            );
+
+            SWIFT_TRACE_LOGI(TAG, "%s - "MACSTR" 칼만 필터 업데이트: 원본=%.2f -> 필터=%.2f (dt=%.2fs)",
+                    report->serial_number, MAC2STR(report->measurements[i].anchor_mac),
+                    report->measurements[i].distance_meters, filtered_distance, dt);
+        }
+
+        // 칼만 필터링된 거리 사용
+        int n = record->measurement_count++;
+        memcpy(record->measurements[n].anchor_mac, report->measurements[i].anchor_mac, 6);
+        record->measurements[n].distance_meters = filtered_distance;
+        record->measurements[n].rssi = report->measurements[i].rssi;
+        record->measurements[n].rtt_nanoseconds = report->measurements[i].rtt_nanoseconds;
+
+        // 좌표가 등록된 앵커면 위치 계산에 사용 (칼만 사후 분산을 거리 분산으로)
+        if (range_count < MULTILAT_MAX_ANCHORS &&
+            anchor_registry_lookup(report->measurements[i].anchor_mac, &ranges[range_count].anchor)) {
+            ranges[range_count].distance = filtered_distance;
+            ranges[range_count].variance = entry->kf_state.P00;
+            range_count++;
+        }
+
+        swift_trace(SWIFT_TRACE_GW_MEASUREMENT, (uint8_t)report->measurements[i].rssi,
+                    swift_trace_mac_tail(report->measurements[i].anchor_mac),
+                    swift_trace_milli(filtered_distance), swift_trace_milli(report->measurements[i].distance_meters));
+        SWIFT_TRACE_LOGI(TAG, "측정값 추가: "MACSTR" 거리=%.2f (원본=%.2f) rssi=%d RTT=%"PRIu32" ns",
+                MAC2STR(report->measurements[i].anchor_mac), filtered_distance,
+                report->measurements[i].distance_meters,
+                report->measurements[i].rssi, report->measurements[i].rtt_nanoseconds);
+    }
+
+    if (range_count >= MULTILAT_MIN_ANCHORS) {
+        solve_beacon_position(report->serial_number, ranges, range_count, record);
+    }
+}
+
+// 다변측량 + 비콘별 위치 추적, 성공하면 레코드를 위치 레코드로 바꿈 (원본 거리는 보내지 않음)
+static void solve_beacon_position(const char *serial_number, const multilat_range_t *ranges, int count,
+                                  relay_record_t *record) {
+    multilat_fix_t fix;
+    esp_err_t err = multilat_solve(ranges, count, &fix);
+    if (err != ESP_OK) {
+        stats.position_failures++;
+        ESP_LOGD(TAG, "%s 위치 계산 실패 (앵커 %d개): %s, 측정 거리로 업로드", serial_number, count, esp_err_to_name(err));
+        return;
+    }
+
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    beacon_anchor_entry_t *entry = beacon_table_find_or_create_position(serial_number, now_ms);
+    float x, y, accuracy;
+    position_tracker_update(&entry->position, &fix, now_ms, &x, &y, &accuracy);
+
+    record->position_x = x;
+    record->position_y = y;
+    record->position_accuracy = accuracy;
+    record->position_anchors = fix.anchors_used;
+    record->measurement_count = 0;
+    stats.positions_solved++;
+
+    swift_trace(SWIFT_TRACE_GW_POSITION, (uint8_t)fix.anchors_used,
+                (uint16_t)(accuracy * 100.0f < 65535.0f ? accuracy * 100.0f : 65535.0f),
+                swift_trace_milli(x), swift_trace_milli(y));
+    SWIFT_TRACE_LOGI(TAG, "%s 위치: (%.2f, %.2f) ±%.2fm (측위 (%.2f, %.2f), 잔차 %.2fm, 앵커 %d개, 반복 %d회)",
+            serial_number, x, y, accuracy, fix.x, fix.y, fix.residual_rms, fix.anchors_used, fix.iterations);
+}
+
+
+// ===== 공개 함수 =====
+
+void relay_pipeline_init(relay_report_hook_t on_report) {
+    beacon_table_init();
+    seq_tracker_init();
+    memset(&stats, 0, sizeof(stats));
+    report_hook = on_report;
+}
+
+// 링에서 프레임 하나를 꺼내 업로더까지 (슬롯에서 바로 디코딩하고 반납)
+bool relay_pipeline_step(TickType_t timeout) {
+    pipeline_stamps_t stamps = {0};
+    const ingest_frame_t *frame = ingest_ring_peek(timeout);
+    if (frame == NULL) {
+        return false;
+    }
+    stamps.rx_us = frame->rx_us;
+    stamps.dequeue_us = pipeline_now_us();
+    pipeline_metrics_record(PIPELINE_STAGE_RING, stamps.rx_us, stamps.dequeue_us);
+
+    esp_err_t err = swift_frame_decode_report(frame->data, frame->len, &step_report);
+    uint8_t frame_len = frame->len;
+    ingest_ring_release();
+    if (err != ESP_OK) {
+        stats.decode_errors++;
+        ESP_LOGW(TAG, "비콘 프레임 디코딩 실패 (길이 %d): %s", frame_len, esp_err_to_name(err));
+        return false;
+    }
+
+    // 같은 사이클의 재전송은 훅에 중복으로 알린 뒤 칼만 필터/업로드 전에 버림
+    bool duplicate = false;
+    if (!step_report.has_sequence) {
+        seq_tracker_note_unsequenced();
+    } else {
+        duplicate = seq_tracker_check(step_report.serial_number, step_report.sequence,
+                                      xTaskGetTickCount() * portTICK_PERIOD_MS) == SEQ_DUPLICATE;
+    }
+    if (report_hook != NULL) {
+        report_hook(&step_report, duplicate);
+    }
+    if (duplicate) {
+        swift_trace(SWIFT_TRACE_GW_DUPLICATE, step_report.measurement_count, 0,
+                    (int32_t)step_report.sequence, swift_trace_serial_tail(step_report.serial_number));
+        ESP_LOGD(TAG, "중복 리포트 버림: %s #%" PRIu32, step_report.serial_number, step_report.sequence);
+        return false;
+    }
+    swift_trace(SWIFT_TRACE_GW_REPORT, step_report.measurement_count, 0,
+                step_report.has_sequence ? (int32_t)step_report.sequence : -1,
+                swift_trace_serial_tail(step_report.serial_number));
+
+    filter_beacon_report(&step_report, &step_record);
+    stamps.filter_us = pipeline_now_us();
+    pipeline_metrics_record(PIPELINE_STAGE_FILTER, stamps.dequeue_us, stamps.filter_us);
+    uploader_submit(&step_record, &stamps);
+    stats.processed++;
+    return true;
+}
+
+void relay_pipeline_get_stats(relay_pipeline_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "swift_frame.h"
+
+// ===== 중계 파이프라인 (수신 링 → 디코딩 → 중복 제거 → 칼만/위치 계산 → 업로더) =====
+// 데이터 중계 태스크 하나에서만 호출 (칼만 상태, 사이클 번호 추적, 통계는 이 태스크 전용)
+// ESP-NOW / Wi-Fi 에 의존하지 않으므로 host_test/bench_pipeline 에서도 같은 소스로 빌드됨
+
+// 리포트 훅: 중복 판정 직후, 칼만 필터 전에 호출 (재전송된 중복에도 응답해야 하는 슬롯 배정 등)
+// duplicate 면 같은 사이클의 재전송이므로 응답만 하고 수요/깨어남 집계에는 넣지 않아야 함
+typedef void (*relay_report_hook_t)(const swift_beacon_report_t *report, bool duplicate);
+
+// 중계 단계 통계
+typedef struct {
+    uint32_t processed;                     // 업로더로 넘긴 레코드 수
+    uint32_t decode_errors;                 // 디코딩에 실패한 프레임 수
+    uint32_t positions_solved;              // 게이트웨이에서 위치를 계산한 리포트 수
+    uint32_t position_failures;             // 앵커는 충분했지만 위치 계산에 실패한 리포트 수
+} relay_pipeline_stats_t;
+
+// 비콘-앵커 상태 테이블과 사이클 번호 추적 초기화, 리포트 훅 등록 (NULL 이면 없음)
+void relay_pipeline_init(relay_report_hook_t on_report);
+
+// 수신 링에서 프레임 하나를 꺼내 처리 (timeout 동안 프레임이 없으면 false)
+// 업로더로 레코드를 넘겼으면 true (디코딩 실패, 중복이면 false)
+bool relay_pipeline_step(TickType_t timeout);
+
+// 중계 단계 통계 복사
+void relay_pipeline_get_stats(relay_pipeline_stats_t *out);
@@ -0,0 +1,249 @@
+#include <string.h>
+#include <inttypes.h>
+#include "seq_tracker.h"
+#include "esp_log.h"
+
+static const char *TAG = "SEQ";
+
+// 해시 인덱스 크기 (부하율 0.5 이하 유지)
+#define SEQ_INDEX_SIZE (SEQ_TRACKER_CAPACITY * 2)
+#define SLOT_EMPTY (-1)
+
+// 비콘별 창 상태
+typedef struct {
+    seq_beacon_stats_t stats;               // 시리얼 및 통계
+    uint32_t highest;                       // 받은 최고 사이클 번호
+    uint64_t window;                        // bit i = (highest - i) 수신 여부
+    uint32_t last_seen;                     // 마지막 수신 시간 (밀리초)
+    int16_t lru_prev;                       // LRU 목록 이전 엔트리 (더 최근)
+    int16_t lru_next;                       // LRU 목록 다음 엔트리 (더 오래됨, 빈 엔트리는 빈 목록 연결)
+} seq_entry_t;
+
+// 엔트리는 고정 위치 배열, 개방 주소법(선형 탐사) 인덱스는 엔트리 번호만 가짐 (beacon_table 과 같은 구조)
+static seq_entry_t entries[SEQ_TRACKER_CAPACITY];
+static int16_t slot_index[SEQ_INDEX_SIZE];
+static int16_t free_head;                   // 빈 엔트리 목록
+static int16_t lru_head;                    // 가장 최근 수신 엔트리
+static int16_t lru_tail;                    // 가장 오래 조용한 엔트리
+static uint32_t entry_count;
+static seq_tracker_stats_t totals;
+
+
+// ===== 해시 인덱스 / LRU =====
+
+// 시리얼의 기본 인덱스 위치 (FNV-1a)
+static uint32_t home_slot(const char *serial_number) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < (int)sizeof(entries[0].stats.serial_number) && serial_number[i] != '\0'; i++) {
+        h = (h ^ (uint8_t)serial_number[i]) * 16777619u;
+    }
+    return h % SEQ_INDEX_SIZE;
+}
+
+// LRU 목록에서 떼어내기
+static void lru_unlink(int16_t idx) {
+    seq_entry_t *e = &entries[idx];
+    if (e->lru_prev != SLOT_EMPTY) {
+        entries[e->lru_prev].lru_next = e->lru_next;
+    } else {
+        lru_head = e->lru_next;
+    }
+    if (e->lru_next != SLOT_EMPTY) {
+        entries[e->lru_next].lru_prev = e->lru_prev;
+    } else {
+        lru_tail = e->lru_prev;
+    }
+}
+
+// LRU 목록 맨 앞 (가장 최근) 에 붙이기
+static void lru_push_front(int16_t idx) {
+    seq_entry_t *e = &entries[idx];
+    e->lru_prev = SLOT_EMPTY;
+    e->lru_next = lru_head;
+    if (lru_head != SLOT_EMPTY) {
+        entries[lru_head].lru_prev = idx;
+    }
+    lru_head = idx;
+    if (lru_tail == SLOT_EMPTY) {
+        lru_tail = idx;
+    }
+}
+
+// 엔트리 제거: 인덱스에서 지우고 뒤따르는 탐사 체인을 당겨 채움 (툼스톤 없음)
+static void remove_entry(int16_t idx) {
+    uint32_t pos = home_slot(entries[idx].stats.serial_number);
+    while (slot_index[pos] != idx) {
+        pos = (pos + 1) % SEQ_INDEX_SIZE;
+    }
+
+    uint32_t hole = pos;
+    uint32_t next = pos;
+    while (true) {
+        next = (next + 1) % SEQ_INDEX_SIZE;
+        int16_t moved = slot_index[next];
+        if (moved == SLOT_EMPTY) {
+            break;
+        }
+        // 기본 위치가 (hole, next] 구간에 있으면 그대로 두어야 탐사가 끊기지 않음
+        uint32_t home = home_slot(entries[moved].stats.serial_number);
+        bool stays = (hole <= next) ? (hole < home && home <= next)
+                                    : (hole < home || home <= next);
+        if (!stays) {
+            slot_index[hole] = moved;
+            hole = next;
+        }
+    }
+    slot_index[hole] = SLOT_EMPTY;
+
+    lru_unlink(idx);
+    entries[idx].stats.serial_number[0] = '\0';
+    entries[idx].lru_next = free_head;
+    free_head = idx;
+    entry_count--;
+}
+
+// 엔트리 찾기, 없으면 빈 엔트리 또는 가장 오래 조용한 엔트리를 재사용
+static seq_entry_t *find_or_create(const char *serial_number, uint32_t now_ms, bool *created) {
+    uint32_t pos = home_slot(serial_number);
+    while (slot_index[pos] != SLOT_EMPTY) {
+        int16_t idx = slot_index[pos];
+        if (strncmp(entries[idx].stats.serial_number, serial_number, sizeof(entries[idx].stats.serial_number)) == 0) {
+            if (lru_head != idx) {
+                lru_unlink(idx);
+                lru_push_front(idx);
+            }
+            *created = false;
+            return &entries[idx];
+        }
+        pos = (pos + 1) % SEQ_INDEX_SIZE;
+    }
+
+    if (free_head == SLOT_EMPTY) {
+        ESP_LOGD(TAG, "추적 비콘 가득 참 (%d개), 가장 오래 조용한 비콘 밀어냄: %s",
+                SEQ_TRACKER_CAPACITY, entries[lru_tail].stats.serial_number);
+        remove_entry(lru_tail);
+        totals.evicted++;
+
+        // 제거로 탐사 체인이 당겨졌을 수 있으므로 빈 자리 다시 찾기
+        pos = home_slot(serial_number);
+        while (slot_index[pos] != SLOT_EMPTY) {
+            pos = (pos + 1) % SEQ_INDEX_SIZE;
+        }
+    }
+
+    int16_t idx = free_head;
+    seq_entry_t *entry = &entries[idx];
+    free_head = entry->lru_next;
+    memset(entry, 0, sizeof(*entry));
+    strncpy(entry->stats.serial_number, serial_number, sizeof(entry->stats.serial_number) - 1);
+    entry->last_seen = now_ms;
+    slot_index[pos] = idx;
+    lru_push_front(idx);
+    entry_count++;
+    *created = true;
+    return entry;
+}
+
+
+// ===== 공개 함수 =====
+
+void seq_tracker_init(void) {
+    for (int i = 0; i < SEQ_INDEX_SIZE; i++) {
+        slot_index[i] = SLOT_EMPTY;
+    }
+    for (int i = 0; i < SEQ_TRACKER_CAPACITY; i++) {
+        entries[i].stats.serial_number[0] = '\0';
+        entries[i].lru_next = (i + 1 < SEQ_TRACKER_CAPACITY) ? (int16_t)(i + 1) : SLOT_EMPTY;
+    }
+    free_head = 0;
+    lru_head = SLOT_EMPTY;
+    lru_tail = SLOT_EMPTY;
+    entry_count = 0;
+    memset(&totals, 0, sizeof(totals));
+}
+
+seq_verdict_t seq_tracker_check(const char *serial_number, uint32_t sequence, uint32_t now_ms) {
+    bool created;
+    seq_entry_t *entry = find_or_create(serial_number, now_ms, &created);
+    entry->last_seen = now_ms;
+
+    // 모듈러 차이 (번호가 한 바퀴 돌아도 동작)
+    uint32_t ahead = sequence - entry->highest;
+    uint32_t behind = entry->highest - sequence;
+
+    if (created) {
+        entry->highest = sequence;
+        entry->window = 1;
+    } else if (ahead != 0 && ahead <= SEQ_RESTART_GAP) {
+        // 앞으로 전진: 건너뛴 번호는 일단 손실로 집계
+        entry->window = (ahead < SEQ_WINDOW_SIZE) ? (entry->window << ahead) | 1 : 1;
+        entry->highest = sequence;
+        entry->stats.lost += ahead - 1;
+        totals.lost += ahead - 1;
+    } else if (behind < SEQ_WINDOW_SIZE) {
+        if (entry->window & (1ULL << behind)) {
+            entry->stats.duplicates++;
+            totals.duplicates++;
+            return SEQ_DUPLICATE;
+        }
+        // 순서가 바뀌어 늦게 도착: 손실로 잡았던 것을 되돌림
+        entry->window |= 1ULL << behind;
+        if (entry->stats.lost > 0) {
+            entry->stats.lost--;
+            totals.lost--;
+        }
+    } else {
+        // 창보다 뒤거나 크게 앞: 비콘이 재시작해 임의 번호에서 다시 시작한 것으로 봄
+        ESP_LOGI(TAG, "비콘 %s 사이클 번호 재시작 (%" PRIu32 " → %" PRIu32 ")",
+                serial_number, entry->highest, sequence);
+        entry->stats.restarts++;
+        entry->highest = sequence;
+        entry->window = 1;
+    }
+
+    entry->stats.received++;
+    totals.accepted++;
+    return SEQ_ACCEPT;
+}
+
+void seq_tracker_note_unsequenced(void) {
+    totals.unsequenced++;
+}
+
+void seq_tracker_get_stats(seq_tracker_stats_t *out) {
+    *out = totals;
+    out->tracked = entry_count;
+}
+
+// 손실 + 중복 비율 (만분율, 비교용)
+static uint32_t badness(const seq_beacon_stats_t *stats) {
+    uint32_t expected = stats->received + stats->lost;
+    if (expected == 0) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)(stats->lost + stats->duplicates) * 10000) / expected);
+}
+
+int seq_tracker_worst(seq_beacon_stats_t *out, int max) {
+    int count = 0;
+
+    // 삽입 정렬로 상위 max 개 유지
+    for (int i = 0; i < SEQ_TRACKER_CAPACITY; i++) {
+        const seq_beacon_stats_t *stats = &entries[i].stats;
+        if (stats->serial_number[0] == '\0') {
+            continue;
+        }
+        uint32_t score = badness(stats);
+        int pos = (count < max) ? count++ : max;
+        while (pos > 0 && badness(&out[pos - 1]) < score) {
+            if (pos < max) {
+                out[pos] = out[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < max) {
+            out[pos] = *stats;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ===== 비콘 사이클 번호 중복 제거 / 손실 집계 =====
+// 비콘별 최고 사이클 번호와 그 아래 SEQ_WINDOW_SIZE 개의 수신 비트맵으로 중복을 걸러냄
+// (ACK 유실 후 재전송, 다른 게이트웨이로의 재시도 등)
+// 조회는 beacon_table 과 같은 개방 주소법 해시 인덱스 + LRU 목록 (비콘 수와 무관하게 O(1))
+// 엔트리 하나당 약 56바이트 + 해시 인덱스 4바이트
+#ifndef SEQ_TRACKER_CAPACITY
+#define SEQ_TRACKER_CAPACITY 1024           // 추적하는 최대 비콘 수 (가득 차면 가장 오래 조용한 비콘을 밀어냄)
+#endif
+#define SEQ_WINDOW_SIZE 64                  // 중복 판정 창 (사이클 수)
+#define SEQ_RESTART_GAP 4096                // 창보다 뒤로 가거나 이보다 크게 앞으로 뛴 번호는 비콘 재시작으로 봄
+
+_Static_assert(SEQ_TRACKER_CAPACITY > 0 && SEQ_TRACKER_CAPACITY < 0x8000,
+               "SEQ_TRACKER_CAPACITY 는 1 ~ 32767 사이여야 함");
+
+// 판정 결과
+typedef enum {
+    SEQ_ACCEPT = 0,                         // 처음 받은 사이클
+    SEQ_DUPLICATE = 1,                      // 이미 받은 사이클 (필터링/업로드 전에 버림)
+} seq_verdict_t;
+
+// 비콘별 통계
+typedef struct {
+    char serial_number[10];                 // 비콘 시리얼 번호
+    uint32_t received;                      // 받아들인 사이클 수
+    uint32_t duplicates;                    // 버린 중복 수
+    uint32_t lost;                          // 번호가 건너뛰어 빠진 사이클 수 (늦게 도착하면 다시 차감)
+    uint32_t restarts;                      // 번호가 창 밖으로 되돌아가거나 크게 뛴 횟수 (비콘 재시작)
+} seq_beacon_stats_t;
+
+// 전체 통계
+typedef struct {
+    uint32_t accepted;                      // 받아들인 리포트 수
+    uint32_t duplicates;                    // 버린 중복 리포트 수
+    uint32_t lost;                          // 빠진 사이클 수 합계
+    uint32_t unsequenced;                   // 사이클 번호가 없어 검사하지 않은 리포트 수
+    uint32_t evicted;                       // 용량 초과로 밀려난 비콘 수
+    uint32_t tracked;                       // 현재 추적 중인 비콘 수
+} seq_tracker_stats_t;
+
+// 추적 상태 비우기
+void seq_tracker_init(void);
+
+// 리포트 사이클 번호 검사 (데이터 중계 태스크에서만 호출)
+seq_verdict_t seq_tracker_check(const char *serial_number, uint32_t sequence, uint32_t now_ms);
+
+// 사이클 번호가 없는 리포트 집계
+void seq_tracker_note_unsequenced(void);
+
+// 전체 통계 복사
+void seq_tracker_get_stats(seq_tracker_stats_t *out);
+
+// 손실률 + 중복률이 가장 높은 비콘부터 최대 max 개 통계 복사, 복사한 수 반환
+int seq_tracker_worst(seq_beacon_stats_t *out, int max);
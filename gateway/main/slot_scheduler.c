@@ -0,0 +1,213 @@
+#include <string.h>
+#include "slot_scheduler.h"
+#include "esp_log.h"
+
+static const char *TAG = "SLOT";
+
+// 슬롯 소유 비콘 (인덱스 = 슬롯 번호, 데이터 중계 태스크에서만 접근)
+typedef struct {
+    char serial_number[SWIFT_SERIAL_MAX_LEN + 1];   // 비어 있으면 빈 슬롯
+    int64_t last_seen_ms;                   // 마지막 리포트 시각 (UTC epoch 밀리초)
+} slot_owner_t;
+
+static slot_owner_t slots[TDMA_MAX_SLOTS];
+static int slot_count = TDMA_MAX_SLOTS;
+static slot_scheduler_stats_t stats = {.slot_ms = TDMA_SUPERFRAME_MS / TDMA_MAX_SLOTS, .slot_count = TDMA_MAX_SLOTS};
+
+// 최근 깨어남 시간 (ms, 원형 버퍼)
+static uint16_t wake_samples[TDMA_WAKE_SAMPLES];
+static int wake_sample_count = 0;
+static int wake_sample_next = 0;
+static bool layout_measured = false;        // 측정값으로 슬롯 길이를 정한 적 있는지
+static int64_t last_relayout_ms = 0;
+
+// 슈퍼프레임당 리포트 수 (TDMA_DEMAND_WINDOW_MS 구간마다 갱신)
+static uint32_t window_reports = 0;
+static int64_t window_start_ms = 0;
+static bool demand_known = false;
+
+void slot_scheduler_init(void) {
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+    slot_count = TDMA_MAX_SLOTS;
+    stats.slot_ms = TDMA_SUPERFRAME_MS / TDMA_MAX_SLOTS;
+    stats.slot_count = TDMA_MAX_SLOTS;
+    wake_sample_count = 0;
+    wake_sample_next = 0;
+    layout_measured = false;
+    last_relayout_ms = 0;
+    window_reports = 0;
+    window_start_ms = 0;
+    demand_known = false;
+}
+
+
+// ===== 슬롯 길이 =====
+
+// 최근 깨어남 시간의 TDMA_WAKE_PERCENTILE 백분위 (삽입 정렬, 최대 TDMA_WAKE_SAMPLES 개)
+static uint16_t wake_percentile(void) {
+    uint16_t sorted[TDMA_WAKE_SAMPLES];
+    for (int i = 0; i < wake_sample_count; i++) {
+        uint16_t value = wake_samples[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > value) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = value;
+    }
+    return sorted[(wake_sample_count - 1) * TDMA_WAKE_PERCENTILE / 100];
+}
+
+// 슬롯 수 선택: 깨어남 시간에 여유를 더한 길이가 들어가는 만큼 (최소 1개)
+// 슈퍼프레임당 리포트 수가 그보다 많으면 리포트 수만큼 (겹침은 피할 수 없으니 깨어나는 시각을 고르게)
+static int slot_count_for(uint16_t wake_ms, uint16_t demand) {
+    uint32_t needed_ms = (uint32_t)wake_ms * TDMA_WAKE_MARGIN_PCT / 100;
+    int count = (int)(TDMA_SUPERFRAME_MS / (needed_ms > 0 ? needed_ms : 1));
+    if (count < demand) {
+        count = demand;
+    }
+    if (count < 1) {
+        count = 1;
+    } else if (count > TDMA_MAX_SLOTS) {
+        count = TDMA_MAX_SLOTS;
+    }
+    return count;
+}
+
+void slot_scheduler_note_wake(const swift_profile_t *profile, int64_t now_epoch_ms) {
+    uint32_t wake_ms = 0;
+    for (int phase = 0; phase < SWIFT_PHASE_COUNT; phase++) {
+        wake_ms += profile->phase_ms[phase];
+    }
+    if (wake_ms == 0) {
+        return;
+    }
+    wake_samples[wake_sample_next] = wake_ms > UINT16_MAX ? UINT16_MAX : (uint16_t)wake_ms;
+    wake_sample_next = (wake_sample_next + 1) % TDMA_WAKE_SAMPLES;
+    if (wake_sample_count < TDMA_WAKE_SAMPLES) {
+        wake_sample_count++;
+    }
+
+    // 리포트 수를 아직 모르거나 변경 간격 안이면 평가하지 않음 (측정값으로 처음 정할 때는 바로)
+    if (wake_sample_count < TDMA_WAKE_MIN_SAMPLES || !demand_known ||
+        (layout_measured && now_epoch_ms - last_relayout_ms < TDMA_RELAYOUT_INTERVAL_MS)) {
+        return;
+    }
+
+    // 바꿀 때마다 배정을 모두 다시 하므로 변경 간격 자체가 히스테리시스
+    stats.wake_ms = wake_percentile();
+    int count = slot_count_for(stats.wake_ms, stats.demand);
+    layout_measured = true;
+    if (count == slot_count) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "슬롯 %d → %d개 (%d ms, 깨어남 p%d %d ms, 슈퍼프레임당 리포트 %d), 배정 초기화",
+            slot_count, count, TDMA_SUPERFRAME_MS / count, TDMA_WAKE_PERCENTILE, stats.wake_ms, stats.demand);
+    memset(slots, 0, sizeof(slots));
+    slot_count = count;
+    stats.slot_ms = (uint16_t)(TDMA_SUPERFRAME_MS / count);
+    stats.slot_count = (uint16_t)slot_count;
+    stats.active = 0;
+    stats.relayouts++;
+    last_relayout_ms = now_epoch_ms;
+}
+
+
+// ===== 배정 =====
+
+// 시리얼 FNV-1a 해시로 선호 슬롯 결정 (게이트웨이가 달라도 같은 값)
+static int preferred_slot(const char *serial_number) {
+    uint32_t hash = 2166136261u;
+    for (const char *p = serial_number; *p != '\0'; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619u;
+    }
+    return (int)(hash % (uint32_t)slot_count);
+}
+
+// 리포트 수 집계 (구간이 끝나면 슈퍼프레임당 리포트 수로 환산)
+void slot_scheduler_note_report(int64_t now_epoch_ms) {
+    if (window_reports == 0 && !demand_known && window_start_ms == 0) {
+        window_start_ms = now_epoch_ms;
+    }
+    window_reports++;
+    int64_t elapsed_ms = now_epoch_ms - window_start_ms;
+    if (elapsed_ms >= TDMA_DEMAND_WINDOW_MS) {
+        uint32_t demand = (uint32_t)((window_reports * (int64_t)TDMA_SUPERFRAME_MS + elapsed_ms / 2) / elapsed_ms);
+        stats.demand = (uint16_t)(demand > UINT16_MAX ? UINT16_MAX : demand);
+        demand_known = true;
+        window_reports = 0;
+        window_start_ms = now_epoch_ms;
+    }
+}
+
+static int find_slot(const char *serial_number, int64_t now_ms) {
+    int start = preferred_slot(serial_number);
+
+    // 이미 배정된 슬롯
+    for (int i = 0; i < slot_count; i++) {
+        int slot = (start + i) % slot_count;
+        if (strcmp(slots[slot].serial_number, serial_number) == 0) {
+            return slot;
+        }
+    }
+
+    // 선호 슬롯부터 빈 슬롯 또는 만료된 슬롯
+    for (int i = 0; i < slot_count; i++) {
+        int slot = (start + i) % slot_count;
+        slot_owner_t *owner = &slots[slot];
+        bool expired = owner->serial_number[0] != '\0' &&
+                       now_ms - owner->last_seen_ms > TDMA_SLOT_TIMEOUT_MS;
+        if (owner->serial_number[0] == '\0' || expired) {
+            if (expired) {
+                ESP_LOGD(TAG, "슬롯 %d 회수 (%s)", slot, owner->serial_number);
+                stats.reclaimed++;
+                stats.active--;
+            }
+            strncpy(owner->serial_number, serial_number, SWIFT_SERIAL_MAX_LEN);
+            owner->serial_number[SWIFT_SERIAL_MAX_LEN] = '\0';
+            stats.assigned++;
+            stats.active++;
+            ESP_LOGD(TAG, "비콘 %s 에 슬롯 %d 배정 (%d/%d 사용)", serial_number, slot,
+                    (int)stats.active, slot_count);
+            return slot;
+        }
+    }
+
+    // 모든 슬롯이 사용 중이면 선호 슬롯을 공유 (소유자는 바꾸지 않음, 리포트마다 불리므로 통계로만 집계)
+    stats.shared++;
+    ESP_LOGD(TAG, "빈 슬롯 없음, 비콘 %s 는 슬롯 %d 공유", serial_number, start);
+    return -start - 1;
+}
+
+esp_err_t slot_scheduler_assign(const char *serial_number, int64_t now_epoch_ms,
+                                swift_slot_assignment_t *out) {
+    if (serial_number[0] == '\0') {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int slot = find_slot(serial_number, now_epoch_ms);
+    if (slot >= 0) {
+        slots[slot].last_seen_ms = now_epoch_ms;
+    } else {
+        slot = -slot - 1;
+    }
+
+    // 현재 슈퍼프레임 안의 위치에서 배정 슬롯 시작까지 남은 시간
+    int64_t phase_ms = now_epoch_ms % TDMA_SUPERFRAME_MS;
+    int64_t offset_ms = ((int64_t)slot * stats.slot_ms - phase_ms + TDMA_SUPERFRAME_MS) % TDMA_SUPERFRAME_MS;
+
+    memset(out, 0, sizeof(*out));
+    strncpy(out->serial_number, serial_number, SWIFT_SERIAL_MAX_LEN);
+    out->slot = (uint8_t)slot;
+    out->slot_count = (uint8_t)slot_count;
+    out->superframe_ms = TDMA_SUPERFRAME_MS;
+    out->offset_ms = (uint16_t)offset_ms;
+    return ESP_OK;
+}
+
+void slot_scheduler_get_stats(slot_scheduler_stats_t *out) {
+    *out = stats;
+}
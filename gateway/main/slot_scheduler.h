@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "swift_frame.h"
+
+// ===== TDMA 측정 슬롯 배정 =====
+// 슈퍼프레임을 슬롯으로 나눠 비콘마다 깨어날 슬롯을 하나씩 배정
+// 위상은 UTC epoch 밀리초 기준이라 SNTP 로 동기화된 게이트웨이끼리는 슬롯 경계가 같고,
+// 선호 슬롯도 시리얼 해시로 정해 게이트웨이가 달라도 대부분 같은 슬롯을 배정
+// 슬롯 길이는 비콘 리포트의 깨어남 프로파일(SWIFT_EXT_PROFILE) 합계 시간의 p90 으로 정함
+// (깨어남은 수백 ms~수 초라 슬롯이 그보다 짧으면 이웃 슬롯 비콘의 FTM/전송과 겹침)
+// 슈퍼프레임당 리포트 수가 그 길이의 슬롯 수보다 많으면 겹침은 피할 수 없으므로, 한 슬롯을 공유해
+// 같은 시각에 깨어나는 대신 리포트 수만큼 슬롯을 나눠 깨어나는 시각을 고르게 흩뜨림
+// (슬롯 길이는 슈퍼프레임 / 슬롯 수, 나머지 밀리초는 마지막 슬롯 뒤에 남음)
+// 측정 슬롯이 100ms 고정 슬롯보다 나은 것은 비콘 수 x 깨어남 p90 이 슈퍼프레임 안에 들어갈 때뿐
+// (깨어남 2 초, 주기 5 초면 비콘 2~4 개), 그보다 많으면 겹침은 구조적이라 둘 다 비슷하게 나쁘고
+// 줄이려면 비콘 주기(슈퍼프레임)를 늘리거나 깨어남 시간을 줄여야 함 (host_test/sim_tdma 표)
+#define TDMA_SUPERFRAME_MS 5000             // 슈퍼프레임 길이 (비콘 최소 주기와 같아야 함)
+#define TDMA_MAX_SLOTS 50                   // 슈퍼프레임당 최대 슬롯 수 (가장 짧은 슬롯 100ms, 측정 전 기본값)
+#define TDMA_SLOT_TIMEOUT_MS 300000         // 이 시간 동안 리포트가 없는 비콘의 슬롯은 회수 (5분)
+#define TDMA_WAKE_SAMPLES 64                // 슬롯 길이 추정에 쓰는 최근 깨어남 시간 수 (전체 비콘)
+#define TDMA_WAKE_MIN_SAMPLES 8             // 이만큼 모이기 전에는 슬롯 길이를 바꾸지 않음
+#define TDMA_WAKE_PERCENTILE 90             // 슬롯 길이 기준 백분위
+#define TDMA_WAKE_MARGIN_PCT 120            // 깨어남 백분위에 곱하는 여유 (부팅 시간 편차, RTC 오차)
+#define TDMA_RELAYOUT_INTERVAL_MS 600000    // 슬롯 길이 변경 최소 간격 (10분, 변경하면 배정을 모두 다시 함)
+#define TDMA_DEMAND_WINDOW_MS 60000         // 슈퍼프레임당 리포트 수를 세는 구간 (정지 비콘은 드물게 리포트)
+
+_Static_assert(TDMA_SUPERFRAME_MS % TDMA_MAX_SLOTS == 0, "슬롯 길이는 정수 밀리초여야 함");
+
+// 슬롯 배정 통계
+typedef struct {
+    uint32_t assigned;                      // 새로 배정한 슬롯 수
+    uint32_t reclaimed;                     // 타임아웃으로 회수한 슬롯 수
+    uint32_t shared;                        // 빈 슬롯이 없어 다른 비콘과 공유시킨 수
+    uint32_t active;                        // 현재 배정된 비콘 수
+    uint32_t relayouts;                     // 슬롯 길이를 바꿔 배정을 다시 한 횟수
+    uint16_t slot_ms;                       // 현재 슬롯 길이
+    uint16_t slot_count;                    // 현재 슈퍼프레임당 슬롯 수
+    uint16_t wake_ms;                       // 마지막으로 평가한 깨어남 시간 백분위 (0 이면 아직 없음)
+    uint16_t demand;                        // 마지막 구간의 슈퍼프레임당 리포트 수 (반올림)
+} slot_scheduler_stats_t;
+
+// 슬롯 배정과 깨어남 측정값 초기화 (최대 슬롯 수로 시작)
+void slot_scheduler_init(void);
+
+// 비콘 깨어남 프로파일 반영 (리포트에 SWIFT_EXT_PROFILE 이 있을 때, now_epoch_ms = 수신 시각 UTC 밀리초)
+// 첫 리포트 수 구간이 끝난 뒤, 필요한 슬롯 수가 지금과 다르고
+// 마지막 변경 후 TDMA_RELAYOUT_INTERVAL_MS 가 지났으면 배정을 비우고 새 슬롯 수로 다시 배정
+// (비콘은 다음 리포트의 배정 프레임으로 옮겨감)
+void slot_scheduler_note_wake(const swift_profile_t *profile, int64_t now_epoch_ms);
+
+// 리포트 수 집계 (슈퍼프레임당 리포트 수 = 슬롯 수 하한, 재전송된 중복 리포트는 넣지 않음)
+void slot_scheduler_note_report(int64_t now_epoch_ms);
+
+// 비콘 슬롯 조회 또는 배정 후 슬롯 배정 프레임 내용 채움 (now_epoch_ms = 송신 직전 UTC 밀리초)
+// 처음 보는 비콘은 시리얼 해시 슬롯부터 비어 있거나 만료된 슬롯을 찾고, 없으면 해시 슬롯을 공유
+esp_err_t slot_scheduler_assign(const char *serial_number, int64_t now_epoch_ms,
+                                swift_slot_assignment_t *out);
+
+// 통계 복사
+void slot_scheduler_get_stats(slot_scheduler_stats_t *out);
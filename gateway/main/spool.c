@@ -0,0 +1,307 @@
+#include <string.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "spool.h"
+
+// ===== 슬롯 레이아웃 =====
+// 플래시는 섹터 단위 순환 로그이며, 시퀀스 번호 seq 인 레코드는 항상
+// 슬롯 (seq % 전체 슬롯 수) 에 기록됨. 섹터에 처음 들어갈 때만 지우므로
+// 모든 섹터가 한 바퀴에 한 번씩 고르게 지워짐.
+#define SPOOL_SEQ_EMPTY 0xFFFFFFFFu         // 지워진 플래시의 seq 값
+#define SPOOL_ACK_PENDING 0xFF              // 미전송
+#define SPOOL_ACK_DONE 0x00                 // 이 레코드까지 재전송 완료 (비트 클리어만으로 기록 가능)
+#define SPOOL_PEEK_MAX 32                   // 한 번에 읽을 수 있는 최대 레코드 수
+
+typedef struct {
+    uint32_t seq;                           // 레코드 시퀀스 번호
+    uint16_t crc;                           // 페이로드 CRC-16/CCITT
+    uint8_t len;                            // 페이로드 길이
+    uint8_t ack;                            // 재전송 완료 표시
+} spool_slot_header_t;
+
+static const char *TAG = "SPOOL";
+
+// ===== 전역 변수 =====
+static spool_flash_t s_flash;
+static size_t s_record_size = 0;
+static size_t s_slot_size = 0;
+static uint32_t s_slots_per_sector = 0;
+static uint32_t s_total_slots = 0;
+static uint32_t s_head_seq = 0;             // 다음에 부여할 seq
+static uint32_t s_tail_seq = 0;             // 가장 오래된 미전송 seq
+static uint32_t s_flushed_seq = 0;          // 이 seq 미만은 플래시에 기록됨, 이상은 RAM 버퍼
+static uint8_t s_buf[SPOOL_WRITE_BUFFER_SIZE];
+static size_t s_buf_len = 0;
+static uint32_t s_buf_first_ms = 0;
+static uint32_t s_peek_seqs[SPOOL_PEEK_MAX];
+static int s_peek_count = 0;
+static spool_stats_t s_stats = {0};
+static bool s_ready = false;
+
+
+// ===== 내부 함수 =====
+
+// CRC-16/CCITT (0x1021) 계산
+static uint16_t spool_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// seq 가 위치한 슬롯 인덱스
+static uint32_t spool_slot_index(uint32_t seq) {
+    return seq % s_total_slots;
+}
+
+// seq 가 위치한 플래시 오프셋
+static size_t spool_slot_offset(uint32_t seq) {
+    uint32_t idx = spool_slot_index(seq);
+    return (size_t)(idx / s_slots_per_sector) * s_flash.sector_size +
+           (size_t)(idx % s_slots_per_sector) * s_slot_size;
+}
+
+// 슬롯 하나 읽고 검증 (유효하면 true)
+static bool spool_read_slot(uint32_t idx, spool_slot_header_t *hdr, void *payload) {
+    size_t offset = (size_t)(idx / s_slots_per_sector) * s_flash.sector_size +
+                    (size_t)(idx % s_slots_per_sector) * s_slot_size;
+    if (s_flash.read(s_flash.ctx, offset, hdr, sizeof(*hdr)) != ESP_OK) {
+        return false;
+    }
+    if (hdr->seq == SPOOL_SEQ_EMPTY || hdr->seq % s_total_slots != idx || hdr->len != s_record_size) {
+        return false;
+    }
+    if (s_flash.read(s_flash.ctx, offset + sizeof(*hdr), payload, s_record_size) != ESP_OK) {
+        return false;
+    }
+    return spool_crc16(payload, s_record_size) == hdr->crc;
+}
+
+// seq 의 레코드를 플래시 또는 RAM 버퍼에서 읽음
+static bool spool_load(uint32_t seq, void *payload) {
+    if (seq >= s_flushed_seq) {
+        const uint8_t *slot = &s_buf[(size_t)(seq - s_flushed_seq) * s_slot_size];
+        memcpy(payload, slot + sizeof(spool_slot_header_t), s_record_size);
+        return true;
+    }
+    spool_slot_header_t hdr;
+    return spool_read_slot(spool_slot_index(seq), &hdr, payload) && hdr.seq == seq;
+}
+
+
+// ===== 공개 함수 =====
+
+// 플래시 영역 위에 순환 스풀 구성 및 복구
+esp_err_t spool_init(const spool_flash_t *flash, size_t record_size, size_t max_sectors) {
+    if (record_size == 0 || record_size > SPOOL_MAX_RECORD_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    s_flash = *flash;
+    s_record_size = record_size;
+    s_slot_size = (sizeof(spool_slot_header_t) + record_size + 3) & ~(size_t)3;
+    s_slots_per_sector = (uint32_t)(flash->sector_size / s_slot_size);
+
+    size_t sectors = flash->size / flash->sector_size;
+    if (max_sectors > 0 && max_sectors < sectors) {
+        sectors = max_sectors;
+    }
+    if (sectors < 2 || s_slots_per_sector == 0) {
+        ESP_LOGE(TAG, "스풀 영역이 너무 작음 (섹터 %u개)", (unsigned)sectors);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    s_total_slots = (uint32_t)sectors * s_slots_per_sector;
+
+    // 전체 슬롯을 스캔해 최신 seq 와 마지막 재전송 완료 seq 를 찾음
+    uint8_t payload[SPOOL_MAX_RECORD_SIZE];
+    bool found = false;
+    bool acked_found = false;
+    uint32_t max_seq = 0, min_seq = UINT32_MAX, max_acked = 0;
+    for (uint32_t idx = 0; idx < s_total_slots; idx++) {
+        spool_slot_header_t hdr;
+        if (!spool_read_slot(idx, &hdr, payload)) {
+            continue;
+        }
+        found = true;
+        if (hdr.seq > max_seq) max_seq = hdr.seq;
+        if (hdr.seq < min_seq) min_seq = hdr.seq;
+        if (hdr.ack == SPOOL_ACK_DONE && (!acked_found || hdr.seq > max_acked)) {
+            max_acked = hdr.seq;
+            acked_found = true;
+        }
+    }
+
+    if (found) {
+        s_head_seq = max_seq + 1;
+        s_tail_seq = acked_found && max_acked + 1 > min_seq ? max_acked + 1 : min_seq;
+
+        // 다음 슬롯이 비어 있지 않으면 (쓰기 도중 전원 차단 등) 다음 섹터부터 기록
+        spool_slot_header_t hdr;
+        s_flash.read(s_flash.ctx, spool_slot_offset(s_head_seq), &hdr, sizeof(hdr));
+        uint32_t in_sector = spool_slot_index(s_head_seq) % s_slots_per_sector;
+        if (hdr.seq != SPOOL_SEQ_EMPTY && in_sector != 0) {
+            s_head_seq += s_slots_per_sector - in_sector;
+        }
+    } else {
+        s_head_seq = 0;
+        s_tail_seq = 0;
+    }
+    s_flushed_seq = s_head_seq;
+    s_buf_len = 0;
+    s_peek_count = 0;
+    s_ready = true;
+
+    // 마지막 완료 표시 뒤가 읽을 수 없는 슬롯이면 (이전 부팅에서 peek 로 건너뛴 섹터 나머지) 바로 넘김
+    while (s_tail_seq != s_head_seq && !spool_load(s_tail_seq, payload)) {
+        s_tail_seq++;
+    }
+
+    ESP_LOGI(TAG, "스풀 준비: 섹터 %u개, 슬롯 %" PRIu32 "개 (%u 바이트), 미전송 %" PRIu32 "개",
+            (unsigned)sectors, s_total_slots, (unsigned)s_slot_size, s_head_seq - s_tail_seq);
+    return ESP_OK;
+}
+
+// 레코드 추가
+esp_err_t spool_append(const void *record, uint32_t now_ms) {
+    if (!s_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 버퍼는 한 섹터 안의 연속 슬롯만 담음: 섹터가 바뀌면 먼저 기록
+    if (s_buf_len > 0 &&
+        spool_slot_index(s_head_seq) / s_slots_per_sector != spool_slot_index(s_flushed_seq) / s_slots_per_sector) {
+        esp_err_t err = spool_flush(now_ms, true);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    uint8_t *slot = &s_buf[s_buf_len];
+    spool_slot_header_t hdr = {
+        .seq = s_head_seq,
+        .crc = spool_crc16(record, s_record_size),
+        .len = (uint8_t)s_record_size,
+        .ack = SPOOL_ACK_PENDING,
+    };
+    memset(slot, 0xFF, s_slot_size);
+    memcpy(slot, &hdr, sizeof(hdr));
+    memcpy(slot + sizeof(hdr), record, s_record_size);
+
+    if (s_buf_len == 0) {
+        s_buf_first_ms = now_ms;
+    }
+    s_buf_len += s_slot_size;
+    s_head_seq++;
+    s_stats.appended++;
+
+    // 버퍼가 가득 차면 한 번에 기록
+    if (s_buf_len + s_slot_size > sizeof(s_buf)) {
+        return spool_flush(now_ms, true);
+    }
+    return ESP_OK;
+}
+
+// RAM 버퍼를 플래시에 기록
+esp_err_t spool_flush(uint32_t now_ms, bool force) {
+    if (!s_ready || s_buf_len == 0) {
+        return ESP_OK;
+    }
+    if (!force && now_ms - s_buf_first_ms < SPOOL_FLUSH_AGE_MS) {
+        return ESP_OK;
+    }
+
+    // 섹터 첫 슬롯이면 지우기 전에 그 섹터의 이전 바퀴 레코드를 보관 한도 초과로 처리
+    uint32_t idx = spool_slot_index(s_flushed_seq);
+    if (idx % s_slots_per_sector == 0) {
+        if (s_flushed_seq >= s_total_slots) {
+            uint32_t evicted_end = s_flushed_seq - s_total_slots + s_slots_per_sector;
+            if (s_tail_seq < evicted_end) {
+                s_stats.dropped += evicted_end - s_tail_seq;
+                ESP_LOGW(TAG, "보관 한도 초과: 오래된 레코드 %" PRIu32 "개 폐기", evicted_end - s_tail_seq);
+                s_tail_seq = evicted_end;
+                s_peek_count = 0;
+            }
+        }
+        esp_err_t err = s_flash.erase(s_flash.ctx, (size_t)(idx / s_slots_per_sector) * s_flash.sector_size,
+                                      s_flash.sector_size);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "섹터 지우기 실패: %s", esp_err_to_name(err));
+            return err;
+        }
+        s_stats.sector_erases++;
+    }
+
+    esp_err_t err = s_flash.write(s_flash.ctx, spool_slot_offset(s_flushed_seq), s_buf, s_buf_len);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "스풀 쓰기 실패: %s", esp_err_to_name(err));
+        return err;
+    }
+    s_stats.flash_writes++;
+    s_flushed_seq = s_head_seq;
+    s_buf_len = 0;
+    return ESP_OK;
+}
+
+// 재전송 대기 중인 레코드 수
+uint32_t spool_pending(void) {
+    return s_ready ? s_head_seq - s_tail_seq : 0;
+}
+
+// 가장 오래된 레코드부터 읽기
+esp_err_t spool_peek(void *records, int max_count, int *out_count) {
+    *out_count = 0;
+    s_peek_count = 0;
+    if (!s_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (max_count > SPOOL_PEEK_MAX) {
+        max_count = SPOOL_PEEK_MAX;
+    }
+
+    uint8_t *dst = (uint8_t *)records;
+    for (uint32_t seq = s_tail_seq; seq != s_head_seq && s_peek_count < max_count; seq++) {
+        if (!spool_load(seq, dst + (size_t)s_peek_count * s_record_size)) {
+            // 읽을 수 없는 슬롯 (복구 시 건너뛴 섹터 나머지, CRC 손상) 은 다시 읽어도 같으므로
+            // 읽은 레코드보다 앞이면 바로 소비, 사이에 있으면 커밋 시 함께 소비
+            if (s_peek_count == 0) {
+                s_tail_seq = seq + 1;
+                s_stats.skipped++;
+            }
+            continue;
+        }
+        s_peek_seqs[s_peek_count++] = seq;
+    }
+    *out_count = s_peek_count;
+    return ESP_OK;
+}
+
+// 앞에서부터 count 개를 전송 완료로 표시하고 소비
+esp_err_t spool_commit(int count) {
+    if (!s_ready || count <= 0 || count > s_peek_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t last_seq = s_peek_seqs[count - 1];
+    s_stats.replayed += (uint32_t)count;
+    s_stats.skipped += (last_seq + 1 - s_tail_seq) - (uint32_t)count;   // 사이에 건너뛴 슬롯
+    s_tail_seq = last_seq + 1;
+    s_peek_count = 0;
+
+    // 재부팅 후 복구를 위해 마지막 소비 레코드에 완료 표시 (바이트 하나, 지우기 없음)
+    uint8_t ack = SPOOL_ACK_DONE;
+    if (last_seq >= s_flushed_seq) {
+        s_buf[(size_t)(last_seq - s_flushed_seq) * s_slot_size + offsetof(spool_slot_header_t, ack)] = ack;
+        return ESP_OK;
+    }
+    return s_flash.write(s_flash.ctx, spool_slot_offset(last_seq) + offsetof(spool_slot_header_t, ack),
+                         &ack, sizeof(ack));
+}
+
+// 스풀 통계 복사
+void spool_get_stats(spool_stats_t *out) {
+    *out = s_stats;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// ===== 스풀 설정 =====
+#define SPOOL_MAX_RECORD_SIZE 192           // 슬롯 하나에 담을 수 있는 최대 레코드 크기
+#define SPOOL_WRITE_BUFFER_SIZE 1024        // RAM 쓰기 버퍼 (이만큼 모아서 한 번에 기록)
+#define SPOOL_FLUSH_AGE_MS 2000             // 버퍼링된 레코드 최대 보관 시간
+
+// ===== 플래시 접근 인터페이스 =====
+// 실제 장치에서는 esp_partition, 호스트에서는 파일 기반 에뮬레이션으로 구현
+typedef struct {
+    esp_err_t (*read)(void *ctx, size_t offset, void *dst, size_t len);
+    esp_err_t (*write)(void *ctx, size_t offset, const void *src, size_t len);
+    esp_err_t (*erase)(void *ctx, size_t offset, size_t len);   // sector_size 단위
+    void *ctx;
+    size_t size;                            // 사용 가능한 전체 크기 (바이트)
+    size_t sector_size;                     // 지우기 단위 (바이트)
+} spool_flash_t;
+
+// 스풀 통계
+typedef struct {
+    uint32_t appended;                      // 스풀에 들어간 레코드 수
+    uint32_t replayed;                      // 재전송 완료로 소비된 레코드 수
+    uint32_t dropped;                       // 보관 한도 초과로 버린 레코드 수
+    uint32_t skipped;                       // 읽을 수 없어 건너뛴 슬롯 수 (쓰기 도중 전원 차단, CRC 손상)
+    uint32_t flash_writes;                  // 플래시 쓰기 호출 수
+    uint32_t sector_erases;                 // 섹터 지우기 횟수
+} spool_stats_t;
+
+// 플래시 영역 위에 순환 스풀 구성, 기존 내용을 스캔해 미전송 레코드 복구
+// max_sectors: 보관 한도 (0이면 영역 전체 사용)
+esp_err_t spool_init(const spool_flash_t *flash, size_t record_size, size_t max_sectors);
+
+// 레코드 추가 (RAM 버퍼에 모았다가 가득 차면 플래시에 기록)
+esp_err_t spool_append(const void *record, uint32_t now_ms);
+
+// RAM 버퍼를 플래시에 기록 (버퍼가 SPOOL_FLUSH_AGE_MS 보다 오래됐거나 force 일 때)
+esp_err_t spool_flush(uint32_t now_ms, bool force);
+
+// 재전송 대기 중인 레코드 수 (RAM 버퍼 포함, 아직 peek 로 걸러지지 않은 읽을 수 없는 슬롯 포함)
+uint32_t spool_pending(void);
+
+// 가장 오래된 레코드부터 최대 max_count 개를 읽음 (소비하지 않음)
+// 앞쪽의 읽을 수 없는 슬롯은 바로 소비하므로 out_count 가 0 이면 spool_pending() 도 0
+esp_err_t spool_peek(void *records, int max_count, int *out_count);
+
+// 앞에서부터 count 개를 전송 완료로 표시하고 소비
+esp_err_t spool_commit(int count);
+
+// 스풀 통계 복사
+void spool_get_stats(spool_stats_t *out);
+
+// 플래시 파티션을 스풀 플래시 인터페이스로 연결
+esp_err_t spool_flash_from_partition(const char *label, spool_flash_t *out);
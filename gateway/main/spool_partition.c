@@ -0,0 +1,43 @@
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "spool.h"
+
+static const char *TAG = "SPOOL";
+
+// ===== esp_partition 기반 플래시 인터페이스 =====
+
+// 파티션 읽기
+static esp_err_t partition_read(void *ctx, size_t offset, void *dst, size_t len) {
+    return esp_partition_read((const esp_partition_t *)ctx, offset, dst, len);
+}
+
+// 파티션 쓰기
+static esp_err_t partition_write(void *ctx, size_t offset, const void *src, size_t len) {
+    return esp_partition_write((const esp_partition_t *)ctx, offset, src, len);
+}
+
+// 파티션 지우기
+static esp_err_t partition_erase(void *ctx, size_t offset, size_t len) {
+    return esp_partition_erase_range((const esp_partition_t *)ctx, offset, len);
+}
+
+// 플래시 파티션을 스풀 플래시 인터페이스로 연결
+esp_err_t spool_flash_from_partition(const char *label, spool_flash_t *out) {
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY,
+                                                           label);
+    if (part == NULL) {
+        ESP_LOGE(TAG, "스풀 파티션 '%s' 을(를) 찾을 수 없음", label);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    *out = (spool_flash_t) {
+        .read = partition_read,
+        .write = partition_write,
+        .erase = partition_erase,
+        .ctx = (void *)part,
+        .size = part->size,
+        .sector_size = part->erase_size,
+    };
+    return ESP_OK;
+}
@@ -0,0 +1,83 @@
+#include <string.h>
+#include "upload_batch.h"
+
+// CBOR 무한 길이 배열 시작 / 끝 바이트
+#define CBOR_ARRAY_INDEFINITE 0x9F
+#define CBOR_BREAK 0xFF
+
+// 배치 비우기
+void upload_batch_reset(upload_batch_t *batch, upload_format_t format) {
+    batch->format = format;
+    batch->buf[0] = (format == UPLOAD_FORMAT_CBOR) ? (char)CBOR_ARRAY_INDEFINITE : '[';
+    batch->len = 1;
+    batch->count = 0;
+    batch->first_ms = 0;
+}
+
+// 직렬화된 레코드 추가
+esp_err_t upload_batch_append(upload_batch_t *batch, const void *record, size_t record_len, uint32_t now_ms) {
+    // 구분자 ',' (JSON 만) + 레코드 + 배열 끝 바이트 + NUL 공간 확인
+    bool separator = (batch->format == UPLOAD_FORMAT_JSON && batch->count > 0);
+    size_t needed = (separator ? 1 : 0) + record_len + 2;
+    if (batch->len + needed > sizeof(batch->buf) || batch->count >= UPLOAD_BATCH_MAX_RECORDS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (separator) {
+        batch->buf[batch->len++] = ',';
+    }
+    if (batch->count == 0) {
+        batch->first_ms = now_ms;
+    }
+    batch->record_offset[batch->count] = (uint16_t)batch->len;
+    batch->record_len[batch->count] = (uint16_t)record_len;
+    memcpy(&batch->buf[batch->len], record, record_len);
+    batch->len += record_len;
+    batch->count++;
+    return ESP_OK;
+}
+
+// 전송 조건 충족 여부
+bool upload_batch_should_flush(const upload_batch_t *batch, uint32_t now_ms) {
+    if (batch->count == 0) {
+        return false;
+    }
+    return batch->count >= UPLOAD_BATCH_MAX_RECORDS ||
+           batch->len >= UPLOAD_BATCH_FLUSH_BYTES ||
+           now_ms - batch->first_ms >= UPLOAD_BATCH_MAX_AGE_MS;
+}
+
+// 나이 한도까지 남은 시간
+uint32_t upload_batch_ms_until_deadline(const upload_batch_t *batch, uint32_t now_ms) {
+    if (batch->count == 0) {
+        return UINT32_MAX;
+    }
+    uint32_t age = now_ms - batch->first_ms;
+    return (age >= UPLOAD_BATCH_MAX_AGE_MS) ? 0 : UPLOAD_BATCH_MAX_AGE_MS - age;
+}
+
+// 배열을 닫고 전송할 본문 반환
+const char *upload_batch_finish(upload_batch_t *batch, size_t *out_len) {
+    batch->buf[batch->len] = (batch->format == UPLOAD_FORMAT_CBOR) ? (char)CBOR_BREAK : ']';
+    batch->buf[batch->len + 1] = '\0';
+    if (out_len != NULL) {
+        *out_len = batch->len + 1;
+    }
+    return batch->buf;
+}
+
+// index 번째 레코드의 직렬화 결과
+const char *upload_batch_record(const upload_batch_t *batch, int index, size_t *out_len) {
+    *out_len = batch->record_len[index];
+    return &batch->buf[batch->record_offset[index]];
+}
+
+// 배치 형식의 HTTP Content-Type
+const char *upload_batch_content_type(const upload_batch_t *batch) {
+    return (batch->format == UPLOAD_FORMAT_CBOR) ? "application/cbor" : "application/json";
+}
+
+// 형식 이름
+const char *upload_format_name(upload_format_t format) {
+    return (format == UPLOAD_FORMAT_CBOR) ? "cbor" : "json";
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// ===== 업로드 배치 설정 =====
+#define UPLOAD_BATCH_MAX_RECORDS 20         // 배치당 최대 레코드 수
+#define UPLOAD_BATCH_MAX_BYTES 4096         // 배치 버퍼 크기 (배열 전체)
+#define UPLOAD_BATCH_FLUSH_BYTES 3072       // 이 크기를 넘으면 즉시 전송
+#define UPLOAD_BATCH_MAX_AGE_MS 200         // 첫 레코드 이후 최대 대기 시간
+
+// ===== 업로드 형식 =====
+typedef enum {
+    UPLOAD_FORMAT_JSON = 0,                 // JSON 배열 "[{...},{...}]" (application/json)
+    UPLOAD_FORMAT_CBOR = 1,                 // CBOR 무한 길이 배열 0x9F ... 0xFF (application/cbor)
+} upload_format_t;
+
+// ===== 업로드 배치 =====
+// 직렬화된 레코드들을 선택된 형식의 배열 하나로 모음
+// 레코드 수 / 바이트 크기 / 첫 레코드 나이 중 하나라도 한도에 닿으면 전송 대상
+typedef struct {
+    char buf[UPLOAD_BATCH_MAX_BYTES];       // 배열 시작 바이트 ('[' 또는 0x9F) 로 시작하는 버퍼
+    size_t len;                             // 현재 사용 중인 바이트 수 (배열 끝 바이트 제외)
+    int count;                              // 담긴 레코드 수
+    uint32_t first_ms;                      // 첫 레코드가 담긴 시각 (밀리초)
+    upload_format_t format;                 // 배치 형식
+    uint16_t record_offset[UPLOAD_BATCH_MAX_RECORDS];   // 레코드별 시작 위치 (레코드 단위 발행용)
+    uint16_t record_len[UPLOAD_BATCH_MAX_RECORDS];      // 레코드별 직렬화 길이
+} upload_batch_t;
+
+// 배치 비우기 (다음 배치의 형식 지정)
+void upload_batch_reset(upload_batch_t *batch, upload_format_t format);
+
+// 직렬화된 레코드 추가, 공간이 없으면 ESP_ERR_NO_MEM (호출자가 전송 후 재시도)
+esp_err_t upload_batch_append(upload_batch_t *batch, const void *record, size_t record_len, uint32_t now_ms);
+
+// 전송 조건 (레코드 수 / 바이트 / 나이) 충족 여부
+bool upload_batch_should_flush(const upload_batch_t *batch, uint32_t now_ms);
+
+// 나이 한도까지 남은 시간 (밀리초), 비어 있으면 UINT32_MAX
+uint32_t upload_batch_ms_until_deadline(const upload_batch_t *batch, uint32_t now_ms);
+
+// 배열을 닫고 전송할 본문 반환 (전송 후 upload_batch_reset 호출 필요)
+const char *upload_batch_finish(upload_batch_t *batch, size_t *out_len);
+
+// index 번째 레코드의 직렬화 결과 (배열 구분자 제외)
+const char *upload_batch_record(const upload_batch_t *batch, int index, size_t *out_len);
+
+// 배치 형식의 HTTP Content-Type
+const char *upload_batch_content_type(const upload_batch_t *batch);
+
+// 형식 이름 ("json" / "cbor")
+const char *upload_format_name(upload_format_t format);
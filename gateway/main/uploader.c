@@ -0,0 +1,531 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+#include "esp_log.h"
+#include "http_uplink.h"
+#include "mqtt_uplink.h"
+#include "record_json.h"
+#include "record_cbor.h"
+#include "upload_batch.h"
+#include "spool.h"
+#include "swift_trace.h"
+#include "uploader.h"
+
+// ===== 설정 상수 =====
+#define MAX_HTTP_RETRY_COUNT 3              // HTTP 전송 최대 재시도 횟수
+#define HTTP_STATS_LOG_INTERVAL 100         // 업링크 통계 로깅 주기 (배치 수)
+#define UPLOADER_TASK_STACK 8192
+#define UPLOADER_TASK_PRIORITY 5            // 수신/필터 태스크보다 낮게
+#define SPOOL_PARTITION_LABEL "spool"       // 저장 후 전달용 데이터 파티션
+#define SPOOL_RETENTION_SECTORS 64          // 스풀 보관 한도 (4KB 섹터 수, 0 = 파티션 전체)
+#define SPOOL_REPLAY_BACKOFF_MS 5000        // 재전송 실패 후 다음 재전송까지 대기
+#define SPOOL_POLL_INTERVAL_MS 1000         // 스풀 작업이 남아 있을 때 최대 대기 시간
+#define MQTT_TOPIC_PREFIX "swift"           // 발행 토픽: swift/<게이트웨이 이름>/beacon/<비콘 시리얼>
+#define MQTT_TOPIC_MAX_LEN 64
+#define MQTT_PUBLISH_TIMEOUT_MS 5000        // 발행 윈도우에 자리가 날 때까지 최대 대기
+#define HEALTH_UPLOAD_INTERVAL_MS 60000     // 상태 레코드 업로드 주기
+
+static const char *TAG = "UPLOADER";
+
+_Static_assert(sizeof(relay_record_t) <= SPOOL_MAX_RECORD_SIZE, "relay_record_t 가 스풀 슬롯보다 큼");
+_Static_assert(RECORD_CBOR_MAX_LEN <= RECORD_JSON_MAX_LEN, "직렬화 버퍼가 CBOR 레코드보다 작음");
+
+// 레코드 버퍼 항목 (단계 시각은 스풀에 저장하지 않으므로 레코드와 분리)
+typedef struct {
+    relay_record_t record;
+    pipeline_stamps_t stamps;
+} queued_record_t;
+
+// ===== 전역 변수 =====
+static QueueHandle_t record_queue;          // 필터 단계 → 업로더 레코드 버퍼
+static upload_batch_t upload_batch;         // 업로드 배치 (업로더 태스크 전용)
+static relay_record_t batch_records[UPLOAD_BATCH_MAX_RECORDS];  // 배치에 담긴 원본 레코드 (스풀용)
+static pipeline_stamps_t batch_stamps[UPLOAD_BATCH_MAX_RECORDS];  // 실시간 배치 레코드별 단계 시각
+static relay_record_t replay_records[UPLOAD_BATCH_MAX_RECORDS]; // 스풀에서 읽은 재전송 레코드
+static health_record_t health_record;       // 상태 레코드 (업로더 태스크 전용)
+static char health_buf[HEALTH_RECORD_MAX_LEN];
+static uint32_t health_due_ms = 0;          // 다음 상태 레코드 업로드 시각
+static char record_buf[RECORD_JSON_MAX_LEN];    // 레코드 직렬화 버퍼 (재사용, 두 형식 공용)
+static volatile upload_format_t requested_format = UPLOAD_FORMAT_JSON;  // 다음 배치부터 적용할 형식
+static volatile uplink_transport_t requested_transport = UPLINK_TRANSPORT_HTTP;  // 다음 배치부터 적용할 전송 방식
+static uplink_transport_t active_transport = UPLINK_TRANSPORT_HTTP;
+static uploader_config_t uplink_config;     // 업링크 주소 및 장치 이름
+static EventGroupHandle_t link_events;      // STA 연결 상태 이벤트 그룹
+static EventBits_t link_up_bit;
+static bool spool_ready = false;
+static uint32_t replay_retry_at_ms = 0;     // 재전송 재시도 가능 시각
+static uploader_stats_t stats = {0};
+
+
+// ===== 서버 전송 (HTTP / MQTT) =====
+
+// 배치 본문을 서버로 전송 (Keep-Alive 영구 연결 재사용)
+static esp_err_t send_batch_to_server(const char *body, size_t body_len, const char *content_type) {
+    // HTTP 요청 수행 (재시도 포함)
+    esp_err_t err = ESP_FAIL;
+    for (int retry = 0; retry < MAX_HTTP_RETRY_COUNT; retry++) {
+        int status_code = 0;
+        err = http_uplink_post(content_type, body, body_len, &status_code);
+        pipeline_metrics_note_http(err == ESP_OK ? status_code : 0, retry > 0);
+
+        if (err == ESP_OK) {
+            if (status_code == 200 || status_code == 201) {
+                ESP_LOGD(TAG, "HTTP POST 성공, 상태: %d", status_code);
+                break;
+            } else {
+                ESP_LOGW(TAG, "HTTP POST 상태 코드 반환: %d", status_code);
+                err = ESP_FAIL;
+            }
+        } else {
+            ESP_LOGW(TAG, "HTTP POST 실패 (시도 %d/%d): %s",
+                    retry + 1, MAX_HTTP_RETRY_COUNT, esp_err_to_name(err));
+        }
+
+        if (retry < MAX_HTTP_RETRY_COUNT - 1) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+        }
+    }
+
+    return err;
+}
+
+// 배치의 레코드를 비콘별 토픽으로 하나씩 QoS1 발행 (PUBACK 은 기다리지 않고 윈도우만큼 겹쳐 보냄)
+// 하나라도 실패하면 배치 전체를 실패로 보고 스풀에 보관 (이미 발행된 레코드는 중복 전달될 수 있음)
+static esp_err_t publish_batch_records(size_t *out_bytes) {
+    char topic[MQTT_TOPIC_MAX_LEN];
+    size_t bytes = 0;
+
+    for (int i = 0; i < upload_batch.count; i++) {
+        snprintf(topic, sizeof(topic), MQTT_TOPIC_PREFIX "/%s/beacon/%s",
+                uplink_config.device_name, batch_records[i].serial_number);
+
+        size_t len = 0;
+        const char *payload = upload_batch_record(&upload_batch, i, &len);
+        esp_err_t err = mqtt_uplink_publish(topic, payload, len, MQTT_PUBLISH_TIMEOUT_MS);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "MQTT 발행 실패 (%d/%d): %s", i + 1, upload_batch.count, esp_err_to_name(err));
+            return err;
+        }
+        bytes += len;
+    }
+
+    *out_bytes = bytes;
+    return ESP_OK;
+}
+
+// 업로더 및 연결 재사용 통계 로깅
+static void log_uploader_stats(void) {
+    http_uplink_stats_t http_stats;
+    http_uplink_get_stats(&http_stats);
+    ESP_LOGI(TAG, "HTTP 업링크 통계: 요청=%" PRIu32 ", 새 연결=%" PRIu32 ", 재사용=%" PRIu32
+            ", 재연결=%" PRIu32 ", 실패=%" PRIu32 ", 연결당 최대 요청=%" PRIu32,
+            http_stats.requests, http_stats.connects, http_stats.reused,
+            http_stats.reconnects, http_stats.failures, http_stats.max_conn_requests);
+    ESP_LOGI(TAG, "업로더 통계: 입력=%" PRIu32 ", 폐기=%" PRIu32 ", 최고 수위=%" PRIu32 "/%d"
+            ", 전송=%" PRIu32 ", 유실=%" PRIu32 ", 스풀 보관=%" PRIu32 ", 스풀 재전송=%" PRIu32
+            ", 전송 바이트=%" PRIu32 " (%s)",
+            stats.records_enqueued, stats.records_dropped, stats.queue_high_water, RECORD_QUEUE_LENGTH,
+            stats.records_sent, stats.records_failed, stats.records_spooled, stats.records_replayed,
+            stats.bytes_sent, upload_format_name(upload_batch.format));
+
+    if (active_transport == UPLINK_TRANSPORT_MQTT) {
+        mqtt_uplink_stats_t mqtt_stats;
+        mqtt_uplink_get_stats(&mqtt_stats);
+        ESP_LOGI(TAG, "MQTT 업링크 통계: 발행=%" PRIu32 ", PUBACK=%" PRIu32 ", 만료=%" PRIu32
+                ", 실패=%" PRIu32 ", 윈도우 대기=%" PRIu32 ", 최대 미확인=%" PRIu32 "/%d, 연결=%" PRIu32,
+                mqtt_stats.published, mqtt_stats.acked, mqtt_stats.expired, mqtt_stats.failures,
+                mqtt_stats.window_stalls, mqtt_stats.max_in_flight, MQTT_UPLINK_WINDOW, mqtt_stats.connects);
+    }
+}
+
+// 업링크(STA 및 선택된 전송 방식) 연결 여부
+static bool uplink_is_up(void) {
+    if ((xEventGroupGetBits(link_events) & link_up_bit) == 0) {
+        return false;
+    }
+    return active_transport != UPLINK_TRANSPORT_MQTT || mqtt_uplink_is_connected();
+}
+
+// 전송 방식 변경 요청 반영 (MQTT 는 처음 선택될 때 연결 시작, 실패하면 기존 방식 유지)
+static void apply_requested_transport(void) {
+    uplink_transport_t transport = requested_transport;
+    if (transport == active_transport) {
+        return;
+    }
+    if (transport == UPLINK_TRANSPORT_MQTT &&
+        mqtt_uplink_init(uplink_config.mqtt_uri, uplink_config.device_name) != ESP_OK) {
+        ESP_LOGE(TAG, "MQTT 업링크 시작 실패, %s 유지", uplink_transport_name(active_transport));
+        requested_transport = active_transport;
+        return;
+    }
+    ESP_LOGI(TAG, "업링크 전송 방식 변경: %s -> %s",
+            uplink_transport_name(active_transport), uplink_transport_name(transport));
+    active_transport = transport;
+}
+
+// 배치 비우기 (형식 / 전송 방식 변경 요청은 배치 경계에서만 반영)
+static void reset_upload_batch(void) {
+    apply_requested_transport();
+
+    upload_format_t format = requested_format;
+    if (format != upload_batch.format) {
+        ESP_LOGI(TAG, "업로드 형식 변경: %s -> %s",
+                upload_format_name(upload_batch.format), upload_format_name(format));
+    }
+    upload_batch_reset(&upload_batch, format);
+}
+
+// 레코드를 배치 형식으로 직렬화해 배치에 추가 (공간이 없으면 ESP_ERR_NO_MEM)
+static esp_err_t batch_add_record(const relay_record_t *record, uint32_t now_ms) {
+    size_t record_len = 0;
+    esp_err_t err;
+    if (upload_batch.format == UPLOAD_FORMAT_CBOR) {
+        err = record_cbor_encode(record, (uint8_t *)record_buf, sizeof(record_buf), &record_len);
+    } else {
+        err = record_json_encode(record, record_buf, sizeof(record_buf), &record_len);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "레코드 직렬화 실패: %s", record->serial_number);
+        return ESP_FAIL;
+    }
+    if (upload_batch.format == UPLOAD_FORMAT_JSON) {
+        SWIFT_TRACE_LOGI(TAG, "JSON 데이터: %s", record_buf);
+    } else {
+        SWIFT_TRACE_LOGI(TAG, "CBOR 데이터: %s, %u 바이트", record->serial_number, (unsigned)record_len);
+    }
+
+    int index = upload_batch.count;
+    err = upload_batch_append(&upload_batch, record_buf, record_len, now_ms);
+    if (err == ESP_OK) {
+        batch_records[index] = *record;
+    }
+    return err;
+}
+
+// 실시간 레코드를 배치에 추가하고 직렬화 시각 기록 (레코드 버퍼 대기 지연)
+static esp_err_t batch_add_live_record(queued_record_t *queued, uint32_t now_ms) {
+    int index = upload_batch.count;
+    esp_err_t err = batch_add_record(&queued->record, now_ms);
+    if (err == ESP_OK) {
+        queued->stamps.serialize_us = pipeline_now_us();
+        batch_stamps[index] = queued->stamps;
+        pipeline_metrics_record(PIPELINE_STAGE_QUEUE, queued->stamps.filter_us, queued->stamps.serialize_us);
+    }
+    return err;
+}
+
+// 전송에 성공한 실시간 배치의 업로드 지연과 전체 지연 기록
+static void record_upload_latency(void) {
+    uint32_t done_us = pipeline_now_us();
+    for (int i = 0; i < upload_batch.count; i++) {
+        pipeline_metrics_record(PIPELINE_STAGE_UPLOAD, batch_stamps[i].serialize_us, done_us);
+        pipeline_metrics_record(PIPELINE_STAGE_TOTAL, batch_stamps[i].rx_us, done_us);
+    }
+}
+
+// 배치를 서버로 전송하고 결과 통계 갱신
+static esp_err_t send_upload_batch(void) {
+    size_t batch_len = 0;
+    esp_err_t err;
+    if (active_transport == UPLINK_TRANSPORT_MQTT) {
+        ESP_LOGD(TAG, "배치 발행: 레코드 %d개 (%s, MQTT)", upload_batch.count,
+                upload_format_name(upload_batch.format));
+        err = publish_batch_records(&batch_len);
+    } else {
+        const char *batch_body = upload_batch_finish(&upload_batch, &batch_len);
+        ESP_LOGD(TAG, "배치 전송: 레코드 %d개, %u 바이트 (%s)", upload_batch.count, (unsigned)batch_len,
+                upload_format_name(upload_batch.format));
+        err = send_batch_to_server(batch_body, batch_len, upload_batch_content_type(&upload_batch));
+    }
+
+    if (err == ESP_OK) {
+        stats.batches_sent++;
+        stats.records_sent += upload_batch.count;
+        stats.bytes_sent += batch_len;
+        ESP_LOGD(TAG, "데이터 서버 전송 성공");
+    } else {
+        stats.batches_failed++;
+    }
+
+    if ((stats.batches_sent + stats.batches_failed) % HTTP_STATS_LOG_INTERVAL == 0) {
+        log_uploader_stats();
+    }
+    return err;
+}
+
+// 배치의 원본 레코드를 플래시 스풀에 보관 (스풀이 없으면 유실)
+static void spool_batch_records(uint32_t now_ms) {
+    for (int i = 0; i < upload_batch.count; i++) {
+        if (spool_ready && spool_append(&batch_records[i], now_ms) == ESP_OK) {
+            stats.records_spooled++;
+        } else {
+            stats.records_failed++;
+        }
+    }
+}
+
+// 모인 실시간 배치 전송, 업링크가 끊겼거나 전송 실패 시 스풀에 보관
+static void flush_upload_batch(void) {
+    if (upload_batch.count == 0) {
+        return;
+    }
+
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    if (!uplink_is_up()) {
+        ESP_LOGW(TAG, "업링크 끊김, 레코드 %d개 스풀에 보관", upload_batch.count);
+        spool_batch_records(now_ms);
+    } else if (send_upload_batch() == ESP_OK) {
+        record_upload_latency();
+    } else {
+        ESP_LOGE(TAG, "데이터 서버 전송 실패, 레코드 %d개 스풀에 보관", upload_batch.count);
+        spool_batch_records(now_ms);
+        replay_retry_at_ms = now_ms + SPOOL_REPLAY_BACKOFF_MS;
+    }
+
+    reset_upload_batch();
+}
+
+// 스풀에 보관된 레코드를 원래 타임스탬프 그대로 한 배치씩 재전송
+// 보낼 것이 없거나 보내지 못하면 항상 재시도 시각을 미룸 (replay_due 가 계속 참이면 업로더 태스크가 쉬지 않고 돎)
+static void replay_spooled_batch(void) {
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    int count = 0;
+    if (spool_peek(replay_records, UPLOAD_BATCH_MAX_RECORDS, &count) != ESP_OK || count == 0) {
+        replay_retry_at_ms = now_ms + SPOOL_REPLAY_BACKOFF_MS;
+        return;
+    }
+
+    int added = 0;
+    while (added < count && batch_add_record(&replay_records[added], now_ms) == ESP_OK) {
+        added++;
+    }
+    if (added == 0) {
+        // 빈 배치에도 못 넣는 레코드는 다시 시도해도 같으므로 버리고 다음 레코드로
+        ESP_LOGW(TAG, "스풀 레코드 직렬화 불가, 폐기: %s", replay_records[0].serial_number);
+        spool_commit(1);
+        stats.records_failed++;
+        replay_retry_at_ms = now_ms + SPOOL_REPLAY_BACKOFF_MS;
+        return;
+    }
+
+    ESP_LOGD(TAG, "스풀 재전송: 레코드 %d개 (남은 %" PRIu32 "개)", added, spool_pending());
+    if (send_upload_batch() == ESP_OK) {
+        spool_commit(added);
+        stats.records_replayed += added;
+    } else {
+        // 스풀에 그대로 남겨 두고 잠시 후 재시도
+        replay_retry_at_ms = now_ms + SPOOL_REPLAY_BACKOFF_MS;
+    }
+    reset_upload_batch();
+}
+
+// 재전송할 차례인지 (실시간 배치가 비어 있고 업링크가 살아 있을 때만)
+static bool replay_due(uint32_t now_ms) {
+    return spool_ready && upload_batch.count == 0 && spool_pending() > 0 &&
+           uplink_is_up() && (int32_t)(now_ms - replay_retry_at_ms) >= 0;
+}
+
+
+// ===== 상태 레코드 =====
+
+// 상태 레코드 업로드 차례인지
+static bool health_due(uint32_t now_ms) {
+    return uplink_config.collect_health != NULL && (int32_t)(now_ms - health_due_ms) >= 0;
+}
+
+// 상태 레코드를 수집해 업로드 (업링크가 끊겼으면 건너뜀, 스풀에 보관하지 않음)
+static void upload_health_record(uint32_t now_ms) {
+    health_due_ms = now_ms + HEALTH_UPLOAD_INTERVAL_MS;
+    if (!uplink_is_up()) {
+        return;
+    }
+
+    memset(&health_record, 0, sizeof(health_record));
+    uplink_config.collect_health(&health_record);
+    size_t len = 0;
+    if (health_record_encode_json(&health_record, health_buf, sizeof(health_buf), &len) != ESP_OK) {
+        ESP_LOGE(TAG, "상태 레코드 직렬화 실패");
+        return;
+    }
+
+    esp_err_t err;
+    int status_code = 0;
+    if (active_transport == UPLINK_TRANSPORT_MQTT) {
+        char topic[MQTT_TOPIC_MAX_LEN];
+        snprintf(topic, sizeof(topic), MQTT_TOPIC_PREFIX "/%s/health", uplink_config.device_name);
+        err = mqtt_uplink_publish(topic, health_buf, len, MQTT_PUBLISH_TIMEOUT_MS);
+    } else {
+        err = http_uplink_post_to(uplink_config.health_url, "application/json", health_buf, len, &status_code);
+        if (err == ESP_OK && status_code != 200 && status_code != 201) {
+            err = ESP_FAIL;
+        }
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "상태 레코드 업로드 실패 (상태 %d): %s", status_code, esp_err_to_name(err));
+    } else {
+        ESP_LOGD(TAG, "상태 레코드 업로드: %u 바이트", (unsigned)len);
+    }
+}
+
+
+// ===== 업로더 태스크 =====
+
+// 레코드 버퍼에서 레코드를 꺼내 배치 단위로 서버에 전송
+static void uploader_task(void *pvParameters) {
+    ESP_LOGI(TAG, "업로더 태스크 시작");
+    queued_record_t queued;
+
+    apply_requested_transport();
+    upload_batch_reset(&upload_batch, requested_format);
+
+    while (1) {
+        // 배치가 비어 있으면 무한 대기, 아니면 나이 한도까지만 대기
+        uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        uint32_t wait_ms = upload_batch_ms_until_deadline(&upload_batch, now_ms);
+
+        // 재전송이나 스풀 기록이 남아 있으면 주기적으로 깨어남
+        if (replay_due(now_ms)) {
+            wait_ms = 0;
+        } else if (spool_ready && spool_pending() > 0 && wait_ms > SPOOL_POLL_INTERVAL_MS) {
+            wait_ms = SPOOL_POLL_INTERVAL_MS;
+        }
+        if (uplink_config.collect_health != NULL) {
+            uint32_t health_wait_ms = health_due(now_ms) ? 0 : health_due_ms - now_ms;
+            if (health_wait_ms < wait_ms) {
+                wait_ms = health_wait_ms;
+            }
+        }
+        TickType_t wait_ticks = (wait_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(wait_ms);
+
+        if (xQueueReceive(record_queue, &queued, wait_ticks) == pdTRUE) {
+            // 배치에 추가, 공간이 없으면 먼저 전송 후 재시도
+            now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+            esp_err_t err = batch_add_live_record(&queued, now_ms);
+            if (err == ESP_ERR_NO_MEM) {
+                flush_upload_batch();
+                err = batch_add_live_record(&queued, now_ms);
+            }
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "레코드를 배치에 추가할 수 없음, 폐기");
+                stats.records_failed++;
+            }
+        }
+
+        // 레코드 수 / 크기 / 나이 한도 중 하나라도 닿으면 전송
+        now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        if (upload_batch_should_flush(&upload_batch, now_ms)) {
+            flush_upload_batch();
+        }
+
+        // 실시간 레코드가 없는 틈에 스풀 재전송, 오래된 스풀 버퍼는 플래시에 기록
+        if (replay_due(now_ms) && uxQueueMessagesWaiting(record_queue) == 0) {
+            replay_spooled_batch();
+        }
+        if (spool_ready) {
+            spool_flush(now_ms, false);
+        }
+
+        // 상태 레코드 (실시간 배치와 별개 요청)
+        if (health_due(now_ms)) {
+            upload_health_record(now_ms);
+        }
+    }
+}
+
+
+// ===== 공개 함수 =====
+
+// 레코드 버퍼 생성 및 업로더 태스크 시작
+esp_err_t uploader_start(const uploader_config_t *config, EventGroupHandle_t link_event_group, EventBits_t link_bit) {
+    uplink_config = *config;
+    link_events = link_event_group;
+    link_up_bit = link_bit;
+
+    // 업링크 장애 동안 레코드를 보관할 플래시 스풀 (없으면 스풀 없이 동작)
+    spool_flash_t flash;
+    if (spool_flash_from_partition(SPOOL_PARTITION_LABEL, &flash) == ESP_OK &&
+        spool_init(&flash, sizeof(relay_record_t), SPOOL_RETENTION_SECTORS) == ESP_OK) {
+        spool_ready = true;
+    } else {
+        ESP_LOGW(TAG, "스풀 비활성화: 업링크 장애 중 레코드는 유실됨");
+    }
+
+    record_queue = xQueueCreate(RECORD_QUEUE_LENGTH, sizeof(queued_record_t));
+    if (record_queue == NULL) {
+        ESP_LOGE(TAG, "레코드 버퍼 생성 실패");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 영구 HTTP 연결 준비 (요청마다 재생성하지 않음)
+    if (http_uplink_init(uplink_config.http_url) != ESP_OK) {
+        ESP_LOGE(TAG, "HTTP 업링크 초기화 실패, 첫 전송 시 재시도");
+    }
+
+    if (xTaskCreate(uploader_task, "uploader", UPLOADER_TASK_STACK, NULL,
+                    UPLOADER_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "업로더 태스크 생성 실패");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+// 레코드를 업로더로 넘김 (필터 태스크 단일 생산자 전제)
+void uploader_submit(const relay_record_t *record, const pipeline_stamps_t *stamps) {
+    // 필터 태스크 전용 (큐 항목이 커서 스택 대신 정적 버퍼)
+    static queued_record_t queued;
+    static queued_record_t oldest;
+    queued.record = *record;
+    queued.stamps = *stamps;
+
+    if (xQueueSend(record_queue, &queued, 0) != pdTRUE) {
+        // 서버가 느려 버퍼가 가득 참: 가장 오래된 레코드를 버리고 최신 레코드 유지
+        if (xQueueReceive(record_queue, &oldest, 0) == pdTRUE) {
+            stats.records_dropped++;
+        }
+        if (xQueueSend(record_queue, &queued, 0) != pdTRUE) {
+            stats.records_dropped++;
+            return;
+        }
+    }
+    stats.records_enqueued++;
+
+    uint32_t waiting = (uint32_t)uxQueueMessagesWaiting(record_queue);
+    if (waiting > stats.queue_high_water) {
+        stats.queue_high_water = waiting;
+    }
+}
+
+// 업로더 통계 복사
+void uploader_get_stats(uploader_stats_t *out) {
+    *out = stats;
+}
+
+// 업로드 형식 선택 (진행 중인 배치는 기존 형식으로 전송되고 다음 배치부터 적용)
+void uploader_set_format(upload_format_t format) {
+    requested_format = format;
+}
+
+// 현재 선택된 업로드 형식
+upload_format_t uploader_get_format(void) {
+    return requested_format;
+}
+
+// 업링크 전송 방식 선택 (진행 중인 배치는 기존 방식으로 전송되고 다음 배치부터 적용)
+void uploader_set_transport(uplink_transport_t transport) {
+    requested_transport = transport;
+}
+
+// 현재 선택된 업링크 전송 방식
+uplink_transport_t uploader_get_transport(void) {
+    return requested_transport;
+}
+
+// 전송 방식 이름 ("http" / "mqtt")
+const char *uplink_transport_name(uplink_transport_t transport) {
+    return (transport == UPLINK_TRANSPORT_MQTT) ? "mqtt" : "http";
+}
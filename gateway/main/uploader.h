@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_err.h"
+#include "swift_frame.h"
+#include "upload_batch.h"
+#include "pipeline_metrics.h"
+#include "health_record.h"
+
+// ===== 업로드 레코드 =====
+#define RELAY_MAX_MEASUREMENTS SWIFT_FRAME_MAX_MEASUREMENTS   // 레코드당 최대 측정값 수
+#define RECORD_QUEUE_LENGTH 64              // 필터 단계 → 업로더 레코드 버퍼 깊이
+
+// 필터 단계를 거친 비콘 레코드 (업로더가 직렬화)
+typedef struct {
+    char serial_number[10];                 // 비콘 시리얼 번호
+    uint8_t battery_level;                  // 배터리 잔량 (%)
+    int8_t floor;                           // 층 번호
+    uint8_t measurement_count;              // 유효 측정값 수 (위치를 계산했으면 0)
+    uint8_t position_anchors;               // 위치 계산에 쓴 앵커 수 (0 이면 위치 없음)
+    bool has_sequence;                      // 비콘 사이클 번호 포함 여부
+    bool has_profile;                       // 비콘 전력 프로파일 포함 여부
+    int64_t timestamp_ms;                   // 게이트웨이 처리 시각 (UTC epoch 밀리초)
+    float position_x;                       // 게이트웨이가 계산한 위치 (m, 앵커 좌표계)
+    float position_y;
+    float position_accuracy;                // 위치 정확도 (m, 1 시그마)
+    uint32_t sequence;                      // 비콘 사이클 번호 (게이트웨이 간 중복 제거용)
+    struct {
+        uint8_t anchor_mac[6];              // 앵커 MAC 주소
+        float distance_meters;              // 칼만 필터링된 거리
+        int8_t rssi;                        // 신호 강도
+        uint32_t rtt_nanoseconds;           // RTT (나노초)
+    } measurements[RELAY_MAX_MEASUREMENTS];
+    swift_profile_t profile;                // 비콘 깨어남 전력 프로파일 (SWIFT_EXT_PROFILE 그대로)
+} relay_record_t;
+
+// 업링크 전송 방식
+typedef enum {
+    UPLINK_TRANSPORT_HTTP = 0,              // 배치를 HTTP POST 한 번으로 전송
+    UPLINK_TRANSPORT_MQTT = 1,              // 레코드별 QoS1 발행 (비콘별 토픽, 윈도우 파이프라이닝)
+} uplink_transport_t;
+
+// 업링크 설정 (문자열은 프로그램 수명 동안 유효해야 함)
+typedef struct {
+    const char *http_url;                   // HTTP 배치 업로드 엔드포인트
+    const char *mqtt_uri;                   // MQTT 브로커 URI
+    const char *device_name;                // 게이트웨이 이름 (MQTT client_id 및 토픽)
+    const char *health_url;                 // 상태 레코드 HTTP 엔드포인트 (MQTT 는 <접두사>/<이름>/health 토픽)
+    void (*collect_health)(health_record_t *out);   // 상태 레코드 수집 (업로더 태스크에서 호출, NULL 이면 업로드 안 함)
+} uploader_config_t;
+
+// 업로더 통계
+typedef struct {
+    uint32_t records_enqueued;              // 레코드 버퍼에 들어간 레코드 수
+    uint32_t records_dropped;               // 버퍼가 가득 차 버린 (가장 오래된) 레코드 수
+    uint32_t queue_high_water;              // 레코드 버퍼 최고 수위
+    uint32_t records_sent;                  // 서버 전송에 성공한 레코드 수
+    uint32_t records_failed;                // 전송도 스풀 보관도 못 해 유실된 레코드 수
+    uint32_t records_spooled;               // 업링크 장애로 플래시 스풀에 보관한 레코드 수
+    uint32_t records_replayed;              // 스풀에서 재전송에 성공한 레코드 수
+    uint32_t batches_sent;                  // 성공한 배치 요청 수
+    uint32_t batches_failed;                // 실패한 배치 요청 수
+    uint32_t bytes_sent;                    // 전송에 성공한 배치 본문 바이트 수
+} uploader_stats_t;
+
+// 레코드 버퍼 생성 및 업로더 태스크 시작
+// link_bit 가 꺼져 있는 동안 레코드는 플래시 스풀에 보관되고, 다시 켜지면 재전송됨
+esp_err_t uploader_start(const uploader_config_t *config, EventGroupHandle_t link_event_group, EventBits_t link_bit);
+
+// 레코드를 업로더로 넘김 (절대 블록하지 않음, 가득 차면 가장 오래된 레코드 폐기)
+// stamps 는 수신/꺼냄/필터 시각이 채워진 단계 시각 (직렬화 이후는 업로더가 기록)
+void uploader_submit(const relay_record_t *record, const pipeline_stamps_t *stamps);
+
+// 업로더 통계 복사
+void uploader_get_stats(uploader_stats_t *out);
+
+// 업로드 형식 선택 (진행 중인 배치는 기존 형식으로 전송되고 다음 배치부터 적용)
+void uploader_set_format(upload_format_t format);
+
+// 현재 선택된 업로드 형식
+upload_format_t uploader_get_format(void);
+
+// 업링크 전송 방식 선택 (진행 중인 배치는 기존 방식으로 전송되고 다음 배치부터 적용)
+void uploader_set_transport(uplink_transport_t transport);
+
+// 현재 선택된 업링크 전송 방식
+uplink_transport_t uploader_get_transport(void);
+
+// 전송 방식 이름 ("http" / "mqtt")
+const char *uplink_transport_name(uplink_transport_t transport);
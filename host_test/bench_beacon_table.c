@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "beacon_table.h"
+#include "bench_util.h"
+
+// ===== 벤치마크 설정 =====
+// 해시 테이블 용량은 CMakeLists.txt 에서 BEACON_TABLE_CAPACITY=8192 로 빌드 (6000 엔트리 수용)
+#define ANCHORS_PER_BEACON 6
+#define HIT_LOOKUPS 2000000                 // 적중 조회 반복 수
+#define CHURN_INSERTS 200000                // 교체 단계 새 키 수
+
+static const int sizes[] = {60, 600, 6000};
+
+// ===== 이전 구현 (선형 탐색 + 만료 시 배열 압축) =====
+// user-006 이전 main.c 의 find_or_create_entry / cleanup_old_entries 를 시간 인자만 바꿔 옮긴 것
+
+typedef struct {
+    char serial_number[10];
+    uint8_t anchor_mac[6];
+    kalman_filter_state_t kf_state;
+    uint32_t last_seen;
+} linear_entry_t;
+
+static linear_entry_t *linear_states;
+static int linear_capacity;
+static int linear_count;
+
+// 오래된 엔트리 정리 (BEACON_TIMEOUT_MS 이상)
+static void linear_cleanup(uint32_t now_ms) {
+    int write_idx = 0;
+    for (int read_idx = 0; read_idx < linear_count; read_idx++) {
+        if (now_ms - linear_states[read_idx].last_seen < BEACON_TIMEOUT_MS) {
+            if (write_idx != read_idx) {
+                linear_states[write_idx] = linear_states[read_idx];
+            }
+            write_idx++;
+        }
+    }
+    linear_count = write_idx;
+}
+
+// 기존 엔트리 찾기 또는 새로 생성
+static linear_entry_t *linear_find_or_create(const char *serial_number, const uint8_t *anchor_mac,
+                                             uint32_t now_ms) {
+    for (int i = 0; i < linear_count; i++) {
+        if (strcmp(linear_states[i].serial_number, serial_number) == 0 &&
+            memcmp(linear_states[i].anchor_mac, anchor_mac, 6) == 0) {
+            linear_states[i].last_seen = now_ms;
+            return &linear_states[i];
+        }
+    }
+    if (linear_count >= linear_capacity) {
+        linear_cleanup(now_ms);
+    }
+    if (linear_count >= linear_capacity) {
+        return NULL;
+    }
+    linear_entry_t *entry = &linear_states[linear_count++];
+    memset(entry, 0, sizeof(*entry));
+    strncpy(entry->serial_number, serial_number, sizeof(entry->serial_number) - 1);
+    memcpy(entry->anchor_mac, anchor_mac, 6);
+    entry->last_seen = now_ms;
+    return entry;
+}
+
+
+// ===== 키 생성 =====
+
+// k 번째 (비콘, 앵커) 키
+static void make_key(uint32_t k, char serial[10], uint8_t mac[6]) {
+    snprintf(serial, 10, "SN%06u", (unsigned)(k / ANCHORS_PER_BEACON));
+    static const uint8_t base[6] = {0x40, 0x4c, 0xca, 0x00, 0x00, 0x00};
+    memcpy(mac, base, 6);
+    mac[5] = (uint8_t)(0x10 + k % ANCHORS_PER_BEACON);
+}
+
+typedef struct {
+    char serial[10];
+    uint8_t mac[6];
+} bench_key_t;
+
+
+// ===== 측정 =====
+
+// 엔트리 n 개를 채운 뒤 무작위 순서 적중 조회의 호출당 시간 (ns)
+static void bench_hits(int n, double *hash_ns, double *linear_ns) {
+    bench_key_t *keys = malloc(sizeof(bench_key_t) * (size_t)n);
+    uint32_t *order = malloc(sizeof(uint32_t) * HIT_LOOKUPS);
+    uint32_t rng = 12345;
+    for (int k = 0; k < n; k++) {
+        make_key((uint32_t)k, keys[k].serial, keys[k].mac);
+    }
+    for (int i = 0; i < HIT_LOOKUPS; i++) {
+        order[i] = bench_rand(&rng) % (uint32_t)n;
+    }
+
+    beacon_table_init();
+    linear_count = 0;
+    for (int k = 0; k < n; k++) {
+        beacon_table_find_or_create(keys[k].serial, keys[k].mac, 0);
+        linear_find_or_create(keys[k].serial, keys[k].mac, 0);
+    }
+
+    // 선형 탐색은 6000 엔트리에서 느리므로 조회 수를 줄여 비슷한 시간만 측정
+    int linear_lookups = HIT_LOOKUPS / (n >= 6000 ? 100 : n >= 600 ? 10 : 1);
+
+    uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < HIT_LOOKUPS; i++) {
+        const bench_key_t *key = &keys[order[i]];
+        bench_consume(beacon_table_find_or_create(key->serial, key->mac, (uint32_t)i / 1000));
+    }
+    uint64_t t1 = bench_now_ns();
+    for (int i = 0; i < linear_lookups; i++) {
+        const bench_key_t *key = &keys[order[i]];
+        bench_consume(linear_find_or_create(key->serial, key->mac, (uint32_t)i / 1000));
+    }
+    uint64_t t2 = bench_now_ns();
+
+    *hash_ns = (double)(t1 - t0) / HIT_LOOKUPS;
+    *linear_ns = (double)(t2 - t1) / linear_lookups;
+    free(order);
+    free(keys);
+}
+
+// 살아 있는 엔트리가 n 개 근처로 유지되도록 새 키가 계속 들어오는 교체 부하의 호출당 시간 (ns)
+// 새 키마다 시각을 BEACON_TIMEOUT_MS / n 씩 진행해 가장 오래된 키가 차례로 만료되게 함
+static void bench_churn(int n, double *hash_ns, double *linear_ns) {
+    int inserts = CHURN_INSERTS;
+    bench_key_t *keys = malloc(sizeof(bench_key_t) * (size_t)inserts);
+    for (int k = 0; k < inserts; k++) {
+        make_key((uint32_t)k, keys[k].serial, keys[k].mac);
+    }
+    uint32_t step_ms = BEACON_TIMEOUT_MS / (uint32_t)n + 1;
+
+    beacon_table_init();
+    uint64_t t0 = bench_now_ns();
+    for (int k = 0; k < inserts; k++) {
+        bench_consume(beacon_table_find_or_create(keys[k].serial, keys[k].mac, (uint32_t)k * step_ms));
+    }
+    uint64_t t1 = bench_now_ns();
+
+    int linear_inserts = inserts / (n >= 6000 ? 20 : n >= 600 ? 4 : 1);
+    linear_count = 0;
+    uint64_t t2 = bench_now_ns();
+    for (int k = 0; k < linear_inserts; k++) {
+        bench_consume(linear_find_or_create(keys[k].serial, keys[k].mac, (uint32_t)k * step_ms));
+    }
+    uint64_t t3 = bench_now_ns();
+
+    *hash_ns = (double)(t1 - t0) / inserts;
+    *linear_ns = (double)(t3 - t2) / linear_inserts;
+    free(keys);
+}
+
+int main(void) {
+    printf("비콘-앵커 테이블: 해시 인덱스 (BEACON_TABLE_CAPACITY=%d) vs 이전 선형 탐색\n", BEACON_TABLE_CAPACITY);
+    printf("%8s | %14s %14s %8s %6s | %14s %14s %8s\n",
+           "entries", "hit hash ns", "hit linear ns", "ratio", "probe", "churn hash ns", "churn lin ns", "ratio");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int n = sizes[s];
+        if (n > BEACON_TABLE_CAPACITY) {
+            continue;
+        }
+        linear_capacity = n;
+        linear_states = calloc((size_t)n, sizeof(linear_entry_t));
+
+        double hit_hash, hit_linear, churn_hash, churn_linear;
+        bench_hits(n, &hit_hash, &hit_linear);
+        beacon_table_stats_t stats;
+        beacon_table_get_stats(&stats);
+        bench_churn(n, &churn_hash, &churn_linear);
+        printf("%8d | %14.1f %14.1f %7.1fx %6u | %14.1f %14.1f %7.1fx\n",
+               n, hit_hash, hit_linear, hit_linear / hit_hash, (unsigned)stats.max_probe, churn_hash, churn_linear, churn_linear / churn_hash);
+
+        free(linear_states);
+    }
+    printf("probe: 적중 조회의 최장 탐사 길이, churn: 새 키마다 가장 오래된 키가 만료되는 교체 부하\n");
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include "bench_util.h"
+#include "ftm_reducer.h"
+
+// ===== 벤치마크 설정 =====
+#define BENCH_CASES 2048                    // 미리 만들어 두는 세션 수
+#define BENCH_ROUNDS 200
+
+static wifi_ftm_report_entry_t s_cases[BENCH_CASES][FTM_REDUCER_MAX_SAMPLES];
+
+// 실제 세션과 비슷한 입력: 기준 RTT 주변 ±200ps 잡음, 15% 다중경로, 5% 실패
+static void make_cases(int count) {
+    uint32_t rng = 7;
+    for (int n = 0; n < BENCH_CASES; n++) {
+        uint32_t base_ps = 20000 + bench_rand(&rng) % 250000;
+        for (int i = 0; i < count; i++) {
+            uint32_t r = bench_rand(&rng) % 100;
+            uint32_t rtt = base_ps + bench_rand(&rng) % 401 - 200;
+            if (r < 5) {
+                rtt = 0;
+            } else if (r < 20) {
+                rtt += 1000 + bench_rand(&rng) % 30000;
+            }
+            s_cases[n][i].rtt = rtt;
+        }
+    }
+}
+
+// 구현 하나의 호출당 시간 (ns)
+static double bench_impl(esp_err_t (*reduce)(const wifi_ftm_report_entry_t *, int, ftm_reduce_result_t *), int count) {
+    uint64_t t0 = bench_now_ns();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int n = 0; n < BENCH_CASES; n++) {
+            ftm_reduce_result_t out;
+            reduce(s_cases[n], count, &out);
+            bench_consume(&out);
+        }
+    }
+    return (double)(bench_now_ns() - t0) / ((double)BENCH_ROUNDS * BENCH_CASES);
+}
+
+int main(void) {
+    static const int counts[] = {8, 16, 32, 64};
+    printf("FTM 세션 축약 호출당 시간 (ns): 정수 ftm_reduce vs 부동소수점 ftm_reduce_reference\n");
+    printf("%8s %12s %12s %8s\n", "entries", "ftm_reduce", "reference", "ratio");
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        make_cases(counts[c]);
+        double fast = bench_impl(ftm_reduce, counts[c]);
+        double ref = bench_impl(ftm_reduce_reference, counts[c]);
+        printf("%8d %12.1f %12.1f %7.2fx\n", counts[c], fast, ref, ref / fast);
+    }
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_util.h"
+#include "freertos_shim.h"
+#include "ftm_reducer.h"
+#include "kalman_filter.h"
+
+// ===== 벤치마크 설정 =====
+// 합성 거리 궤적에 FTM 프레임 잡음을 입혀 비콘의 실제 축약(ftm_reduce)을 거친 측정값을 만들고,
+// 게이트웨이 칼만 필터(kalman_filter_update)와 이전 1차원 랜덤 워크 필터의 거리 오차를
+// 세션당 FTM 프레임 수별로 비교
+#define REPORT_PERIOD_MS 5000               // 비콘 리포트 주기
+#define REPORTS_PER_TRACE 120               // 궤적당 리포트 수 (10분)
+#define WARMUP_REPORTS 5                    // 오차 집계에서 뺄 초기 리포트 수
+#define TRACES 300                          // 시나리오별 궤적 수
+
+#define FRAME_NOISE_M 0.6f                  // 프레임 하나의 거리 잡음 표준편차 (보정 후 m)
+#define FRAME_MULTIPATH_PROB 0.15f          // 다중경로로 길어진 프레임 비율
+#define FRAME_MULTIPATH_MAX_M 5.0f          // 다중경로 추가 거리 최대값
+#define FRAME_LOSS_PROB 0.05f               // RTT 0 으로 실패한 프레임 비율
+#define RANGE_MIN_M 1.0f                    // 보정 후 거리 범위 (FTM_RTT_MAX_PS 가 보정 후 ~10m)
+#define RANGE_MAX_M 9.0f
+#define SESSION_JUMP_PROB 0.05f             // 세션 전체가 길어진 리포트 비율 (jumps 시나리오)
+#define SESSION_JUMP_MIN_M 2.0f             // 세션 전체에 더해지는 거리 범위
+#define SESSION_JUMP_MAX_M 8.0f
+
+// 보정 후 거리 (m) → RTT (ps), ftm_reducer.c 와 같은 환산
+#define CALIBRATED_METERS_PER_PS (299792458.0 * 1e-12 / 2.0 * FTM_CALIBRATION_FACTOR)
+
+static const int frame_counts[] = {4, 6, 8, 12, 16, 24, 32};
+#define FRAME_COUNT_CASES (int)(sizeof(frame_counts) / sizeof(frame_counts[0]))
+
+typedef enum {
+    SCENARIO_STATIC,                        // 한 자리에 고정
+    SCENARIO_WALKING,                       // 계속 걸으며 5~20초마다 방향 전환
+    SCENARIO_STOP_AND_GO,                   // 20초 걷고 40초 멈춤 반복
+    SCENARIO_JUMPS,                         // static + 리포트 단위 이상치 (세션 전체가 +2~8m)
+    SCENARIO_COUNT
+} scenario_t;
+
+static const char *const scenario_names[SCENARIO_COUNT] = {"static", "walking", "stop-and-go", "static+jumps"};
+
+// 필터별 오차 제곱합
+typedef struct {
+    double raw;
+    double random_walk;
+    double kalman;
+    int samples;
+    int lost;                               // 유효 샘플이 없어 측정값이 없던 리포트 수
+} error_sum_t;
+
+
+// ===== 이전 필터 (user-011 이전 kalman_filter.c, Q = 0.05 고정 랜덤 워크) =====
+
+typedef struct {
+    float x;
+    float P;
+    bool initialized;
+} random_walk_filter_t;
+
+// 측정값으로 갱신
+static float random_walk_update(random_walk_filter_t *f, float measurement, float variance, float dt) {
+    if (!f->initialized) {
+        f->x = measurement;
+        f->P = variance;
+        f->initialized = true;
+        return f->x;
+    }
+    float P_pred = f->P + 0.05f * dt;
+    float K = P_pred / (P_pred + variance);
+    f->x += K * (measurement - f->x);
+    f->P = (1.0f - K) * P_pred;
+    return f->x;
+}
+
+
+// ===== 합성 데이터 =====
+
+// [0, 1) 균등 난수
+static float rand_unit(uint32_t *rng) {
+    return (float)(bench_rand(rng) >> 8) / 16777216.0f;
+}
+
+// 표준 정규 난수 (Box-Muller)
+static float rand_normal(uint32_t *rng) {
+    float u1 = rand_unit(rng) + 1e-7f;
+    float u2 = rand_unit(rng);
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+// 궤적 하나 생성 (리포트 시각마다의 실제 거리)
+static void make_trace(scenario_t scenario, uint32_t *rng, float *range) {
+    float r = RANGE_MIN_M + (RANGE_MAX_M - RANGE_MIN_M) * rand_unit(rng);
+    float speed = 0.6f + 0.8f * rand_unit(rng);
+    float direction = rand_unit(rng) < 0.5f ? -1.0f : 1.0f;
+    float next_turn_s = 5.0f + 15.0f * rand_unit(rng);
+    const float step_s = 0.1f;
+    float t = 0;
+    for (int k = 0; k < REPORTS_PER_TRACE; k++) {
+        range[k] = r;
+        for (float end = t + REPORT_PERIOD_MS / 1000.0f; t < end; t += step_s) {
+            bool moving = scenario == SCENARIO_WALKING ||
+                          (scenario == SCENARIO_STOP_AND_GO && fmodf(t, 60.0f) < 20.0f);
+            if (!moving) {
+                continue;
+            }
+            // 앵커 쪽으로 걷거나 멀어짐 (앵커를 지나가는 경우는 거리 변화율이 줄어드는 것과 같음)
+            r += direction * speed * step_s;
+            if (t >= next_turn_s || r < RANGE_MIN_M || r > RANGE_MAX_M) {
+                direction = -direction;
+                next_turn_s = t + 5.0f + 15.0f * rand_unit(rng);
+            }
+        }
+    }
+}
+
+// 실제 거리에서 FTM 세션 하나의 리포트 엔트리 생성
+static void make_frames(float range, int frames, uint32_t *rng, wifi_ftm_report_entry_t *entries) {
+    memset(entries, 0, sizeof(*entries) * (size_t)frames);
+    for (int i = 0; i < frames; i++) {
+        if (rand_unit(rng) < FRAME_LOSS_PROB) {
+            entries[i].rtt = 0;
+            continue;
+        }
+        float measured = range + FRAME_NOISE_M * rand_normal(rng);
+        if (rand_unit(rng) < FRAME_MULTIPATH_PROB) {
+            measured += FRAME_MULTIPATH_MAX_M * rand_unit(rng);
+        }
+        if (measured < 0.01f) {
+            measured = 0.01f;
+        }
+        entries[i].rtt = (uint32_t)(measured / CALIBRATED_METERS_PER_PS);
+        entries[i].rssi = -60;
+    }
+}
+
+
+// ===== 측정 =====
+
+// 시나리오 하나, 프레임 수 하나의 오차 집계
+static void run_case(scenario_t scenario, int frames, error_sum_t *sum) {
+    // 프레임 수와 무관하게 같은 궤적 (jumps 는 static 과 같은 궤적에 이상치만 더함)
+    uint32_t rng = 0x5EED0000u + (uint32_t)(scenario == SCENARIO_JUMPS ? SCENARIO_STATIC : scenario) * 7919u;
+    uint32_t frame_rng = 0xF00Du + (uint32_t)frames * 104729u;
+    float range[REPORTS_PER_TRACE];
+    wifi_ftm_report_entry_t entries[FTM_REDUCER_MAX_SAMPLES];
+    memset(sum, 0, sizeof(*sum));
+
+    for (int trace = 0; trace < TRACES; trace++) {
+        make_trace(scenario, &rng, range);
+        kalman_filter_state_t kf = {0};
+        random_walk_filter_t rw = {0};
+        float raw = NAN, rw_x = NAN, kf_x = NAN;
+
+        for (int k = 0; k < REPORTS_PER_TRACE; k++) {
+            uint32_t now_ms = (uint32_t)(k + 1) * REPORT_PERIOD_MS;
+            freertos_shim_set_tick(now_ms / portTICK_PERIOD_MS);
+            // 반사 경로로만 잡힌 세션 등: 프레임 전체가 같이 길어져 중앙값도 그대로 튐
+            float measured_range = range[k];
+            if (scenario == SCENARIO_JUMPS && rand_unit(&frame_rng) < SESSION_JUMP_PROB) {
+                measured_range += SESSION_JUMP_MIN_M + (SESSION_JUMP_MAX_M - SESSION_JUMP_MIN_M) * rand_unit(&frame_rng);
+                // FTM_RTT_MAX_PS 를 넘는 프레임은 비콘이 버려 세션 손실이 되므로 측정 가능 거리 안으로 자름
+                float measurable_m = (float)(FTM_RTT_MAX_PS * CALIBRATED_METERS_PER_PS) - 2.0f * FRAME_NOISE_M;
+                if (measured_range > measurable_m) {
+                    measured_range = measurable_m;
+                }
+            }
+            make_frames(measured_range, frames, &frame_rng, entries);
+
+            ftm_reduce_result_t m;
+            if (ftm_reduce(entries, frames, &m) == ESP_OK) {
+                // 게이트웨이 중계 태스크와 같은 순서: 처음이면 초기화, 아니면 틱 차이로 dt 계산
+                raw = m.distance;
+                if (!kf.initialized) {
+                    kalman_filter_init(&kf, m.distance, m.variance);
+                    kf_x = kf.x;
+                } else {
+                    float dt = (now_ms - kf.last_update_time) / 1000.0f;
+                    kf_x = kalman_filter_update(&kf, m.distance, m.variance, dt);
+                }
+                rw_x = random_walk_update(&rw, m.distance, m.variance, REPORT_PERIOD_MS / 1000.0f);
+            } else if (k >= WARMUP_REPORTS) {
+                sum->lost++;
+            }
+
+            if (k >= WARMUP_REPORTS && !isnan(raw)) {
+                double e_raw = raw - range[k], e_rw = rw_x - range[k], e_kf = kf_x - range[k];
+                sum->raw += e_raw * e_raw;
+                sum->random_walk += e_rw * e_rw;
+                sum->kalman += e_kf * e_kf;
+                sum->samples++;
+            }
+        }
+    }
+}
+
+int main(void) {
+    printf("FTM 프레임 수별 거리 오차 RMS (m): 프레임 잡음 %.1fm, 다중경로 %.0f%% (+0~%.0fm), 손실 %.0f%%, 리포트 %dms\n",
+           FRAME_NOISE_M, FRAME_MULTIPATH_PROB * 100, FRAME_MULTIPATH_MAX_M, FRAME_LOSS_PROB * 100, REPORT_PERIOD_MS);
+    printf("raw: ftm_reduce 중앙값, rw: 이전 랜덤 워크 필터 (Q=0.05), kf: kalman_filter_update\n");
+    printf("jumps: 리포트의 %.0f%% 는 세션 전체가 +%.0f~%.0fm\n\n",
+           SESSION_JUMP_PROB * 100, SESSION_JUMP_MIN_M, SESSION_JUMP_MAX_M);
+
+    for (int s = 0; s < SCENARIO_COUNT; s++) {
+        printf("[%s]\n%7s %8s %8s %8s %8s\n", scenario_names[s], "frames", "raw", "rw", "kf", "lost");
+        double rw_at_24 = 0;
+        double kf_rms[FRAME_COUNT_CASES];
+        kalman_filter_stats_t before, after;
+        kalman_filter_get_stats(&before);
+        for (int f = 0; f < FRAME_COUNT_CASES; f++) {
+            error_sum_t sum;
+            run_case((scenario_t)s, frame_counts[f], &sum);
+            double raw = sqrt(sum.raw / sum.samples);
+            double rw = sqrt(sum.random_walk / sum.samples);
+            kf_rms[f] = sqrt(sum.kalman / sum.samples);
+            if (frame_counts[f] == 24) {
+                rw_at_24 = rw;
+            }
+            printf("%7d %8.3f %8.3f %8.3f %8d\n", frame_counts[f], raw, rw, kf_rms[f], sum.lost);
+        }
+        kalman_filter_get_stats(&after);
+        printf("게이트 밖 %u, 기동 %u, 재초기화 %u (업데이트 %u)\n",
+               (unsigned)(after.gated - before.gated), (unsigned)(after.maneuvers - before.maneuvers),
+               (unsigned)(after.reinitialized - before.reinitialized), (unsigned)(after.updates - before.updates));
+        for (int f = 0; f < FRAME_COUNT_CASES; f++) {
+            if (kf_rms[f] <= rw_at_24) {
+                printf("→ kf 가 이전 필터 24프레임 오차(%.3fm) 이하가 되는 최소 프레임 수: %d\n\n", rw_at_24, frame_counts[f]);
+                break;
+            }
+            if (f == FRAME_COUNT_CASES - 1) {
+                printf("→ kf 가 이전 필터 24프레임 오차(%.3fm) 에 못 미침\n\n", rw_at_24);
+            }
+        }
+    }
+
+    kalman_filter_stats_t stats;
+    kalman_filter_get_stats(&stats);
+    printf("kalman_filter 누적: 업데이트 %u, 게이트 밖 %u, 기동 %u, 재초기화 %u\n",
+           (unsigned)stats.updates, (unsigned)stats.gated, (unsigned)stats.maneuvers, (unsigned)stats.reinitialized);
+    return 0;
+}
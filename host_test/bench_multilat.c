@@ -0,0 +1,66 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "bench_util.h"
+#include "multilat.h"
+
+// ===== 벤치마크 설정 =====
+#define BENCH_CASES 4096                    // 미리 만들어 두는 입력 수
+#define BENCH_ROUNDS 100
+#define ANCHOR_HEIGHT_M 2.5f
+
+static const float hexagon6[6][2] = {{0, 0}, {12, 0}, {18, 8}, {12, 16}, {0, 16}, {-6, 8}};
+static multilat_range_t s_cases[BENCH_CASES][MULTILAT_MAX_ANCHORS];
+
+// 앵커 count 개, 거리 잡음 noise_m, outlier 면 측정 하나에 다중경로 지연 추가
+static void make_cases(int count, float noise_m, bool outlier) {
+    uint32_t rng = 99;
+    for (int n = 0; n < BENCH_CASES; n++) {
+        float bx = 12.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+        float by = 2.0f + 12.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+        for (int i = 0; i < count; i++) {
+            multilat_range_t *r = &s_cases[n][i];
+            r->anchor = (anchor_position_t){hexagon6[i][0], hexagon6[i][1], ANCHOR_HEIGHT_M};
+            float dx = bx - r->anchor.x, dy = by - r->anchor.y, dz = ANCHOR_HEIGHT_M - MULTILAT_BEACON_HEIGHT_M;
+            float u = (float)(bench_rand(&rng) % 2001) / 1000.0f - 1.0f;
+            r->distance = sqrtf(dx * dx + dy * dy + dz * dz) + noise_m * 1.732f * u;
+            r->variance = noise_m * noise_m;
+        }
+        if (outlier) {
+            s_cases[n][bench_rand(&rng) % count].distance += 3.0f + 7.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+        }
+    }
+}
+
+// 한 구성의 호출당 시간과 평균 반복 수
+static void bench_case(const char *label, int count, float noise_m, bool outlier) {
+    make_cases(count, noise_m, outlier);
+    uint64_t iterations = 0;
+    int failures = 0;
+    uint64_t t0 = bench_now_ns();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int n = 0; n < BENCH_CASES; n++) {
+            multilat_fix_t fix;
+            if (multilat_solve(s_cases[n], count, &fix) == ESP_OK) {
+                iterations += fix.iterations;
+            } else {
+                failures++;
+            }
+            bench_consume(&fix);
+        }
+    }
+    uint64_t t1 = bench_now_ns();
+    double calls = (double)BENCH_ROUNDS * BENCH_CASES;
+    printf("%-22s %7d %10.1f %10.2f %9.2f%%\n", label, count, (double)(t1 - t0) / calls,
+           (double)iterations / (calls - failures), 100.0 * failures / calls);
+}
+
+int main(void) {
+    printf("%-22s %7s %10s %10s %10s\n", "case", "anchors", "ns/solve", "iters", "failed");
+    bench_case("noise 0.3m", 3, 0.3f, false);
+    bench_case("noise 0.3m", 4, 0.3f, false);
+    bench_case("noise 0.3m", 6, 0.3f, false);
+    bench_case("noise 0.3m + multipath", 4, 0.3f, true);
+    bench_case("noise 0.3m + multipath", 6, 0.3f, true);
+    return 0;
+}
@@ -0,0 +1,451 @@
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "anchor_registry.h"
+#include "file_flash.h"
+#include "load_generator.h"
+#include "pipeline_metrics.h"
+#include "relay_pipeline.h"
+#include "spool.h"
+#include "uploader.h"
+
+// ===== 하네스 설정 =====
+// 게이트웨이의 수신 링 → 디코딩/중복 제거 → 칼만(/위치) → 직렬화/배치 → HTTP 업로드 경로를 실제 소스 그대로 호스트에서 실행
+// 입력은 장치 콘솔의 loadgen 과 같은 load_generator.c (ESP-NOW 수신 콜백과 같은 ingest_ring_push 로 넣음)
+// 업로드는 esp_http_client 대체(POSIX 소켓)로 같은 프로세스의 스텁 HTTP 서버에 Keep-Alive 로 보냄
+// 단계별 지연은 pipeline_metrics_record 를 --wrap 으로 가로채 레코드마다 정확한 값으로 p50/p99 계산
+//
+//   ./bench_pipeline [비콘 수] [초당 프레임] [초] [--cbor] [--positions] [--server-delay-ms=N] [--server-status=N] [--check]
+#define DEFAULT_BEACONS 1000
+#define DEFAULT_RATE 2000
+#define DEFAULT_SECONDS 10
+#define SPOOL_IMAGE_PATH "bench_pipeline_spool.img"
+#define SPOOL_SECTOR_SIZE 4096
+#define SPOOL_IMAGE_SECTORS 64              // 업로더의 SPOOL_RETENTION_SECTORS 와 같게
+#define LINK_UP_BIT BIT0
+#define MAX_SAMPLES (1u << 21)              // 단계별로 보관하는 최대 지연 샘플 수
+#define CHECK_MAX_LOG_LINES_PER_RECORD 0.02 // --check: 레코드당 출력 로그 줄 (I/W/E) 상한
+
+typedef struct {
+    uint32_t beacons;
+    uint32_t rate;
+    uint32_t seconds;
+    upload_format_t format;
+    bool positions;                         // 합성 앵커 좌표를 등록해 다변측량 경로까지 실행
+    int server_delay_ms;                    // 스텁 서버 응답 지연
+    int server_status;                      // 스텁 서버 응답 상태 코드
+    bool check;                             // 유실 / 로그 줄 수 검사 (ctest)
+} bench_options_t;
+
+// 단계별 지연 샘플 (단계마다 기록하는 태스크는 하나)
+typedef struct {
+    uint32_t *values;
+    uint32_t capacity;
+    _Atomic uint32_t count;
+    _Atomic uint32_t overflow;              // 용량을 넘어 버린 샘플 수
+} stage_samples_t;
+
+static stage_samples_t samples[PIPELINE_STAGE_COUNT];
+static atomic_bool recording;
+static atomic_bool relay_running;
+
+
+// ===== 지연 샘플 (pipeline_metrics_record 가로채기) =====
+
+void __real_pipeline_metrics_record(pipeline_stage_t stage, uint32_t from_us, uint32_t to_us);
+
+void __wrap_pipeline_metrics_record(pipeline_stage_t stage, uint32_t from_us, uint32_t to_us) {
+    if (atomic_load_explicit(&recording, memory_order_relaxed)) {
+        stage_samples_t *s = &samples[stage];
+        uint32_t n = atomic_load_explicit(&s->count, memory_order_relaxed);
+        if (n < s->capacity) {
+            s->values[n] = to_us - from_us;
+            atomic_store_explicit(&s->count, n + 1, memory_order_release);
+        } else {
+            atomic_fetch_add_explicit(&s->overflow, 1, memory_order_relaxed);
+        }
+    }
+    __real_pipeline_metrics_record(stage, from_us, to_us);
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 정렬된 샘플의 백분위 (최근접 순위)
+static uint32_t percentile(const uint32_t *sorted, uint32_t count, int percent) {
+    if (count == 0) {
+        return 0;
+    }
+    uint32_t rank = (uint32_t)(((uint64_t)count * (uint64_t)percent + 99) / 100);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+
+// ===== 스텁 HTTP 서버 =====
+// 요청을 끝까지 읽고 본문은 버린 뒤 빈 응답 (Keep-Alive), 요청 수와 본문 바이트만 집계
+
+static struct {
+    int listen_fd;
+    int port;
+    int status;
+    int delay_ms;
+    _Atomic uint32_t connections;
+    _Atomic uint32_t requests;
+    _Atomic uint64_t body_bytes;
+} server;
+
+// 헤더 끝 ("\r\n\r\n") 위치 (없으면 NULL)
+static char *find_header_end(char *buf, size_t len) {
+    for (size_t i = 0; i + 4 <= len; i++) {
+        if (memcmp(buf + i, "\r\n\r\n", 4) == 0) {
+            return buf + i;
+        }
+    }
+    return NULL;
+}
+
+// Content-Length 값 (대소문자 무시, 없으면 0)
+static size_t content_length(const char *headers) {
+    static const char name[] = "\r\nContent-Length:";
+    for (const char *p = headers; *p != '\0'; p++) {
+        if (strncasecmp(p, name, sizeof(name) - 1) == 0) {
+            return strtoul(p + sizeof(name) - 1, NULL, 10);
+        }
+    }
+    return 0;
+}
+
+// 연결 하나에서 요청을 차례로 처리 (클라이언트가 닫으면 반환)
+static void serve_connection(int fd) {
+    static char buf[8192];
+    size_t used = 0;
+
+    for (;;) {
+        char *end = NULL;
+        while ((end = find_header_end(buf, used)) == NULL) {
+            if (used == sizeof(buf)) {
+                return;
+            }
+            ssize_t n = recv(fd, buf + used, sizeof(buf) - used, 0);
+            if (n <= 0) {
+                return;
+            }
+            used += (size_t)n;
+        }
+
+        size_t header_len = (size_t)(end + 4 - buf);
+        end[2] = '\0';
+        size_t body_len = content_length(buf);
+
+        // 이미 받은 본문은 건너뛰고 나머지는 읽어서 버림 (다음 요청의 앞부분은 버퍼 앞으로)
+        size_t have = used - header_len;
+        if (have >= body_len) {
+            used = have - body_len;
+            memmove(buf, buf + header_len + body_len, used);
+        } else {
+            size_t remaining = body_len - have;
+            used = 0;
+            while (remaining > 0) {
+                ssize_t n = recv(fd, buf, remaining < sizeof(buf) ? remaining : sizeof(buf), 0);
+                if (n <= 0) {
+                    return;
+                }
+                remaining -= (size_t)n;
+            }
+        }
+        atomic_fetch_add(&server.requests, 1);
+        atomic_fetch_add(&server.body_bytes, body_len);
+
+        if (server.delay_ms > 0) {
+            usleep((useconds_t)server.delay_ms * 1000);
+        }
+        char response[128];
+        int len = snprintf(response, sizeof(response),
+                           "HTTP/1.1 %d Stub\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n", server.status);
+        if (send(fd, response, (size_t)len, MSG_NOSIGNAL) != len) {
+            return;
+        }
+    }
+}
+
+static void *server_thread(void *arg) {
+    for (;;) {
+        int fd = accept(server.listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        atomic_fetch_add(&server.connections, 1);
+        serve_connection(fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+// 127.0.0.1 의 빈 포트에서 서버 시작
+static bool server_start(int status, int delay_ms) {
+    server.status = status;
+    server.delay_ms = delay_ms;
+    server.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    socklen_t addr_len = sizeof(addr);
+    if (server.listen_fd < 0 ||
+        bind(server.listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(server.listen_fd, 4) != 0 ||
+        getsockname(server.listen_fd, (struct sockaddr *)&addr, &addr_len) != 0) {
+        return false;
+    }
+    server.port = ntohs(addr.sin_port);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, server_thread, NULL) != 0) {
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+
+// ===== 장치 의존 부분 대체 =====
+
+// 업로더가 여는 스풀 파티션을 파일 이미지로 대체 (spool_partition.c 대신 링크)
+esp_err_t spool_flash_from_partition(const char *label, spool_flash_t *out) {
+    static file_flash_t flash;
+    return file_flash_create(&flash, SPOOL_IMAGE_PATH, SPOOL_SECTOR_SIZE * SPOOL_IMAGE_SECTORS,
+                             SPOOL_SECTOR_SIZE, out);
+}
+
+// 데이터 중계 태스크 (main.c 와 같은 루프, 슬롯 배정 훅 없음)
+static void relay_task(void *arg) {
+    while (atomic_load(&relay_running)) {
+        relay_pipeline_step(pdMS_TO_TICKS(100));
+    }
+    vTaskDelete(NULL);
+}
+
+// 합성 앵커 3개에 좌표 등록 (load_generator 의 앵커 MAC 02:'L':'G':00:00:번호)
+static void register_synthetic_anchors(void) {
+    static const anchor_position_t positions[LOADGEN_ANCHORS] = {
+        {0.0f, 0.0f, 2.5f},
+        {20.0f, 0.0f, 2.5f},
+        {0.0f, 20.0f, 2.5f},
+    };
+    for (int a = 0; a < LOADGEN_ANCHORS; a++) {
+        const uint8_t mac[6] = {0x02, 'L', 'G', 0x00, 0x00, (uint8_t)a};
+        anchor_registry_set(mac, &positions[a]);
+    }
+}
+
+
+// ===== 실행 =====
+
+static bool parse_options(int argc, char **argv, bench_options_t *opt) {
+    *opt = (bench_options_t) {
+        .beacons = DEFAULT_BEACONS,
+        .rate = DEFAULT_RATE,
+        .seconds = DEFAULT_SECONDS,
+        .format = UPLOAD_FORMAT_JSON,
+        .server_status = 200,
+    };
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--cbor") == 0) {
+            opt->format = UPLOAD_FORMAT_CBOR;
+        } else if (strcmp(arg, "--positions") == 0) {
+            opt->positions = true;
+        } else if (strcmp(arg, "--check") == 0) {
+            opt->check = true;
+        } else if (strncmp(arg, "--server-delay-ms=", 18) == 0) {
+            opt->server_delay_ms = atoi(arg + 18);
+        } else if (strncmp(arg, "--server-status=", 16) == 0) {
+            opt->server_status = atoi(arg + 16);
+        } else if (arg[0] != '-' && positional < 3) {
+            uint32_t value = (uint32_t)strtoul(arg, NULL, 10);
+            uint32_t *fields[] = {&opt->beacons, &opt->rate, &opt->seconds};
+            *fields[positional++] = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void print_result(const bench_options_t *opt, const loadgen_result_t *r, const uint32_t log_lines[ESP_LOG_VERBOSE + 1]) {
+    double elapsed_sec = r->elapsed_us / 1e6;
+    const uploader_stats_t *up = &r->uploader;
+    uint32_t requests = atomic_load(&server.requests);
+    uint64_t body_bytes = atomic_load(&server.body_bytes);
+
+    printf("게이트웨이 파이프라인 부하: 비콘 %" PRIu32 "개, 목표 %" PRIu32 " fps, %.1f초, %s, 위치 계산 %s, 서버 지연 %d ms\n",
+           opt->beacons, opt->rate, elapsed_sec, upload_format_name(opt->format),
+           opt->positions ? "켬" : "끔", opt->server_delay_ms);
+    printf("생성: 링 투입 %" PRIu32 " (%.0f fps), 링 가득 참 %" PRIu32 ", 타이머 지연으로 건너뜀 %" PRIu32 "\n",
+           r->pushed, r->pushed / elapsed_sec, r->ring_full, r->skipped);
+    printf("업로드: 전송 %" PRIu32 " (%.0f 레코드/s), 버퍼 폐기 %" PRIu32 " (최고 수위 %" PRIu32 "/%d), 스풀 보관 %" PRIu32
+           ", 유실 %" PRIu32 "\n",
+           up->records_sent, up->records_sent / elapsed_sec, up->records_dropped, up->queue_high_water,
+           RECORD_QUEUE_LENGTH, up->records_spooled, up->records_failed);
+    printf("배치: 성공 %" PRIu32 " (평균 %.1f 레코드, %.0f 바이트), 실패 %" PRIu32 "\n",
+           up->batches_sent, up->batches_sent ? (double)up->records_sent / up->batches_sent : 0.0,
+           up->batches_sent ? (double)up->bytes_sent / up->batches_sent : 0.0, up->batches_failed);
+    printf("스텁 서버: 요청 %" PRIu32 " (%.0f /s), 연결 %" PRIu32 ", 본문 %.1f KB/s\n",
+           requests, requests / elapsed_sec, atomic_load(&server.connections), body_bytes / 1024.0 / elapsed_sec);
+
+    relay_pipeline_stats_t relay;
+    relay_pipeline_get_stats(&relay);
+    printf("중계: 처리 %" PRIu32 ", 디코딩 실패 %" PRIu32 ", 위치 계산 성공 %" PRIu32 " / 실패 %" PRIu32 "\n",
+           relay.processed, relay.decode_errors, relay.positions_solved, relay.position_failures);
+
+    uint32_t shown = log_lines[ESP_LOG_ERROR] + log_lines[ESP_LOG_WARN] + log_lines[ESP_LOG_INFO];
+    printf("로그 줄: E %" PRIu32 ", W %" PRIu32 ", I %" PRIu32 " → 레코드당 %.4f (D %" PRIu32 " 는 장치 기본 빌드에서 컴파일되지 않음)\n",
+           log_lines[ESP_LOG_ERROR], log_lines[ESP_LOG_WARN], log_lines[ESP_LOG_INFO],
+           r->pushed ? (double)shown / r->pushed : 0.0, log_lines[ESP_LOG_DEBUG]);
+
+    printf("\n단계별 지연 (us, 레코드별 정확한 값 / 괄호는 장치 히스토그램의 버킷 상한 추정)\n");
+    printf("%-7s %8s %8s %8s %8s %8s %17s\n", "stage", "count", "mean", "p50", "p99", "max", "(hist p50/p99)");
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        stage_samples_t *s = &samples[stage];
+        uint32_t count = atomic_load_explicit(&s->count, memory_order_acquire);
+        qsort(s->values, count, sizeof(uint32_t), compare_u32);
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            sum += s->values[i];
+        }
+        const pipeline_histogram_t *hist = &r->latency[stage];
+        char hist_text[32];
+        snprintf(hist_text, sizeof(hist_text), "(%" PRIu32 "/%" PRIu32 ")",
+                 pipeline_histogram_percentile(hist, 50), pipeline_histogram_percentile(hist, 99));
+        printf("%-7s %8" PRIu32 " %8.0f %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %17s\n",
+               pipeline_stage_name((pipeline_stage_t)stage), count, count ? (double)sum / count : 0.0,
+               percentile(s->values, count, 50), percentile(s->values, count, 99),
+               count ? s->values[count - 1] : 0, hist_text);
+        if (atomic_load(&s->overflow) > 0) {
+            printf("        (샘플 %" PRIu32 "개는 용량 초과로 백분위에서 빠짐)\n", atomic_load(&s->overflow));
+        }
+    }
+}
+
+// --check: 서버가 정상이면 링에 들어간 프레임은 모두 업로드되고, 레코드마다 로그를 남기지 않아야 함
+static bool check_result(const loadgen_result_t *r, const uint32_t log_lines[ESP_LOG_VERBOSE + 1]) {
+    const uploader_stats_t *up = &r->uploader;
+    uint32_t shown = log_lines[ESP_LOG_ERROR] + log_lines[ESP_LOG_WARN] + log_lines[ESP_LOG_INFO];
+    bool ok = true;
+    if (r->pushed == 0 || up->records_sent != r->pushed) {
+        printf("FAIL: 링 투입 %" PRIu32 " 중 업로드 %" PRIu32 "\n", r->pushed, up->records_sent);
+        ok = false;
+    }
+    if (up->records_dropped || up->records_failed || up->records_spooled || up->batches_failed) {
+        printf("FAIL: 폐기 %" PRIu32 ", 유실 %" PRIu32 ", 스풀 %" PRIu32 ", 실패 배치 %" PRIu32 "\n",
+               up->records_dropped, up->records_failed, up->records_spooled, up->batches_failed);
+        ok = false;
+    }
+    if (r->pushed > 0 && (double)shown / r->pushed > CHECK_MAX_LOG_LINES_PER_RECORD) {
+        printf("FAIL: 레코드당 로그 %.4f 줄 (상한 %.2f)\n", (double)shown / r->pushed,
+               CHECK_MAX_LOG_LINES_PER_RECORD);
+        ok = false;
+    }
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    bench_options_t opt;
+    if (!parse_options(argc, argv, &opt)) {
+        fprintf(stderr, "사용법: %s [비콘 수] [초당 프레임] [초] [--cbor] [--positions] "
+                "[--server-delay-ms=N] [--server-status=N] [--check]\n", argv[0]);
+        return 2;
+    }
+    uint64_t capacity = (uint64_t)opt.rate * opt.seconds + 1024;
+    for (int stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+        samples[stage].capacity = capacity < MAX_SAMPLES ? (uint32_t)capacity : MAX_SAMPLES;
+        samples[stage].values = malloc(samples[stage].capacity * sizeof(uint32_t));
+        if (samples[stage].values == NULL) {
+            fprintf(stderr, "샘플 버퍼 할당 실패\n");
+            return 1;
+        }
+    }
+
+    if (!server_start(opt.server_status, opt.server_delay_ms)) {
+        fprintf(stderr, "스텁 서버 시작 실패\n");
+        return 1;
+    }
+    static char batch_url[96];
+    static char health_url[96];
+    snprintf(batch_url, sizeof(batch_url), "http://127.0.0.1:%d/api/locations/calculate/batch", server.port);
+    snprintf(health_url, sizeof(health_url), "http://127.0.0.1:%d/api/gateways/health", server.port);
+
+    // main.c 의 app_main / data_relay_task 와 같은 순서로 시작 (STA 연결은 처음부터 켜진 것으로)
+    EventGroupHandle_t link_events = xEventGroupCreate();
+    xEventGroupSetBits(link_events, LINK_UP_BIT);
+    if (opt.positions) {
+        register_synthetic_anchors();
+    }
+    relay_pipeline_init(NULL);
+    uploader_set_format(opt.format);
+    const uploader_config_t config = {
+        .http_url = batch_url,
+        .mqtt_uri = "mqtt://127.0.0.1:1883",
+        .device_name = "bench",
+        .health_url = health_url,
+        .collect_health = NULL,
+    };
+    if (uploader_start(&config, link_events, LINK_UP_BIT) != ESP_OK) {
+        fprintf(stderr, "업로더 시작 실패\n");
+        return 1;
+    }
+    atomic_store(&relay_running, true);
+    xTaskCreate(relay_task, "data_relay", 8192, NULL, 10, NULL);
+
+    const loadgen_config_t loadgen = {
+        .beacons = opt.beacons,
+        .rate = opt.rate,
+        .duration_sec = opt.seconds,
+    };
+    uint32_t log_before[ESP_LOG_VERBOSE + 1];
+    uint32_t log_lines[ESP_LOG_VERBOSE + 1];
+    for (int level = 0; level <= ESP_LOG_VERBOSE; level++) {
+        log_before[level] = esp_log_shim_count((esp_log_level_t)level);
+    }
+    atomic_store(&recording, true);
+    esp_err_t err = load_generator_start(&loadgen);
+    if (err != ESP_OK) {
+        fprintf(stderr, "부하 생성 시작 실패: %s (비콘 1~%d, 초당 1~%d, 1~%d초)\n", esp_err_to_name(err),
+                LOADGEN_MAX_BEACONS, LOADGEN_MAX_RATE, LOADGEN_MAX_DURATION_SEC);
+        return 2;
+    }
+
+    // 생성 시간 + LOADGEN_DRAIN_MS 뒤에 결과가 나옴
+    loadgen_result_t result;
+    while (load_generator_get_result(&result) != ESP_OK) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    atomic_store(&recording, false);
+    for (int level = 0; level <= ESP_LOG_VERBOSE; level++) {
+        log_lines[level] = esp_log_shim_count((esp_log_level_t)level) - log_before[level];
+    }
+    atomic_store(&relay_running, false);
+
+    print_result(&opt, &result, log_lines);
+    remove(SPOOL_IMAGE_PATH);
+    if (opt.check) {
+        bool ok = check_result(&result, log_lines);
+        printf("%s\n", ok ? "OK" : "FAIL");
+        return ok ? 0 : 1;
+    }
+    return 0;
+}
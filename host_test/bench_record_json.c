@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_util.h"
+#include "record_cbor.h"
+#include "record_fixture.h"
+#include "record_json.h"
+#ifdef HAVE_CJSON
+#include "cJSON.h"
+#include "cjson_reference.h"
+#endif
+
+// ===== 벤치마크 설정 =====
+#define BENCH_RECORDS 1024                  // 미리 만들어 두는 레코드 수
+#define BENCH_ROUNDS 200                    // 레코드 묶음 반복 수
+
+// ===== 힙 할당 계수 =====
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc 로 링크해 모든 할당을 셈
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+static uint64_t s_allocations;
+
+void *__wrap_malloc(size_t size) {
+    s_allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    s_allocations++;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *p, size_t size) {
+    s_allocations++;
+    return __real_realloc(p, size);
+}
+
+#if defined(HAVE_CJSON) && defined(CJSON_SHARED)
+// 공유 라이브러리 cJSON 은 --wrap 이 닿지 않으므로 훅으로 셈
+static void *counting_malloc(size_t size) {
+    return __wrap_malloc(size);
+}
+#endif
+
+// 인코더 하나의 레코드당 결과
+typedef struct {
+    double ns;
+    double bytes;
+} bench_result_t;
+
+static relay_record_t s_records[BENCH_RECORDS];
+static char s_buf[RECORD_JSON_MAX_LEN];
+static uint8_t s_cbor_buf[RECORD_CBOR_MAX_LEN];
+
+
+// ===== 측정 =====
+
+// record_json_encode 의 레코드당 시간과 할당 수
+static bench_result_t bench_stream(const char *label) {
+    size_t bytes = 0;
+    uint64_t allocs_before = s_allocations;
+    uint64_t t0 = bench_now_ns();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_RECORDS; i++) {
+            size_t len = 0;
+            record_json_encode(&s_records[i], s_buf, sizeof(s_buf), &len);
+            bench_consume(s_buf);
+            bytes += len;
+        }
+    }
+    uint64_t t1 = bench_now_ns();
+    double n = (double)BENCH_ROUNDS * BENCH_RECORDS;
+    bench_result_t result = {.ns = (double)(t1 - t0) / n, .bytes = (double)bytes / n};
+    printf("%-10s %-14s %10.1f %12.2f %12.1f\n", label, "record_json",
+           result.ns, (double)(s_allocations - allocs_before) / n, result.bytes);
+    return result;
+}
+
+// record_cbor_encode 의 레코드당 시간과 할당 수
+static bench_result_t bench_cbor(const char *label) {
+    size_t bytes = 0;
+    uint64_t allocs_before = s_allocations;
+    uint64_t t0 = bench_now_ns();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_RECORDS; i++) {
+            size_t len = 0;
+            record_cbor_encode(&s_records[i], s_cbor_buf, sizeof(s_cbor_buf), &len);
+            bench_consume(s_cbor_buf);
+            bytes += len;
+        }
+    }
+    uint64_t t1 = bench_now_ns();
+    double n = (double)BENCH_ROUNDS * BENCH_RECORDS;
+    bench_result_t result = {.ns = (double)(t1 - t0) / n, .bytes = (double)bytes / n};
+    printf("%-10s %-14s %10.1f %12.2f %12.1f\n", label, "record_cbor",
+           result.ns, (double)(s_allocations - allocs_before) / n, result.bytes);
+    return result;
+}
+
+#ifdef HAVE_CJSON
+// 이전 cJSON 트리 직렬화의 레코드당 시간과 할당 수
+static void bench_cjson(const char *label) {
+    size_t bytes = 0;
+    int rounds = BENCH_ROUNDS / 10;
+    uint64_t allocs_before = s_allocations;
+    uint64_t t0 = bench_now_ns();
+    for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < BENCH_RECORDS; i++) {
+            char *json = cjson_reference_encode(&s_records[i]);
+            bytes += strlen(json);
+            cJSON_free(json);
+        }
+    }
+    uint64_t t1 = bench_now_ns();
+    double n = (double)rounds * BENCH_RECORDS;
+    printf("%-10s %-14s %10.1f %12.2f %12.1f\n", label, "cJSON",
+           (double)(t1 - t0) / n, (double)(s_allocations - allocs_before) / n, (double)bytes / n);
+}
+#endif
+
+// 한 가지 레코드 묶음 측정 (CBOR 는 record_json 대비 크기/시간 비율도 출력)
+static void bench_set(const char *label) {
+    bench_result_t json = bench_stream(label);
+    bench_result_t cbor = bench_cbor(label);
+#ifdef HAVE_CJSON
+    bench_cjson(label);
+#endif
+    printf("%-10s → CBOR 는 record_json 대비 크기 1/%.2f, 시간 1/%.2f\n", label,
+           json.bytes / cbor.bytes, json.ns / cbor.ns);
+}
+
+int main(void) {
+#if defined(HAVE_CJSON) && defined(CJSON_SHARED)
+    cJSON_Hooks hooks = {.malloc_fn = counting_malloc, .free_fn = free};
+    cJSON_InitHooks(&hooks);
+#endif
+    printf("%-10s %-14s %10s %12s %12s\n", "records", "encoder", "ns/record", "allocs/rec", "bytes/rec");
+
+    for (int i = 0; i < BENCH_RECORDS; i++) {
+        record_fixture_typical(&s_records[i], (uint32_t)i);
+    }
+    bench_set("typical");
+
+    uint32_t rng = 0xBEEF;
+    for (int i = 0; i < BENCH_RECORDS; i++) {
+        record_fixture_random(&s_records[i], &rng);
+    }
+    bench_set("random");
+
+#ifndef HAVE_CJSON
+    printf("cJSON 없음: 이전 구현 비교는 건너뜀 (CJSON_DIR 또는 IDF_PATH 지정)\n");
+#endif
+    return 0;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// ===== 호스트 벤치마크 공통 도우미 =====
+
+#include <stdint.h>
+#include <time.h>
+
+// 단조 시계 (나노초)
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// 재현 가능한 의사 난수 (xorshift32, 상태는 호출자가 가짐)
+static inline uint32_t bench_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// 최적화로 결과가 지워지지 않게 값 소비
+static inline void bench_consume(const void *p) {
+    __asm__ volatile("" : : "g"(p) : "memory");
+}
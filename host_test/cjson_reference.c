@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <time.h>
+#include "cJSON.h"
+#include "cjson_reference.h"
+
+// 레코드를 cJSON 트리로 만들어 출력
+char *cjson_reference_encode(const relay_record_t *record) {
+    char timestamp[32];
+    time_t seconds = (time_t)(record->timestamp_ms / 1000);
+    int milliseconds = (int)(record->timestamp_ms % 1000);
+    struct tm timeinfo;
+    gmtime_r(&seconds, &timeinfo);
+    snprintf(timestamp, sizeof(timestamp),
+            "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+            timeinfo.tm_year + 1900,
+            timeinfo.tm_mon + 1,
+            timeinfo.tm_mday,
+            timeinfo.tm_hour,
+            timeinfo.tm_min,
+            timeinfo.tm_sec,
+            milliseconds);
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL) {
+        return NULL;
+    }
+    cJSON_AddNumberToObject(root, "battery_level", record->battery_level);
+    cJSON_AddNumberToObject(root, "floor", record->floor);
+
+    cJSON *measurements = cJSON_CreateArray();
+    for (int i = 0; i < record->measurement_count; i++) {
+        cJSON *measurement = cJSON_CreateObject();
+        char mac_str[18];
+        snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
+                record->measurements[i].anchor_mac[0],
+                record->measurements[i].anchor_mac[1],
+                record->measurements[i].anchor_mac[2],
+                record->measurements[i].anchor_mac[3],
+                record->measurements[i].anchor_mac[4],
+                record->measurements[i].anchor_mac[5]);
+        cJSON_AddStringToObject(measurement, "anchor_mac", mac_str);
+        cJSON_AddNumberToObject(measurement, "distance_meters", record->measurements[i].distance_meters);
+        cJSON_AddNumberToObject(measurement, "rssi", record->measurements[i].rssi);
+        cJSON_AddNumberToObject(measurement, "rtt_nanoseconds", record->measurements[i].rtt_nanoseconds);
+        cJSON_AddItemToArray(measurements, measurement);
+    }
+    cJSON_AddItemToObject(root, "measurements", measurements);
+
+    if (record->position_anchors > 0) {
+        cJSON *position = cJSON_CreateObject();
+        cJSON_AddNumberToObject(position, "x", record->position_x);
+        cJSON_AddNumberToObject(position, "y", record->position_y);
+        cJSON_AddNumberToObject(position, "accuracy_meters", record->position_accuracy);
+        cJSON_AddNumberToObject(position, "anchors", record->position_anchors);
+        cJSON_AddItemToObject(root, "position", position);
+    }
+
+    if (record->has_profile) {
+        cJSON *profile = cJSON_CreateObject();
+        cJSON_AddNumberToObject(profile, "cycles", record->profile.cycles);
+        cJSON_AddNumberToObject(profile, "charge_mas", record->profile.charge_dmas / 10.0);
+        cJSON_AddNumberToObject(profile, "radio_on_ms", record->profile.radio_on_ms);
+        cJSON *phases = cJSON_CreateObject();
+        for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+            cJSON_AddNumberToObject(phases, swift_phase_name((swift_phase_t)i), record->profile.phase_ms[i]);
+        }
+        cJSON_AddItemToObject(profile, "phases_ms", phases);
+        cJSON_AddItemToObject(root, "power_profile", profile);
+    }
+
+    if (record->has_sequence) {
+        cJSON_AddNumberToObject(root, "sequence", record->sequence);
+    }
+
+    cJSON_AddStringToObject(root, "serial_number", record->serial_number);
+    cJSON_AddStringToObject(root, "timestamp", timestamp);
+
+    char *json_string = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return json_string;
+}
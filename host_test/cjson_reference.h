@@ -0,0 +1,10 @@
+#pragma once
+
+// ===== user-007 이전의 cJSON 직렬화 (비교 기준) =====
+// 원래 uploader 가 만들던 트리를 그대로 만든 뒤, 이후 추가된 position / power_profile / sequence 를
+// record_json.h 에 적힌 키 순서대로 붙임
+
+#include "uploader.h"
+
+// 레코드를 cJSON_PrintUnformatted 로 직렬화 (호출자가 cJSON_free 로 해제, 실패 시 NULL)
+char *cjson_reference_encode(const relay_record_t *record);
@@ -0,0 +1,138 @@
+#include <string.h>
+#include "file_flash.h"
+
+// ===== 내부 함수 =====
+
+// 범위 읽기
+static esp_err_t ff_read(void *ctx, size_t offset, void *dst, size_t len) {
+    file_flash_t *ff = ctx;
+    if (offset + len > ff->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (fseek(ff->file, (long)offset, SEEK_SET) != 0 || fread(dst, 1, len, ff->file) != len) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// 범위 쓰기 (기존 값과 AND, 전원 차단 주입 시 일부만 기록)
+static esp_err_t ff_write(void *ctx, size_t offset, const void *src, size_t len) {
+    file_flash_t *ff = ctx;
+    if (offset + len > ff->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (ff->powered_off) {
+        return ESP_FAIL;
+    }
+
+    size_t n = len;
+    if (ff->cut_after_bytes >= 0 && (long)len > ff->cut_after_bytes) {
+        n = (size_t)ff->cut_after_bytes;
+        ff->powered_off = true;
+    }
+    if (ff->cut_after_bytes >= 0) {
+        ff->cut_after_bytes -= (long)n;
+    }
+
+    uint8_t cur[256];
+    const uint8_t *in = src;
+    for (size_t done = 0; done < n; ) {
+        size_t chunk = n - done < sizeof(cur) ? n - done : sizeof(cur);
+        if (ff_read(ff, offset + done, cur, chunk) != ESP_OK) {
+            return ESP_FAIL;
+        }
+        for (size_t i = 0; i < chunk; i++) {
+            cur[i] &= in[done + i];
+        }
+        fseek(ff->file, (long)(offset + done), SEEK_SET);
+        fwrite(cur, 1, chunk, ff->file);
+        done += chunk;
+    }
+    fflush(ff->file);
+    ff->writes++;
+    return ff->powered_off ? ESP_FAIL : ESP_OK;
+}
+
+// 섹터 지우기 (0xFF 로 채움)
+static esp_err_t ff_erase(void *ctx, size_t offset, size_t len) {
+    file_flash_t *ff = ctx;
+    if (offset % ff->sector_size != 0 || len % ff->sector_size != 0 || offset + len > ff->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ff->powered_off) {
+        return ESP_FAIL;
+    }
+    uint8_t ones[256];
+    memset(ones, 0xFF, sizeof(ones));
+    fseek(ff->file, (long)offset, SEEK_SET);
+    for (size_t done = 0; done < len; done += sizeof(ones)) {
+        size_t chunk = len - done < sizeof(ones) ? len - done : sizeof(ones);
+        fwrite(ones, 1, chunk, ff->file);
+    }
+    fflush(ff->file);
+    ff->erases += (uint32_t)(len / ff->sector_size);
+    return ESP_OK;
+}
+
+// 구조체 초기화 및 인터페이스 연결
+static void ff_bind(file_flash_t *ff, size_t size, size_t sector_size, spool_flash_t *out) {
+    ff->size = size;
+    ff->sector_size = sector_size;
+    ff->cut_after_bytes = -1;
+    ff->powered_off = false;
+    ff->writes = 0;
+    ff->erases = 0;
+    *out = (spool_flash_t){
+        .read = ff_read,
+        .write = ff_write,
+        .erase = ff_erase,
+        .ctx = ff,
+        .size = size,
+        .sector_size = sector_size,
+    };
+}
+
+
+// ===== 공개 함수 =====
+
+// 지워진 이미지 새로 만들기
+esp_err_t file_flash_create(file_flash_t *ff, const char *path, size_t size, size_t sector_size,
+                            spool_flash_t *out) {
+    ff->file = fopen(path, "w+b");
+    if (ff->file == NULL) {
+        return ESP_FAIL;
+    }
+    ff_bind(ff, size, sector_size, out);
+    return ff_erase(ff, 0, size);
+}
+
+// 기존 이미지 다시 열기
+esp_err_t file_flash_open(file_flash_t *ff, const char *path, size_t size, size_t sector_size,
+                          spool_flash_t *out) {
+    ff->file = fopen(path, "r+b");
+    if (ff->file == NULL) {
+        return ESP_FAIL;
+    }
+    ff_bind(ff, size, sector_size, out);
+    return ESP_OK;
+}
+
+// 전원 차단 예약
+void file_flash_cut_power_after(file_flash_t *ff, long after_bytes) {
+    ff->cut_after_bytes = after_bytes;
+}
+
+// 한 바이트 직접 덮어쓰기
+void file_flash_poke(file_flash_t *ff, size_t offset, uint8_t value) {
+    fseek(ff->file, (long)offset, SEEK_SET);
+    fputc(value, ff->file);
+    fflush(ff->file);
+}
+
+// 파일 닫기
+void file_flash_close(file_flash_t *ff) {
+    if (ff->file != NULL) {
+        fclose(ff->file);
+        ff->file = NULL;
+    }
+}
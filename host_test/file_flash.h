@@ -0,0 +1,35 @@
+#pragma once
+
+// ===== 파일 기반 플래시 에뮬레이션 =====
+// NOR 플래시처럼 쓰기는 비트를 1 → 0 으로만 바꾸고 (AND), 지우기는 섹터를 0xFF 로 채움.
+// 전원 차단 주입: 정해진 바이트만큼 쓴 뒤 쓰기를 실패시켜 기록 도중 꺼진 상황을 재현.
+
+#include <stdio.h>
+#include "spool.h"
+
+typedef struct {
+    FILE *file;
+    size_t size;
+    size_t sector_size;
+    long cut_after_bytes;                   // 이만큼 더 쓰면 전원 차단 (-1 이면 없음)
+    bool powered_off;                       // 전원 차단 이후 모든 쓰기/지우기 실패
+    uint32_t writes;                        // 쓰기 호출 수
+    uint32_t erases;                        // 섹터 지우기 수
+} file_flash_t;
+
+// path 에 size 바이트짜리 지워진 플래시 이미지를 새로 만들고 spool_flash_t 로 연결
+esp_err_t file_flash_create(file_flash_t *ff, const char *path, size_t size, size_t sector_size,
+                            spool_flash_t *out);
+
+// 기존 이미지 파일을 다시 열어 연결 (재부팅 재현)
+esp_err_t file_flash_open(file_flash_t *ff, const char *path, size_t size, size_t sector_size,
+                          spool_flash_t *out);
+
+// after_bytes 바이트를 더 쓴 뒤 전원 차단
+void file_flash_cut_power_after(file_flash_t *ff, long after_bytes);
+
+// 이미지의 한 바이트를 직접 덮어씀 (비트 손상 재현)
+void file_flash_poke(file_flash_t *ff, size_t offset, uint8_t value);
+
+// 파일 닫기
+void file_flash_close(file_flash_t *ff);
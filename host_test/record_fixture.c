@@ -0,0 +1,83 @@
+#include <string.h>
+#include "bench_util.h"
+#include "record_fixture.h"
+
+// [0, 1) 균등 난수
+static float rand_unit(uint32_t *rng) {
+    return (float)(bench_rand(rng) >> 8) / 16777216.0f;
+}
+
+// 숫자 출력 분기를 고르게 지나는 float (정수, 0.5 단위, 임의 값, 큰/작은 값)
+static float rand_number(uint32_t *rng, float scale) {
+    switch (bench_rand(rng) % 5) {
+        case 0:  return (float)(int)(rand_unit(rng) * scale);
+        case 1:  return (float)(int)(rand_unit(rng) * scale * 2.0f) * 0.5f;
+        case 2:  return -rand_unit(rng) * scale;
+        case 3:  return rand_unit(rng) * 1e-6f;
+        default: return rand_unit(rng) * scale;
+    }
+}
+
+// 무작위 레코드 생성
+void record_fixture_random(relay_record_t *record, uint32_t *rng) {
+    memset(record, 0, sizeof(*record));
+    int serial_len = 1 + (int)(bench_rand(rng) % 9);
+    for (int i = 0; i < serial_len; i++) {
+        // 가끔 이스케이프가 필요한 문자도 섞음
+        uint32_t r = bench_rand(rng) % 40;
+        record->serial_number[i] = (r == 0) ? '"' : (r == 1) ? '\\' : (r == 2) ? '\t' : (char)('A' + r % 26);
+    }
+    record->battery_level = (uint8_t)(bench_rand(rng) % 101);
+    record->floor = (int8_t)((int)(bench_rand(rng) % 20) - 3);
+    record->timestamp_ms = 1700000000000LL + (int64_t)(bench_rand(rng) % 100000000u) * 1000 + bench_rand(rng) % 1000;
+
+    record->measurement_count = (uint8_t)(bench_rand(rng) % (RELAY_MAX_MEASUREMENTS + 1));
+    for (int i = 0; i < record->measurement_count; i++) {
+        for (int b = 0; b < 6; b++) {
+            record->measurements[i].anchor_mac[b] = (uint8_t)bench_rand(rng);
+        }
+        record->measurements[i].distance_meters = rand_number(rng, 40.0f);
+        record->measurements[i].rssi = (int8_t)-(int)(30 + bench_rand(rng) % 70);
+        record->measurements[i].rtt_nanoseconds = bench_rand(rng) % 400;
+    }
+
+    if (bench_rand(rng) % 3 == 0) {
+        record->position_anchors = (uint8_t)(3 + bench_rand(rng) % 4);
+        record->position_x = rand_number(rng, 50.0f);
+        record->position_y = rand_number(rng, 50.0f);
+        record->position_accuracy = rand_number(rng, 5.0f);
+    }
+    if (bench_rand(rng) % 3 == 0) {
+        record->has_profile = true;
+        record->profile.cycles = (uint8_t)(1 + bench_rand(rng) % 16);
+        record->profile.charge_dmas = (uint16_t)(bench_rand(rng) % 5000);
+        record->profile.radio_on_ms = (uint16_t)(bench_rand(rng) % 4000);
+        for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+            record->profile.phase_ms[i] = (uint16_t)(bench_rand(rng) % 3000);
+        }
+    }
+    if (bench_rand(rng) % 2 == 0) {
+        record->has_sequence = true;
+        record->sequence = bench_rand(rng);
+    }
+}
+
+// 현장에서 흔한 형태의 레코드
+void record_fixture_typical(relay_record_t *record, uint32_t index) {
+    memset(record, 0, sizeof(*record));
+    strcpy(record->serial_number, "SN0042");
+    record->battery_level = 87;
+    record->floor = 3;
+    record->timestamp_ms = 1760608800123LL + index;
+    record->measurement_count = 3;
+    for (int i = 0; i < 3; i++) {
+        static const uint8_t mac[6] = {0x40, 0x4C, 0xCA, 0x01, 0x02, 0x00};
+        memcpy(record->measurements[i].anchor_mac, mac, 6);
+        record->measurements[i].anchor_mac[5] = (uint8_t)(0x10 + i);
+        record->measurements[i].distance_meters = 2.0f + 1.37f * (float)i + 0.001f * (float)(index % 100);
+        record->measurements[i].rssi = (int8_t)(-55 - i * 4);
+        record->measurements[i].rtt_nanoseconds = 14u + 9u * (uint32_t)i;
+    }
+    record->has_sequence = true;
+    record->sequence = index;
+}
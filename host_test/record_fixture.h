@@ -0,0 +1,13 @@
+#pragma once
+
+// ===== 업로드 레코드 테스트 데이터 =====
+
+#include <stdint.h>
+#include "uploader.h"
+
+// 무작위 레코드 생성 (측정값 0~6개, 위치/전력 프로파일/사이클 번호는 무작위로 포함)
+// 거리와 좌표는 정수, 짧은 소수, 임의 float 을 섞어 숫자 출력 규칙의 분기를 모두 지나게 함
+void record_fixture_random(relay_record_t *record, uint32_t *rng);
+
+// 현장에서 흔한 형태의 레코드 (측정값 3개, 사이클 번호, 전력 프로파일 없음)
+void record_fixture_typical(relay_record_t *record, uint32_t index);
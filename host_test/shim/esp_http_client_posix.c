@@ -0,0 +1,286 @@
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "esp_http_client.h"
+
+// ===== 설정 상수 =====
+#define HTTP_SHIM_MAX_HEADERS 8
+#define HTTP_SHIM_HOST_LEN 64
+#define HTTP_SHIM_PATH_LEN 128
+#define HTTP_SHIM_HEADER_LEN 96
+#define HTTP_SHIM_RX_LEN 2048                // 응답 헤더 최대 크기
+
+struct esp_http_client {
+    esp_http_client_config_t config;
+    char host[HTTP_SHIM_HOST_LEN];
+    char port[8];
+    char path[HTTP_SHIM_PATH_LEN];
+    char header_keys[HTTP_SHIM_MAX_HEADERS][32];
+    char header_values[HTTP_SHIM_MAX_HEADERS][HTTP_SHIM_HEADER_LEN];
+    int header_count;
+    const char *post_data;
+    int post_len;
+    int status_code;
+    int fd;                                 // 연결 소켓 (-1 이면 없음)
+    char rx[HTTP_SHIM_RX_LEN];
+};
+
+
+// ===== 내부 함수 =====
+
+static void fire_event(esp_http_client_handle_t client, esp_http_client_event_id_t id) {
+    if (client->config.event_handler != NULL) {
+        esp_http_client_event_t evt = {
+            .event_id = id,
+            .client = client,
+            .user_data = client->config.user_data,
+        };
+        client->config.event_handler(&evt);
+    }
+}
+
+// "http://호스트[:포트][/경로]" 분해
+static esp_err_t parse_url(const char *url, char *host, char *port, char *path) {
+    const char *prefix = "http://";
+    if (strncmp(url, prefix, strlen(prefix)) != 0) {
+        return ESP_ERR_HTTP_INVALID_TRANSPORT;
+    }
+    const char *p = url + strlen(prefix);
+    size_t host_len = strcspn(p, ":/");
+    if (host_len == 0 || host_len >= HTTP_SHIM_HOST_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(host, p, host_len);
+    host[host_len] = '\0';
+    p += host_len;
+
+    strcpy(port, "80");
+    if (*p == ':') {
+        size_t port_len = strcspn(++p, "/");
+        if (port_len == 0 || port_len >= 8) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(port, p, port_len);
+        port[port_len] = '\0';
+        p += port_len;
+    }
+    snprintf(path, HTTP_SHIM_PATH_LEN, "%s", *p == '/' ? p : "/");
+    return ESP_OK;
+}
+
+static esp_err_t connect_server(esp_http_client_handle_t client) {
+    struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(client->host, client->port, &hints, &res) != 0) {
+        return ESP_ERR_HTTP_CONNECT;
+    }
+    int fd = -1;
+    for (struct addrinfo *ai = res; ai != NULL && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    struct timeval tv = {
+        .tv_sec = client->config.timeout_ms / 1000,
+        .tv_usec = (client->config.timeout_ms % 1000) * 1000,
+    };
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (client->config.keep_alive_enable) {
+        setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+    }
+    client->fd = fd;
+    fire_event(client, HTTP_EVENT_ON_CONNECTED);
+    return ESP_OK;
+}
+
+static bool send_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// 헤더 값 찾기 (대소문자 무시, 없으면 NULL)
+static const char *find_header(const char *headers, const char *name) {
+    size_t name_len = strlen(name);
+    for (const char *line = strstr(headers, "\r\n"); line != NULL; line = strstr(line, "\r\n")) {
+        line += 2;
+        if (strncasecmp(line, name, name_len) == 0 && line[name_len] == ':') {
+            const char *value = line + name_len + 1;
+            while (*value == ' ') {
+                value++;
+            }
+            return value;
+        }
+    }
+    return NULL;
+}
+
+// 응답 상태 줄과 헤더를 읽고 본문은 버림, 서버가 연결을 닫겠다고 하면 *close_after = true
+static esp_err_t read_response(esp_http_client_handle_t client, bool *close_after) {
+    size_t used = 0;
+    char *end = NULL;
+    while (end == NULL) {
+        if (used + 1 >= sizeof(client->rx)) {
+            return ESP_ERR_HTTP_FETCH_HEADER;
+        }
+        ssize_t n = recv(client->fd, client->rx + used, sizeof(client->rx) - 1 - used, 0);
+        if (n <= 0) {
+            return ESP_ERR_HTTP_FETCH_HEADER;
+        }
+        used += (size_t)n;
+        client->rx[used] = '\0';
+        end = strstr(client->rx, "\r\n\r\n");
+    }
+
+    int status = 0;
+    if (sscanf(client->rx, "HTTP/1.%*d %d", &status) != 1) {
+        return ESP_ERR_HTTP_FETCH_HEADER;
+    }
+    end[2] = '\0';                          // 헤더 검색을 빈 줄 앞까지로 제한
+    const char *length = find_header(client->rx, "Content-Length");
+    const char *connection = find_header(client->rx, "Connection");
+    long remaining = length ? atol(length) : 0;
+    *close_after = connection != NULL && strncasecmp(connection, "close", 5) == 0;
+
+    remaining -= (long)(used - (size_t)(end + 4 - client->rx));
+    while (remaining > 0) {
+        ssize_t n = recv(client->fd, client->rx, sizeof(client->rx), 0);
+        if (n <= 0) {
+            return ESP_ERR_HTTP_FETCH_HEADER;
+        }
+        remaining -= n;
+    }
+    client->status_code = status;
+    return ESP_OK;
+}
+
+
+// ===== 공개 함수 =====
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config) {
+    esp_http_client_handle_t client = calloc(1, sizeof(*client));
+    if (client == NULL) {
+        return NULL;
+    }
+    client->config = *config;
+    client->fd = -1;
+    if (parse_url(config->url, client->host, client->port, client->path) != ESP_OK) {
+        free(client);
+        return NULL;
+    }
+    return client;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url) {
+    char host[HTTP_SHIM_HOST_LEN];
+    char port[8];
+    char path[HTTP_SHIM_PATH_LEN];
+    esp_err_t err = parse_url(url, host, port, path);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (strcmp(host, client->host) != 0 || strcmp(port, client->port) != 0) {
+        esp_http_client_close(client);
+        strcpy(client->host, host);
+        strcpy(client->port, port);
+    }
+    strcpy(client->path, path);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value) {
+    int i = 0;
+    while (i < client->header_count && strcasecmp(client->header_keys[i], key) != 0) {
+        i++;
+    }
+    if (i == HTTP_SHIM_MAX_HEADERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    snprintf(client->header_keys[i], sizeof(client->header_keys[i]), "%s", key);
+    snprintf(client->header_values[i], sizeof(client->header_values[i]), "%s", value);
+    if (i == client->header_count) {
+        client->header_count++;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len) {
+    client->post_data = data;
+    client->post_len = len;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client) {
+    client->status_code = 0;
+    if (client->fd < 0) {
+        esp_err_t err = connect_server(client);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    char head[1024];
+    int len = snprintf(head, sizeof(head), "%s %s HTTP/1.1\r\nHost: %s:%s\r\nUser-Agent: ESP32 HTTP Client/1.0\r\n",
+                       client->config.method == HTTP_METHOD_POST ? "POST" : "GET",
+                       client->path, client->host, client->port);
+    for (int i = 0; i < client->header_count; i++) {
+        len += snprintf(head + len, sizeof(head) - (size_t)len, "%s: %s\r\n",
+                        client->header_keys[i], client->header_values[i]);
+    }
+    len += snprintf(head + len, sizeof(head) - (size_t)len, "Content-Length: %d\r\n\r\n", client->post_len);
+
+    bool close_after = false;
+    esp_err_t err = ESP_OK;
+    if (!send_all(client->fd, head, (size_t)len) ||
+        (client->post_len > 0 && !send_all(client->fd, client->post_data, (size_t)client->post_len))) {
+        err = ESP_ERR_HTTP_WRITE_DATA;
+    } else {
+        err = read_response(client, &close_after);
+    }
+    if (err != ESP_OK || close_after) {
+        esp_http_client_close(client);
+    }
+    return err;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client) {
+    return client->status_code;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client) {
+    if (client->fd >= 0) {
+        close(client->fd);
+        client->fd = -1;
+        fire_event(client, HTTP_EVENT_DISCONNECTED);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client) {
+    esp_http_client_close(client);
+    free(client);
+    return ESP_OK;
+}
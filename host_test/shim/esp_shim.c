@@ -0,0 +1,205 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "nvs.h"
+
+// ===== 전역 변수 =====
+static uint32_t s_log_counts[ESP_LOG_VERBOSE + 1];
+static int s_log_level = -1;                // -1: 아직 환경 변수를 읽지 않음
+static uint32_t s_random_state = 0x12345678u;
+
+
+// ===== esp_err =====
+
+// 에러 코드 이름
+const char *esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC:   return "ESP_ERR_INVALID_CRC";
+        case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+        case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+        case ESP_ERR_HTTP_CONNECT:  return "ESP_ERR_HTTP_CONNECT";
+        case ESP_ERR_HTTP_WRITE_DATA: return "ESP_ERR_HTTP_WRITE_DATA";
+        case ESP_ERR_HTTP_FETCH_HEADER: return "ESP_ERR_HTTP_FETCH_HEADER";
+        case ESP_ERR_HTTP_INVALID_TRANSPORT: return "ESP_ERR_HTTP_INVALID_TRANSPORT";
+        default:                    return "UNKNOWN ERROR";
+    }
+}
+
+
+// ===== esp_log =====
+
+// 로그 한 줄 기록
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...) {
+    static const char letters[] = "NEWIDV";
+    if (level <= ESP_LOG_NONE || level > ESP_LOG_VERBOSE) {
+        return;
+    }
+    __atomic_fetch_add(&s_log_counts[level], 1, __ATOMIC_RELAXED);
+
+    if (s_log_level < 0) {
+        const char *env = getenv("ESP_LOG_LEVEL");
+        s_log_level = env ? atoi(env) : ESP_LOG_WARN;
+    }
+    if ((int)level > s_log_level) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "%c (%s) ", letters[level], tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+// 레벨별 누적 로그 줄 수
+uint32_t esp_log_shim_count(esp_log_level_t level) {
+    return __atomic_load_n(&s_log_counts[level], __ATOMIC_RELAXED);
+}
+
+// 누적 로그 줄 수 초기화
+void esp_log_shim_reset(void) {
+    for (int i = 0; i <= ESP_LOG_VERBOSE; i++) {
+        __atomic_store_n(&s_log_counts[i], 0, __ATOMIC_RELAXED);
+    }
+}
+
+
+// ===== esp_timer / esp_random =====
+
+// 경과 시간 (마이크로초)
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// 주기 타이머
+struct esp_timer {
+    esp_timer_create_args_t args;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint64_t period_us;
+    bool running;
+};
+
+// 타이머 스레드: 다음 주기의 절대 시각까지 자고 콜백 호출 (정지 요청은 조건 변수로 바로 깨움)
+static void *timer_thread(void *arg) {
+    esp_timer_handle_t timer = arg;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    pthread_mutex_lock(&timer->lock);
+    while (timer->running) {
+        next.tv_nsec += (long)(timer->period_us % 1000000) * 1000L;
+        next.tv_sec += (time_t)(timer->period_us / 1000000) + next.tv_nsec / 1000000000L;
+        next.tv_nsec %= 1000000000L;
+        int rc = 0;
+        while (timer->running && rc != ETIMEDOUT) {
+            rc = pthread_cond_timedwait(&timer->cond, &timer->lock, &next);
+        }
+        if (!timer->running) {
+            break;
+        }
+        pthread_mutex_unlock(&timer->lock);
+        timer->args.callback(timer->args.arg);
+        pthread_mutex_lock(&timer->lock);
+
+        // 콜백이 주기보다 오래 걸렸으면 밀린 주기는 건너뜀 (esp_timer 도 한 번만 호출)
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > next.tv_sec || (now.tv_sec == next.tv_sec && now.tv_nsec > next.tv_nsec)) {
+            next = now;
+        }
+    }
+    pthread_mutex_unlock(&timer->lock);
+    return NULL;
+}
+
+// 타이머 생성
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle) {
+    esp_timer_handle_t timer = calloc(1, sizeof(*timer));
+    if (timer == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->args = *args;
+    pthread_mutex_init(&timer->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&timer->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+// 주기 호출 시작
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+    pthread_mutex_lock(&timer->lock);
+    if (timer->running) {
+        pthread_mutex_unlock(&timer->lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->period_us = period_us > 0 ? period_us : 1;
+    timer->running = true;
+    pthread_mutex_unlock(&timer->lock);
+    if (pthread_create(&timer->thread, NULL, timer_thread, timer) != 0) {
+        timer->running = false;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+// 정지
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    pthread_mutex_lock(&timer->lock);
+    if (!timer->running) {
+        pthread_mutex_unlock(&timer->lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->running = false;
+    pthread_cond_signal(&timer->cond);
+    pthread_mutex_unlock(&timer->lock);
+    pthread_join(timer->thread, NULL);
+    return ESP_OK;
+}
+
+// 정지 후 해제
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (timer->running) {
+        esp_timer_stop(timer);
+    }
+    pthread_mutex_destroy(&timer->lock);
+    pthread_cond_destroy(&timer->cond);
+    free(timer);
+    return ESP_OK;
+}
+
+// 32비트 의사 난수 (xorshift32)
+uint32_t esp_random(void) {
+    uint32_t x = s_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_random_state = x;
+    return x;
+}
@@ -0,0 +1,375 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos_shim.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// ===== 공통 =====
+
+struct shim_task {
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify;                        // 태스크 알림 값
+};
+
+struct shim_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t *items;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+struct shim_semaphore {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    UBaseType_t count;
+    UBaseType_t max_count;
+};
+
+struct shim_event_group {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    EventBits_t bits;
+};
+
+static __thread TaskHandle_t s_current_task;
+
+// 현재 시각 + ticks 의 절대 시각 (CLOCK_REALTIME, pthread_cond_timedwait 용)
+static struct timespec deadline_after(TickType_t ticks) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ticks / 1000;
+    ts.tv_nsec += (long)(ticks % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+// 조건 변수 대기 (portMAX_DELAY 면 무한, 시간 초과면 false)
+static bool cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, TickType_t ticks, const struct timespec *deadline) {
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+// 동기화 객체 초기화
+static void sync_init(pthread_mutex_t *lock, pthread_cond_t *cond) {
+    pthread_mutex_init(lock, NULL);
+    pthread_cond_init(cond, NULL);
+}
+
+
+// ===== 태스크 =====
+
+// 태스크 스레드 진입점
+static void *task_entry(void *arg) {
+    TaskHandle_t task = arg;
+    s_current_task = task;
+    task->fn(task->arg);
+    return NULL;
+}
+
+// 태스크 생성
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *out_handle) {
+    TaskHandle_t task = calloc(1, sizeof(*task));
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    sync_init(&task->lock, &task->cond);
+    if (pthread_create(&task->thread, NULL, task_entry, task) != 0) {
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(task->thread);
+    if (out_handle != NULL) {
+        *out_handle = task;
+    }
+    return pdPASS;
+}
+
+// 태스크 종료 (자기 자신만)
+void vTaskDelete(TaskHandle_t task) {
+    if (task == NULL || task == s_current_task) {
+        pthread_exit(NULL);
+    }
+}
+
+// 지정 틱만큼 대기
+void vTaskDelay(TickType_t ticks) {
+    struct timespec ts = {.tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000L};
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+// 주기 대기
+void vTaskDelayUntil(TickType_t *last_wake, TickType_t period) {
+    *last_wake += period;
+    int32_t remaining = (int32_t)(*last_wake - xTaskGetTickCount());
+    if (remaining > 0) {
+        vTaskDelay((TickType_t)remaining);
+    }
+}
+
+static struct timespec s_tick_start;       // 틱 0 시각
+static bool s_manual_tick = false;          // 시뮬레이션 틱 사용 여부
+static TickType_t s_manual_tick_value;
+static pthread_once_t s_tick_once = PTHREAD_ONCE_INIT;
+
+// 틱 0 시각 기록 (처음 한 번)
+static void tick_start_init(void) {
+    clock_gettime(CLOCK_MONOTONIC, &s_tick_start);
+}
+
+// 현재 틱 (ms)
+TickType_t xTaskGetTickCount(void) {
+    if (__atomic_load_n(&s_manual_tick, __ATOMIC_ACQUIRE)) {
+        return __atomic_load_n(&s_manual_tick_value, __ATOMIC_RELAXED);
+    }
+    pthread_once(&s_tick_once, tick_start_init);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (TickType_t)((now.tv_sec - s_tick_start.tv_sec) * 1000 +
+                        (now.tv_nsec - s_tick_start.tv_nsec) / 1000000);
+}
+
+// 틱을 고정값으로 설정
+void freertos_shim_set_tick(TickType_t ticks) {
+    __atomic_store_n(&s_manual_tick_value, ticks, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_manual_tick, true, __ATOMIC_RELEASE);
+}
+
+// 실제 시계 틱으로 되돌림
+void freertos_shim_use_real_tick(void) {
+    __atomic_store_n(&s_manual_tick, false, __ATOMIC_RELEASE);
+}
+
+// 현재 스레드의 태스크 핸들
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    if (s_current_task == NULL) {
+        s_current_task = calloc(1, sizeof(*s_current_task));
+        s_current_task->thread = pthread_self();
+        sync_init(&s_current_task->lock, &s_current_task->cond);
+    }
+    return s_current_task;
+}
+
+// 태스크 알림
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    pthread_mutex_lock(&task->lock);
+    task->notify++;
+    pthread_cond_signal(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+// 태스크 알림 대기
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    struct timespec deadline = deadline_after(ticks);
+    pthread_mutex_lock(&task->lock);
+    while (task->notify == 0 && ticks != 0) {
+        if (!cond_wait(&task->cond, &task->lock, ticks, &deadline)) {
+            break;
+        }
+    }
+    uint32_t value = task->notify;
+    if (value > 0) {
+        task->notify = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+
+// ===== 큐 =====
+
+// 큐 생성
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    QueueHandle_t queue = calloc(1, sizeof(*queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->items = malloc((size_t)length * item_size);
+    if (queue->items == NULL) {
+        free(queue);
+        return NULL;
+    }
+    queue->length = length;
+    queue->item_size = item_size;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+    return queue;
+}
+
+// 뒤에 넣기
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks) {
+    struct timespec deadline = deadline_after(ticks);
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length) {
+        if (ticks == 0 || !cond_wait(&queue->not_full, &queue->lock, ticks, &deadline)) {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFAIL;
+        }
+    }
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->items[(size_t)tail * queue->item_size], item, queue->item_size);
+    queue->count++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+// 앞에서 꺼내기
+BaseType_t xQueueReceive(QueueHandle_t queue, void *out, TickType_t ticks) {
+    struct timespec deadline = deadline_after(ticks);
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0) {
+        if (ticks == 0 || !cond_wait(&queue->not_empty, &queue->lock, ticks, &deadline)) {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFAIL;
+        }
+    }
+    memcpy(out, &queue->items[(size_t)queue->head * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    pthread_cond_signal(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+// 들어 있는 항목 수
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+
+// ===== 세마포어 =====
+
+// 카운팅 세마포어 생성
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count) {
+    SemaphoreHandle_t sem = calloc(1, sizeof(*sem));
+    if (sem == NULL) {
+        return NULL;
+    }
+    sync_init(&sem->lock, &sem->cond);
+    sem->count = initial_count;
+    sem->max_count = max_count;
+    return sem;
+}
+
+// 획득
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    struct timespec deadline = deadline_after(ticks);
+    pthread_mutex_lock(&sem->lock);
+    while (sem->count == 0) {
+        if (ticks == 0 || !cond_wait(&sem->cond, &sem->lock, ticks, &deadline)) {
+            pthread_mutex_unlock(&sem->lock);
+            return pdFAIL;
+        }
+    }
+    sem->count--;
+    pthread_mutex_unlock(&sem->lock);
+    return pdPASS;
+}
+
+// 반납
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    pthread_mutex_lock(&sem->lock);
+    BaseType_t ok = sem->count < sem->max_count;
+    if (ok) {
+        sem->count++;
+        pthread_cond_signal(&sem->cond);
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return ok ? pdPASS : pdFAIL;
+}
+
+// 현재 카운트
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t sem) {
+    pthread_mutex_lock(&sem->lock);
+    UBaseType_t count = sem->count;
+    pthread_mutex_unlock(&sem->lock);
+    return count;
+}
+
+
+// ===== 이벤트 그룹 =====
+
+// 이벤트 그룹 생성
+EventGroupHandle_t xEventGroupCreate(void) {
+    EventGroupHandle_t group = calloc(1, sizeof(*group));
+    if (group != NULL) {
+        sync_init(&group->lock, &group->cond);
+    }
+    return group;
+}
+
+// 비트 켜기
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    pthread_mutex_lock(&group->lock);
+    group->bits |= bits;
+    EventBits_t value = group->bits;
+    pthread_cond_broadcast(&group->cond);
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+// 비트 끄기
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    pthread_mutex_lock(&group->lock);
+    EventBits_t value = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+// 현재 비트
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    pthread_mutex_lock(&group->lock);
+    EventBits_t value = group->bits;
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+// 비트 대기
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks) {
+    struct timespec deadline = deadline_after(ticks);
+    pthread_mutex_lock(&group->lock);
+    while (true) {
+        bool met = wait_for_all ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+        if (met || ticks == 0 || !cond_wait(&group->cond, &group->lock, ticks, &deadline)) {
+            break;
+        }
+    }
+    EventBits_t value = group->bits;
+    bool met = wait_for_all ? (value & bits) == bits : (value & bits) != 0;
+    if (met && clear_on_exit) {
+        group->bits &= ~bits;
+    }
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// ===== 호스트 빌드용 esp_attr.h =====
+
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
@@ -0,0 +1,11 @@
+#pragma once
+
+// ===== 호스트 빌드용 esp_event.h =====
+// 이벤트 루프는 없고 mqtt_client.h 의 이벤트 핸들러 형식만 정의
+
+#include <stdint.h>
+
+typedef const char *esp_event_base_t;
+typedef void (*esp_event_handler_t)(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data);
+
+#define ESP_EVENT_ANY_ID -1
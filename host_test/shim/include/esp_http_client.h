@@ -0,0 +1,77 @@
+#pragma once
+
+// ===== 호스트 빌드용 esp_http_client.h =====
+// http_uplink.c 가 쓰는 부분만: 평문 HTTP/1.1 POST, Keep-Alive 연결 유지, 연결/해제 이벤트
+// POSIX 소켓으로 실제 TCP 연결을 맺음 (응답 본문은 읽고 버림, 청크 전송 인코딩은 지원하지 않음)
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define ESP_ERR_HTTP_BASE               0x7000
+#define ESP_ERR_HTTP_CONNECT            (ESP_ERR_HTTP_BASE + 2)
+#define ESP_ERR_HTTP_WRITE_DATA         (ESP_ERR_HTTP_BASE + 3)
+#define ESP_ERR_HTTP_FETCH_HEADER       (ESP_ERR_HTTP_BASE + 4)
+#define ESP_ERR_HTTP_INVALID_TRANSPORT  (ESP_ERR_HTTP_BASE + 5)
+
+typedef struct esp_http_client *esp_http_client_handle_t;
+
+typedef enum {
+    HTTP_METHOD_GET = 0,
+    HTTP_METHOD_POST,
+} esp_http_client_method_t;
+
+typedef enum {
+    HTTP_EVENT_ERROR = 0,
+    HTTP_EVENT_ON_CONNECTED,
+    HTTP_EVENT_HEADERS_SENT,
+    HTTP_EVENT_ON_HEADER,
+    HTTP_EVENT_ON_DATA,
+    HTTP_EVENT_ON_FINISH,
+    HTTP_EVENT_DISCONNECTED,
+} esp_http_client_event_id_t;
+
+typedef struct {
+    esp_http_client_event_id_t event_id;
+    esp_http_client_handle_t client;
+    void *user_data;
+} esp_http_client_event_t;
+
+typedef esp_err_t (*http_event_handle_cb)(esp_http_client_event_t *evt);
+
+// 클라이언트 설정 (TLS, 인증, 리다이렉트 관련 필드는 없음)
+typedef struct {
+    const char *url;                        // http://호스트[:포트][/경로]
+    esp_http_client_method_t method;
+    int timeout_ms;                         // 송수신 타임아웃
+    int buffer_size;
+    bool keep_alive_enable;                 // TCP keep-alive (호스트에서는 SO_KEEPALIVE 만)
+    int keep_alive_idle;
+    int keep_alive_interval;
+    int keep_alive_count;
+    http_event_handle_cb event_handler;
+    void *user_data;
+} esp_http_client_config_t;
+
+// 클라이언트 생성 (연결은 첫 요청에서)
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config);
+
+// 요청 URL 변경 (호스트나 포트가 바뀌면 현재 연결을 닫음)
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url);
+
+// 요청 헤더 설정 (같은 이름이면 덮어씀)
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value);
+
+// 요청 본문 설정 (perform 이 끝날 때까지 유효해야 함)
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len);
+
+// 요청 전송 후 응답을 끝까지 읽음 (연결이 없으면 새로 맺고, 서버가 Connection: close 면 응답 후 닫음)
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client);
+
+// 마지막 응답 상태 코드
+int esp_http_client_get_status_code(esp_http_client_handle_t client);
+
+// 현재 연결 닫기
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+
+// 연결을 닫고 해제
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
@@ -0,0 +1,32 @@
+#pragma once
+
+// ===== 호스트 빌드용 esp_log.h =====
+// 레벨별 출력 줄 수를 세고 (하네스가 레코드당 로그 줄 수를 보고),
+// 환경 변수 ESP_LOG_LEVEL (0=NONE ~ 5=VERBOSE, 기본 2=WARN) 이하만 stderr 로 출력
+
+#include <stdint.h>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+// 로그 한 줄 기록
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// 레벨별 누적 로그 줄 수 (출력 여부와 무관)
+uint32_t esp_log_shim_count(esp_log_level_t level);
+
+// 누적 로그 줄 수 초기화
+void esp_log_shim_reset(void);
+
+#define ESP_LOGE(tag, format, ...) esp_log_write(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) esp_log_write(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) esp_log_write(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) esp_log_write(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) esp_log_write(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
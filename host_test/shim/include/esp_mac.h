@@ -0,0 +1,6 @@
+#pragma once
+
+// ===== 호스트 빌드용 esp_mac.h =====
+
+#define MACSTR "%02x:%02x:%02x:%02x:%02x:%02x"
+#define MAC2STR(a) (a)[0], (a)[1], (a)[2], (a)[3], (a)[4], (a)[5]
@@ -0,0 +1,8 @@
+#pragma once
+
+// ===== 호스트 빌드용 esp_random.h =====
+
+#include <stdint.h>
+
+// 32비트 의사 난수 (재현 가능하도록 고정 시드)
+uint32_t esp_random(void);
@@ -0,0 +1,32 @@
+#pragma once
+
+// ===== 호스트 빌드용 esp_timer.h =====
+// 주기 타이머는 타이머마다 pthread 하나 (CLOCK_MONOTONIC 절대 시각으로 대기, 밀리면 따라잡지 않고 다음 주기부터)
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct esp_timer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+// 타이머 생성 인자 (dispatch_method 등 나머지 필드는 호스트에서 의미 없음)
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+} esp_timer_create_args_t;
+
+// 프로세스 시작 이후 경과 시간 (마이크로초, CLOCK_MONOTONIC)
+int64_t esp_timer_get_time(void);
+
+// 타이머 생성 (시작하지 않음)
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle);
+
+// period_us 마다 콜백 호출 시작 (이미 돌고 있으면 ESP_ERR_INVALID_STATE)
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us);
+
+// 정지 (실행 중인 콜백이 끝날 때까지 기다림, 콜백 안에서 부르면 안 됨)
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+
+// 정지 후 해제
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
@@ -0,0 +1,18 @@
+#pragma once
+
+// ===== 호스트 빌드용 esp_wifi.h =====
+// 비콘 FTM 축약 코드가 쓰는 리포트 엔트리 구조체만 ESP-IDF 와 같은 배치로 정의
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// FTM 리포트 엔트리 (시각은 피코초)
+typedef struct {
+    uint8_t dlog_token;
+    int8_t rssi;
+    uint32_t rtt;
+    uint64_t t1;
+    uint64_t t2;
+    uint64_t t3;
+    uint64_t t4;
+} wifi_ftm_report_entry_t;
@@ -0,0 +1,31 @@
+#pragma once
+
+// ===== 호스트 빌드용 freertos/event_groups.h =====
+
+#include "freertos/FreeRTOS.h"
+
+typedef uint32_t EventBits_t;
+typedef struct shim_event_group *EventGroupHandle_t;
+
+#define BIT0 (1u << 0)
+#define BIT1 (1u << 1)
+#define BIT2 (1u << 2)
+#define BIT3 (1u << 3)
+#define BIT4 (1u << 4)
+#define BIT5 (1u << 5)
+
+// 이벤트 그룹 생성
+EventGroupHandle_t xEventGroupCreate(void);
+
+// 비트 켜기
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+
+// 비트 끄기 (끄기 전 값 반환)
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+
+// 현재 비트
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+
+// 비트 대기 (all 이면 모두, 아니면 하나라도), 반환 시점의 비트 반환
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks);
@@ -0,0 +1,19 @@
+#pragma once
+
+// ===== 호스트 빌드용 freertos/queue.h =====
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct shim_queue *QueueHandle_t;
+
+// 고정 크기 항목 큐 생성
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+
+// 뒤에 넣기 (가득 차면 ticks 까지 대기)
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+
+// 앞에서 꺼내기 (비어 있으면 ticks 까지 대기)
+BaseType_t xQueueReceive(QueueHandle_t queue, void *out, TickType_t ticks);
+
+// 들어 있는 항목 수
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
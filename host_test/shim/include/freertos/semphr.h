@@ -0,0 +1,19 @@
+#pragma once
+
+// ===== 호스트 빌드용 freertos/semphr.h =====
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct shim_semaphore *SemaphoreHandle_t;
+
+// 카운팅 세마포어 생성
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+
+// 획득 (ticks 까지 대기)
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+
+// 반납
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+
+// 현재 카운트
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t sem);
@@ -0,0 +1,33 @@
+#pragma once
+
+// ===== 호스트 빌드용 freertos/task.h =====
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct shim_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+// 태스크 생성 (스택 크기, 우선순위는 무시)
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *out_handle);
+
+// 태스크 종료 (NULL 이면 자기 자신, 다른 태스크 강제 종료는 지원하지 않음)
+void vTaskDelete(TaskHandle_t task);
+
+// 지정 틱만큼 대기
+void vTaskDelay(TickType_t ticks);
+
+// *last_wake 기준 주기 대기
+void vTaskDelayUntil(TickType_t *last_wake, TickType_t period);
+
+// 현재 틱 (ms)
+TickType_t xTaskGetTickCount(void);
+
+// 현재 스레드의 태스크 핸들 (xTaskCreate 로 만들지 않은 스레드는 처음 호출 시 생성)
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+// 태스크 알림 (카운팅)
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+// 태스크 알림 대기 (clear 면 0 으로, 아니면 1 감소), 받은 알림 값 반환
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
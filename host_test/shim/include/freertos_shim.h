@@ -0,0 +1,11 @@
+#pragma once
+
+// ===== 호스트 FreeRTOS 대체의 테스트 제어 =====
+
+#include "freertos/FreeRTOS.h"
+
+// 틱을 고정값으로 설정 (이후 xTaskGetTickCount 는 이 값을 반환, 시뮬레이션 시간 진행용)
+void freertos_shim_set_tick(TickType_t ticks);
+
+// 실제 시계 틱으로 되돌림
+void freertos_shim_use_real_tick(void);
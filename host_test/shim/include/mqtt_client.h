@@ -0,0 +1,69 @@
+#pragma once
+
+// ===== 호스트 빌드용 mqtt_client.h =====
+// mqtt_uplink.c 가 쓰는 부분만: 영구 세션 설정, 이벤트 등록, QoS1 발행
+// 네트워크 없이 같은 프로세스의 브로커 대체로 동작 (mqtt_client_sim.c, 테스트 제어는 mqtt_client_sim.h)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_event.h"
+
+typedef struct esp_mqtt_client *esp_mqtt_client_handle_t;
+
+typedef enum {
+    MQTT_EVENT_ANY = -1,
+    MQTT_EVENT_ERROR = 0,
+    MQTT_EVENT_CONNECTED,
+    MQTT_EVENT_DISCONNECTED,
+    MQTT_EVENT_SUBSCRIBED,
+    MQTT_EVENT_UNSUBSCRIBED,
+    MQTT_EVENT_PUBLISHED,
+    MQTT_EVENT_DATA,
+    MQTT_EVENT_BEFORE_CONNECT,
+    MQTT_EVENT_DELETED,
+} esp_mqtt_event_id_t;
+
+// 이벤트 데이터 (수신 메시지 관련 필드는 없음)
+typedef struct {
+    esp_mqtt_event_id_t event_id;
+    esp_mqtt_client_handle_t client;
+    int msg_id;                             // PUBLISHED / DELETED 의 메시지 ID
+    int session_present;                    // CONNECTED 의 브로커 세션 유지 여부
+} esp_mqtt_event_t;
+
+typedef esp_mqtt_event_t *esp_mqtt_event_handle_t;
+
+// 클라이언트 설정 (TLS, 인증, LWT 관련 필드는 없음)
+typedef struct {
+    struct {
+        struct {
+            const char *uri;
+        } address;
+    } broker;
+    struct {
+        const char *client_id;
+    } credentials;
+    struct {
+        bool disable_clean_session;
+        int keepalive;
+    } session;
+    struct {
+        int reconnect_timeout_ms;
+    } network;
+} esp_mqtt_client_config_t;
+
+// 클라이언트 생성 (연결은 start 에서)
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config);
+
+// 이벤트 핸들러 등록 (호스트에서는 핸들러 하나만, event 는 ESP_EVENT_ANY_ID 만 지원)
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t handler, void *handler_args);
+
+// 연결 시작 (CONNECTED 는 브로커 대체 스레드에서 비동기로 전달)
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client);
+
+// 발행 (아웃박스에 넣고 메시지 ID 반환, 실패 시 -1)
+// QoS1 은 브로커 대체가 PUBACK 을 보낼 때까지 아웃박스에 남음
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data,
+                            int len, int qos, int retain);
@@ -0,0 +1,40 @@
+#pragma once
+
+// ===== 호스트 MQTT 브로커 대체의 테스트 제어 =====
+// 발행은 아웃박스에 쌓이고, PUBACK / 만료 / 연결 변화는 여기서 지시할 때만 일어남 (자동 PUBACK 제외)
+// 이벤트 핸들러는 지시한 스레드(자동 PUBACK 은 브로커 대체 스레드)에서 한 번에 하나씩 호출
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 브로커 대체 통계
+typedef struct {
+    uint32_t accepted;                      // 아웃박스에 넣은 발행 수
+    uint32_t rejected;                      // 실패(-1)로 돌려준 발행 수
+    uint32_t acked;                         // PUBACK 을 보낸 메시지 수
+    uint32_t deleted;                       // PUBACK 없이 만료시킨 메시지 수
+    uint32_t resent;                        // 세션 유지 재연결에서 다시 보낸 미확인 메시지 수
+    uint32_t outstanding;                   // 현재 아웃박스의 미확인 메시지 수
+    char last_topic[64];                    // 마지막으로 받은 발행의 토픽
+} mqtt_sim_stats_t;
+
+// 브로커 연결 (CONNECTED 전달, session_present 면 아웃박스의 미확인 메시지를 재전송으로 셈)
+void mqtt_sim_connect(bool session_present);
+
+// 브로커 연결 끊김 (DISCONNECTED 전달, 아웃박스는 유지)
+void mqtt_sim_disconnect(void);
+
+// 가장 오래된 미확인 메시지 count 개에 PUBACK (PUBLISHED 전달), 보낸 수 반환
+int mqtt_sim_ack(int count);
+
+// 가장 오래된 미확인 메시지 count 개를 PUBACK 없이 만료 (DELETED 전달), 만료시킨 수 반환
+int mqtt_sim_expire(int count);
+
+// 앞으로 skip 개의 발행은 받고 그다음 한 개는 실패(-1)로 돌려줌 (음수면 해제)
+void mqtt_sim_fail_publish_after(int skip);
+
+// 켜면 브로커 대체 스레드가 아웃박스의 메시지마다 바로 PUBACK (실제 브로커처럼 비동기)
+void mqtt_sim_set_auto_ack(bool enable);
+
+// 통계 복사
+void mqtt_sim_get_stats(mqtt_sim_stats_t *out);
@@ -0,0 +1,49 @@
+#pragma once
+
+// ===== 호스트 빌드용 nvs.h =====
+// 프로세스 메모리의 blob 저장소 (anchor_registry.c 가 쓰는 blob 읽기/쓰기/삭제/순회만, 재시작하면 사라짐)
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define ESP_ERR_NVS_BASE        0x1100
+#define ESP_ERR_NVS_NOT_FOUND   (ESP_ERR_NVS_BASE + 0x02)
+#define NVS_DEFAULT_PART_NAME   "nvs"
+#define NVS_KEY_NAME_MAX_SIZE   16
+#define NVS_NS_NAME_MAX_SIZE    16
+
+typedef uint32_t nvs_handle_t;
+typedef struct nvs_iterator *nvs_iterator_t;
+
+typedef enum {
+    NVS_READONLY,
+    NVS_READWRITE,
+} nvs_open_mode_t;
+
+typedef enum {
+    NVS_TYPE_BLOB = 0x42,
+    NVS_TYPE_ANY = 0xff,
+} nvs_type_t;
+
+typedef struct {
+    char namespace_name[NVS_NS_NAME_MAX_SIZE];
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    nvs_type_t type;
+} nvs_entry_info_t;
+
+// 네임스페이스 열기 (읽기 전용인데 항목이 하나도 없으면 ESP_ERR_NVS_NOT_FOUND, 장치와 같음)
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t mode, nvs_handle_t *out_handle);
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length);
+// *length 는 버퍼 크기로 들어가고 저장된 크기로 나옴 (버퍼가 작으면 ESP_ERR_INVALID_SIZE)
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key);
+
+// 순회 (항목이 없으면 ESP_ERR_NVS_NOT_FOUND 이고 *out 은 NULL, 끝에 닿으면 nvs_entry_next 가 *it 을 해제하고 NULL 로)
+esp_err_t nvs_entry_find(const char *part_name, const char *namespace_name, nvs_type_t type, nvs_iterator_t *out);
+esp_err_t nvs_entry_next(nvs_iterator_t *it);
+esp_err_t nvs_entry_info(nvs_iterator_t it, nvs_entry_info_t *out_info);
+void nvs_release_iterator(nvs_iterator_t it);
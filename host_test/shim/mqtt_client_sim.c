@@ -0,0 +1,207 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mqtt_client.h"
+#include "mqtt_client_sim.h"
+
+// ===== 설정 상수 =====
+#define MQTT_SIM_OUTBOX_LEN 64              // 아웃박스 최대 미확인 메시지 수 (가득 차면 발행 실패)
+
+static const char *MQTT_SIM_EVENT_BASE = "MQTT_EVENTS";
+
+struct esp_mqtt_client {
+    esp_event_handler_t handler;
+    void *handler_args;
+    bool started;
+};
+
+// ===== 전역 변수 =====
+// 클라이언트는 프로세스에 하나 (mqtt_uplink.c 와 같은 전제)
+static esp_mqtt_client_handle_t s_client = NULL;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;         // 아웃박스 / 통계 보호
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;           // 자동 PUBACK 대상 생김
+static pthread_mutex_t s_dispatch_lock = PTHREAD_MUTEX_INITIALIZER; // 이벤트 핸들러 직렬화 (MQTT 태스크 하나와 같게)
+static int s_outbox[MQTT_SIM_OUTBOX_LEN];   // 미확인 메시지 ID (오래된 순 링)
+static int s_outbox_head = 0;
+static int s_outbox_count = 0;
+static int s_next_msg_id = 1;
+static int s_fail_after = -1;               // 남은 성공 발행 수 (0 이면 다음 발행 실패, 음수면 없음)
+static bool s_auto_ack = false;
+static mqtt_sim_stats_t s_stats = {0};
+
+
+// ===== 내부 함수 =====
+
+// 등록된 핸들러로 이벤트 전달
+static void dispatch(esp_mqtt_event_id_t id, int msg_id, int session_present) {
+    if (s_client == NULL || s_client->handler == NULL) {
+        return;
+    }
+    esp_mqtt_event_t event = {
+        .event_id = id,
+        .client = s_client,
+        .msg_id = msg_id,
+        .session_present = session_present,
+    };
+    pthread_mutex_lock(&s_dispatch_lock);
+    s_client->handler(s_client->handler_args, MQTT_SIM_EVENT_BASE, id, &event);
+    pthread_mutex_unlock(&s_dispatch_lock);
+}
+
+// 가장 오래된 미확인 메시지 꺼냄 (s_lock 보유 상태에서 호출, 없으면 -1)
+static int outbox_pop(void) {
+    if (s_outbox_count == 0) {
+        return -1;
+    }
+    int msg_id = s_outbox[s_outbox_head];
+    s_outbox_head = (s_outbox_head + 1) % MQTT_SIM_OUTBOX_LEN;
+    s_outbox_count--;
+    s_stats.outstanding = (uint32_t)s_outbox_count;
+    return msg_id;
+}
+
+// 미확인 메시지 count 개를 꺼내 id 이벤트로 전달
+static int complete_oldest(int count, esp_mqtt_event_id_t id) {
+    int done = 0;
+    while (done < count) {
+        pthread_mutex_lock(&s_lock);
+        int msg_id = outbox_pop();
+        if (msg_id >= 0) {
+            if (id == MQTT_EVENT_PUBLISHED) {
+                s_stats.acked++;
+            } else {
+                s_stats.deleted++;
+            }
+        }
+        pthread_mutex_unlock(&s_lock);
+        if (msg_id < 0) {
+            break;
+        }
+        dispatch(id, msg_id, 0);
+        done++;
+    }
+    return done;
+}
+
+// 브로커 대체 스레드: 연결 수립 후 자동 PUBACK
+static void *broker_thread(void *arg) {
+    mqtt_sim_connect(false);
+
+    while (1) {
+        pthread_mutex_lock(&s_lock);
+        while (!s_auto_ack || s_outbox_count == 0) {
+            pthread_cond_wait(&s_cond, &s_lock);
+        }
+        pthread_mutex_unlock(&s_lock);
+        complete_oldest(1, MQTT_EVENT_PUBLISHED);
+    }
+    return NULL;
+}
+
+
+// ===== esp_mqtt_client API =====
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config) {
+    if (config == NULL || config->broker.address.uri == NULL || s_client != NULL) {
+        return NULL;
+    }
+    s_client = calloc(1, sizeof(*s_client));
+    return s_client;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t handler, void *handler_args) {
+    if (client == NULL || (int)event != ESP_EVENT_ANY_ID) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->handler = handler;
+    client->handler_args = handler_args;
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client) {
+    if (client == NULL || client->started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, broker_thread, NULL) != 0) {
+        return ESP_FAIL;
+    }
+    pthread_detach(thread);
+    client->started = true;
+    return ESP_OK;
+}
+
+// 연결이 끊겨 있어도 QoS1 은 아웃박스에 넣음 (재연결 후 전송, esp-mqtt 와 같게)
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data,
+                            int len, int qos, int retain) {
+    if (client == NULL || topic == NULL) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    bool fail = (s_fail_after == 0) || s_outbox_count == MQTT_SIM_OUTBOX_LEN;
+    if (s_fail_after >= 0) {
+        s_fail_after--;
+    }
+    if (fail) {
+        s_stats.rejected++;
+        pthread_mutex_unlock(&s_lock);
+        return -1;
+    }
+
+    int msg_id = s_next_msg_id++;
+    s_stats.accepted++;
+    strncpy(s_stats.last_topic, topic, sizeof(s_stats.last_topic) - 1);
+    if (qos > 0) {
+        s_outbox[(s_outbox_head + s_outbox_count) % MQTT_SIM_OUTBOX_LEN] = msg_id;
+        s_outbox_count++;
+        s_stats.outstanding = (uint32_t)s_outbox_count;
+        pthread_cond_signal(&s_cond);
+    }
+    pthread_mutex_unlock(&s_lock);
+    return msg_id;
+}
+
+
+// ===== 테스트 제어 =====
+
+void mqtt_sim_connect(bool session_present) {
+    pthread_mutex_lock(&s_lock);
+    if (session_present) {
+        s_stats.resent += (uint32_t)s_outbox_count;
+    }
+    pthread_mutex_unlock(&s_lock);
+    dispatch(MQTT_EVENT_CONNECTED, 0, session_present ? 1 : 0);
+}
+
+void mqtt_sim_disconnect(void) {
+    dispatch(MQTT_EVENT_DISCONNECTED, 0, 0);
+}
+
+int mqtt_sim_ack(int count) {
+    return complete_oldest(count, MQTT_EVENT_PUBLISHED);
+}
+
+int mqtt_sim_expire(int count) {
+    return complete_oldest(count, MQTT_EVENT_DELETED);
+}
+
+void mqtt_sim_fail_publish_after(int skip) {
+    pthread_mutex_lock(&s_lock);
+    s_fail_after = skip;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void mqtt_sim_set_auto_ack(bool enable) {
+    pthread_mutex_lock(&s_lock);
+    s_auto_ack = enable;
+    pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+}
+
+void mqtt_sim_get_stats(mqtt_sim_stats_t *out) {
+    pthread_mutex_lock(&s_lock);
+    *out = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
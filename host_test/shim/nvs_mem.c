@@ -0,0 +1,194 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "nvs.h"
+
+// ===== 설정 상수 =====
+#define NVS_MEM_ENTRIES 64                  // 저장 가능한 최대 항목 수
+#define NVS_MEM_BLOB_MAX 64                 // blob 최대 크기
+#define NVS_MEM_HANDLES 8                   // 동시에 열 수 있는 핸들 수
+
+typedef struct {
+    bool used;
+    char namespace_name[NVS_NS_NAME_MAX_SIZE];
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    uint8_t data[NVS_MEM_BLOB_MAX];
+    size_t len;
+} nvs_mem_entry_t;
+
+struct nvs_iterator {
+    char namespace_name[NVS_NS_NAME_MAX_SIZE];
+    int index;                              // 현재 항목
+};
+
+static nvs_mem_entry_t entries[NVS_MEM_ENTRIES];
+static char handles[NVS_MEM_HANDLES][NVS_NS_NAME_MAX_SIZE];    // 핸들 = 인덱스 + 1, 빈 문자열이면 비어 있음
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+// ===== 내부 함수 =====
+
+static nvs_mem_entry_t *find_entry(const char *namespace_name, const char *key) {
+    for (int i = 0; i < NVS_MEM_ENTRIES; i++) {
+        if (entries[i].used && strcmp(entries[i].namespace_name, namespace_name) == 0 &&
+            (key == NULL || strcmp(entries[i].key, key) == 0)) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+static const char *handle_namespace(nvs_handle_t handle) {
+    if (handle == 0 || handle > NVS_MEM_HANDLES || handles[handle - 1][0] == '\0') {
+        return NULL;
+    }
+    return handles[handle - 1];
+}
+
+// index 부터 namespace_name 의 다음 항목 (없으면 -1)
+static int next_in_namespace(const char *namespace_name, int index) {
+    for (int i = index; i < NVS_MEM_ENTRIES; i++) {
+        if (entries[i].used && strcmp(entries[i].namespace_name, namespace_name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+// ===== 공개 함수 =====
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t mode, nvs_handle_t *out_handle) {
+    if (strlen(namespace_name) >= NVS_NS_NAME_MAX_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&lock);
+    esp_err_t err = ESP_ERR_NO_MEM;
+    if (mode == NVS_READONLY && find_entry(namespace_name, NULL) == NULL) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else {
+        for (int i = 0; i < NVS_MEM_HANDLES; i++) {
+            if (handles[i][0] == '\0') {
+                strcpy(handles[i], namespace_name);
+                *out_handle = (nvs_handle_t)(i + 1);
+                err = ESP_OK;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return err;
+}
+
+void nvs_close(nvs_handle_t handle) {
+    pthread_mutex_lock(&lock);
+    if (handle_namespace(handle) != NULL) {
+        handles[handle - 1][0] = '\0';
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    return handle_namespace(handle) != NULL ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length) {
+    if (strlen(key) >= NVS_KEY_NAME_MAX_SIZE || length > NVS_MEM_BLOB_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&lock);
+    const char *ns = handle_namespace(handle);
+    esp_err_t err = ns != NULL ? ESP_ERR_NO_MEM : ESP_ERR_INVALID_ARG;
+    nvs_mem_entry_t *entry = ns != NULL ? find_entry(ns, key) : NULL;
+    for (int i = 0; ns != NULL && entry == NULL && i < NVS_MEM_ENTRIES; i++) {
+        if (!entries[i].used) {
+            entry = &entries[i];
+            entry->used = true;
+            strcpy(entry->namespace_name, ns);
+            strcpy(entry->key, key);
+        }
+    }
+    if (entry != NULL) {
+        memcpy(entry->data, value, length);
+        entry->len = length;
+        err = ESP_OK;
+    }
+    pthread_mutex_unlock(&lock);
+    return err;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length) {
+    pthread_mutex_lock(&lock);
+    const char *ns = handle_namespace(handle);
+    nvs_mem_entry_t *entry = ns != NULL ? find_entry(ns, key) : NULL;
+    esp_err_t err = ESP_ERR_NVS_NOT_FOUND;
+    if (entry != NULL) {
+        if (out_value != NULL && *length < entry->len) {
+            err = ESP_ERR_INVALID_SIZE;
+        } else {
+            if (out_value != NULL) {
+                memcpy(out_value, entry->data, entry->len);
+            }
+            err = ESP_OK;
+        }
+        *length = entry->len;
+    }
+    pthread_mutex_unlock(&lock);
+    return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key) {
+    pthread_mutex_lock(&lock);
+    const char *ns = handle_namespace(handle);
+    nvs_mem_entry_t *entry = ns != NULL ? find_entry(ns, key) : NULL;
+    if (entry != NULL) {
+        entry->used = false;
+    }
+    pthread_mutex_unlock(&lock);
+    return entry != NULL ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_entry_find(const char *part_name, const char *namespace_name, nvs_type_t type, nvs_iterator_t *out) {
+    *out = NULL;
+    pthread_mutex_lock(&lock);
+    int index = next_in_namespace(namespace_name, 0);
+    pthread_mutex_unlock(&lock);
+    if (index < 0) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    nvs_iterator_t it = calloc(1, sizeof(*it));
+    if (it == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    strncpy(it->namespace_name, namespace_name, NVS_NS_NAME_MAX_SIZE - 1);
+    it->index = index;
+    *out = it;
+    return ESP_OK;
+}
+
+esp_err_t nvs_entry_next(nvs_iterator_t *it) {
+    pthread_mutex_lock(&lock);
+    int index = next_in_namespace((*it)->namespace_name, (*it)->index + 1);
+    pthread_mutex_unlock(&lock);
+    if (index < 0) {
+        free(*it);
+        *it = NULL;
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    (*it)->index = index;
+    return ESP_OK;
+}
+
+esp_err_t nvs_entry_info(nvs_iterator_t it, nvs_entry_info_t *out_info) {
+    pthread_mutex_lock(&lock);
+    strcpy(out_info->namespace_name, entries[it->index].namespace_name);
+    strcpy(out_info->key, entries[it->index].key);
+    out_info->type = NVS_TYPE_BLOB;
+    pthread_mutex_unlock(&lock);
+    return ESP_OK;
+}
+
+void nvs_release_iterator(nvs_iterator_t it) {
+    free(it);
+}
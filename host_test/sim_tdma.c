@@ -0,0 +1,307 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_util.h"
+#include "slot_scheduler.h"
+
+// ===== 시뮬레이션 설정 =====
+// 이산 사건 시뮬레이션: 비콘 N 개가 5초 주기로 깨어나 부팅 → 스캔 → 앵커별 FTM → 전송을 하고,
+// 게이트웨이는 실제 slot_scheduler 로 슬롯을 배정, 비콘은 duty_cycle_align_slot 과 같은 방식으로 데드라인을 맞춤
+// 충돌: 같은 앵커에 대한 FTM 세션이 시간상 겹치거나, ESP-NOW 전송 구간이 겹침
+// 충돌해도 타임라인은 바꾸지 않음 (재시도로 길어지는 2차 효과는 무시한 1차 추정)
+#define SIM_PERIOD_MS 5000                  // 비콘 주기 (움직이는 비콘, DUTY_MIN_INTERVAL_SEC)
+#define SIM_DURATION_MS 900000              // 시뮬레이션 길이 (15분)
+#define SIM_WARMUP_MS 120000                // 슬롯 배정이 자리 잡을 때까지 집계에서 빼는 시간
+#define SIM_ANCHORS 6                       // 앵커 (FTM 응답기) 수
+#define SIM_ANCHORS_PER_BEACON 3            // 비콘 하나가 측정하는 앵커 수
+#define SIM_MAX_BEACONS 128
+#define SIM_RTC_DRIFT_PPM 150               // RTC 저속 클럭 오차 최대값 (비콘마다 고정, ±)
+#define SIM_DUTY_MIN_SLEEP_MS 100           // DUTY_MIN_SLEEP_MS
+
+// 깨어남 타임라인 (ms, 실측 프로파일 규모)
+#define SIM_BOOT_MS 250                     // 부팅 + NVS + Wi-Fi 초기화
+#define SIM_BOOT_JITTER_MS 60
+#define SIM_SCAN_MS 120
+#define SIM_SCAN_JITTER_MS 60
+#define SIM_FTM_SESSION_MS 250              // 16 프레임 세션 하나 (버스트 주기 200ms)
+#define SIM_FTM_SESSION_JITTER_MS 80
+#define SIM_FTM_EXTRA_SESSION_PROB 25       // 신뢰구간이 넓어 세션을 추가할 확률 (%, 세션마다, 최대 4세션)
+#define SIM_FTM_TIMEOUT_PROB 2              // 세션이 리포트 없이 타임아웃될 확률 (%)
+#define SIM_FTM_TIMEOUT_MS 4000             // FTM_SESSION_TIMEOUT_MS
+#define SIM_FLOOR_WAIT_MS 80
+#define SIM_SEND_MS 8                       // ESP-NOW 전송 (공중 구간 + ACK)
+#define SIM_SLOT_REPLY_MS 30                // SLOT_REPLY_TIMEOUT_MS
+
+#define SIM_MAX_INTERVALS 400000
+#define SIM_TRIALS 10                       // 비콘 수마다 반복 (초기 위상에 따른 편차 평균)
+#define SIM_SATURATED_PCT 90.0              // 슬롯 없음 충돌률이 이 이상이면 배치로 줄일 여지가 없는 포화로 봄
+
+typedef enum {
+    MODE_UNSLOTTED,                         // 슬롯 없음 (무작위 위상, 각자 주기)
+    MODE_FIXED_100MS,                       // 이전 방식 (프로파일 미반영, 100ms 슬롯 50개)
+    MODE_MEASURED,                          // 깨어남 프로파일로 슬롯 길이 결정
+    MODE_COUNT
+} sim_mode_t;
+
+static const char *const mode_names[MODE_COUNT] = {"슬롯 없음", "100ms 고정", "측정 기반"};
+
+// 무선 점유 구간 (resource: 0..SIM_ANCHORS-1 = 앵커 FTM, SIM_ANCHORS = ESP-NOW 전송)
+typedef struct {
+    int64_t start;
+    int64_t end;
+    int32_t wake;                           // 깨어남 번호
+    uint8_t resource;
+} interval_t;
+
+typedef struct {
+    char serial[SWIFT_SERIAL_MAX_LEN + 1];
+    int64_t next_wake_ms;                   // 다음 깨어남 데드라인 (게이트웨이 시계 기준)
+    int32_t drift_ppm;
+    uint8_t anchors[SIM_ANCHORS_PER_BEACON];
+} sim_beacon_t;
+
+static interval_t s_intervals[SIM_MAX_INTERVALS];
+static int s_interval_count;
+static bool s_wake_collided[SIM_MAX_INTERVALS];
+static bool s_wake_counted[SIM_MAX_INTERVALS];
+static int s_wake_count;
+
+// 시뮬레이션 결과
+typedef struct {
+    int wakes;                              // 집계한 깨어남 수
+    int collided;                           // 충돌이 하나라도 있던 깨어남 수
+    int slot_count;                         // 마지막 슬롯 수 (슬롯 없음은 0)
+    int slot_ms;
+    int wake_p90_ms;
+} sim_result_t;
+
+
+// ===== 타임라인 =====
+
+static int jitter(uint32_t *rng, int max_ms) {
+    return max_ms > 0 ? (int)(bench_rand(rng) % (uint32_t)(max_ms + 1)) : 0;
+}
+
+static void add_interval(int64_t start, int64_t end, int wake, uint8_t resource) {
+    if (s_interval_count < SIM_MAX_INTERVALS) {
+        s_intervals[s_interval_count++] = (interval_t){start, end, wake, resource};
+    }
+}
+
+// 깨어남 하나의 무선 구간을 기록하고 단계별 시간을 프로파일로 채움, 전송 완료 시각 반환
+static int64_t run_wake(const sim_beacon_t *beacon, int64_t start_ms, int wake, uint32_t *rng,
+                        swift_profile_t *profile) {
+    memset(profile, 0, sizeof(*profile));
+    profile->cycles = 1;
+    int64_t t = start_ms;
+
+    int boot = SIM_BOOT_MS + jitter(rng, SIM_BOOT_JITTER_MS);
+    profile->phase_ms[SWIFT_PHASE_BOOT] = (uint16_t)boot;
+    t += boot;
+
+    int scan = SIM_SCAN_MS + jitter(rng, SIM_SCAN_JITTER_MS);
+    profile->phase_ms[SWIFT_PHASE_SCAN] = (uint16_t)scan;
+    t += scan;
+
+    int64_t ftm_start = t;
+    for (int a = 0; a < SIM_ANCHORS_PER_BEACON; a++) {
+        for (int session = 0; session < 4; session++) {
+            int duration = SIM_FTM_SESSION_MS + jitter(rng, SIM_FTM_SESSION_JITTER_MS);
+            if ((int)(bench_rand(rng) % 100) < SIM_FTM_TIMEOUT_PROB) {
+                duration = SIM_FTM_TIMEOUT_MS;
+            }
+            add_interval(t, t + duration, wake, beacon->anchors[a]);
+            t += duration;
+            if ((int)(bench_rand(rng) % 100) >= SIM_FTM_EXTRA_SESSION_PROB) {
+                break;
+            }
+        }
+    }
+    profile->phase_ms[SWIFT_PHASE_FTM] = (uint16_t)(t - ftm_start);
+
+    profile->phase_ms[SWIFT_PHASE_FLOOR_WAIT] = SIM_FLOOR_WAIT_MS;
+    t += SIM_FLOOR_WAIT_MS;
+
+    add_interval(t, t + SIM_SEND_MS, wake, SIM_ANCHORS);
+    t += SIM_SEND_MS;
+    profile->phase_ms[SWIFT_PHASE_SEND] = SIM_SEND_MS + SIM_SLOT_REPLY_MS;
+    return t;
+}
+
+// 배정 슬롯에 데드라인 맞춤 (duty_cycle_align_slot 과 같은 계산, received_age = 0)
+static int64_t align_to_slot(const swift_slot_assignment_t *assignment, int64_t now_ms) {
+    int64_t slot_start = now_ms + assignment->offset_ms;
+    while (slot_start > now_ms) {
+        slot_start -= assignment->superframe_ms;
+    }
+    return slot_start;
+}
+
+// 다음 데드라인 (duty_cycle_sleep 과 같이 예정 시각에 주기를 더하고, 너무 가까우면 다음 주기로)
+static int64_t next_deadline(int64_t deadline_ms, int64_t now_ms) {
+    int64_t next = deadline_ms + SIM_PERIOD_MS;
+    while (next < now_ms + SIM_DUTY_MIN_SLEEP_MS) {
+        next += SIM_PERIOD_MS;
+    }
+    return next;
+}
+
+
+// ===== 충돌 판정 =====
+
+static int compare_intervals(const void *a, const void *b) {
+    const interval_t *x = a, *y = b;
+    if (x->resource != y->resource) {
+        return x->resource - y->resource;
+    }
+    return (x->start > y->start) - (x->start < y->start);
+}
+
+// 같은 자원에서 겹치는 구간을 가진 깨어남 표시 (자원, 시작 시각 순으로 정렬 후 뒤쪽만 확인)
+static void mark_collisions(void) {
+    qsort(s_intervals, (size_t)s_interval_count, sizeof(s_intervals[0]), compare_intervals);
+    for (int i = 0; i < s_interval_count; i++) {
+        const interval_t *a = &s_intervals[i];
+        for (int j = i + 1; j < s_interval_count; j++) {
+            const interval_t *b = &s_intervals[j];
+            if (b->resource != a->resource || b->start >= a->end) {
+                break;
+            }
+            if (b->wake != a->wake) {
+                s_wake_collided[a->wake] = true;
+                s_wake_collided[b->wake] = true;
+            }
+        }
+    }
+}
+
+
+// ===== 시뮬레이션 =====
+
+// 한 번 실행 (trial 마다 비콘 초기 위상, 앵커, RTC 오차가 다름, 같은 trial 은 모드가 달라도 같은 비콘 구성)
+static void simulate(sim_mode_t mode, int beacon_count, int trial, sim_result_t *result) {
+    static sim_beacon_t beacons[SIM_MAX_BEACONS];
+    uint32_t rng = 0x9E3779B9u ^ ((uint32_t)beacon_count * 2654435761u) ^ ((uint32_t)trial * 40503u);
+    for (int i = 0; i < 16; i++) {
+        bench_rand(&rng);                   // 작은 시드의 초기 출력 상관 제거
+    }
+    const int64_t epoch0 = 1760000000000LL + jitter(&rng, SIM_PERIOD_MS);
+
+    slot_scheduler_init();
+    s_interval_count = 0;
+    s_wake_count = 0;
+    memset(s_wake_collided, 0, sizeof(s_wake_collided));
+
+    for (int b = 0; b < beacon_count; b++) {
+        sim_beacon_t *beacon = &beacons[b];
+        snprintf(beacon->serial, sizeof(beacon->serial), "S-%03d", b + 1);
+        beacon->next_wake_ms = epoch0 + jitter(&rng, SIM_PERIOD_MS);
+        beacon->drift_ppm = jitter(&rng, 2 * SIM_RTC_DRIFT_PPM) - SIM_RTC_DRIFT_PPM;
+        // 앵커 SIM_ANCHORS 개 중 서로 다른 SIM_ANCHORS_PER_BEACON 개 (거리순이라 비콘마다 순서가 다름)
+        uint8_t order[SIM_ANCHORS];
+        for (int a = 0; a < SIM_ANCHORS; a++) {
+            order[a] = (uint8_t)a;
+        }
+        for (int a = SIM_ANCHORS - 1; a > 0; a--) {
+            int k = jitter(&rng, a);
+            uint8_t tmp = order[a];
+            order[a] = order[k];
+            order[k] = tmp;
+        }
+        memcpy(beacon->anchors, order, SIM_ANCHORS_PER_BEACON);
+    }
+
+    // 가장 이른 데드라인의 비콘부터 깨어남 처리 (전송 시각 순서가 조금 바뀌어도 배정 결과에는 영향 없음)
+    while (true) {
+        sim_beacon_t *beacon = NULL;
+        for (int b = 0; b < beacon_count; b++) {
+            if (beacon == NULL || beacons[b].next_wake_ms < beacon->next_wake_ms) {
+                beacon = &beacons[b];
+            }
+        }
+        int64_t deadline = beacon->next_wake_ms;
+        if (deadline - epoch0 >= SIM_DURATION_MS || s_wake_count >= SIM_MAX_INTERVALS) {
+            break;
+        }
+
+        // RTC 오차만큼 실제 깨어나는 시각이 어긋남 (슬롯 배정을 받을 때마다 다시 맞춤)
+        int64_t wake_ms = deadline + (SIM_PERIOD_MS * (int64_t)beacon->drift_ppm) / 1000000;
+        int wake = s_wake_count++;
+        s_wake_counted[wake] = wake_ms - epoch0 >= SIM_WARMUP_MS;
+        swift_profile_t profile;
+        int64_t sent_ms = run_wake(beacon, wake_ms, wake, &rng, &profile);
+
+        if (mode != MODE_UNSLOTTED) {
+            slot_scheduler_note_report(sent_ms);
+            if (mode == MODE_MEASURED) {
+                slot_scheduler_note_wake(&profile, sent_ms);
+            }
+            swift_slot_assignment_t assignment;
+            slot_scheduler_assign(beacon->serial, sent_ms, &assignment);
+            deadline = align_to_slot(&assignment, sent_ms);
+        } else {
+            deadline = wake_ms;
+        }
+        beacon->next_wake_ms = next_deadline(deadline, sent_ms + SIM_SLOT_REPLY_MS);
+    }
+
+    mark_collisions();
+    memset(result, 0, sizeof(*result));
+    for (int w = 0; w < s_wake_count; w++) {
+        if (s_wake_counted[w]) {
+            result->wakes++;
+            result->collided += s_wake_collided[w] ? 1 : 0;
+        }
+    }
+    if (mode != MODE_UNSLOTTED) {
+        slot_scheduler_stats_t stats;
+        slot_scheduler_get_stats(&stats);
+        result->slot_count = stats.slot_count;
+        result->slot_ms = stats.slot_ms;
+        result->wake_p90_ms = stats.wake_ms;
+    }
+}
+
+int main(void) {
+    static const int beacon_counts[] = {2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+    printf("TDMA 충돌 시뮬레이션: 주기 %dms, 앵커 %d개 (비콘당 %d개), %d분 (앞 %d초 제외)\n",
+           SIM_PERIOD_MS, SIM_ANCHORS, SIM_ANCHORS_PER_BEACON, SIM_DURATION_MS / 60000, SIM_WARMUP_MS / 1000);
+    printf("충돌: 같은 앵커에 FTM 세션이 겹치거나 ESP-NOW 전송이 겹친 깨어남 비율 (%d회 평균, 슬롯은 마지막 회)\n\n", SIM_TRIALS);
+    printf("%8s", "beacons");
+    for (int m = 0; m < MODE_COUNT; m++) {
+        printf(" %12s", mode_names[m]);
+    }
+    printf("   측정 기반 슬롯\n");
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(beacon_counts) / sizeof(beacon_counts[0]); i++) {
+        int n = beacon_counts[i];
+        sim_result_t results[MODE_COUNT] = {0};
+        printf("%8d", n);
+        for (int m = 0; m < MODE_COUNT; m++) {
+            for (int trial = 0; trial < SIM_TRIALS; trial++) {
+                sim_result_t one;
+                simulate((sim_mode_t)m, n, trial, &one);
+                results[m].wakes += one.wakes;
+                results[m].collided += one.collided;
+                results[m].slot_count = one.slot_count;
+                results[m].slot_ms = one.slot_ms;
+                results[m].wake_p90_ms = one.wake_p90_ms;
+            }
+            printf(" %11.1f%%", 100.0 * results[m].collided / results[m].wakes);
+        }
+        const sim_result_t *measured = &results[MODE_MEASURED];
+        printf("   %d x %dms (깨어남 p90 %dms)\n", measured->slot_count, measured->slot_ms, measured->wake_p90_ms);
+
+        // 포화 전 (슬롯 없음 충돌률 SIM_SATURATED_PCT 미만) 에는 측정 기반 슬롯이 슬롯 없음보다 충돌이 적어야 함
+        double unslotted_pct = 100.0 * results[MODE_UNSLOTTED].collided / results[MODE_UNSLOTTED].wakes;
+        double measured_pct = 100.0 * measured->collided / measured->wakes;
+        if (unslotted_pct < SIM_SATURATED_PCT && measured_pct >= unslotted_pct) {
+            printf("  → 비콘 %d개: 측정 기반 슬롯이 슬롯 없음보다 충돌이 많음\n", n);
+            failures++;
+        }
+    }
+    return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#include <string.h>
+#include "anchor_registry.h"
+#include "test_util.h"
+
+// ===== 도우미 =====
+// 저장소는 shim/nvs_mem.c (프로세스 메모리)
+
+static void make_mac(uint8_t id, uint8_t *mac) {
+    const uint8_t base[6] = {0x02, 'T', 'S', 0x00, 0x00, id};
+    memcpy(mac, base, 6);
+}
+
+// 앵커 id 의 gen 번째 좌표 (세 값이 같고 1000 으로 나눈 몫이 id)
+static anchor_position_t make_position(uint8_t id, uint32_t gen) {
+    float v = (float)(id * 1000u + gen % 1000u);
+    anchor_position_t position = {v, v, v};
+    return position;
+}
+
+static void clear_registry(void) {
+    uint8_t mac[6];
+    anchor_position_t position;
+    while (anchor_registry_get(0, mac, &position)) {
+        CHECK_EQ_INT(anchor_registry_remove(mac), ESP_OK);
+    }
+}
+
+
+// ===== 테스트 =====
+
+// 등록, 복사 조회, 갱신, 삭제 후 나머지 유지, 목록, NVS 다시 로드
+static void test_set_lookup_remove(void) {
+    clear_registry();
+    uint8_t mac[6];
+    anchor_position_t position;
+
+    for (uint8_t id = 0; id < 3; id++) {
+        make_mac(id, mac);
+        position = make_position(id, 1);
+        CHECK_EQ_INT(anchor_registry_set(mac, &position), ESP_OK);
+    }
+    CHECK_EQ_INT(anchor_registry_count(), 3);
+
+    make_mac(1, mac);
+    CHECK(anchor_registry_lookup(mac, &position));
+    CHECK_NEAR(position.x, 1001.0, 0.0);
+
+    // 갱신은 개수를 늘리지 않음
+    position = make_position(1, 2);
+    CHECK_EQ_INT(anchor_registry_set(mac, &position), ESP_OK);
+    CHECK_EQ_INT(anchor_registry_count(), 3);
+    CHECK(anchor_registry_lookup(mac, &position));
+    CHECK_NEAR(position.y, 1002.0, 0.0);
+
+    // 가운데 삭제: 나머지는 그대로 조회됨
+    make_mac(0, mac);
+    CHECK_EQ_INT(anchor_registry_remove(mac), ESP_OK);
+    CHECK_EQ_INT(anchor_registry_remove(mac), ESP_ERR_NOT_FOUND);
+    CHECK(!anchor_registry_lookup(mac, &position));
+    CHECK_EQ_INT(anchor_registry_count(), 2);
+    for (uint8_t id = 1; id < 3; id++) {
+        make_mac(id, mac);
+        CHECK(anchor_registry_lookup(mac, &position));
+        CHECK_EQ_INT((int)position.z / 1000, id);
+    }
+
+    uint8_t listed[6];
+    CHECK(anchor_registry_get(1, listed, &position));
+    CHECK(!anchor_registry_get(2, listed, &position));
+    CHECK(!anchor_registry_get(-1, listed, &position));
+
+    // NVS 에서 다시 로드해도 같은 내용
+    CHECK_EQ_INT(anchor_registry_load(), ESP_OK);
+    CHECK_EQ_INT(anchor_registry_count(), 2);
+    make_mac(1, mac);
+    CHECK(anchor_registry_lookup(mac, &position));
+    CHECK_NEAR(position.x, 1002.0, 0.0);
+    clear_registry();
+}
+
+
+int main(void) {
+    RUN_TEST(test_set_lookup_remove);
+    return test_finish();
+}
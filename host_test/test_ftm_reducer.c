@@ -0,0 +1,301 @@
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bench_util.h"
+#include "ftm_reducer.h"
+#include "test_util.h"
+
+// ftm_reducer.c 와 같은 환산 (보정 후 m / ps)
+#define CALIBRATED_METERS_PER_PS (299792458.0 * 1e-12 / 2.0 * FTM_CALIBRATION_FACTOR)
+#define RANDOM_SESSIONS 200000
+
+// 보정 후 최소 거리에 해당하는 첫 유효 RTT (ftm_reducer.c 의 rtt_min_ps)
+static const uint32_t rtt_min_ps = (uint32_t)(FTM_DISTANCE_MIN_M / CALIBRATED_METERS_PER_PS) + 1;
+
+// ===== 도우미 =====
+
+// RTT 배열로 리포트 엔트리 채우기
+static void fill_entries(wifi_ftm_report_entry_t *entries, const uint32_t *rtt, int count) {
+    memset(entries, 0, sizeof(*entries) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        entries[i].rtt = rtt[i];
+    }
+}
+
+static int s_fence_ties = 0;                // IQR 경계에 정확히 걸린 샘플이 있어 유효 수가 달랐던 세션 수
+
+// 오름차순 비교 (qsort)
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 유효 샘플 중 IQR 경계 (Q1 - 1.5 IQR, Q3 + 1.5 IQR) 와 정확히 같은 값이 있는지 (정수 계산)
+// 기준 구현은 경계를 float 로 계산해 이런 샘플을 반올림에 따라 빼기도 함 (정수 구현은 항상 포함)
+static bool has_fence_tie(const wifi_ftm_report_entry_t *entries, int count) {
+    uint32_t rtt[FTM_REDUCER_MAX_SAMPLES];
+    int n = 0;
+    for (int i = 0; i < count && i < FTM_REDUCER_MAX_SAMPLES; i++) {
+        if (entries[i].rtt >= rtt_min_ps && entries[i].rtt >= FTM_RTT_MIN_PS && entries[i].rtt <= FTM_RTT_MAX_PS) {
+            rtt[n++] = entries[i].rtt;
+        }
+    }
+    if (n < FTM_MIN_VALID_SAMPLES) {
+        return false;
+    }
+    qsort(rtt, (size_t)n, sizeof(rtt[0]), compare_u32);
+    int64_t q1 = rtt[n / 4], q3 = rtt[(3 * n) / 4];
+    int64_t lower2 = 2 * q1 - 3 * (q3 - q1), upper2 = 2 * q3 + 3 * (q3 - q1);
+    for (int i = 0; i < n; i++) {
+        if (2 * (int64_t)rtt[i] == lower2 || 2 * (int64_t)rtt[i] == upper2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 정수 구현과 부동소수점 기준 구현의 결과 비교 (기준 구현의 float 반올림만큼 허용)
+// IQR 경계에 정확히 걸린 샘플 때문에 유효 수만 다르면 정수 구현이 그 샘플을 포함했는지 확인하고 집계
+// 같으면 true, 다르면 입력과 두 결과 출력
+static bool check_equivalent(const wifi_ftm_report_entry_t *entries, int count) {
+    ftm_reduce_result_t fast, ref;
+    memset(&fast, 0, sizeof(fast));
+    memset(&ref, 0, sizeof(ref));
+    esp_err_t fast_err = ftm_reduce(entries, count, &fast);
+    esp_err_t ref_err = ftm_reduce_reference(entries, count, &ref);
+
+    bool same = fast_err == ref_err;
+    if (same && fast_err == ESP_OK && fast.valid_count > ref.valid_count && has_fence_tie(entries, count)) {
+        s_fence_ties++;
+        return true;
+    }
+    if (same && fast_err == ESP_OK) {
+        same = fast.valid_count == ref.valid_count &&
+               fabsf(fast.distance - ref.distance) <= 1e-5f * ref.distance + 1e-6f &&
+               fabsf(fast.variance - ref.variance) <= 1e-3f * ref.variance + 1e-6f &&
+               (fast.rtt_ns > ref.rtt_ns ? fast.rtt_ns - ref.rtt_ns : ref.rtt_ns - fast.rtt_ns) <= 1;
+    }
+    if (!same) {
+        fprintf(stderr, "불일치 (count=%d): 정수 err=%d n=%d d=%.6f var=%.8f rtt=%u, 기준 err=%d n=%d d=%.6f var=%.8f rtt=%u\n  rtt:",
+                count, fast_err, fast.valid_count, fast.distance, fast.variance, (unsigned)fast.rtt_ns,
+                ref_err, ref.valid_count, ref.distance, ref.variance, (unsigned)ref.rtt_ns);
+        for (int i = 0; i < count; i++) {
+            fprintf(stderr, " %u", (unsigned)entries[i].rtt);
+        }
+        fprintf(stderr, "\n");
+    }
+    return same;
+}
+
+// 한 세션의 RTT 생성: 기준 거리 주변 잡음 + 다중경로 + 실패/범위 밖 엔트리
+static uint32_t random_rtt(uint32_t *rng, uint32_t base_ps, uint32_t spread_ps) {
+    uint32_t r = bench_rand(rng) % 100;
+    if (r < 3) {
+        return 0;                                           // 측정 실패
+    } else if (r < 4) {
+        return UINT32_MAX;
+    } else if (r < 6) {
+        return bench_rand(rng) % rtt_min_ps;                // 최소 거리 미만
+    } else if (r < 8) {
+        return FTM_RTT_MAX_PS + 1 + bench_rand(rng) % 100000;   // 최대 RTT 초과
+    } else if (r < 20) {
+        return base_ps + bench_rand(rng) % (8 * spread_ps + 1); // 다중경로로 길어진 프레임
+    }
+    uint32_t noise = bench_rand(rng) % (2 * spread_ps + 1);
+    return base_ps + noise > spread_ps ? base_ps + noise - spread_ps : rtt_min_ps;
+}
+
+
+// ===== 테스트 케이스 =====
+
+// 무작위 세션: 엔트리 수 0~64, 기준 거리와 잡음 폭도 무작위
+static void test_random_equivalence(void) {
+    uint32_t rng = 0xC0FFEE;
+    wifi_ftm_report_entry_t entries[FTM_REDUCER_MAX_SAMPLES];
+    int mismatches = 0;
+    for (int session = 0; session < RANDOM_SESSIONS && mismatches < 5; session++) {
+        int count = (int)(bench_rand(&rng) % (FTM_REDUCER_MAX_SAMPLES + 1));
+        uint32_t base_ps = rtt_min_ps + bench_rand(&rng) % (FTM_RTT_MAX_PS - rtt_min_ps);
+        uint32_t spread_ps = 1 + bench_rand(&rng) % 20000;
+        uint32_t rtt[FTM_REDUCER_MAX_SAMPLES];
+        for (int i = 0; i < count; i++) {
+            rtt[i] = random_rtt(&rng, base_ps, spread_ps);
+        }
+        fill_entries(entries, rtt, count);
+        if (!check_equivalent(entries, count)) {
+            mismatches++;
+        }
+    }
+    CHECK_EQ_INT(mismatches, 0);
+    printf("  세션 %d개, IQR 경계 동률로 기준 구현과 유효 수가 다른 세션 %d개\n", RANDOM_SESSIONS, s_fence_ties);
+}
+
+// 중복이 많은 세션: 서너 개 값만 반복 (IQR 이 0 이 되거나 사분위가 중복 값에 걸리는 경우)
+static void test_duplicate_heavy(void) {
+    uint32_t rng = 0xD0D0;
+    wifi_ftm_report_entry_t entries[FTM_REDUCER_MAX_SAMPLES];
+    int mismatches = 0;
+    for (int session = 0; session < RANDOM_SESSIONS / 4 && mismatches < 5; session++) {
+        int count = 1 + (int)(bench_rand(&rng) % FTM_REDUCER_MAX_SAMPLES);
+        uint32_t values[4];
+        int distinct = 1 + (int)(bench_rand(&rng) % 4);
+        uint32_t base_ps = rtt_min_ps + bench_rand(&rng) % (FTM_RTT_MAX_PS / 2);
+        for (int v = 0; v < distinct; v++) {
+            values[v] = base_ps + bench_rand(&rng) % 3000;
+        }
+        uint32_t rtt[FTM_REDUCER_MAX_SAMPLES];
+        for (int i = 0; i < count; i++) {
+            // 첫 값에 몰리도록 (절반 이상이 같은 값)
+            rtt[i] = (bench_rand(&rng) % 2) ? values[0] : values[bench_rand(&rng) % distinct];
+        }
+        fill_entries(entries, rtt, count);
+        if (!check_equivalent(entries, count)) {
+            mismatches++;
+        }
+    }
+    CHECK_EQ_INT(mismatches, 0);
+
+    // 모두 같은 값: 분산 0, 전부 유효
+    uint32_t same[16];
+    for (int i = 0; i < 16; i++) {
+        same[i] = 20000;
+    }
+    fill_entries(entries, same, 16);
+    ftm_reduce_result_t out;
+    CHECK_EQ_INT(ftm_reduce(entries, 16, &out), ESP_OK);
+    CHECK_EQ_INT(out.valid_count, 16);
+    CHECK_NEAR(out.variance, 0.0, 1e-12);
+    CHECK(check_equivalent(entries, 16));
+}
+
+// 범위 경계: rtt_min_ps 는 포함, 바로 아래는 제외 / FTM_RTT_MAX_PS 는 포함, 바로 위는 제외
+static void test_range_edges(void) {
+    wifi_ftm_report_entry_t entries[4];
+    ftm_reduce_result_t out;
+    CHECK_NEAR(rtt_min_ps * CALIBRATED_METERS_PER_PS, FTM_DISTANCE_MIN_M, CALIBRATED_METERS_PER_PS);
+
+    const uint32_t cases[][2] = {       // {RTT, 유효하면 1}
+        {rtt_min_ps - 1, 0}, {rtt_min_ps, 1}, {rtt_min_ps + 1, 1},
+        {FTM_RTT_MIN_PS - 1, 0}, {FTM_RTT_MAX_PS, 1}, {FTM_RTT_MAX_PS + 1, 0},
+        {0, 0}, {UINT32_MAX, 0},
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        fill_entries(entries, &cases[c][0], 1);
+        CHECK_EQ_INT(ftm_reduce(entries, 1, &out), cases[c][1] ? ESP_OK : ESP_ERR_NOT_FOUND);
+        CHECK(check_equivalent(entries, 1));
+    }
+
+    // 경계 값이 섞인 세션에서 범위 밖 값만 빠짐
+    const uint32_t mixed[4] = {rtt_min_ps - 1, rtt_min_ps, rtt_min_ps + 2, FTM_RTT_MAX_PS + 1};
+    fill_entries(entries, mixed, 4);
+    CHECK_EQ_INT(ftm_reduce(entries, 4, &out), ESP_OK);
+    CHECK_EQ_INT(out.valid_count, 2);
+    CHECK_NEAR(out.distance, (rtt_min_ps + 1) * CALIBRATED_METERS_PER_PS, 1e-6);
+    CHECK(check_equivalent(entries, 4));
+}
+
+// IQR 경계: 정렬 8개에서 Q1 = [2], Q3 = [6], 경계값 (Q3 + 1.5 IQR, Q1 - 1.5 IQR) 은 남고 1ps 밖은 제거
+static void test_iqr_edges(void) {
+    const uint32_t q1 = 20000, q3 = 20100;
+    const uint32_t upper = q3 + 3 * (q3 - q1) / 2;       // 20250
+    const uint32_t lower = q1 - 3 * (q3 - q1) / 2;       // 19850
+    const struct {
+        uint32_t rtt[8];
+        int valid;
+    } cases[] = {
+        {{q1, q1, q1, 20050, 20050, 20050, q3, upper}, 8},
+        {{q1, q1, q1, 20050, 20050, 20050, q3, upper + 1}, 7},
+        {{lower, q1, q1, 20050, 20050, 20050, q3, q3}, 8},
+        {{lower - 1, q1, q1, 20050, 20050, 20050, q3, q3}, 7},
+        {{lower - 1, q1, q1, 20050, 20050, 20050, q3, upper + 1}, 6},
+    };
+    wifi_ftm_report_entry_t entries[8];
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        // 입력 순서와 무관해야 하므로 뒤집어서 넣음
+        uint32_t reversed[8];
+        for (int i = 0; i < 8; i++) {
+            reversed[i] = cases[c].rtt[7 - i];
+        }
+        fill_entries(entries, reversed, 8);
+        ftm_reduce_result_t out;
+        CHECK_EQ_INT(ftm_reduce(entries, 8, &out), ESP_OK);
+        CHECK_EQ_INT(out.valid_count, cases[c].valid);
+        CHECK(check_equivalent(entries, 8));
+    }
+}
+
+// 짝수 개: 가운데 두 값의 평균 (홀수 ps 합도 반올림 없이)
+static void test_even_counts(void) {
+    wifi_ftm_report_entry_t entries[6];
+    ftm_reduce_result_t out;
+
+    const uint32_t two[2] = {30001, 30002};
+    fill_entries(entries, two, 2);
+    CHECK_EQ_INT(ftm_reduce(entries, 2, &out), ESP_OK);
+    CHECK_NEAR(out.distance, 30001.5 * CALIBRATED_METERS_PER_PS, 1e-6);
+    CHECK_NEAR(out.variance, 0.25 * CALIBRATED_METERS_PER_PS * CALIBRATED_METERS_PER_PS, 1e-12);
+    CHECK(check_equivalent(entries, 2));
+
+    const uint32_t six[6] = {40010, 40000, 40030, 40020, 40050, 40040};
+    fill_entries(entries, six, 6);
+    CHECK_EQ_INT(ftm_reduce(entries, 6, &out), ESP_OK);
+    CHECK_EQ_INT(out.valid_count, 6);
+    CHECK_NEAR(out.distance, 40025 * CALIBRATED_METERS_PER_PS, 1e-6);
+    CHECK_EQ_INT(out.rtt_ns, 40);
+    CHECK(check_equivalent(entries, 6));
+}
+
+// FTM_MIN_VALID_SAMPLES 미만: IQR 을 적용하지 않아 다중경로 값도 남지만 중앙값은 흔들리지 않음
+static void test_below_min_samples(void) {
+    wifi_ftm_report_entry_t entries[FTM_MIN_VALID_SAMPLES];
+    ftm_reduce_result_t out;
+    uint32_t rtt[FTM_MIN_VALID_SAMPLES] = {0};
+    for (int i = 0; i < FTM_MIN_VALID_SAMPLES - 1; i++) {
+        rtt[i] = 50000 + (uint32_t)i * 10;
+    }
+    rtt[FTM_MIN_VALID_SAMPLES - 2] = 250000;            // 다중경로
+
+    for (int count = 1; count < FTM_MIN_VALID_SAMPLES; count++) {
+        fill_entries(entries, rtt, count);
+        CHECK_EQ_INT(ftm_reduce(entries, count, &out), ESP_OK);
+        CHECK_EQ_INT(out.valid_count, count);
+        CHECK(check_equivalent(entries, count));
+    }
+    CHECK(out.distance < 50100 * CALIBRATED_METERS_PER_PS);
+
+    // 유효 샘플이 FTM_MIN_VALID_SAMPLES 개가 되면 같은 다중경로 값이 제거됨
+    rtt[FTM_MIN_VALID_SAMPLES - 1] = 50005;
+    fill_entries(entries, rtt, FTM_MIN_VALID_SAMPLES);
+    CHECK_EQ_INT(ftm_reduce(entries, FTM_MIN_VALID_SAMPLES, &out), ESP_OK);
+    CHECK_EQ_INT(out.valid_count, FTM_MIN_VALID_SAMPLES - 1);
+    CHECK(check_equivalent(entries, FTM_MIN_VALID_SAMPLES));
+
+    // 엔트리가 없거나 모두 무효
+    CHECK_EQ_INT(ftm_reduce(entries, 0, &out), ESP_ERR_NOT_FOUND);
+    CHECK(check_equivalent(entries, 0));
+}
+
+// 최대 엔트리 수 초과: 앞 FTM_REDUCER_MAX_SAMPLES 개만 사용 (스택 버퍼 밖을 쓰지 않음)
+static void test_over_capacity(void) {
+    wifi_ftm_report_entry_t entries[FTM_REDUCER_MAX_SAMPLES + 8];
+    uint32_t rtt[FTM_REDUCER_MAX_SAMPLES + 8];
+    for (int i = 0; i < FTM_REDUCER_MAX_SAMPLES + 8; i++) {
+        rtt[i] = i < FTM_REDUCER_MAX_SAMPLES ? 60000 : 300000;
+    }
+    fill_entries(entries, rtt, FTM_REDUCER_MAX_SAMPLES + 8);
+    ftm_reduce_result_t out;
+    CHECK_EQ_INT(ftm_reduce(entries, FTM_REDUCER_MAX_SAMPLES + 8, &out), ESP_OK);
+    CHECK_EQ_INT(out.valid_count, FTM_REDUCER_MAX_SAMPLES);
+    CHECK_NEAR(out.distance, 60000 * CALIBRATED_METERS_PER_PS, 1e-6);
+}
+
+int main(void) {
+    RUN_TEST(test_random_equivalence);
+    RUN_TEST(test_duplicate_heavy);
+    RUN_TEST(test_range_edges);
+    RUN_TEST(test_iqr_edges);
+    RUN_TEST(test_even_counts);
+    RUN_TEST(test_below_min_samples);
+    RUN_TEST(test_over_capacity);
+    return test_finish();
+}
@@ -0,0 +1,260 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "http_uplink.h"
+#include "test_util.h"
+
+// ===== 테스트 설정 =====
+// 실제 http_uplink.c 를 esp_http_client 대체(POSIX 소켓)로 같은 프로세스의 스텁 서버에 연결
+// http_uplink 는 프로세스에 하나뿐이므로 통계는 테스트 시작 시점과의 차이로 비교
+#define KEEPALIVE_REQUESTS 10               // 한 연결로 보내는 요청 수
+#define DROP_WAIT_MS 1000                   // 서버가 소켓을 닫을 때까지 대기 한도
+
+static const char s_body[] = "[{\"serialNumber\":\"SWB00001\"}]";
+
+// 다음 응답 뒤 서버 동작
+typedef enum {
+    SERVER_KEEP = 0,                        // Keep-Alive 유지
+    SERVER_DROP,                            // 평소처럼 응답한 뒤 알리지 않고 소켓을 닫음 (유휴 연결 정리 재현)
+    SERVER_CLOSE,                           // Connection: close 로 응답하고 닫음
+} server_action_t;
+
+
+// ===== 스텁 HTTP 서버 =====
+// 요청을 끝까지 읽고 빈 200 응답, 연결 수 / 요청 수 / 닫은 연결 수 집계
+
+static struct {
+    int listen_fd;
+    int port;
+    _Atomic int next_action;                // 다음 응답 뒤 동작 (적용 후 SERVER_KEEP)
+    _Atomic uint32_t connections;
+    _Atomic uint32_t requests;
+    _Atomic uint32_t closed;                // 서버 쪽에서 닫은 연결 수
+} server;
+
+// 헤더 끝 ("\r\n\r\n") 위치 (없으면 NULL)
+static char *find_header_end(char *buf, size_t len) {
+    for (size_t i = 0; i + 4 <= len; i++) {
+        if (memcmp(buf + i, "\r\n\r\n", 4) == 0) {
+            return buf + i;
+        }
+    }
+    return NULL;
+}
+
+// Content-Length 값 (대소문자 무시, 없으면 0)
+static size_t content_length(const char *headers) {
+    static const char name[] = "\r\nContent-Length:";
+    for (const char *p = headers; *p != '\0'; p++) {
+        if (strncasecmp(p, name, sizeof(name) - 1) == 0) {
+            return strtoul(p + sizeof(name) - 1, NULL, 10);
+        }
+    }
+    return 0;
+}
+
+// 연결 하나에서 요청을 차례로 처리 (클라이언트가 닫거나 서버가 닫기로 하면 반환)
+static void serve_connection(int fd) {
+    static char buf[4096];
+    size_t used = 0;
+
+    for (;;) {
+        char *end = NULL;
+        while ((end = find_header_end(buf, used)) == NULL) {
+            if (used == sizeof(buf)) {
+                return;
+            }
+            ssize_t n = recv(fd, buf + used, sizeof(buf) - used, 0);
+            if (n <= 0) {
+                return;
+            }
+            used += (size_t)n;
+        }
+
+        size_t header_len = (size_t)(end + 4 - buf);
+        end[2] = '\0';
+        size_t body_len = content_length(buf);
+        while (used < header_len + body_len) {
+            if (used == sizeof(buf)) {
+                return;
+            }
+            ssize_t n = recv(fd, buf + used, sizeof(buf) - used, 0);
+            if (n <= 0) {
+                return;
+            }
+            used += (size_t)n;
+        }
+        used -= header_len + body_len;
+        memmove(buf, buf + header_len + body_len, used);
+        atomic_fetch_add(&server.requests, 1);
+
+        server_action_t action = (server_action_t)atomic_exchange(&server.next_action, SERVER_KEEP);
+        char response[128];
+        int len = snprintf(response, sizeof(response),
+                           "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: %s\r\n\r\nok",
+                           action == SERVER_CLOSE ? "close" : "keep-alive");
+        if (send(fd, response, (size_t)len, MSG_NOSIGNAL) != len || action != SERVER_KEEP) {
+            return;
+        }
+    }
+}
+
+static void *server_thread(void *arg) {
+    for (;;) {
+        int fd = accept(server.listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        atomic_fetch_add(&server.connections, 1);
+        serve_connection(fd);
+        close(fd);
+        atomic_fetch_add(&server.closed, 1);
+    }
+    return NULL;
+}
+
+// 127.0.0.1 의 빈 포트에서 서버 시작
+static bool server_start(void) {
+    server.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    socklen_t addr_len = sizeof(addr);
+    if (server.listen_fd < 0 ||
+        bind(server.listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(server.listen_fd, 4) != 0 ||
+        getsockname(server.listen_fd, (struct sockaddr *)&addr, &addr_len) != 0) {
+        return false;
+    }
+    server.port = ntohs(addr.sin_port);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, server_thread, NULL) != 0) {
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+
+// ===== 도우미 =====
+
+static http_uplink_stats_t uplink_stats(void) {
+    http_uplink_stats_t stats;
+    http_uplink_get_stats(&stats);
+    return stats;
+}
+
+// POST 한 번, 상태 코드 확인
+static esp_err_t post(void) {
+    int status = 0;
+    esp_err_t err = http_uplink_post("application/json", s_body, sizeof(s_body) - 1, &status);
+    if (err == ESP_OK) {
+        CHECK_EQ_INT(status, 200);
+    }
+    return err;
+}
+
+// 서버가 closed 개째 연결을 닫을 때까지 대기
+static void wait_server_closed(uint32_t closed) {
+    for (int waited = 0; atomic_load(&server.closed) < closed && waited < DROP_WAIT_MS; waited++) {
+        usleep(1000);
+    }
+    CHECK_EQ_INT(atomic_load(&server.closed), closed);
+}
+
+
+// ===== 테스트 =====
+
+// Keep-Alive: N 개 요청이 연결 하나로 (새 연결 1, 재사용 N-1)
+static void test_keepalive_reuse(void) {
+    http_uplink_stats_t before = uplink_stats();
+    uint32_t connections_before = atomic_load(&server.connections);
+
+    for (int i = 0; i < KEEPALIVE_REQUESTS; i++) {
+        CHECK_EQ_INT(post(), ESP_OK);
+    }
+
+    http_uplink_stats_t after = uplink_stats();
+    CHECK_EQ_INT(after.requests - before.requests, KEEPALIVE_REQUESTS);
+    CHECK_EQ_INT(after.connects - before.connects, 1);
+    CHECK_EQ_INT(after.reused - before.reused, KEEPALIVE_REQUESTS - 1);
+    CHECK_EQ_INT(after.reconnects - before.reconnects, 0);
+    CHECK_EQ_INT(after.failures - before.failures, 0);
+    CHECK_EQ_INT(after.current_conn_requests, KEEPALIVE_REQUESTS);
+    CHECK(after.max_conn_requests >= KEEPALIVE_REQUESTS);
+    CHECK_EQ_INT(atomic_load(&server.connections) - connections_before, 1);
+}
+
+// 서버가 요청 사이에 소켓을 닫으면 다음 요청은 한 번만 투명하게 재연결해 성공
+static void test_server_drop_retries_once(void) {
+    CHECK_EQ_INT(post(), ESP_OK);               // 열린 연결 확보
+    http_uplink_stats_t before = uplink_stats();
+    uint32_t connections_before = atomic_load(&server.connections);
+    uint32_t requests_before = atomic_load(&server.requests);
+    uint32_t closed_before = atomic_load(&server.closed);
+
+    atomic_store(&server.next_action, SERVER_DROP);
+    CHECK_EQ_INT(post(), ESP_OK);
+    wait_server_closed(closed_before + 1);
+
+    // 클라이언트는 닫힌 줄 모르는 소켓으로 보냄 → 실패 → 재연결 후 재전송
+    CHECK_EQ_INT(post(), ESP_OK);
+
+    http_uplink_stats_t after = uplink_stats();
+    CHECK_EQ_INT(after.requests - before.requests, 2);
+    CHECK_EQ_INT(after.reused - before.reused, 1);
+    CHECK_EQ_INT(after.reconnects - before.reconnects, 1);
+    CHECK_EQ_INT(after.connects - before.connects, 1);
+    CHECK_EQ_INT(after.failures - before.failures, 0);
+    CHECK_EQ_INT(after.current_conn_requests, 1);
+    CHECK_EQ_INT(atomic_load(&server.connections) - connections_before, 1);
+    CHECK_EQ_INT(atomic_load(&server.requests) - requests_before, 2);
+
+    // 새 연결은 다시 재사용됨
+    CHECK_EQ_INT(post(), ESP_OK);
+    CHECK_EQ_INT(uplink_stats().reused - before.reused, 2);
+}
+
+// Connection: close 응답: 클라이언트가 바로 닫고 다음 요청은 재시도 없이 새 연결
+static void test_connection_close(void) {
+    CHECK_EQ_INT(post(), ESP_OK);
+    http_uplink_stats_t before = uplink_stats();
+    uint32_t connections_before = atomic_load(&server.connections);
+    uint32_t closed_before = atomic_load(&server.closed);
+
+    atomic_store(&server.next_action, SERVER_CLOSE);
+    CHECK_EQ_INT(post(), ESP_OK);
+    wait_server_closed(closed_before + 1);
+
+    CHECK_EQ_INT(post(), ESP_OK);
+    CHECK_EQ_INT(post(), ESP_OK);
+
+    http_uplink_stats_t after = uplink_stats();
+    CHECK_EQ_INT(after.requests - before.requests, 3);
+    CHECK_EQ_INT(after.connects - before.connects, 1);
+    CHECK_EQ_INT(after.reused - before.reused, 2);
+    CHECK_EQ_INT(after.reconnects - before.reconnects, 0);
+    CHECK_EQ_INT(after.failures - before.failures, 0);
+    CHECK_EQ_INT(atomic_load(&server.connections) - connections_before, 1);
+}
+
+int main(void) {
+    if (!server_start()) {
+        fprintf(stderr, "스텁 서버 시작 실패\n");
+        return EXIT_FAILURE;
+    }
+    static char url[64];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d/api/locations/calculate/batch", server.port);
+    CHECK_EQ_INT(http_uplink_init(url), ESP_OK);
+
+    RUN_TEST(test_keepalive_reuse);
+    RUN_TEST(test_server_drop_retries_once);
+    RUN_TEST(test_connection_close);
+    return test_finish();
+}
@@ -0,0 +1,217 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench_util.h"
+#include "ingest_ring.h"
+#include "test_util.h"
+
+// ===== 테스트 설정 =====
+// 소비자는 항상 메인 스레드 (ingest_ring 은 첫 peek 한 태스크를 소비자로 등록), 생산자는 pthread
+#define STRESS_FRAMES 500000                // 재시도 생산자가 넣는 프레임 수
+#define BURST_FRAMES 200000                 // 버스트 생산자가 시도하는 프레임 수
+#define PEEK_TIMEOUT_MS 2000                // 이 안에 프레임이 안 오면 알림 유실로 봄
+
+// 생산자 스레드 상태 (결과는 join 후 메인 스레드에서 확인)
+typedef struct {
+    int frames;                             // 넣을(시도할) 프레임 수
+    bool retry;                             // 가득 차면 다시 시도 (false 면 실제 수신 콜백처럼 버림)
+    uint32_t seed;
+    atomic_uint consumed;                   // 소비자가 반납한 프레임 수 (소비자가 갱신)
+    uint32_t accepted;                      // push 성공 수
+    uint32_t rejected;                      // push 실패 수
+    uint32_t early_rejects;                 // 들어 있는 프레임이 슬롯 수보다 적은데 실패한 수 (있으면 안 됨)
+    atomic_bool done;
+} producer_t;
+
+
+// ===== 도우미 =====
+
+// 순번으로 프레임 생성 (앞 4바이트 순번, 길이와 내용은 순번에서 결정)
+static size_t make_frame(uint32_t seq, uint8_t *buf) {
+    size_t len = 4 + seq % (SWIFT_FRAME_MAX_SIZE - 3);
+    memcpy(buf, &seq, sizeof(seq));
+    for (size_t i = 4; i < len; i++) {
+        buf[i] = (uint8_t)(seq * 31u + i);
+    }
+    return len;
+}
+
+// 슬롯 내용이 순번의 프레임과 같은지
+static bool frame_matches(const ingest_frame_t *frame, uint32_t seq) {
+    uint8_t expected[SWIFT_FRAME_MAX_SIZE];
+    size_t len = make_frame(seq, expected);
+    return frame->len == len && memcmp(frame->data, expected, len) == 0;
+}
+
+// 프레임 순번 읽기
+static uint32_t frame_seq(const ingest_frame_t *frame) {
+    uint32_t seq;
+    memcpy(&seq, frame->data, sizeof(seq));
+    return seq;
+}
+
+// 생산자: 순번 0 부터 frames 개 시도 (버스트 모드는 무작위 길이 버스트 사이에 쉼)
+static void *producer_main(void *arg) {
+    producer_t *p = arg;
+    uint8_t buf[SWIFT_FRAME_MAX_SIZE];
+    uint32_t rng = p->seed;
+    int burst_left = 0;
+    for (int i = 0; i < p->frames; i++) {
+        if (!p->retry && burst_left-- <= 0) {
+            burst_left = (int)(bench_rand(&rng) % (2 * INGEST_RING_SLOTS));
+            usleep(bench_rand(&rng) % 300);
+        }
+        size_t len = make_frame((uint32_t)i, buf);
+        while (true) {
+            // 실패하면 그 시점에 반납되지 않은 프레임이 슬롯 수 이상이어야 함 (consumed 는 실제 반납보다 늦게 늘어남)
+            uint32_t consumed = atomic_load(&p->consumed);
+            if (ingest_ring_push(buf, len)) {
+                p->accepted++;
+                break;
+            }
+            p->rejected++;
+            if (p->accepted - consumed < INGEST_RING_SLOTS) {
+                p->early_rejects++;
+            }
+            if (!p->retry) {
+                break;
+            }
+            sched_yield();
+        }
+    }
+    atomic_store(&p->done, true);
+    return NULL;
+}
+
+// 소비자: 생산자가 끝나고 링이 빌 때까지 꺼내며 순서와 내용 확인, 가끔 늦게 반납해 링을 채움
+// 반환: 꺼낸 프레임 수
+static uint32_t consume_all(producer_t *p, bool require_contiguous, int *order_errors, int *content_errors,
+                            int *lost_wakeups) {
+    uint32_t count = 0;
+    int64_t last_seq = -1;
+    uint32_t rng = p->seed ^ 0xABCDu;
+    while (true) {
+        const ingest_frame_t *frame = ingest_ring_peek(atomic_load(&p->done) ? 0 : pdMS_TO_TICKS(PEEK_TIMEOUT_MS));
+        if (frame == NULL) {
+            if (atomic_load(&p->done)) {
+                // 완료 표시 후 마지막 게시를 한 번 더 확인
+                frame = ingest_ring_peek(0);
+                if (frame == NULL) {
+                    break;
+                }
+            } else {
+                (*lost_wakeups)++;
+                continue;
+            }
+        }
+        uint32_t seq = frame_seq(frame);
+        if ((int64_t)seq <= last_seq || (require_contiguous && (int64_t)seq != last_seq + 1)) {
+            (*order_errors)++;
+        }
+        if (!frame_matches(frame, seq)) {
+            (*content_errors)++;
+        }
+        last_seq = seq;
+        if (bench_rand(&rng) % 4096 == 0) {
+            usleep(200);                    // 반납 지연 (생산자가 가득 찬 링을 만나게)
+        }
+        ingest_ring_release();
+        atomic_fetch_add(&p->consumed, 1);
+        count++;
+    }
+    return count;
+}
+
+
+// ===== 테스트 케이스 =====
+
+// 단일 스레드: 용량까지 순서대로 들어가고 그 다음은 거절, 통계 확인
+static void test_capacity_and_order(void) {
+    uint8_t buf[SWIFT_FRAME_MAX_SIZE];
+    ingest_ring_stats_t before, after;
+    ingest_ring_get_stats(&before);
+
+    for (uint32_t seq = 0; seq < INGEST_RING_SLOTS; seq++) {
+        CHECK(ingest_ring_push(buf, make_frame(seq, buf)));
+    }
+    CHECK(!ingest_ring_push(buf, make_frame(99, buf)));
+
+    uint8_t oversized[SWIFT_FRAME_MAX_SIZE + 1] = {0};
+    CHECK(!ingest_ring_push(oversized, sizeof(oversized)));
+
+    for (uint32_t seq = 0; seq < INGEST_RING_SLOTS; seq++) {
+        const ingest_frame_t *frame = ingest_ring_peek(0);
+        CHECK(frame != NULL);
+        if (frame != NULL) {
+            CHECK_EQ_INT(frame_seq(frame), seq);
+            CHECK(frame_matches(frame, seq));
+            ingest_ring_release();
+        }
+    }
+    CHECK(ingest_ring_peek(0) == NULL);
+
+    ingest_ring_get_stats(&after);
+    CHECK_EQ_INT(after.received - before.received, INGEST_RING_SLOTS);
+    CHECK_EQ_INT(after.dropped - before.dropped, 1);
+    CHECK_EQ_INT(after.high_water, INGEST_RING_SLOTS);
+}
+
+// 빈 링에서 타임아웃 동안 기다린 뒤 NULL
+static void test_peek_timeout(void) {
+    uint64_t t0 = bench_now_ns();
+    CHECK(ingest_ring_peek(pdMS_TO_TICKS(20)) == NULL);
+    uint64_t waited_ms = (bench_now_ns() - t0) / 1000000;
+    CHECK(waited_ms >= 15);
+}
+
+// 재시도 생산자: 용량 미만에서는 절대 거절되지 않고, 모든 프레임이 순서대로 한 번씩 내용 그대로 도착
+static void test_stress_no_loss(void) {
+    producer_t p = {.frames = STRESS_FRAMES, .retry = true, .seed = 0x51};
+    int order_errors = 0, content_errors = 0, lost_wakeups = 0;
+    pthread_t thread;
+    CHECK_EQ_INT(pthread_create(&thread, NULL, producer_main, &p), 0);
+    uint32_t consumed = consume_all(&p, true, &order_errors, &content_errors, &lost_wakeups);
+    pthread_join(thread, NULL);
+
+    printf("  프레임 %d개, 가득 차 재시도 %u회\n", STRESS_FRAMES, (unsigned)p.rejected);
+    CHECK_EQ_INT(consumed, STRESS_FRAMES);
+    CHECK_EQ_INT(p.accepted, STRESS_FRAMES);
+    CHECK_EQ_INT(p.early_rejects, 0);
+    CHECK_EQ_INT(order_errors, 0);
+    CHECK_EQ_INT(content_errors, 0);
+    CHECK_EQ_INT(lost_wakeups, 0);
+}
+
+// 버스트 생산자 (실제 수신 콜백처럼 가득 차면 버림): 받은 프레임은 모두 순서대로 도착, 통계 합이 맞음
+static void test_stress_bursts(void) {
+    ingest_ring_stats_t before, after;
+    ingest_ring_get_stats(&before);
+    producer_t p = {.frames = BURST_FRAMES, .retry = false, .seed = 0x77};
+    int order_errors = 0, content_errors = 0, lost_wakeups = 0;
+    pthread_t thread;
+    CHECK_EQ_INT(pthread_create(&thread, NULL, producer_main, &p), 0);
+    uint32_t consumed = consume_all(&p, false, &order_errors, &content_errors, &lost_wakeups);
+    pthread_join(thread, NULL);
+    ingest_ring_get_stats(&after);
+
+    printf("  시도 %d개, 받음 %u, 버림 %u, 최고 수위 %u/%d\n", BURST_FRAMES, (unsigned)p.accepted,
+           (unsigned)p.rejected, (unsigned)after.high_water, INGEST_RING_SLOTS);
+    CHECK_EQ_INT(p.accepted + p.rejected, BURST_FRAMES);
+    CHECK_EQ_INT(consumed, p.accepted);
+    CHECK_EQ_INT(after.received - before.received, p.accepted);
+    CHECK_EQ_INT(after.dropped - before.dropped, p.rejected);
+    CHECK_EQ_INT(p.early_rejects, 0);
+    CHECK_EQ_INT(order_errors, 0);
+    CHECK_EQ_INT(content_errors, 0);
+    CHECK_EQ_INT(lost_wakeups, 0);
+}
+
+int main(void) {
+    RUN_TEST(test_capacity_and_order);
+    RUN_TEST(test_peek_timeout);
+    RUN_TEST(test_stress_no_loss);
+    RUN_TEST(test_stress_bursts);
+    return test_finish();
+}
@@ -0,0 +1,290 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+#include "file_flash.h"
+#include "mqtt_client_sim.h"
+#include "mqtt_uplink.h"
+#include "pipeline_metrics.h"
+#include "spool.h"
+#include "uploader.h"
+#include "test_util.h"
+
+// ===== 테스트 설정 =====
+// 실제 mqtt_uplink.c / uploader.c 를 같은 프로세스의 브로커 대체(shim/mqtt_client_sim.c)에 연결
+// mqtt_uplink 는 프로세스에 하나뿐이므로 각 테스트는 미확인 0 개로 끝내고 통계는 시작 시점과의 차이로 비교
+#define TEST_TOPIC "swift/test/beacon/SWB00001"
+#define CONNECT_TIMEOUT_MS 1000
+#define STALL_TIMEOUT_MS 50                 // 윈도우가 가득 찬 발행이 포기할 때까지 대기
+#define BLOCKED_PUBLISH_TIMEOUT_MS 2000     // PUBACK 을 기다리는 발행의 대기 한도
+#define SPOOL_IMAGE_PATH "test_mqtt_uplink_spool.img"
+#define SPOOL_SECTOR_SIZE 4096
+#define SPOOL_IMAGE_SECTORS 64              // 업로더의 SPOOL_RETENTION_SECTORS 와 같게
+#define LINK_UP_BIT BIT0
+#define BATCH_RECORDS 10                    // 한 배치로 묶일 만큼 빠르게 넣는 레코드 수
+#define FAIL_AFTER_PUBLISHES 3              // 배치 중 이만큼 발행한 뒤 한 건 실패
+#define BATCH_TIMEOUT_MS 2000
+#define REPLAY_TIMEOUT_MS 8000              // 업로더의 SPOOL_REPLAY_BACKOFF_MS(5 초) + 여유
+
+static const char s_payload[] = "{\"test\":1}";
+
+// 윈도우 대기 중인 발행 스레드
+typedef struct {
+    atomic_int result;                      // 결과 (끝나기 전에는 PUBLISH_PENDING)
+} blocked_publish_t;
+
+#define PUBLISH_PENDING 0x7FFFFFFF
+
+
+// ===== 도우미 =====
+
+static uint32_t now_ms(void) {
+    return xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+static mqtt_uplink_stats_t uplink_stats(void) {
+    mqtt_uplink_stats_t stats;
+    mqtt_uplink_get_stats(&stats);
+    return stats;
+}
+
+static mqtt_sim_stats_t sim_stats(void) {
+    mqtt_sim_stats_t stats;
+    mqtt_sim_get_stats(&stats);
+    return stats;
+}
+
+static uploader_stats_t upload_stats(void) {
+    uploader_stats_t stats;
+    uploader_get_stats(&stats);
+    return stats;
+}
+
+static esp_err_t publish(uint32_t timeout_ms) {
+    return mqtt_uplink_publish(TEST_TOPIC, s_payload, sizeof(s_payload) - 1, timeout_ms);
+}
+
+// n 개 발행, 성공한 수 반환
+static int publish_n(int n) {
+    int ok = 0;
+    for (int i = 0; i < n; i++) {
+        if (publish(STALL_TIMEOUT_MS) == ESP_OK) {
+            ok++;
+        }
+    }
+    return ok;
+}
+
+static void *blocked_publish_thread(void *arg) {
+    blocked_publish_t *bp = arg;
+    atomic_store(&bp->result, publish(BLOCKED_PUBLISH_TIMEOUT_MS));
+    return NULL;
+}
+
+// 업로더 스풀 파티션을 파일 이미지로 대체 (spool_partition.c 대신 링크)
+esp_err_t spool_flash_from_partition(const char *label, spool_flash_t *out) {
+    static file_flash_t flash;
+    return file_flash_create(&flash, SPOOL_IMAGE_PATH, SPOOL_SECTOR_SIZE * SPOOL_IMAGE_SECTORS,
+                             SPOOL_SECTOR_SIZE, out);
+}
+
+
+// ===== 테스트 =====
+
+// 연결 수립: start 후 브로커 대체 스레드의 CONNECTED 로 연결 상태가 됨
+static void test_connect(void) {
+    CHECK_EQ_INT(mqtt_uplink_publish(TEST_TOPIC, s_payload, 1, 0), ESP_ERR_INVALID_STATE);
+    CHECK_EQ_INT(mqtt_uplink_init("mqtt://127.0.0.1:1883", "test"), ESP_OK);
+
+    uint32_t start = now_ms();
+    while (!mqtt_uplink_is_connected() && now_ms() - start < CONNECT_TIMEOUT_MS) {
+        usleep(1000);
+    }
+    CHECK(mqtt_uplink_is_connected());
+    CHECK_EQ_INT(uplink_stats().connects, 1);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 0);
+}
+
+// 윈도우 상한: WINDOW 개까지는 바로, 그다음은 대기 (시간 초과 시 실패, PUBACK 이 오면 진행)
+static void test_window_cap(void) {
+    mqtt_uplink_stats_t before = uplink_stats();
+    uint32_t accepted_before = sim_stats().accepted;
+
+    CHECK_EQ_INT(publish_n(MQTT_UPLINK_WINDOW), MQTT_UPLINK_WINDOW);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), MQTT_UPLINK_WINDOW);
+    CHECK_EQ_INT(uplink_stats().window_stalls, before.window_stalls);
+    CHECK_EQ_INT(sim_stats().outstanding, MQTT_UPLINK_WINDOW);
+
+    // 윈도우가 가득 참: 대기 후 시간 초과, 브로커로는 보내지 않음
+    CHECK_EQ_INT(publish(STALL_TIMEOUT_MS), ESP_ERR_TIMEOUT);
+    CHECK_EQ_INT(uplink_stats().window_stalls, before.window_stalls + 1);
+    CHECK_EQ_INT(sim_stats().accepted - accepted_before, MQTT_UPLINK_WINDOW);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), MQTT_UPLINK_WINDOW);
+
+    // 대기 중인 발행은 PUBACK 한 건으로 풀림
+    blocked_publish_t bp = { .result = PUBLISH_PENDING };
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, blocked_publish_thread, &bp) == 0);
+    uint32_t start = now_ms();
+    while (uplink_stats().window_stalls < before.window_stalls + 2 && now_ms() - start < BLOCKED_PUBLISH_TIMEOUT_MS) {
+        usleep(1000);
+    }
+    CHECK_EQ_INT(uplink_stats().window_stalls, before.window_stalls + 2);
+    CHECK_EQ_INT(atomic_load(&bp.result), PUBLISH_PENDING);
+    CHECK_EQ_INT(mqtt_sim_ack(1), 1);
+    pthread_join(thread, NULL);
+    CHECK_EQ_INT(atomic_load(&bp.result), ESP_OK);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), MQTT_UPLINK_WINDOW);
+
+    mqtt_uplink_stats_t after = uplink_stats();
+    CHECK_EQ_INT(after.published - before.published, MQTT_UPLINK_WINDOW + 1);
+    CHECK_EQ_INT(after.max_in_flight, MQTT_UPLINK_WINDOW);
+
+    CHECK_EQ_INT(mqtt_sim_ack(MQTT_UPLINK_WINDOW), MQTT_UPLINK_WINDOW);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 0);
+    CHECK_EQ_INT(uplink_stats().acked - before.acked, MQTT_UPLINK_WINDOW + 1);
+}
+
+// PUBACK 없이 만료(DELETED)된 메시지도 윈도우 자리를 돌려줌
+static void test_deleted_releases_slot(void) {
+    mqtt_uplink_stats_t before = uplink_stats();
+
+    CHECK_EQ_INT(publish_n(MQTT_UPLINK_WINDOW), MQTT_UPLINK_WINDOW);
+    CHECK_EQ_INT(mqtt_sim_expire(3), 3);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), MQTT_UPLINK_WINDOW - 3);
+    CHECK_EQ_INT(uplink_stats().expired - before.expired, 3);
+
+    // 만료된 자리만큼은 대기 없이 발행
+    CHECK_EQ_INT(publish_n(3), 3);
+    CHECK_EQ_INT(uplink_stats().window_stalls, before.window_stalls);
+
+    CHECK_EQ_INT(mqtt_sim_expire(MQTT_UPLINK_WINDOW), MQTT_UPLINK_WINDOW);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 0);
+    CHECK_EQ_INT(uplink_stats().expired - before.expired, MQTT_UPLINK_WINDOW + 3);
+}
+
+// 발행 실패(-1)는 잡은 윈도우 자리를 돌려줌 (반복해도 새지 않음)
+static void test_publish_failure_no_leak(void) {
+    mqtt_uplink_stats_t before = uplink_stats();
+
+    for (int round = 0; round < MQTT_UPLINK_WINDOW * 2; round++) {
+        mqtt_sim_fail_publish_after(0);
+        CHECK_EQ_INT(publish(STALL_TIMEOUT_MS), ESP_FAIL);
+    }
+    CHECK_EQ_INT(uplink_stats().failures - before.failures, MQTT_UPLINK_WINDOW * 2);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 0);
+
+    // 윈도우 중간의 실패
+    mqtt_sim_fail_publish_after(2);
+    CHECK_EQ_INT(publish_n(3), 2);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 2);
+
+    // 실패로 잃은 자리가 없으면 나머지 WINDOW - 2 개는 대기 없이 들어감
+    CHECK_EQ_INT(publish_n(MQTT_UPLINK_WINDOW - 2), MQTT_UPLINK_WINDOW - 2);
+    CHECK_EQ_INT(uplink_stats().window_stalls, before.window_stalls);
+    CHECK_EQ_INT(mqtt_sim_ack(MQTT_UPLINK_WINDOW), MQTT_UPLINK_WINDOW);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 0);
+    CHECK_EQ_INT(uplink_stats().published - before.published, MQTT_UPLINK_WINDOW);
+}
+
+// 세션 유지 재연결: 미확인 메시지는 윈도우를 계속 차지하다가 재전송 후 PUBACK 으로 풀림
+static void test_reconnect_session_resume(void) {
+    mqtt_uplink_stats_t before = uplink_stats();
+    uint32_t resent_before = sim_stats().resent;
+
+    CHECK_EQ_INT(publish_n(3), 3);
+    mqtt_sim_disconnect();
+    CHECK(!mqtt_uplink_is_connected());
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 3);
+
+    // 끊긴 동안의 발행은 아웃박스에 쌓임
+    CHECK_EQ_INT(publish_n(1), 1);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 4);
+
+    mqtt_sim_connect(true);
+    CHECK(mqtt_uplink_is_connected());
+    CHECK_EQ_INT(uplink_stats().connects - before.connects, 1);
+    CHECK_EQ_INT(sim_stats().resent - resent_before, 4);
+
+    CHECK_EQ_INT(mqtt_sim_ack(4), 4);
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 0);
+}
+
+// 업로더: 배치 중간의 발행 실패 → 배치 전체를 스풀에 보관 → 백오프 후 재전송
+static void test_uploader_partial_batch_spools(void) {
+    EventGroupHandle_t link_events = xEventGroupCreate();
+    xEventGroupSetBits(link_events, LINK_UP_BIT);
+    uploader_set_format(UPLOAD_FORMAT_CBOR);
+    uploader_set_transport(UPLINK_TRANSPORT_MQTT);
+    const uploader_config_t config = {
+        .http_url = "http://127.0.0.1:9/unused",
+        .mqtt_uri = "mqtt://127.0.0.1:1883",
+        .device_name = "test",
+        .health_url = "http://127.0.0.1:9/unused",
+        .collect_health = NULL,
+    };
+    CHECK_EQ_INT(uploader_start(&config, link_events, LINK_UP_BIT), ESP_OK);
+
+    mqtt_uplink_stats_t before = uplink_stats();
+    uint32_t accepted_before = sim_stats().accepted;
+    mqtt_sim_set_auto_ack(true);
+    mqtt_sim_fail_publish_after(FAIL_AFTER_PUBLISHES);
+
+    for (int i = 0; i < BATCH_RECORDS; i++) {
+        relay_record_t record = {0};
+        snprintf(record.serial_number, sizeof(record.serial_number), "SWB%05d", i);
+        record.battery_level = 80;
+        record.floor = 1;
+        record.timestamp_ms = 1700000000000LL + i;
+        pipeline_stamps_t stamps = {0};
+        stamps.filter_us = pipeline_now_us();
+        uploader_submit(&record, &stamps);
+    }
+
+    uint32_t start = now_ms();
+    while (upload_stats().batches_failed == 0 && now_ms() - start < BATCH_TIMEOUT_MS) {
+        usleep(1000);
+    }
+    uploader_stats_t failed = upload_stats();
+    CHECK_EQ_INT(failed.records_enqueued, BATCH_RECORDS);
+    CHECK_EQ_INT(failed.batches_failed, 1);
+    CHECK_EQ_INT(failed.records_spooled, BATCH_RECORDS);
+    CHECK_EQ_INT(failed.records_sent, 0);
+    CHECK_EQ_INT(failed.records_failed, 0);
+    CHECK_EQ_INT(uplink_stats().failures - before.failures, 1);
+    CHECK_EQ_INT(sim_stats().accepted - accepted_before, FAIL_AFTER_PUBLISHES);
+
+    // 재전송은 같은 레코드를 비콘별 토픽으로 다시 발행
+    start = now_ms();
+    while (upload_stats().records_replayed < BATCH_RECORDS && now_ms() - start < REPLAY_TIMEOUT_MS) {
+        usleep(10000);
+    }
+    uploader_stats_t replayed = upload_stats();
+    CHECK_EQ_INT(replayed.records_replayed, BATCH_RECORDS);
+    CHECK_EQ_INT(replayed.batches_failed, 1);
+    CHECK_EQ_INT(spool_pending(), 0);
+    CHECK_EQ_INT(sim_stats().accepted - accepted_before, FAIL_AFTER_PUBLISHES + BATCH_RECORDS);
+    CHECK_EQ_INT(strcmp(sim_stats().last_topic, "swift/test/beacon/SWB00009"), 0);
+
+    start = now_ms();
+    while (mqtt_uplink_in_flight() > 0 && now_ms() - start < BATCH_TIMEOUT_MS) {
+        usleep(1000);
+    }
+    CHECK_EQ_INT(mqtt_uplink_in_flight(), 0);
+}
+
+
+int main(void) {
+    RUN_TEST(test_connect);
+    RUN_TEST(test_window_cap);
+    RUN_TEST(test_deleted_releases_slot);
+    RUN_TEST(test_publish_failure_no_leak);
+    RUN_TEST(test_reconnect_session_resume);
+    RUN_TEST(test_uploader_partial_batch_spools);
+    unlink(SPOOL_IMAGE_PATH);
+    return test_finish();
+}
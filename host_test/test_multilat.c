@@ -0,0 +1,282 @@
+#include <math.h>
+#include <string.h>
+#include "bench_util.h"
+#include "multilat.h"
+#include "test_util.h"
+
+#define ANCHOR_HEIGHT_M 2.5f
+#define MONTE_CARLO_TRIALS 2000
+
+// ===== 도우미 =====
+
+// 표준 정규 난수 (Box-Muller)
+static float rand_normal(uint32_t *rng) {
+    float u1 = ((float)(bench_rand(rng) >> 8) + 1.0f) / 16777217.0f;
+    float u2 = (float)(bench_rand(rng) >> 8) / 16777216.0f;
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+// 앵커 좌표들과 비콘 위치로 거리 측정 생성 (noise_m: 거리 잡음 표준편차)
+static void make_ranges(const float (*anchors)[2], int count, float bx, float by, float noise_m,
+                        uint32_t *rng, multilat_range_t *out) {
+    for (int i = 0; i < count; i++) {
+        out[i].anchor = (anchor_position_t){anchors[i][0], anchors[i][1], ANCHOR_HEIGHT_M};
+        float dx = bx - anchors[i][0];
+        float dy = by - anchors[i][1];
+        float dz = ANCHOR_HEIGHT_M - MULTILAT_BEACON_HEIGHT_M;
+        out[i].distance = sqrtf(dx * dx + dy * dy + dz * dz) + (noise_m > 0 ? noise_m * rand_normal(rng) : 0.0f);
+        out[i].variance = noise_m > 0 ? noise_m * noise_m : 0.01f;
+    }
+}
+
+static const float square4[4][2] = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+static const float hexagon6[6][2] = {{0, 0}, {12, 0}, {18, 8}, {12, 16}, {0, 16}, {-6, 8}};
+static const float triangle3[3][2] = {{0, 0}, {15, 0}, {5, 12}};
+
+
+// ===== 테스트 케이스 =====
+
+// 잡음 없는 거리: 여러 기하에서 안팎의 격자점을 cm 이하로 복원하고 수렴
+static void test_exact_geometries(void) {
+    struct {
+        const float (*anchors)[2];
+        int count;
+    } geometries[] = {{triangle3, 3}, {square4, 4}, {hexagon6, 6}};
+    uint32_t rng = 1;
+
+    for (size_t g = 0; g < sizeof(geometries) / sizeof(geometries[0]); g++) {
+        int worst_iterations = 0;
+        float worst_error = 0;
+        for (float bx = -5.0f; bx <= 20.0f; bx += 2.5f) {
+            for (float by = -5.0f; by <= 20.0f; by += 2.5f) {
+                multilat_range_t ranges[MULTILAT_MAX_ANCHORS];
+                make_ranges(geometries[g].anchors, geometries[g].count, bx, by, 0, &rng, ranges);
+                multilat_fix_t fix;
+                CHECK_EQ_INT(multilat_solve(ranges, geometries[g].count, &fix), ESP_OK);
+                float err = hypotf(fix.x - bx, fix.y - by);
+                if (err > worst_error) worst_error = err;
+                if (fix.iterations > worst_iterations) worst_iterations = fix.iterations;
+                CHECK_EQ_INT(fix.anchors_used, geometries[g].count);
+            }
+        }
+        printf("  앵커 %d개: 최대 오차 %.4fm, 최대 반복 %d회\n", geometries[g].count, worst_error, worst_iterations);
+        CHECK(worst_error < 0.01f);
+        CHECK(worst_iterations < MULTILAT_MAX_ITERATIONS);
+    }
+}
+
+// 잡음 있는 거리: 오차 RMS 가 잡음 수준이고, 보고한 분산이 실제 오차와 맞음
+static void test_noisy_accuracy(void) {
+    const float noise_levels[] = {0.1f, 0.3f, 1.0f};
+    uint32_t rng = 42;
+    for (size_t n = 0; n < sizeof(noise_levels) / sizeof(noise_levels[0]); n++) {
+        float sigma = noise_levels[n];
+        double sum_err2 = 0, sum_var = 0;
+        int solved = 0;
+        for (int t = 0; t < MONTE_CARLO_TRIALS; t++) {
+            float bx = 1.0f + 8.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+            float by = 1.0f + 8.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+            multilat_range_t ranges[4];
+            make_ranges(square4, 4, bx, by, sigma, &rng, ranges);
+            multilat_fix_t fix;
+            if (multilat_solve(ranges, 4, &fix) != ESP_OK) {
+                continue;
+            }
+            solved++;
+            sum_err2 += (fix.x - bx) * (fix.x - bx) + (fix.y - by) * (fix.y - by);
+            sum_var += fix.variance;
+        }
+        double rms = sqrt(sum_err2 / solved);
+        double predicted = sqrt(sum_var / solved);
+        printf("  잡음 %.1fm: 해 %d/%d, 위치 오차 RMS %.3fm, 보고 정확도 %.3fm\n",
+               sigma, solved, MONTE_CARLO_TRIALS, rms, predicted);
+        CHECK(solved >= MONTE_CARLO_TRIALS * 99 / 100);
+        CHECK(rms < 1.5 * sigma + 0.05);
+        CHECK(predicted > 0.6 * rms && predicted < 1.6 * rms);
+    }
+}
+
+// 분산이 큰 측정은 가중치가 낮아 위치를 덜 끌어당김
+static void test_weighting(void) {
+    uint32_t rng = 7;
+    multilat_range_t ranges[4];
+    make_ranges(square4, 4, 4.0f, 6.0f, 0, &rng, ranges);
+    ranges[0].distance += 2.0f;
+
+    multilat_fix_t equal;
+    CHECK_EQ_INT(multilat_solve(ranges, 4, &equal), ESP_OK);
+    ranges[0].variance = 4.0f;
+    multilat_fix_t weighted;
+    CHECK_EQ_INT(multilat_solve(ranges, 4, &weighted), ESP_OK);
+    CHECK(hypotf(weighted.x - 4.0f, weighted.y - 6.0f) < hypotf(equal.x - 4.0f, equal.y - 6.0f));
+}
+
+// 앵커 부족, 최대 앵커 수 초과
+static void test_anchor_count(void) {
+    uint32_t rng = 3;
+    multilat_range_t ranges[8];
+    multilat_fix_t fix;
+    make_ranges(square4, 2, 5.0f, 5.0f, 0, &rng, ranges);
+    CHECK_EQ_INT(multilat_solve(ranges, 2, &fix), ESP_ERR_INVALID_ARG);
+    CHECK_EQ_INT(multilat_solve(ranges, 0, &fix), ESP_ERR_INVALID_ARG);
+
+    const float eight[8][2] = {{0, 0}, {10, 0}, {10, 10}, {0, 10}, {5, -5}, {15, 5}, {5, 15}, {-5, 5}};
+    make_ranges(eight, 8, 3.0f, 4.0f, 0, &rng, ranges);
+    CHECK_EQ_INT(multilat_solve(ranges, 8, &fix), ESP_OK);
+    CHECK_EQ_INT(fix.anchors_used, MULTILAT_MAX_ANCHORS);
+    CHECK_NEAR(fix.x, 3.0f, 0.01f);
+    CHECK_NEAR(fix.y, 4.0f, 0.01f);
+}
+
+// 일직선 / 한 점에 모인 앵커: 위치를 정할 수 없으므로 ESP_ERR_INVALID_STATE
+static void test_degenerate_geometry(void) {
+    uint32_t rng = 5;
+    multilat_range_t ranges[4];
+    multilat_fix_t fix;
+
+    const float line[4][2] = {{0, 0}, {5, 0}, {10, 0}, {15, 0}};
+    make_ranges(line, 4, 6.0f, 3.0f, 0, &rng, ranges);
+    CHECK_EQ_INT(multilat_solve(ranges, 4, &fix), ESP_ERR_INVALID_STATE);
+
+    const float diagonal[3][2] = {{0, 0}, {4, 4}, {9, 9}};
+    make_ranges(diagonal, 3, 2.0f, 7.0f, 0.1f, &rng, ranges);
+    CHECK_EQ_INT(multilat_solve(ranges, 3, &fix), ESP_ERR_INVALID_STATE);
+
+    const float same[3][2] = {{3, 3}, {3, 3}, {3, 3}};
+    make_ranges(same, 3, 6.0f, 1.0f, 0, &rng, ranges);
+    CHECK_EQ_INT(multilat_solve(ranges, 3, &fix), ESP_ERR_INVALID_STATE);
+}
+
+// 거의 일직선인 앵커: 앵커 선에 대한 거울상 두 점이 거의 같은 잔차를 가지므로
+// 실제 위치나 그 거울상 근처로 풀리거나, 기하 퇴화로 실패해야 함
+static void test_near_collinear(void) {
+    uint32_t rng = 11;
+    const float flat[4][2] = {{0, 0}, {5, 0.05f}, {10, 0}, {15, 0.05f}};
+    int real_side = 0, mirror_side = 0, failed = 0;
+    for (int t = 0; t < 200; t++) {
+        multilat_range_t ranges[4];
+        make_ranges(flat, 4, 6.0f, 3.0f, 0.1f, &rng, ranges);
+        multilat_fix_t fix;
+        esp_err_t err = multilat_solve(ranges, 4, &fix);
+        if (err != ESP_OK) {
+            CHECK(err == ESP_ERR_INVALID_STATE || err == ESP_ERR_TIMEOUT);
+            failed++;
+        } else if (hypotf(fix.x - 6.0f, fix.y - 3.0f) < 1.0f) {
+            real_side++;
+        } else {
+            CHECK(hypotf(fix.x - 6.0f, fix.y + 3.0f) < 1.0f);
+            mirror_side++;
+        }
+    }
+    printf("  거의 일직선 200회: 실제 쪽 %d, 거울상 쪽 %d, 실패 %d\n", real_side, mirror_side, failed);
+}
+
+// 서로 맞지 않는 거리 / 비정상 입력: 실패하거나 유한한 해만 반환 (NaN 위치 없음)
+static void test_inconsistent_and_invalid(void) {
+    uint32_t rng = 13;
+    multilat_range_t ranges[4];
+    multilat_fix_t fix;
+
+    // 모든 거리가 앵커 높이 차보다 짧음 (수평 거리 0): 네 앵커 바로 아래일 수는 없음
+    make_ranges(square4, 4, 5.0f, 5.0f, 0, &rng, ranges);
+    for (int i = 0; i < 4; i++) {
+        ranges[i].distance = 0.5f;
+    }
+    esp_err_t err = multilat_solve(ranges, 4, &fix);
+    CHECK(err != ESP_OK || (isfinite(fix.x) && isfinite(fix.y) && isfinite(fix.variance)));
+
+    // 앵커 사이 거리보다 훨씬 긴 거리 (멀리 있는 다중경로)
+    make_ranges(square4, 4, 5.0f, 5.0f, 0, &rng, ranges);
+    ranges[1].distance = 80.0f;
+    err = multilat_solve(ranges, 4, &fix);
+    CHECK(err != ESP_OK || (isfinite(fix.x) && isfinite(fix.y) && fix.residual_rms > 1.0f));
+
+    // NaN / 무한대 거리
+    make_ranges(square4, 4, 5.0f, 5.0f, 0, &rng, ranges);
+    ranges[2].distance = NAN;
+    CHECK(multilat_solve(ranges, 4, &fix) != ESP_OK);
+    ranges[2].distance = INFINITY;
+    CHECK(multilat_solve(ranges, 4, &fix) != ESP_OK);
+}
+
+// 서로 크게 어긋난 거리: 스텝이 발산하지 않고, 한도 안에 수렴하면 앵커 근처의 유한한 해,
+// 아니면 ESP_ERR_TIMEOUT (반복 한도에서 멈춘 해는 내보내지 않음)
+static void test_non_converging(void) {
+    // 스텝 조절 없이는 (-2335, 3185) 로 발산하던 입력
+    multilat_range_t diverging[3] = {
+        {.anchor = {0, 0, ANCHOR_HEIGHT_M}, .distance = 4.8f, .variance = 2.12f},
+        {.anchor = {15, 0, ANCHOR_HEIGHT_M}, .distance = 37.1f, .variance = 7.22f},
+        {.anchor = {5, 12, ANCHOR_HEIGHT_M}, .distance = 4.5f, .variance = 9.5f},
+    };
+    multilat_fix_t fix;
+    esp_err_t err = multilat_solve(diverging, 3, &fix);
+    CHECK(err == ESP_OK || err == ESP_ERR_TIMEOUT);
+    if (err == ESP_OK) {
+        CHECK(hypotf(fix.x - 5.0f, fix.y - 4.0f) < 50.0f);
+    }
+
+    uint32_t rng = 17;
+    int ok = 0, timeout = 0, other = 0, worst_iterations = 0;
+    for (int t = 0; t < 5000; t++) {
+        multilat_range_t ranges[3];
+        make_ranges(triangle3, 3, 5.0f, 4.0f, 0, &rng, ranges);
+        for (int i = 0; i < 3; i++) {
+            ranges[i].distance = 0.5f + 40.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+            ranges[i].variance = 0.0001f + (float)(bench_rand(&rng) % 1000) / 100.0f;
+        }
+        err = multilat_solve(ranges, 3, &fix);
+        if (err == ESP_ERR_TIMEOUT) {
+            timeout++;
+            continue;
+        }
+        if (err != ESP_OK) {
+            other++;
+            continue;
+        }
+        ok++;
+        CHECK(isfinite(fix.x) && isfinite(fix.y) && isfinite(fix.variance) && isfinite(fix.residual_rms));
+        CHECK(hypotf(fix.x - 5.0f, fix.y - 4.0f) < 100.0f);
+        if (fix.iterations > worst_iterations) worst_iterations = fix.iterations;
+    }
+    printf("  모순된 거리 5000회: 성공 %d (최대 반복 %d회), 수렴 실패 %d, 기타 실패 %d\n",
+           ok, worst_iterations, timeout, other);
+    CHECK(worst_iterations <= MULTILAT_MAX_ITERATIONS);
+}
+
+// 측정 하나가 다중경로로 길어진 현실적인 경우: 대부분 수렴하고, 실패는 소수
+static void test_multipath_outlier(void) {
+    uint32_t rng = 19;
+    int ok = 0, timeout = 0, iterations_sum = 0;
+    for (int t = 0; t < MONTE_CARLO_TRIALS; t++) {
+        float bx = 1.0f + 8.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+        float by = 1.0f + 8.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+        multilat_range_t ranges[4];
+        make_ranges(square4, 4, bx, by, 0.3f, &rng, ranges);
+        ranges[bench_rand(&rng) % 4].distance += 3.0f + 7.0f * (float)(bench_rand(&rng) % 1000) / 1000.0f;
+        multilat_fix_t fix;
+        esp_err_t err = multilat_solve(ranges, 4, &fix);
+        if (err == ESP_OK) {
+            ok++;
+            iterations_sum += fix.iterations;
+        } else {
+            CHECK_EQ_INT(err, ESP_ERR_TIMEOUT);
+            timeout++;
+        }
+    }
+    printf("  다중경로 1개 %d회: 성공 %d (평균 반복 %.1f회), 수렴 실패 %d\n",
+           MONTE_CARLO_TRIALS, ok, (double)iterations_sum / ok, timeout);
+    CHECK(ok >= MONTE_CARLO_TRIALS * 95 / 100);
+}
+
+int main(void) {
+    RUN_TEST(test_exact_geometries);
+    RUN_TEST(test_noisy_accuracy);
+    RUN_TEST(test_weighting);
+    RUN_TEST(test_anchor_count);
+    RUN_TEST(test_degenerate_geometry);
+    RUN_TEST(test_near_collinear);
+    RUN_TEST(test_inconsistent_and_invalid);
+    RUN_TEST(test_non_converging);
+    RUN_TEST(test_multipath_outlier);
+    return test_finish();
+}
@@ -0,0 +1,388 @@
+#include <math.h>
+#include <string.h>
+#include "record_cbor.h"
+#include "record_fixture.h"
+#include "test_util.h"
+
+#define RANDOM_RECORDS 20000
+
+static uint8_t s_buf[RECORD_CBOR_MAX_LEN];
+
+
+// ===== 기준 디코더 =====
+// record_cbor.c 와 코드를 공유하지 않는 최소 CBOR 디코더 (RFC 8949, 이 스키마에 나오는 타입만)
+// 가장 짧은 인코딩이 아닌 머리, 오름차순이 아닌 맵 키, 남는 바이트는 모두 오류로 봄
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    bool error;
+} cbor_in_t;
+
+// 바이트 하나 (끝이면 오류)
+static uint8_t next_byte(cbor_in_t *in) {
+    if (in->error || in->pos >= in->len) {
+        in->error = true;
+        return 0;
+    }
+    return in->data[in->pos++];
+}
+
+// 데이터 항목 머리: 주 타입과 값
+static uint64_t read_head(cbor_in_t *in, int *major) {
+    uint8_t initial = next_byte(in);
+    uint8_t info = initial & 0x1F;
+    *major = initial >> 5;
+    if (info < 24) {
+        return info;
+    }
+    if (info > 27) {
+        in->error = true;
+        return 0;
+    }
+    int bytes = 1 << (info - 24);
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value = (value << 8) | next_byte(in);
+    }
+    // 더 짧게 쓸 수 있었던 값이면 오류 (직렬화기가 가장 짧은 인코딩을 쓰는지 확인)
+    static const uint64_t min_value[4] = {24, 0x100, 0x10000, 0x100000000ull};
+    if (value < min_value[info - 24]) {
+        in->error = true;
+    }
+    return value;
+}
+
+// 정해진 주 타입의 머리 값
+static uint64_t expect_head(cbor_in_t *in, int expected_major) {
+    int major = 0;
+    uint64_t value = read_head(in, &major);
+    if (major != expected_major) {
+        in->error = true;
+    }
+    return value;
+}
+
+// 부호 없는 정수 (주 타입 0)
+static uint64_t read_uint(cbor_in_t *in) {
+    return expect_head(in, 0);
+}
+
+// 부호 있는 정수 (주 타입 0 또는 1)
+static int64_t read_int(cbor_in_t *in) {
+    int major = 0;
+    uint64_t value = read_head(in, &major);
+    if (major == 0) {
+        return (int64_t)value;
+    }
+    if (major != 1) {
+        in->error = true;
+    }
+    return -1 - (int64_t)value;
+}
+
+// 단정밀도 실수 (0xFA + 빅 엔디언 4바이트)
+static float read_float32(cbor_in_t *in) {
+    if (next_byte(in) != 0xFA) {
+        in->error = true;
+    }
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; i++) {
+        bits = (bits << 8) | next_byte(in);
+    }
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 배열 머리 (원소 수가 기대값과 다르면 오류)
+static void expect_array(cbor_in_t *in, uint64_t count) {
+    if (expect_head(in, 4) != count) {
+        in->error = true;
+    }
+}
+
+// CBOR 레코드 → relay_record_t (오류가 없고 남는 바이트도 없으면 true)
+static bool decode_record(const uint8_t *data, size_t len, relay_record_t *out) {
+    cbor_in_t in = {.data = data, .len = len};
+    memset(out, 0, sizeof(*out));
+
+    uint64_t entries = expect_head(&in, 5);
+    int64_t prev_key = -1;
+    for (uint64_t n = 0; n < entries && !in.error; n++) {
+        int64_t key = (int64_t)read_uint(&in);
+        if (key <= prev_key) {
+            in.error = true;
+        }
+        prev_key = key;
+
+        switch (key) {
+            case RECORD_CBOR_KEY_SERIAL: {
+                uint64_t serial_len = expect_head(&in, 3);
+                if (serial_len >= sizeof(out->serial_number)) {
+                    in.error = true;
+                    break;
+                }
+                for (uint64_t i = 0; i < serial_len; i++) {
+                    out->serial_number[i] = (char)next_byte(&in);
+                }
+                break;
+            }
+            case RECORD_CBOR_KEY_BATTERY:
+                out->battery_level = (uint8_t)read_uint(&in);
+                break;
+            case RECORD_CBOR_KEY_FLOOR:
+                out->floor = (int8_t)read_int(&in);
+                break;
+            case RECORD_CBOR_KEY_TIMESTAMP:
+                out->timestamp_ms = read_int(&in);
+                break;
+            case RECORD_CBOR_KEY_MEASUREMENTS: {
+                uint64_t count = expect_head(&in, 4);
+                if (count > RELAY_MAX_MEASUREMENTS) {
+                    in.error = true;
+                    break;
+                }
+                out->measurement_count = (uint8_t)count;
+                for (uint64_t i = 0; i < count; i++) {
+                    expect_array(&in, 4);
+                    if (expect_head(&in, 2) != 6) {
+                        in.error = true;
+                    }
+                    for (int b = 0; b < 6; b++) {
+                        out->measurements[i].anchor_mac[b] = next_byte(&in);
+                    }
+                    out->measurements[i].distance_meters = read_float32(&in);
+                    out->measurements[i].rssi = (int8_t)read_int(&in);
+                    out->measurements[i].rtt_nanoseconds = (uint32_t)read_uint(&in);
+                }
+                break;
+            }
+            case RECORD_CBOR_KEY_POSITION:
+                expect_array(&in, 4);
+                out->position_x = read_float32(&in);
+                out->position_y = read_float32(&in);
+                out->position_accuracy = read_float32(&in);
+                out->position_anchors = (uint8_t)read_uint(&in);
+                break;
+            case RECORD_CBOR_KEY_SEQUENCE:
+                out->has_sequence = true;
+                out->sequence = (uint32_t)read_uint(&in);
+                break;
+            case RECORD_CBOR_KEY_POWER_PROFILE:
+                out->has_profile = true;
+                expect_array(&in, 4);
+                out->profile.cycles = (uint8_t)read_uint(&in);
+                out->profile.charge_dmas = (uint16_t)read_uint(&in);
+                out->profile.radio_on_ms = (uint16_t)read_uint(&in);
+                expect_array(&in, SWIFT_PHASE_COUNT);
+                for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+                    out->profile.phase_ms[i] = (uint16_t)read_uint(&in);
+                }
+                break;
+            default:
+                in.error = true;
+                break;
+        }
+    }
+    return !in.error && in.pos == in.len;
+}
+
+
+// ===== 비교 =====
+
+// 실수는 비트 단위로 비교 (NaN 도 그대로 실려야 함)
+static bool same_float(float a, float b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// 원본과 디코딩 결과의 첫 차이 필드 이름 (같으면 NULL)
+static const char *first_difference(const relay_record_t *expected, const relay_record_t *decoded) {
+    if (strncmp(expected->serial_number, decoded->serial_number, sizeof(expected->serial_number)) != 0) {
+        return "serial_number";
+    }
+    if (expected->battery_level != decoded->battery_level) {
+        return "battery_level";
+    }
+    if (expected->floor != decoded->floor) {
+        return "floor";
+    }
+    if (expected->timestamp_ms != decoded->timestamp_ms) {
+        return "timestamp";
+    }
+    if (expected->measurement_count != decoded->measurement_count) {
+        return "measurement_count";
+    }
+    for (int i = 0; i < expected->measurement_count; i++) {
+        if (memcmp(expected->measurements[i].anchor_mac, decoded->measurements[i].anchor_mac, 6) != 0) {
+            return "anchor_mac";
+        }
+        if (!same_float(expected->measurements[i].distance_meters, decoded->measurements[i].distance_meters)) {
+            return "distance_meters";
+        }
+        if (expected->measurements[i].rssi != decoded->measurements[i].rssi) {
+            return "rssi";
+        }
+        if (expected->measurements[i].rtt_nanoseconds != decoded->measurements[i].rtt_nanoseconds) {
+            return "rtt_nanoseconds";
+        }
+    }
+    if (expected->position_anchors != decoded->position_anchors) {
+        return "position_anchors";
+    }
+    if (expected->position_anchors > 0 &&
+        (!same_float(expected->position_x, decoded->position_x) ||
+         !same_float(expected->position_y, decoded->position_y) ||
+         !same_float(expected->position_accuracy, decoded->position_accuracy))) {
+        return "position";
+    }
+    if (expected->has_sequence != decoded->has_sequence ||
+        (expected->has_sequence && expected->sequence != decoded->sequence)) {
+        return "sequence";
+    }
+    if (expected->has_profile != decoded->has_profile ||
+        (expected->has_profile && memcmp(&expected->profile, &decoded->profile, sizeof(expected->profile)) != 0)) {
+        return "power_profile";
+    }
+    return NULL;
+}
+
+// 직렬화 → 디코딩 → 필드 비교 (실패면 false)
+static bool roundtrip(const relay_record_t *record, const char **difference) {
+    size_t len = 0;
+    relay_record_t decoded;
+    if (record_cbor_encode(record, s_buf, sizeof(s_buf), &len) != ESP_OK) {
+        *difference = "encode";
+        return false;
+    }
+    if (!decode_record(s_buf, len, &decoded)) {
+        *difference = "decode";
+        return false;
+    }
+    *difference = first_difference(record, &decoded);
+    return *difference == NULL;
+}
+
+
+// ===== 테스트 케이스 =====
+
+// 손으로 인코딩한 기준 바이트열 (디코더 자체의 기준)
+static void test_known_bytes(void) {
+    relay_record_t r = {0};
+    strcpy(r.serial_number, "SN1");
+    r.battery_level = 87;
+    r.floor = -1;
+    r.timestamp_ms = 5;
+    r.measurement_count = 1;
+    memcpy(r.measurements[0].anchor_mac, (uint8_t[]){0x40, 0x4c, 0xca, 0x01, 0x02, 0x0a}, 6);
+    r.measurements[0].distance_meters = 2.5f;
+    r.measurements[0].rssi = -61;
+    r.measurements[0].rtt_nanoseconds = 16;
+
+    static const uint8_t expected[] = {
+        0xA5,                                   // map(5)
+        0x00, 0x63, 'S', 'N', '1',              // 0: "SN1"
+        0x01, 0x18, 0x57,                       // 1: 87
+        0x02, 0x20,                             // 2: -1
+        0x03, 0x05,                             // 3: 5
+        0x04, 0x81, 0x84,                       // 4: [[
+        0x46, 0x40, 0x4c, 0xca, 0x01, 0x02, 0x0a,   // h'404cca01020a'
+        0xFA, 0x40, 0x20, 0x00, 0x00,           // 2.5
+        0x38, 0x3C,                             // -61
+        0x10,                                   // 16 ]]
+    };
+    size_t len = 0;
+    CHECK_EQ_INT(record_cbor_encode(&r, s_buf, sizeof(s_buf), &len), ESP_OK);
+    CHECK_EQ_INT(len, sizeof(expected));
+    CHECK(memcmp(s_buf, expected, sizeof(expected)) == 0);
+
+    relay_record_t decoded;
+    CHECK(decode_record(expected, sizeof(expected), &decoded));
+    CHECK(first_difference(&r, &decoded) == NULL);
+}
+
+// 현장 형태 레코드 (JSON 테스트와 같은 record_fixture_typical)
+static void test_typical_records(void) {
+    for (uint32_t i = 0; i < 100; i++) {
+        relay_record_t r;
+        record_fixture_typical(&r, i);
+        const char *difference = NULL;
+        if (!roundtrip(&r, &difference)) {
+            fprintf(stderr, "  레코드 %u: %s 불일치\n", (unsigned)i, difference);
+            s_test_failures++;
+        }
+    }
+}
+
+// 무작위 레코드 (선택 필드, 음수, 긴 정수, NaN 포함 float) 필드별 일치
+static void test_random_records(void) {
+    uint32_t rng = 0xC0FFEE;
+    int mismatches = 0;
+    for (int n = 0; n < RANDOM_RECORDS; n++) {
+        relay_record_t r;
+        record_fixture_random(&r, &rng);
+        const char *difference = NULL;
+        if (!roundtrip(&r, &difference) && mismatches++ < 5) {
+            fprintf(stderr, "  레코드 %d: %s 불일치\n", n, difference);
+        }
+    }
+    CHECK_EQ_INT(mismatches, 0);
+}
+
+// 버퍼가 부족하면 ESP_ERR_INVALID_SIZE, 딱 맞으면 성공
+static void test_buffer_limits(void) {
+    relay_record_t r;
+    record_fixture_typical(&r, 7);
+    size_t len = 0;
+    CHECK_EQ_INT(record_cbor_encode(&r, s_buf, sizeof(s_buf), &len), ESP_OK);
+
+    uint8_t exact[RECORD_CBOR_MAX_LEN];
+    size_t exact_len = 0;
+    CHECK_EQ_INT(record_cbor_encode(&r, exact, len, &exact_len), ESP_OK);
+    CHECK_EQ_INT(exact_len, len);
+    CHECK_EQ_INT(record_cbor_encode(&r, exact, len - 1, &exact_len), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ_INT(record_cbor_encode(&r, exact, 0, &exact_len), ESP_ERR_INVALID_SIZE);
+}
+
+// 가장 긴 레코드도 RECORD_CBOR_MAX_LEN 안에 들어가고 그대로 디코딩됨
+static void test_max_len_fits(void) {
+    relay_record_t r = {0};
+    memset(r.serial_number, 'Z', sizeof(r.serial_number) - 1);
+    r.battery_level = 100;
+    r.floor = -128;
+    r.timestamp_ms = 253402300799999LL;
+    r.measurement_count = RELAY_MAX_MEASUREMENTS;
+    for (int i = 0; i < RELAY_MAX_MEASUREMENTS; i++) {
+        memset(r.measurements[i].anchor_mac, 0xFF, 6);
+        r.measurements[i].distance_meters = NAN;
+        r.measurements[i].rssi = -128;
+        r.measurements[i].rtt_nanoseconds = UINT32_MAX;
+    }
+    r.position_anchors = 255;
+    r.position_x = r.position_y = r.position_accuracy = -INFINITY;
+    r.has_profile = true;
+    r.profile.cycles = 255;
+    r.profile.charge_dmas = 65535;
+    r.profile.radio_on_ms = 65535;
+    for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+        r.profile.phase_ms[i] = 65535;
+    }
+    r.has_sequence = true;
+    r.sequence = UINT32_MAX;
+
+    const char *difference = NULL;
+    CHECK(roundtrip(&r, &difference));
+    size_t len = 0;
+    CHECK_EQ_INT(record_cbor_encode(&r, s_buf, sizeof(s_buf), &len), ESP_OK);
+    CHECK(len <= RECORD_CBOR_MAX_LEN);
+}
+
+int main(void) {
+    RUN_TEST(test_known_bytes);
+    RUN_TEST(test_typical_records);
+    RUN_TEST(test_random_records);
+    RUN_TEST(test_buffer_limits);
+    RUN_TEST(test_max_len_fits);
+    return test_finish();
+}
@@ -0,0 +1,157 @@
+#include <math.h>
+#include <string.h>
+#include "record_fixture.h"
+#include "record_json.h"
+#include "test_util.h"
+#ifdef HAVE_CJSON
+#include "cJSON.h"
+#include "cjson_reference.h"
+#endif
+
+#define RANDOM_RECORDS 20000
+
+static char s_buf[RECORD_JSON_MAX_LEN];
+
+// 직렬화 결과가 기대 문자열과 같은지 확인
+static void check_encoded(const relay_record_t *record, const char *expected) {
+    size_t len = 0;
+    CHECK_EQ_INT(record_json_encode(record, s_buf, sizeof(s_buf), &len), ESP_OK);
+    CHECK_EQ_INT(len, strlen(expected));
+    if (strcmp(s_buf, expected) != 0) {
+        fprintf(stderr, "  출력: %s\n  기대: %s\n", s_buf, expected);
+        s_test_failures++;
+    }
+}
+
+
+// ===== 테스트 케이스 =====
+
+// 기본 레코드 (cJSON_PrintUnformatted 출력을 그대로 적어 둔 기준 문자열)
+static void test_basic_record(void) {
+    relay_record_t r = {0};
+    strcpy(r.serial_number, "SN0001");
+    r.battery_level = 87;
+    r.floor = -1;
+    r.timestamp_ms = 1760608800123LL;
+    r.measurement_count = 2;
+    memcpy(r.measurements[0].anchor_mac, (uint8_t[]){0x40, 0x4c, 0xca, 0x01, 0x02, 0x0a}, 6);
+    r.measurements[0].distance_meters = 2.5f;
+    r.measurements[0].rssi = -61;
+    r.measurements[0].rtt_nanoseconds = 16;
+    memcpy(r.measurements[1].anchor_mac, (uint8_t[]){0xff, 0x00, 0x10, 0xab, 0xcd, 0xef}, 6);
+    r.measurements[1].distance_meters = 1.1f;     // %1.15g 로는 되읽은 값이 달라 %1.17g
+    r.measurements[1].rssi = -80;
+    r.measurements[1].rtt_nanoseconds = 0;
+    check_encoded(&r,
+        "{\"battery_level\":87,\"floor\":-1,\"measurements\":["
+        "{\"anchor_mac\":\"40:4C:CA:01:02:0A\",\"distance_meters\":2.5,\"rssi\":-61,\"rtt_nanoseconds\":16},"
+        "{\"anchor_mac\":\"FF:00:10:AB:CD:EF\",\"distance_meters\":1.1000000238418579,\"rssi\":-80,\"rtt_nanoseconds\":0}],"
+        "\"serial_number\":\"SN0001\",\"timestamp\":\"2025-10-16T10:00:00.123Z\"}");
+}
+
+// 선택 필드와 특수 값 (정수 값 실수, NaN, 이스케이프)
+static void test_optional_fields(void) {
+    relay_record_t r = {0};
+    strcpy(r.serial_number, "A\"B\\C\tD");
+    r.battery_level = 100;
+    r.floor = 0;
+    r.timestamp_ms = 5;
+    r.position_anchors = 4;
+    r.position_x = 3.0f;
+    r.position_y = NAN;
+    r.position_accuracy = 0.25f;
+    r.has_profile = true;
+    r.profile.cycles = 8;
+    r.profile.charge_dmas = 123;
+    r.profile.radio_on_ms = 900;
+    for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+        r.profile.phase_ms[i] = (uint16_t)(i * 10);
+    }
+    r.has_sequence = true;
+    r.sequence = 4000000000u;
+    check_encoded(&r,
+        "{\"battery_level\":100,\"floor\":0,\"measurements\":[],"
+        "\"position\":{\"x\":3,\"y\":null,\"accuracy_meters\":0.25,\"anchors\":4},"
+        "\"power_profile\":{\"cycles\":8,\"charge_mas\":12.3,\"radio_on_ms\":900,\"phases_ms\":"
+        "{\"boot\":0,\"nvs\":10,\"wifi_init\":20,\"scan\":30,\"ftm\":40,\"floor_wait\":50,\"send\":60,\"other\":70}},"
+        "\"sequence\":4000000000,\"serial_number\":\"A\\\"B\\\\C\\tD\",\"timestamp\":\"1970-01-01T00:00:00.005Z\"}");
+}
+
+// 버퍼가 부족하면 ESP_ERR_INVALID_SIZE, 딱 맞으면 성공
+static void test_buffer_limits(void) {
+    relay_record_t r;
+    record_fixture_typical(&r, 7);
+    size_t len = 0;
+    CHECK_EQ_INT(record_json_encode(&r, s_buf, sizeof(s_buf), &len), ESP_OK);
+
+    char exact[RECORD_JSON_MAX_LEN];
+    size_t exact_len = 0;
+    CHECK_EQ_INT(record_json_encode(&r, exact, len + 1, &exact_len), ESP_OK);
+    CHECK_EQ_INT(exact_len, len);
+    CHECK_EQ_INT(record_json_encode(&r, exact, len, &exact_len), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ_INT(record_json_encode(&r, exact, 0, &exact_len), ESP_ERR_INVALID_SIZE);
+}
+
+// 가장 긴 레코드도 RECORD_JSON_MAX_LEN 안에 들어감
+static void test_max_len_fits(void) {
+    relay_record_t r = {0};
+    memset(r.serial_number, '\t', sizeof(r.serial_number) - 1);   // 글자마다 2바이트 이스케이프
+    r.battery_level = 100;
+    r.floor = -128;
+    r.timestamp_ms = 253402300799999LL;
+    r.measurement_count = RELAY_MAX_MEASUREMENTS;
+    for (int i = 0; i < RELAY_MAX_MEASUREMENTS; i++) {
+        r.measurements[i].distance_meters = -1.23456789e-7f;
+        r.measurements[i].rssi = -128;
+        r.measurements[i].rtt_nanoseconds = UINT32_MAX;
+    }
+    r.position_anchors = 255;
+    r.position_x = r.position_y = r.position_accuracy = -1.23456789e-7f;
+    r.has_profile = true;
+    r.profile.cycles = 255;
+    r.profile.charge_dmas = 65535;
+    r.profile.radio_on_ms = 65535;
+    for (int i = 0; i < SWIFT_PHASE_COUNT; i++) {
+        r.profile.phase_ms[i] = 65535;
+    }
+    r.has_sequence = true;
+    r.sequence = UINT32_MAX;
+    size_t len = 0;
+    CHECK_EQ_INT(record_json_encode(&r, s_buf, sizeof(s_buf), &len), ESP_OK);
+    CHECK(len < RECORD_JSON_MAX_LEN);
+}
+
+#ifdef HAVE_CJSON
+// 무작위 레코드에서 기존 cJSON_PrintUnformatted 출력과 바이트 단위로 같음
+static void test_matches_cjson(void) {
+    uint32_t rng = 0xC0FFEE;
+    int mismatches = 0;
+    for (int n = 0; n < RANDOM_RECORDS; n++) {
+        relay_record_t r;
+        record_fixture_random(&r, &rng);
+        char *expected = cjson_reference_encode(&r);
+        size_t len = 0;
+        esp_err_t err = record_json_encode(&r, s_buf, sizeof(s_buf), &len);
+        if (expected == NULL || err != ESP_OK || strcmp(s_buf, expected) != 0) {
+            if (mismatches++ < 5) {
+                fprintf(stderr, "  레코드 %d 불일치\n  출력: %s\n  cJSON: %s\n", n, s_buf, expected ? expected : "(NULL)");
+            }
+        }
+        cJSON_free(expected);
+    }
+    CHECK_EQ_INT(mismatches, 0);
+}
+#endif
+
+int main(void) {
+    RUN_TEST(test_basic_record);
+    RUN_TEST(test_optional_fields);
+    RUN_TEST(test_buffer_limits);
+    RUN_TEST(test_max_len_fits);
+#ifdef HAVE_CJSON
+    RUN_TEST(test_matches_cjson);
+#else
+    printf("cJSON 없음: 기존 cJSON 출력과의 무작위 비교는 건너뜀 (CJSON_DIR 또는 IDF_PATH 지정)\n");
+#endif
+    return test_finish();
+}
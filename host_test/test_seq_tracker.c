@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <string.h>
+#include "bench_util.h"
+#include "seq_tracker.h"
+#include "test_util.h"
+
+#define CHURN_SERIALS 3000                  // 용량보다 많은 시리얼로 밀어내기 반복
+#define CHURN_STEPS 400000
+
+// ===== 도우미 =====
+
+static void serial_for(int index, char *out) {
+    snprintf(out, 10, "B%05d", index);
+}
+
+// 시리얼로 비콘 통계 찾기 (seq_tracker_worst 로 전체를 복사해서 검색)
+static bool beacon_stats(const char *serial, seq_beacon_stats_t *out) {
+    static seq_beacon_stats_t all[SEQ_TRACKER_CAPACITY];
+    int count = seq_tracker_worst(all, SEQ_TRACKER_CAPACITY);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(all[i].serial_number, serial) == 0) {
+            *out = all[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+// 기준 모델: 시리얼별 창을 배열로 두고 가장 오래 조용한 것을 선형 탐색으로 밀어냄 (seq_tracker.c 이전 방식)
+typedef struct {
+    bool present;
+    uint32_t highest;
+    uint64_t window;
+    uint64_t last_use;
+} model_entry_t;
+
+static model_entry_t s_model[CHURN_SERIALS];
+static int s_model_count;
+
+static seq_verdict_t model_check(int serial, uint32_t sequence, uint64_t tick) {
+    model_entry_t *e = &s_model[serial];
+    if (!e->present) {
+        if (s_model_count == SEQ_TRACKER_CAPACITY) {
+            int oldest = -1;
+            for (int i = 0; i < CHURN_SERIALS; i++) {
+                if (s_model[i].present && (oldest < 0 || s_model[i].last_use < s_model[oldest].last_use)) {
+                    oldest = i;
+                }
+            }
+            s_model[oldest].present = false;
+            s_model_count--;
+        }
+        e->present = true;
+        e->highest = sequence;
+        e->window = 1;
+        e->last_use = tick;
+        s_model_count++;
+        return SEQ_ACCEPT;
+    }
+    e->last_use = tick;
+    uint32_t ahead = sequence - e->highest;
+    uint32_t behind = e->highest - sequence;
+    if (ahead != 0 && ahead <= SEQ_RESTART_GAP) {
+        e->window = (ahead < SEQ_WINDOW_SIZE) ? (e->window << ahead) | 1 : 1;
+        e->highest = sequence;
+    } else if (behind < SEQ_WINDOW_SIZE) {
+        if (e->window & (1ULL << behind)) {
+            return SEQ_DUPLICATE;
+        }
+        e->window |= 1ULL << behind;
+    } else {
+        e->highest = sequence;
+        e->window = 1;
+    }
+    return SEQ_ACCEPT;
+}
+
+
+// ===== 테스트 케이스 =====
+
+// 한 비콘의 창: 중복, 늦은 도착, 재시작, 번호 한 바퀴
+static void test_window(void) {
+    seq_tracker_init();
+    const char *s = "W-1";
+    CHECK_EQ_INT(seq_tracker_check(s, 10, 0), SEQ_ACCEPT);
+    CHECK_EQ_INT(seq_tracker_check(s, 10, 1), SEQ_DUPLICATE);
+    CHECK_EQ_INT(seq_tracker_check(s, 13, 2), SEQ_ACCEPT);          // 11, 12 손실
+    CHECK_EQ_INT(seq_tracker_check(s, 12, 3), SEQ_ACCEPT);          // 늦게 도착 → 손실 1 로
+    CHECK_EQ_INT(seq_tracker_check(s, 12, 4), SEQ_DUPLICATE);
+    CHECK_EQ_INT(seq_tracker_check(s, 13 - SEQ_WINDOW_SIZE, 5), SEQ_ACCEPT);    // 창 밖 → 재시작
+
+    seq_beacon_stats_t st;
+    CHECK(beacon_stats(s, &st));
+    CHECK_EQ_INT(st.received, 4);
+    CHECK_EQ_INT(st.duplicates, 2);
+    CHECK_EQ_INT(st.lost, 1);
+    CHECK_EQ_INT(st.restarts, 1);
+
+    // 번호 한 바퀴 (모듈러 차이)
+    const char *w = "W-2";
+    CHECK_EQ_INT(seq_tracker_check(w, UINT32_MAX - 1, 0), SEQ_ACCEPT);
+    CHECK_EQ_INT(seq_tracker_check(w, 1, 1), SEQ_ACCEPT);
+    CHECK_EQ_INT(seq_tracker_check(w, UINT32_MAX - 1, 2), SEQ_DUPLICATE);
+    CHECK_EQ_INT(seq_tracker_check(w, UINT32_MAX, 3), SEQ_ACCEPT);
+    CHECK_EQ_INT(seq_tracker_check(w, 0, 4), SEQ_ACCEPT);
+    CHECK_EQ_INT(seq_tracker_check(w, 0, 5), SEQ_DUPLICATE);
+}
+
+// 용량만큼의 비콘을 번갈아 받아도 밀려나지 않고 모든 재전송을 걸러냄 (이전 128 용량에서는 깨지던 경우)
+static void test_full_capacity_dedup(void) {
+    seq_tracker_init();
+    char serial[10];
+    int duplicates_missed = 0;
+    for (uint32_t seq = 0; seq < 20; seq++) {
+        for (int b = 0; b < SEQ_TRACKER_CAPACITY; b++) {
+            serial_for(b, serial);
+            CHECK_EQ_INT(seq_tracker_check(serial, seq, seq * 5000), SEQ_ACCEPT);
+        }
+        // 한 바퀴 돈 뒤 모든 비콘의 재전송
+        for (int b = 0; b < SEQ_TRACKER_CAPACITY; b++) {
+            serial_for(b, serial);
+            if (seq_tracker_check(serial, seq, seq * 5000 + 1) != SEQ_DUPLICATE) {
+                duplicates_missed++;
+            }
+        }
+    }
+    CHECK_EQ_INT(duplicates_missed, 0);
+
+    seq_tracker_stats_t stats;
+    seq_tracker_get_stats(&stats);
+    CHECK_EQ_INT(stats.tracked, SEQ_TRACKER_CAPACITY);
+    CHECK_EQ_INT(stats.evicted, 0);
+    CHECK_EQ_INT(stats.lost, 0);
+    CHECK_EQ_INT(stats.duplicates, 20 * SEQ_TRACKER_CAPACITY);
+}
+
+// 가득 차면 가장 오래 조용한 비콘만 밀려남 (최근에 받은 비콘은 창 유지)
+static void test_lru_eviction(void) {
+    seq_tracker_init();
+    char serial[10];
+    for (int b = 0; b < SEQ_TRACKER_CAPACITY; b++) {
+        serial_for(b, serial);
+        seq_tracker_check(serial, 100, (uint32_t)b);
+    }
+    // 0번을 다시 받아 가장 최근으로 → 다음 새 비콘은 1번을 밀어냄
+    serial_for(0, serial);
+    CHECK_EQ_INT(seq_tracker_check(serial, 101, 5000), SEQ_ACCEPT);
+    serial_for(SEQ_TRACKER_CAPACITY, serial);
+    CHECK_EQ_INT(seq_tracker_check(serial, 1, 5001), SEQ_ACCEPT);
+
+    seq_tracker_stats_t stats;
+    seq_tracker_get_stats(&stats);
+    CHECK_EQ_INT(stats.evicted, 1);
+    CHECK_EQ_INT(stats.tracked, SEQ_TRACKER_CAPACITY);
+
+    seq_beacon_stats_t st;
+    serial_for(1, serial);
+    CHECK(!beacon_stats(serial, &st));
+    serial_for(0, serial);
+    CHECK_EQ_INT(seq_tracker_check(serial, 101, 5002), SEQ_DUPLICATE);
+    serial_for(2, serial);
+    CHECK_EQ_INT(seq_tracker_check(serial, 100, 5003), SEQ_DUPLICATE);
+}
+
+// 용량보다 많은 시리얼로 무작위 번호/중복/밀어내기를 반복해 기준 모델과 판정 비교 (해시 인덱스 제거 경로 검증)
+static void test_churn_against_model(void) {
+    seq_tracker_init();
+    memset(s_model, 0, sizeof(s_model));
+    s_model_count = 0;
+    static uint32_t next_seq[CHURN_SERIALS];
+    memset(next_seq, 0, sizeof(next_seq));
+
+    uint32_t rng = 0x5E0;
+    char serial[10];
+    int mismatches = 0;
+    for (int step = 0; step < CHURN_STEPS && mismatches < 5; step++) {
+        // 앞쪽 시리얼일수록 자주 (일부만 계속 살아 있고 나머지는 드나듦)
+        int b = (int)(bench_rand(&rng) % CHURN_SERIALS);
+        if (bench_rand(&rng) % 2) {
+            b %= SEQ_TRACKER_CAPACITY / 2;
+        }
+        uint32_t r = bench_rand(&rng) % 100;
+        uint32_t seq;
+        if (r < 70) {
+            seq = next_seq[b]++;                                    // 정상 전진
+        } else if (r < 85) {
+            seq = next_seq[b] - 1 - bench_rand(&rng) % 8;           // 재전송 / 늦은 도착
+        } else if (r < 95) {
+            next_seq[b] += 1 + bench_rand(&rng) % 5;                // 손실
+            seq = next_seq[b]++;
+        } else {
+            next_seq[b] = bench_rand(&rng);                         // 재시작
+            seq = next_seq[b]++;
+        }
+        serial_for(b, serial);
+        seq_verdict_t actual = seq_tracker_check(serial, seq, (uint32_t)step);
+        seq_verdict_t expected = model_check(b, seq, (uint64_t)step);
+        if (actual != expected) {
+            fprintf(stderr, "단계 %d: %s #%u 판정 %d, 기대값 %d\n", step, serial, (unsigned)seq, actual, expected);
+            mismatches++;
+        }
+    }
+    CHECK_EQ_INT(mismatches, 0);
+
+    seq_tracker_stats_t stats;
+    seq_tracker_get_stats(&stats);
+    CHECK_EQ_INT(stats.tracked, s_model_count);
+    printf("  %d단계, 밀려남 %u, 중복 %u\n", CHURN_STEPS, (unsigned)stats.evicted, (unsigned)stats.duplicates);
+    CHECK(stats.evicted > 0);
+}
+
+int main(void) {
+    RUN_TEST(test_window);
+    RUN_TEST(test_full_capacity_dedup);
+    RUN_TEST(test_lru_eviction);
+    RUN_TEST(test_churn_against_model);
+    return test_finish();
+}
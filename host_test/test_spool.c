@@ -0,0 +1,255 @@
+#include <string.h>
+#include <unistd.h>
+#include "file_flash.h"
+#include "spool.h"
+#include "test_util.h"
+
+// ===== 테스트 설정 =====
+#define TEST_IMAGE_PATH "test_spool.img"
+#define TEST_SECTOR_SIZE 4096
+#define TEST_SECTORS 4
+#define TEST_RECORD_SIZE 64                 // 슬롯 72 바이트, 섹터당 56 슬롯
+#define TEST_SLOT_SIZE 72
+#define TEST_SLOTS_PER_SECTOR (TEST_SECTOR_SIZE / TEST_SLOT_SIZE)
+
+typedef struct {
+    uint32_t id;
+    uint8_t fill[TEST_RECORD_SIZE - 4];
+} test_record_t;
+
+static file_flash_t s_ff;
+static spool_flash_t s_flash;
+
+
+// ===== 도우미 =====
+
+// id 로 채운 레코드 생성
+static test_record_t make_record(uint32_t id) {
+    test_record_t r;
+    r.id = id;
+    memset(r.fill, (int)(0x40 + id % 64), sizeof(r.fill));
+    return r;
+}
+
+// 새 이미지로 스풀 시작
+static void fresh_spool(size_t max_sectors) {
+    file_flash_close(&s_ff);
+    CHECK_EQ_INT(file_flash_create(&s_ff, TEST_IMAGE_PATH, TEST_SECTOR_SIZE * TEST_SECTORS,
+                                   TEST_SECTOR_SIZE, &s_flash), ESP_OK);
+    CHECK_EQ_INT(spool_init(&s_flash, TEST_RECORD_SIZE, max_sectors), ESP_OK);
+}
+
+// 같은 이미지로 재부팅
+static void reboot_spool(size_t max_sectors) {
+    file_flash_close(&s_ff);
+    CHECK_EQ_INT(file_flash_open(&s_ff, TEST_IMAGE_PATH, TEST_SECTOR_SIZE * TEST_SECTORS,
+                                 TEST_SECTOR_SIZE, &s_flash), ESP_OK);
+    CHECK_EQ_INT(spool_init(&s_flash, TEST_RECORD_SIZE, max_sectors), ESP_OK);
+}
+
+// 업로더 재전송 루프처럼 비울 때까지 peek/commit, 읽은 id 를 ids 에 기록
+// peek 가 0개를 돌려주면서 pending 이 남아 있으면 업로더가 헛돌게 되므로 실패로 처리
+static int drain(uint32_t *ids, int max_ids) {
+    test_record_t batch[16];
+    int total = 0;
+    for (int round = 0; round < 1000 && spool_pending() > 0; round++) {
+        int count = -1;
+        CHECK_EQ_INT(spool_peek(batch, 16, &count), ESP_OK);
+        if (count == 0) {
+            CHECK_EQ_INT(spool_pending(), 0);
+            break;
+        }
+        for (int i = 0; i < count && total < max_ids; i++) {
+            ids[total++] = batch[i].id;
+        }
+        CHECK_EQ_INT(spool_commit(count), ESP_OK);
+    }
+    CHECK_EQ_INT(spool_pending(), 0);
+    return total;
+}
+
+
+// ===== 테스트 케이스 =====
+
+// 추가한 순서대로 읽히고 커밋하면 비워짐 (RAM 버퍼 + 플래시)
+static void test_roundtrip(void) {
+    fresh_spool(0);
+    for (uint32_t i = 0; i < 40; i++) {
+        test_record_t r = make_record(i);
+        CHECK_EQ_INT(spool_append(&r, 0), ESP_OK);
+    }
+    CHECK_EQ_INT(spool_pending(), 40);
+
+    uint32_t ids[64];
+    int n = drain(ids, 64);
+    CHECK_EQ_INT(n, 40);
+    for (int i = 0; i < n; i++) {
+        CHECK_EQ_INT(ids[i], i);
+    }
+}
+
+// 커밋 위치가 재부팅 후에도 유지됨
+static void test_persist_across_reboot(void) {
+    fresh_spool(0);
+    for (uint32_t i = 0; i < 20; i++) {
+        test_record_t r = make_record(i);
+        spool_append(&r, 0);
+    }
+    CHECK_EQ_INT(spool_flush(0, true), ESP_OK);
+
+    test_record_t batch[5];
+    int count = 0;
+    spool_peek(batch, 5, &count);
+    CHECK_EQ_INT(count, 5);
+    CHECK_EQ_INT(spool_commit(5), ESP_OK);
+
+    reboot_spool(0);
+    CHECK_EQ_INT(spool_pending(), 15);
+    count = 0;
+    spool_peek(batch, 1, &count);
+    CHECK_EQ_INT(count, 1);
+    CHECK_EQ_INT(batch[0].id, 5);
+}
+
+// 섹터 기록 도중 전원 차단: 복구 후 건너뛴 슬롯이 pending 에 남아 있어도 peek 가 비우고,
+// 살아남은 레코드는 모두 읽히며, 이후 추가한 레코드도 정상적으로 나옴
+static void test_power_cut_recovery(void) {
+    fresh_spool(0);
+    for (uint32_t i = 0; i < 7; i++) {
+        test_record_t r = make_record(i);
+        spool_append(&r, 0);
+    }
+    CHECK_EQ_INT(spool_flush(0, true), ESP_OK);
+
+    // 다음 배치 7개 중 3개 반만 기록되고 꺼짐 (4번째 슬롯은 헤더만, 페이로드 일부)
+    for (uint32_t i = 7; i < 14; i++) {
+        test_record_t r = make_record(i);
+        spool_append(&r, 0);
+    }
+    file_flash_cut_power_after(&s_ff, 3 * TEST_SLOT_SIZE + 40);
+    CHECK(spool_flush(0, true) != ESP_OK);
+
+    reboot_spool(0);
+    // 다음 기록은 새 섹터부터이므로 첫 섹터의 나머지가 모두 pending 에 포함됨
+    CHECK_EQ_INT(spool_pending(), TEST_SLOTS_PER_SECTOR);
+
+    spool_stats_t before;
+    spool_get_stats(&before);
+    uint32_t ids[64];
+    int n = drain(ids, 64);
+    CHECK_EQ_INT(n, 10);
+    for (int i = 0; i < n; i++) {
+        CHECK_EQ_INT(ids[i], i);
+    }
+    spool_stats_t after;
+    spool_get_stats(&after);
+    CHECK_EQ_INT(after.skipped - before.skipped, TEST_SLOTS_PER_SECTOR - 10);
+
+    // 복구 이후 추가한 레코드
+    for (uint32_t i = 100; i < 105; i++) {
+        test_record_t r = make_record(i);
+        CHECK_EQ_INT(spool_append(&r, 0), ESP_OK);
+    }
+    CHECK_EQ_INT(spool_flush(0, true), ESP_OK);
+    reboot_spool(0);
+    CHECK_EQ_INT(spool_pending(), 5);
+    n = drain(ids, 64);
+    CHECK_EQ_INT(n, 5);
+    CHECK_EQ_INT(ids[0], 100);
+    CHECK_EQ_INT(ids[4], 104);
+}
+
+// 일부 커밋 후 전원 차단: 커밋하지 않은 레코드만 남고 헛돌지 않음
+static void test_power_cut_after_partial_commit(void) {
+    fresh_spool(0);
+    for (uint32_t i = 0; i < 7; i++) {
+        test_record_t r = make_record(i);
+        spool_append(&r, 0);
+    }
+    spool_flush(0, true);
+    for (uint32_t i = 7; i < 14; i++) {
+        test_record_t r = make_record(i);
+        spool_append(&r, 0);
+    }
+    file_flash_cut_power_after(&s_ff, TEST_SLOT_SIZE / 2);
+    CHECK(spool_flush(0, true) != ESP_OK);
+
+    reboot_spool(0);
+    test_record_t batch[4];
+    int count = 0;
+    spool_peek(batch, 4, &count);
+    CHECK_EQ_INT(count, 4);
+    spool_commit(count);
+
+    reboot_spool(0);
+    uint32_t ids[64];
+    int n = drain(ids, 64);
+    CHECK_EQ_INT(n, 3);
+    CHECK_EQ_INT(ids[0], 4);
+    CHECK_EQ_INT(ids[2], 6);
+}
+
+// 중간 슬롯의 CRC 손상: 그 레코드만 빠지고 커밋 시 함께 소비
+static void test_corrupt_middle_slot(void) {
+    fresh_spool(0);
+    for (uint32_t i = 0; i < 10; i++) {
+        test_record_t r = make_record(i);
+        spool_append(&r, 0);
+    }
+    spool_flush(0, true);
+    file_flash_poke(&s_ff, 3 * TEST_SLOT_SIZE + 8 + 10, 0x00);   // seq 3 페이로드 한 바이트
+
+    spool_stats_t before;
+    spool_get_stats(&before);
+    test_record_t batch[16];
+    int count = 0;
+    spool_peek(batch, 16, &count);
+    CHECK_EQ_INT(count, 9);
+    CHECK_EQ_INT(batch[2].id, 2);
+    CHECK_EQ_INT(batch[3].id, 4);
+    CHECK_EQ_INT(spool_commit(count), ESP_OK);
+    CHECK_EQ_INT(spool_pending(), 0);
+
+    spool_stats_t after;
+    spool_get_stats(&after);
+    CHECK_EQ_INT(after.skipped - before.skipped, 1);
+    CHECK_EQ_INT(after.replayed - before.replayed, 9);
+}
+
+// 보관 한도를 넘기면 가장 오래된 섹터부터 버림
+static void test_wrap_eviction(void) {
+    fresh_spool(2);
+    uint32_t total = 3 * TEST_SLOTS_PER_SECTOR;
+    spool_stats_t before;
+    spool_get_stats(&before);
+    for (uint32_t i = 0; i < total; i++) {
+        test_record_t r = make_record(i);
+        CHECK_EQ_INT(spool_append(&r, 0), ESP_OK);
+    }
+    spool_flush(0, true);
+
+    spool_stats_t after;
+    spool_get_stats(&after);
+    CHECK_EQ_INT(after.dropped - before.dropped, TEST_SLOTS_PER_SECTOR);
+    CHECK_EQ_INT(spool_pending(), 2 * TEST_SLOTS_PER_SECTOR);
+
+    reboot_spool(2);
+    CHECK_EQ_INT(spool_pending(), 2 * TEST_SLOTS_PER_SECTOR);
+    uint32_t ids[2 * TEST_SLOTS_PER_SECTOR];
+    int n = drain(ids, 2 * TEST_SLOTS_PER_SECTOR);
+    CHECK_EQ_INT(n, 2 * TEST_SLOTS_PER_SECTOR);
+    CHECK_EQ_INT(ids[0], TEST_SLOTS_PER_SECTOR);
+    CHECK_EQ_INT(ids[n - 1], total - 1);
+}
+
+int main(void) {
+    RUN_TEST(test_roundtrip);
+    RUN_TEST(test_persist_across_reboot);
+    RUN_TEST(test_power_cut_recovery);
+    RUN_TEST(test_power_cut_after_partial_commit);
+    RUN_TEST(test_corrupt_middle_slot);
+    RUN_TEST(test_wrap_eviction);
+    file_flash_close(&s_ff);
+    unlink(TEST_IMAGE_PATH);
+    return test_finish();
+}
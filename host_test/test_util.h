@@ -0,0 +1,51 @@
+#pragma once
+
+// ===== 호스트 테스트 공통 매크로 =====
+// 실패해도 계속 진행해 한 번에 모든 실패를 보여 주고, test_finish() 가 종료 코드를 결정
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int s_test_failures = 0;
+
+#define CHECK(cond) do {                                                        \
+    if (!(cond)) {                                                              \
+        fprintf(stderr, "%s:%d: CHECK 실패: %s\n", __FILE__, __LINE__, #cond);   \
+        s_test_failures++;                                                      \
+    }                                                                           \
+} while (0)
+
+#define CHECK_EQ_INT(actual, expected) do {                                     \
+    long long a_ = (long long)(actual), e_ = (long long)(expected);             \
+    if (a_ != e_) {                                                             \
+        fprintf(stderr, "%s:%d: %s = %lld, 기대값 %lld\n",                        \
+                __FILE__, __LINE__, #actual, a_, e_);                           \
+        s_test_failures++;                                                      \
+    }                                                                           \
+} while (0)
+
+#define CHECK_NEAR(actual, expected, tol) do {                                  \
+    double a_ = (double)(actual), e_ = (double)(expected);                      \
+    if (!(fabs(a_ - e_) <= (tol))) {                                            \
+        fprintf(stderr, "%s:%d: %s = %.6f, 기대값 %.6f (허용 %.6f)\n",             \
+                __FILE__, __LINE__, #actual, a_, e_, (double)(tol));            \
+        s_test_failures++;                                                      \
+    }                                                                           \
+} while (0)
+
+// 테스트 케이스 실행 (이름 출력 후 호출)
+#define RUN_TEST(fn) do {                                                       \
+    printf("[테스트] %s\n", #fn);                                                \
+    fn();                                                                       \
+} while (0)
+
+// 결과 출력 후 종료 코드 반환
+static inline int test_finish(void) {
+    if (s_test_failures > 0) {
+        printf("실패 %d건\n", s_test_failures);
+        return EXIT_FAILURE;
+    }
+    printf("모두 통과\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+"""게이트웨이 업로드 스텁 서버.
+
+게이트웨이의 배치 업로드(JSON / CBOR)와 상태 레코드를 받아 버리고 처리량만 집계한다.
+게이트웨이 콘솔의 loadgen 명령과 함께 쓰면 실제 서버 없이 수신 → 업로드 경로의 처리량과 지연을 잴 수 있다.
+
+사용 예:
+    python3 tools/stub_upload_server.py --port 8080
+    idf.py -DGATEWAY_SERVER_BASE_URL=http://<PC IP>:8080 build flash monitor
+    (게이트웨이 콘솔) loadgen 1000 2000 60
+
+상태 레코드가 오면 게이트웨이가 잰 단계별 지연(p50/p99)을 함께 출력한다.
+레코드 timestamp 기준 도착 지연은 게이트웨이(SNTP)와 PC 시계가 맞아 있을 때만 의미가 있다.
+"""
+
+import argparse
+import json
+import struct
+import sys
+import threading
+import time
+from datetime import datetime, timezone
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+BATCH_PATH = '/api/locations/calculate/batch'
+SINGLE_PATH = '/api/locations/calculate'
+HEALTH_PATH = '/api/gateways/health'
+SYNTHETIC_PREFIX = 'LG-'                    # gateway/main/load_generator.h 의 LOADGEN_SERIAL_PREFIX
+CBOR_KEY_SERIAL = 0                         # gateway/main/record_cbor.h 의 레코드 맵 키
+CBOR_KEY_TIMESTAMP = 3
+
+
+class CborDecoder:
+    """레코드 CBOR 에 쓰는 타입만 읽는 최소 디코더 (정수, 바이트/텍스트, 배열, 맵, float32/64)."""
+
+    BREAK = object()
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def _take(self, n):
+        if self.pos + n > len(self.data):
+            raise ValueError('CBOR 가 중간에 끝남')
+        chunk = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return chunk
+
+    def _argument(self, info):
+        if info < 24:
+            return info
+        if info == 31:
+            return None                     # 무한 길이
+        size = {24: 1, 25: 2, 26: 4, 27: 8}.get(info)
+        if size is None:
+            raise ValueError('지원하지 않는 CBOR 길이 인코딩: %d' % info)
+        return int.from_bytes(self._take(size), 'big')
+
+    def decode(self):
+        head = self._take(1)[0]
+        major, info = head >> 5, head & 0x1F
+        if head == 0xFF:
+            return self.BREAK
+        if major == 7:
+            if info == 26:
+                return struct.unpack('>f', self._take(4))[0]
+            if info == 27:
+                return struct.unpack('>d', self._take(8))[0]
+            return {20: False, 21: True, 22: None}.get(info)
+        value = self._argument(info)
+        if major == 0:
+            return value
+        if major == 1:
+            return -1 - value
+        if major in (2, 3):
+            raw = self._take(value)
+            return raw if major == 2 else raw.decode('utf-8', errors='replace')
+        if major == 4:
+            return self._array(value)
+        if major == 5:
+            return self._map(value)
+        raise ValueError('지원하지 않는 CBOR 주 타입: %d' % major)
+
+    def _array(self, count):
+        items = []
+        while count is None or len(items) < count:
+            item = self.decode()
+            if item is self.BREAK:
+                break
+            items.append(item)
+        return items
+
+    def _map(self, count):
+        result = {}
+        while count is None or len(result) < count:
+            key = self.decode()
+            if key is self.BREAK:
+                break
+            result[key] = self.decode()
+        return result
+
+
+def record_fields(record):
+    """JSON / CBOR 레코드 → (시리얼, 게이트웨이 처리 시각 epoch 초 또는 None)"""
+    if CBOR_KEY_SERIAL in record:
+        serial = record.get(CBOR_KEY_SERIAL, '')
+        timestamp_ms = record.get(CBOR_KEY_TIMESTAMP)
+        return serial, timestamp_ms / 1000.0 if isinstance(timestamp_ms, int) else None
+    serial = record.get('serial_number', '')
+    timestamp = record.get('timestamp')
+    try:
+        return serial, datetime.strptime(timestamp, '%Y-%m-%dT%H:%M:%S.%fZ').replace(tzinfo=timezone.utc).timestamp()
+    except (TypeError, ValueError):
+        return serial, None
+
+
+def percentile(sorted_values, percent):
+    if not sorted_values:
+        return 0.0
+    index = min(len(sorted_values) - 1, int(len(sorted_values) * percent / 100))
+    return sorted_values[index]
+
+
+class Stats:
+    """구간/전체 카운터 (요청 스레드 여러 개가 갱신)"""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.total_records = 0
+        self.total_synthetic = 0
+        self.total_requests = 0
+        self.total_bytes = 0
+        self.total_errors = 0
+        self.started = time.monotonic()
+        self.reset_interval()
+
+    def reset_interval(self):
+        self.records = 0
+        self.synthetic = 0
+        self.requests = 0
+        self.bytes = 0
+        self.arrival_delays = []
+        self.interval_started = time.monotonic()
+
+    def note_batch(self, records, body_len):
+        now = time.time()
+        with self.lock:
+            self.requests += 1
+            self.total_requests += 1
+            self.bytes += body_len
+            self.total_bytes += body_len
+            for record in records:
+                serial, timestamp = record_fields(record) if isinstance(record, dict) else ('', None)
+                self.records += 1
+                self.total_records += 1
+                if isinstance(serial, str) and serial.startswith(SYNTHETIC_PREFIX):
+                    self.synthetic += 1
+                    self.total_synthetic += 1
+                if timestamp is not None:
+                    self.arrival_delays.append(now - timestamp)
+
+    def note_error(self):
+        with self.lock:
+            self.total_errors += 1
+
+    def report_interval(self):
+        with self.lock:
+            elapsed = max(time.monotonic() - self.interval_started, 1e-6)
+            delays = sorted(self.arrival_delays)
+            line = ('%6.1f 레코드/s (합성 %d), 요청 %.1f/s, %.1f KB/s' %
+                    (self.records / elapsed, self.synthetic, self.requests / elapsed, self.bytes / elapsed / 1024))
+            if delays:
+                line += ', 도착 지연 p50 %.0f ms / p99 %.0f ms' % (percentile(delays, 50) * 1000,
+                                                               percentile(delays, 99) * 1000)
+            busy = self.requests > 0
+            self.reset_interval()
+        if busy:
+            print(line, flush=True)
+
+    def report_total(self):
+        elapsed = max(time.monotonic() - self.started, 1e-6)
+        print('전체: 레코드 %d (합성 %d), 요청 %d, %.1f KB, 파싱 실패 %d, %.0f초' %
+              (self.total_records, self.total_synthetic, self.total_requests, self.total_bytes / 1024,
+               self.total_errors, elapsed))
+
+
+def print_health(record):
+    """게이트웨이 상태 레코드의 단계별 지연 요약"""
+    latency = record.get('latency_us', {})
+    stages = ', '.join('%s p50 %d / p99 %d us' % (name, hist.get('p50', 0), hist.get('p99', 0))
+                       for name, hist in latency.items())
+    ingest = record.get('ingest', {})
+    uplink = record.get('uplink', {})
+    print('[상태 %s] 수신 %d (링 폐기 %d), 전송 %d (버퍼 폐기 %d), %s' %
+          (record.get('gateway', '?'), ingest.get('received', 0), ingest.get('ring_dropped', 0),
+           uplink.get('records_sent', 0), uplink.get('records_dropped', 0), stages), flush=True)
+
+
+def make_handler(stats, args):
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = 'HTTP/1.1'       # 게이트웨이는 keep-alive 로 연결을 재사용
+
+        def do_POST(self):
+            body = self.rfile.read(int(self.headers.get('Content-Length', 0)))
+            path = self.path.split('?', 1)[0]
+            content_type = self.headers.get('Content-Type', '')
+            try:
+                if path == HEALTH_PATH:
+                    print_health(json.loads(body))
+                elif path in (BATCH_PATH, SINGLE_PATH):
+                    if 'cbor' in content_type:
+                        records = CborDecoder(body).decode()
+                    else:
+                        records = json.loads(body)
+                    if not isinstance(records, list):
+                        records = [records]
+                    stats.note_batch(records, len(body))
+                else:
+                    self._reply(404)
+                    return
+            except (ValueError, UnicodeDecodeError) as e:
+                stats.note_error()
+                print('파싱 실패 (%s, %d 바이트): %s' % (path, len(body), e), file=sys.stderr)
+                self._reply(400)
+                return
+
+            if args.delay_ms > 0:
+                time.sleep(args.delay_ms / 1000.0)
+            self._reply(args.status if path != HEALTH_PATH else 200)
+
+        def _reply(self, status):
+            self.send_response(status)
+            self.send_header('Content-Length', '0')
+            self.end_headers()
+
+        def log_message(self, format, *log_args):
+            pass                            # 요청마다 찍지 않음 (구간 요약만)
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description='게이트웨이 업로드 스텁 서버 (처리량/도착 지연 집계)')
+    parser.add_argument('--host', default='0.0.0.0', help='수신 주소 (기본 0.0.0.0)')
+    parser.add_argument('--port', type=int, default=8080, help='수신 포트 (기본 8080)')
+    parser.add_argument('--interval', type=float, default=5.0, help='구간 요약 출력 간격 (초)')
+    parser.add_argument('--status', type=int, default=200, help='배치 응답 상태 코드 (재시도/스풀 경로 확인용)')
+    parser.add_argument('--delay-ms', type=int, default=0, help='응답 전 인위적 지연 (느린 서버 흉내)')
+    args = parser.parse_args()
+
+    stats = Stats()
+    server = ThreadingHTTPServer((args.host, args.port), make_handler(stats, args))
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    print('스텁 서버 대기 중: http://%s:%d (배치 %s, 상태 %s)' % (args.host, args.port, BATCH_PATH, HEALTH_PATH),
+          flush=True)
+
+    try:
+        while True:
+            time.sleep(args.interval)
+            stats.report_interval()
+    except KeyboardInterrupt:
+        pass
+    server.shutdown()
+    stats.report_total()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""swift_trace 덤프 디코더.
+
+idf.py monitor 출력(또는 저장한 로그)에서 "@SWT" 줄을 찾아 레코드를 읽을 수 있는 텍스트로 변환한다.
+이벤트 표는 components/swift_trace/include/swift_trace.h 의 SWIFT_TRACE_EVENTS 를 그대로 읽는다.
+
+사용 예:
+    idf.py -p /dev/ttyUSB0 monitor | tee monitor.log
+    python3 tools/swift_trace_decode.py monitor.log
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'components',
+                              'swift_trace', 'include', 'swift_trace.h')
+
+EVENT_RE = re.compile(r'X\(\s*(\w+)\s*,\s*(0x[0-9a-fA-F]+|\d+)\s*,\s*"([^"]*)"\s*\)')
+LINE_RE = re.compile(r'@SWT ([0-9a-f]{8}) ([0-9a-f]+)')
+RECORD = struct.Struct('<IBBHii')
+
+
+def load_events(header_path):
+    """헤더의 SWIFT_TRACE_EVENTS 표 → {번호: (이름, 설명 포맷)}"""
+    with open(header_path, encoding='utf-8') as f:
+        text = f.read()
+    events = {}
+    for name, number, description in EVENT_RE.findall(text):
+        events[int(number, 0)] = (name, description)
+    if not events:
+        sys.exit('이벤트 표를 찾지 못함: %s' % header_path)
+    return events
+
+
+def serial_tail(value):
+    raw = struct.pack('<i', value).rstrip(b'\0')
+    return raw.decode('ascii', errors='replace')
+
+
+def fields(u8, u16, a, b):
+    """설명 문자열에서 쓸 수 있는 필드 (헤더 주석과 같은 이름)"""
+    return {
+        'u8': u8,
+        's8': u8 - 256 if u8 >= 128 else u8,
+        'u16': u16,
+        'a': a,
+        'b': b,
+        'am': a / 1000.0,
+        'bm': b / 1000.0,
+        'bu': b / 1000000.0,
+        'k16': u16 / 1000.0,
+        'cm16': u16 / 100.0,
+        'mac': '%02x:%02x' % (u16 >> 8, u16 & 0xFF),
+        'serial': serial_tail(b),
+    }
+
+
+def decode(stream, events, out):
+    expected = None
+    last_raw = None
+    wrap_us = 0
+    lost_total = 0
+
+    for line in stream:
+        match = LINE_RE.search(line)
+        if match is None:
+            continue
+        index = int(match.group(1), 16)
+        payload = bytes.fromhex(match.group(2))
+
+        # 재부팅(순번이 되돌아감)이면 시간 기준을 다시 잡음
+        if expected is not None and index < expected:
+            out.write('---- 재부팅 (순번 %d → %d) ----\n' % (expected, index))
+            last_raw = None
+            wrap_us = 0
+        elif expected is not None and index > expected:
+            lost = index - expected
+            lost_total += lost
+            out.write('---- 레코드 %d개 손실 (덤프 전에 링이 덮어씀) ----\n' % lost)
+
+        for offset in range(0, len(payload) - RECORD.size + 1, RECORD.size):
+            time_us, event, u8, u16, a, b = RECORD.unpack_from(payload, offset)
+
+            # esp_timer 하위 32비트 (약 71분마다 돌아감)
+            if last_raw is not None and time_us < last_raw:
+                wrap_us += 1 << 32
+            last_raw = time_us
+            now_us = wrap_us + time_us
+
+            name, description = events.get(event, ('UNKNOWN_%02X' % event, 'u8={u8} u16={u16} a={a} b={b}'))
+            try:
+                text = description.format(**fields(u8, u16, a, b))
+            except (KeyError, ValueError, IndexError) as e:
+                text = '(포맷 오류 %s) u8=%d u16=%d a=%d b=%d' % (e, u8, u16, a, b)
+            out.write('%12.6f  #%08x  %-18s %s\n' % (now_us / 1e6, index, name, text))
+            index += 1
+
+        expected = index
+
+    if lost_total:
+        out.write('총 손실 레코드: %d\n' % lost_total)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='swift_trace 덤프를 텍스트로 변환')
+    parser.add_argument('logs', nargs='*', help='모니터 로그 파일 (없으면 표준 입력)')
+    parser.add_argument('--header', default=DEFAULT_HEADER, help='swift_trace.h 경로')
+    args = parser.parse_args()
+
+    events = load_events(args.header)
+    if not args.logs:
+        decode(sys.stdin, events, sys.stdout)
+        return
+    for path in args.logs:
+        with open(path, encoding='utf-8', errors='replace') as f:
+            decode(f, events, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()